@@ -0,0 +1,14 @@
+#!/bin/bash
+
+# Wrapper script to run the headless bot with the SDK library paths
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+SDK_QT_LIB_PATH="${SCRIPT_DIR}/src/lib/zoom_video_sdk/qt_libs/Qt/lib"
+SDK_LIB_PATH="${SCRIPT_DIR}/src/lib/zoom_video_sdk"
+
+export LD_LIBRARY_PATH="${SDK_QT_LIB_PATH}:${SDK_LIB_PATH}:${LD_LIBRARY_PATH}"
+
+# No display is needed
+export QT_QPA_PLATFORM=offscreen
+
+"${SCRIPT_DIR}/src/bin/headless_bot" "$@"
@@ -0,0 +1,226 @@
+#include "AllocationTracker.h"
+#include "Logger.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <malloc.h>
+#include <mutex>
+#include <new>
+#include <time.h>
+
+namespace {
+
+struct StageCounters
+{
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> bytesAllocated{0};
+    std::atomic<int64_t> liveBytes{0};
+};
+
+StageCounters g_stages[ALLOC_STAGE_COUNT];
+std::atomic<uint64_t> g_frames{0};
+thread_local AllocStage t_stage = ALLOC_STAGE_OTHER;
+
+// State for the rates in snapshot(); guarded by g_rateMutex
+std::mutex g_rateMutex;
+int64_t g_lastSampleNs = 0;
+uint64_t g_lastAllocations = 0;
+uint64_t g_lastVideoAllocations = 0;
+uint64_t g_lastFrames = 0;
+
+const char* const kStageNames[ALLOC_STAGE_COUNT] = {
+    "other", "session", "video-receive", "video-convert", "audio", "ui"
+};
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+uint64_t processHeapBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+#ifdef ENABLE_ALLOC_TRACKING
+
+// Every tracked block is preceded by this header so delete can find the
+// size, the stage it was charged to and the start of the malloc'd block.
+struct alignas(16) AllocHeader
+{
+    uint64_t size;
+    uint32_t stage;
+    uint32_t offset;
+};
+static_assert(sizeof(AllocHeader) == 16, "header must keep 16-byte alignment");
+
+void* trackedAlloc(size_t size, size_t alignment)
+{
+    size_t offset = alignment > sizeof(AllocHeader) ? alignment : sizeof(AllocHeader);
+    void* raw;
+    if (alignment > alignof(std::max_align_t)) {
+        size_t total = (size + offset + alignment - 1) / alignment * alignment;
+        raw = aligned_alloc(alignment, total);
+    } else {
+        raw = malloc(size + offset);
+    }
+    if (!raw) return nullptr;
+
+    char* user = static_cast<char*>(raw) + offset;
+    AllocHeader* header = reinterpret_cast<AllocHeader*>(user) - 1;
+    header->size = size;
+    header->stage = t_stage;
+    header->offset = (uint32_t)offset;
+
+    StageCounters& c = g_stages[t_stage];
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+    c.liveBytes.fetch_add((int64_t)size, std::memory_order_relaxed);
+    return user;
+}
+
+void trackedFree(void* ptr)
+{
+    if (!ptr) return;
+    AllocHeader* header = static_cast<AllocHeader*>(ptr) - 1;
+    StageCounters& c = g_stages[header->stage];
+    c.frees.fetch_add(1, std::memory_order_relaxed);
+    c.liveBytes.fetch_sub((int64_t)header->size, std::memory_order_relaxed);
+    free(static_cast<char*>(ptr) - header->offset);
+}
+
+void* trackedAllocOrThrow(size_t size, size_t alignment)
+{
+    for (;;) {
+        void* p = trackedAlloc(size ? size : 1, alignment);
+        if (p) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+#endif // ENABLE_ALLOC_TRACKING
+
+} // namespace
+
+#ifdef ENABLE_ALLOC_TRACKING
+
+void* operator new(size_t size) { return trackedAllocOrThrow(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size) { return trackedAllocOrThrow(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size ? size : 1, alignof(std::max_align_t)); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size ? size : 1, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t al) { return trackedAllocOrThrow(size, (size_t)al); }
+void* operator new[](size_t size, std::align_val_t al) { return trackedAllocOrThrow(size, (size_t)al); }
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return trackedAlloc(size ? size : 1, (size_t)al); }
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return trackedAlloc(size ? size : 1, (size_t)al); }
+
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+
+#endif // ENABLE_ALLOC_TRACKING
+
+bool AllocationTracker::isEnabled()
+{
+#ifdef ENABLE_ALLOC_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+AllocStage AllocationTracker::currentStage()
+{
+    return t_stage;
+}
+
+void AllocationTracker::setCurrentStage(AllocStage stage)
+{
+    t_stage = stage;
+}
+
+void AllocationTracker::noteFrame()
+{
+#ifdef ENABLE_ALLOC_TRACKING
+    g_frames.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+AllocSnapshot AllocationTracker::snapshot()
+{
+    AllocSnapshot snap = {};
+    uint64_t totalAllocations = 0;
+    for (int i = 0; i < ALLOC_STAGE_COUNT; i++) {
+        AllocStageStats& s = snap.stages[i];
+        s.allocations = g_stages[i].allocations.load(std::memory_order_relaxed);
+        s.frees = g_stages[i].frees.load(std::memory_order_relaxed);
+        s.bytesAllocated = g_stages[i].bytesAllocated.load(std::memory_order_relaxed);
+        s.liveBytes = g_stages[i].liveBytes.load(std::memory_order_relaxed);
+        snap.liveBytes += s.liveBytes;
+        totalAllocations += s.allocations;
+    }
+    uint64_t videoAllocations = snap.stages[ALLOC_STAGE_VIDEO_RECEIVE].allocations
+                              + snap.stages[ALLOC_STAGE_VIDEO_CONVERT].allocations;
+    snap.frames = g_frames.load(std::memory_order_relaxed);
+    snap.processHeapBytes = processHeapBytes();
+
+    std::lock_guard<std::mutex> lock(g_rateMutex);
+    int64_t now = monotonicNs();
+    if (g_lastSampleNs != 0 && now > g_lastSampleNs) {
+        double seconds = (now - g_lastSampleNs) / 1e9;
+        snap.allocationsPerSecond = (totalAllocations - g_lastAllocations) / seconds;
+        uint64_t frames = snap.frames - g_lastFrames;
+        if (frames > 0) {
+            snap.allocationsPerFrame = double(videoAllocations - g_lastVideoAllocations) / frames;
+        }
+    }
+    g_lastSampleNs = now;
+    g_lastAllocations = totalAllocations;
+    g_lastVideoAllocations = videoAllocations;
+    g_lastFrames = snap.frames;
+    return snap;
+}
+
+void AllocationTracker::report()
+{
+    if (!isEnabled()) return;
+
+    AllocSnapshot snap = snapshot();
+    LOG_INFO("Allocation tracker: live %lld bytes, heap %llu bytes, %.1f allocs/s, %.2f video allocs/frame over %llu frames",
+             (long long)snap.liveBytes, (unsigned long long)snap.processHeapBytes,
+             snap.allocationsPerSecond, snap.allocationsPerFrame, (unsigned long long)snap.frames);
+    for (int i = 0; i < ALLOC_STAGE_COUNT; i++) {
+        const AllocStageStats& s = snap.stages[i];
+        LOG_INFO("  %-14s allocs %llu frees %llu bytes %llu live %lld", kStageNames[i],
+                 (unsigned long long)s.allocations, (unsigned long long)s.frees,
+                 (unsigned long long)s.bytesAllocated, (long long)s.liveBytes);
+    }
+    if (snap.allocationsPerFrame > 0.0) {
+        LOG_WARN("Allocation tracker: video pipeline is allocating in steady state (%.2f allocs/frame)",
+                 snap.allocationsPerFrame);
+    }
+}
+
+const char* AllocationTracker::stageName(AllocStage stage)
+{
+    return stage < ALLOC_STAGE_COUNT ? kStageNames[stage] : "invalid";
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+
+// Opt-in heap accounting (configure with -DENABLE_ALLOC_TRACKING=ON).
+// When enabled, the global operator new/delete family is replaced so every
+// C++ allocation is counted against the pipeline stage active on the calling
+// thread. When disabled, the scope guard and counters compile to no-ops.
+
+enum AllocStage
+{
+    ALLOC_STAGE_OTHER = 0,
+    ALLOC_STAGE_SESSION,        // session/user delegate callbacks
+    ALLOC_STAGE_VIDEO_RECEIVE,  // raw video callbacks before conversion
+    ALLOC_STAGE_VIDEO_CONVERT,  // YUV to RGB and hand-off to the widget
+    ALLOC_STAGE_AUDIO,          // raw audio callbacks and ALSA playback
+    ALLOC_STAGE_UI,             // Qt widgets and painting
+    ALLOC_STAGE_COUNT
+};
+
+struct AllocStageStats
+{
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t bytesAllocated;
+    int64_t liveBytes;
+};
+
+struct AllocSnapshot
+{
+    AllocStageStats stages[ALLOC_STAGE_COUNT];
+    uint64_t frames;          // frames reported through noteFrame()
+    int64_t liveBytes;        // all tracked stages
+    uint64_t processHeapBytes; // malloc arena in use, including SDK and Qt allocations
+    double allocationsPerSecond;
+    double allocationsPerFrame; // video stages only, since the previous snapshot
+};
+
+class AllocationTracker
+{
+public:
+    static bool isEnabled();
+
+    static AllocStage currentStage();
+    static void setCurrentStage(AllocStage stage);
+
+    // Called once per delivered video frame so per-frame rates can be derived
+    static void noteFrame();
+
+    // Totals plus rates measured since the previous snapshot() call
+    static AllocSnapshot snapshot();
+
+    // Log a per-stage summary; warns when video stages allocate in steady state
+    static void report();
+
+    static const char* stageName(AllocStage stage);
+};
+
+// Attributes allocations made on this thread to a stage for the current scope
+class AllocStageScope
+{
+public:
+    explicit AllocStageScope(AllocStage stage)
+#ifdef ENABLE_ALLOC_TRACKING
+        : m_previous(AllocationTracker::currentStage())
+    {
+        AllocationTracker::setCurrentStage(stage);
+    }
+    ~AllocStageScope() { AllocationTracker::setCurrentStage(m_previous); }
+
+private:
+    AllocStage m_previous;
+#else
+    {
+        (void)stage;
+    }
+#endif
+};
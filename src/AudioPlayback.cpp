@@ -0,0 +1,102 @@
+#include "AudioPlayback.h"
+#include "Logger.h"
+
+AudioPlayback::AudioPlayback() : pcm_handle(nullptr), initialized(false) {}
+
+AudioPlayback::~AudioPlayback() {
+    cleanup();
+}
+
+bool AudioPlayback::init() {
+    int err;
+
+    // Open PCM device for playback
+    err = snd_pcm_open(&pcm_handle, "default", SND_PCM_STREAM_PLAYBACK, 0);
+    if (err < 0) {
+        LOG_ERROR("Failed to open PCM device: %s", snd_strerror(err));
+        return false;
+    }
+
+    // Set hardware parameters
+    snd_pcm_hw_params_t* hw_params;
+    snd_pcm_hw_params_alloca(&hw_params);
+
+    err = snd_pcm_hw_params_any(pcm_handle, hw_params);
+    if (err < 0) {
+        LOG_ERROR("Failed to initialize hw_params: %s", snd_strerror(err));
+        return false;
+    }
+
+    // Set access type
+    err = snd_pcm_hw_params_set_access(pcm_handle, hw_params, SND_PCM_ACCESS_RW_INTERLEAVED);
+    if (err < 0) {
+        LOG_ERROR("Failed to set access type: %s", snd_strerror(err));
+        return false;
+    }
+
+    // Set sample format (16-bit signed)
+    err = snd_pcm_hw_params_set_format(pcm_handle, hw_params, SND_PCM_FORMAT_S16_LE);
+    if (err < 0) {
+        LOG_ERROR("Failed to set sample format: %s", snd_strerror(err));
+        return false;
+    }
+
+    // Set sample rate (44.1kHz)
+    unsigned int rate = 44100;
+    err = snd_pcm_hw_params_set_rate_near(pcm_handle, hw_params, &rate, 0);
+    if (err < 0) {
+        LOG_ERROR("Failed to set sample rate: %s", snd_strerror(err));
+        return false;
+    }
+
+    // Set number of channels (stereo)
+    err = snd_pcm_hw_params_set_channels(pcm_handle, hw_params, 2);
+    if (err < 0) {
+        LOG_ERROR("Failed to set channel count: %s", snd_strerror(err));
+        return false;
+    }
+
+    // Apply hardware parameters
+    err = snd_pcm_hw_params(pcm_handle, hw_params);
+    if (err < 0) {
+        LOG_ERROR("Failed to set hw params: %s", snd_strerror(err));
+        return false;
+    }
+
+    // Prepare the PCM device
+    err = snd_pcm_prepare(pcm_handle);
+    if (err < 0) {
+        LOG_ERROR("Failed to prepare PCM device: %s", snd_strerror(err));
+        return false;
+    }
+
+    initialized = true;
+    LOG_INFO("Audio playback initialized successfully");
+    return true;
+}
+
+void AudioPlayback::playAudio(const char* buffer, int buffer_len) {
+    if (!initialized || !pcm_handle || !buffer) return;
+
+    // Convert buffer length to frames (assuming 16-bit stereo)
+    int frames = buffer_len / 4; // 2 bytes per sample * 2 channels
+
+    snd_pcm_sframes_t written = snd_pcm_writei(pcm_handle, buffer, frames);
+    if (written < 0) {
+        // Handle underrun
+        if (written == -EPIPE) {
+            LOG_RATE_LIMITED(LOG_LEVEL_WARN, 1000, "Audio underrun occurred, recovering...");
+            snd_pcm_prepare(pcm_handle);
+        } else {
+            LOG_ERROR("Audio write error: %s", snd_strerror((int)written));
+        }
+    }
+}
+
+void AudioPlayback::cleanup() {
+    if (pcm_handle) {
+        snd_pcm_close(pcm_handle);
+        pcm_handle = nullptr;
+    }
+    initialized = false;
+}
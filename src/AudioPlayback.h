@@ -0,0 +1,18 @@
+#pragma once
+
+#include <alsa/asoundlib.h>
+
+// Simple audio playback class using ALSA
+class AudioPlayback {
+private:
+    snd_pcm_t* pcm_handle;
+    bool initialized;
+
+public:
+    AudioPlayback();
+    ~AudioPlayback();
+
+    bool init();
+    void playAudio(const char* buffer, int buffer_len);
+    void cleanup();
+};
@@ -0,0 +1,1505 @@
+#include "BotSession.h"
+#include "AudioPlayback.h"
+#include "CommandChannel.h"
+#include "QtRemoteVideoHandler.h"
+#include "QtPreviewVideoHandler.h"
+#include "QtShareVideoHandler.h"
+#include "FrameHub.h"
+#include "SdkVideoFrame.h"
+#include "Logger.h"
+#include "AllocationTracker.h"
+#include "MemoryBudget.h"
+#include "EventBus.h"
+#include "StartupProfiler.h"
+#include "DeviceCache.h"
+#include "SubscriptionPolicy.h"
+#include "StrandedFrameSink.h"
+#include "StreamWatchdog.h"
+#include "FrameExporter.h"
+#include "Y4MRecorder.h"
+#include "LumaAnalyzers.h"
+#include "SnapshotService.h"
+#include "TranscriptLog.h"
+#include "VirtualShareSource.h"
+#include "WorkStealingExecutor.h"
+
+#include <QFile>
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "json.hpp"
+
+// Include Zoom SDK headers
+#include "helpers/zoom_video_sdk_user_helper_interface.h"
+#include "zoom_video_sdk_api.h"
+#include "zoom_video_sdk_def.h"
+#include "zoom_video_sdk_delegate_interface.h"
+#include "zoom_video_sdk_interface.h"
+#include "zoom_video_sdk_session_info_interface.h"
+#include "zoom_video_sdk_platform.h"
+#include "helpers/zoom_video_sdk_audio_helper_interface.h"
+#include "helpers/zoom_video_sdk_video_helper_interface.h"
+#include "helpers/zoom_video_sdk_share_helper_interface.h"
+
+//needed for chat
+#include "helpers/zoom_video_sdk_chat_helper_interface.h"
+#include "zoom_video_sdk_chat_message_interface.h"
+
+using Json = nlohmann::json;
+USING_ZOOM_VIDEO_SDK_NAMESPACE
+IZoomVideoSDK* video_sdk_obj = nullptr;
+
+// Global audio playback instance
+AudioPlayback* g_audio_playback = nullptr;
+
+// Delegate callbacks post here; front ends drain it on their own thread
+static EventBus g_eventBus;
+
+// Self (camera) and mixed video fan out from here to every subscribed sink
+static FrameHub g_selfHub("self");
+static FrameHub g_mixedHub("mixed");
+
+// Remote subscription resolutions; fed by the delegate and the front ends
+static SubscriptionPolicy g_subscriptionPolicy;
+
+// Worker count for the frame executor (config frame_worker_threads; 0 = one
+// per core). The executor starts with the first remote stream.
+static int g_frameWorkerThreads = 0;
+static std::once_flag g_frameExecutorOnce;
+static std::unique_ptr<WorkStealingExecutor> g_frameExecutor;
+static std::atomic<WorkStealingExecutor*> g_frameExecutorStarted{nullptr};
+
+// Shared-memory export of remote streams to other processes (config
+// frame_export, frame_export_slots, frame_export_max_lines)
+static bool g_frameExport = false;
+static uint32_t g_frameExportSlots = 4;
+static int g_frameExportMaxLines = 1080;
+
+// Per-user Y4M recording of remote streams (config record_dir, empty = off;
+// record_segment_seconds, record_segment_mb, record_queue_frames)
+static Y4MRecorder::Config g_recorderConfig;
+
+// Analyzers run on every remote stream's Y plane (config analysis_plugins,
+// analysis_fps, analysis_budget_us)
+static std::vector<std::string> g_analysisPlugins;
+static FrameAnalysisStage::Config g_analysisConfig;
+
+// Participant thumbnails for dashboards (config snapshot_dir, empty = off;
+// snapshot_interval_sec, snapshot_width, snapshot_quality)
+static SnapshotService::Config g_snapshotConfig;
+
+// Live transcription kept per session (config transcript_dir, empty = off;
+// transcript_flush_ms). Opened on join, closed on leave; the mutex only
+// guards swapping the pointer.
+static TranscriptLog::Config g_transcriptConfig;
+static std::mutex g_transcriptMutex;
+static std::shared_ptr<TranscriptLog> g_transcriptLog;
+
+// Resubscribes remote streams that stop delivering without the SDK saying
+// so (config watchdog_stall_ms, 0 = off; watchdog_max_backoff_ms)
+static StreamWatchdog::Config g_watchdogConfig;
+static std::once_flag g_watchdogOnce;
+static std::unique_ptr<StreamWatchdog> g_streamWatchdog;
+
+// Screen share of bot-rendered content (config share_file, share_fps,
+// share_keepalive_ms, share_color_space); started on join when a file is
+// configured, or through startVirtualShare()
+static VirtualShareSource::Config g_virtualShareConfig;
+static std::once_flag g_virtualShareOnce;
+static std::unique_ptr<VirtualShareSource> g_virtualShare;
+static std::atomic<VirtualShareSource*> g_virtualShareStarted{nullptr};
+
+// Bot control messages over the SDK command channel (config
+// command_channel_rate, command_channel_burst, command_channel_batch_ms)
+static CommandChannel::Config g_commandChannelConfig;
+static std::once_flag g_commandChannelOnce;
+static std::unique_ptr<CommandChannel> g_commandChannel;
+static std::atomic<CommandChannel*> g_commandChannelStarted{nullptr};
+
+static int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static ZoomVideoSDKResolution resolutionForLines(int lines)
+{
+    switch (lines) {
+    case 180:  return ZoomVideoSDKResolution_180P;
+    case 360:  return ZoomVideoSDKResolution_360P;
+    case 720:  return ZoomVideoSDKResolution_720P;
+    case 1080: return ZoomVideoSDKResolution_1080P;
+    default:   return ZoomVideoSDKResolution_90P;
+    }
+}
+
+// Front end the delegate reports to. Atomic because the SDK may be
+// initialized on a worker thread before the front end is attached.
+static std::atomic<IBotFrontend*> g_frontend{nullptr};
+
+// Background initialization (initializeVideoSDKAsync) and its outcome. The
+// thread is joined on exit too, so early returns from main() stay safe.
+struct InitThread
+{
+    std::thread thread;
+    ~InitThread() { if (thread.joinable()) thread.join(); }
+};
+static InitThread g_init;
+static std::atomic<bool> g_sdkReady{false};
+
+std::shared_ptr<TranscriptLog> currentTranscriptLog()
+{
+    std::lock_guard<std::mutex> lock(g_transcriptMutex);
+    return g_transcriptLog;
+}
+
+static void openTranscriptLog()
+{
+    if (g_transcriptConfig.directory.empty()) return;
+    IZoomVideoSDKSession* session = video_sdk_obj ? video_sdk_obj->getSessionInfo() : nullptr;
+    const zchar_t* sessionName = session ? session->getSessionName() : nullptr;
+    std::shared_ptr<TranscriptLog> log = std::make_shared<TranscriptLog>(g_transcriptConfig);
+    if (!log->open(std::string(), sessionName ? sessionName : "session")) {
+        LOG_WARN("Transcript log disabled for this session");
+        return;
+    }
+    LOG_INFO("Writing live transcription to %s", log->path().c_str());
+    std::lock_guard<std::mutex> lock(g_transcriptMutex);
+    g_transcriptLog = std::move(log);
+}
+
+static void closeTranscriptLog()
+{
+    std::shared_ptr<TranscriptLog> log;
+    {
+        std::lock_guard<std::mutex> lock(g_transcriptMutex);
+        log.swap(g_transcriptLog);
+    }
+    if (!log) return;
+    TranscriptLog::Stats s = log->stats();
+    LOG_INFO("Transcript log %s: %llu records, %zu segments from %zu speakers, %llu flushes, %llu drops",
+             log->path().c_str(), (unsigned long long)s.records, s.segments, s.speakers,
+             (unsigned long long)s.flushes, (unsigned long long)s.drops);
+    // Final commit; a callback racing with this finds it closed and drops its message
+    log->close();
+}
+
+static TranscriptOperation transcriptOperation(ZoomVideoSDKLiveTranscriptionOperationType type)
+{
+    switch (type) {
+    case ZoomVideoSDKLiveTranscription_OperationType_Add:      return TRANSCRIPT_OP_ADD;
+    case ZoomVideoSDKLiveTranscription_OperationType_Update:   return TRANSCRIPT_OP_UPDATE;
+    case ZoomVideoSDKLiveTranscription_OperationType_Delete:   return TRANSCRIPT_OP_DELETE;
+    case ZoomVideoSDKLiveTranscription_OperationType_Complete: return TRANSCRIPT_OP_COMPLETE;
+    default:                                                   return TRANSCRIPT_OP_NONE;
+    }
+}
+
+// Global variables
+std::atomic<bool> g_in_session(false);
+std::atomic<bool> g_audio_muted(false);
+std::atomic<bool> g_video_muted(false);
+
+//controls to demonstrate the flow
+bool enableChat = true;
+
+// Zoom Video SDK Delegate
+class ZoomVideoSDKDelegate : public IZoomVideoSDKDelegate
+{
+public:
+    ZoomVideoSDKDelegate() {}
+
+    ~ZoomVideoSDKDelegate()
+    {
+        releaseAllRemoteHandlers();
+        releaseAllShares();
+    }
+
+    /// \brief Triggered when user enter the session.
+    virtual void onSessionJoin()
+    {
+        AllocStageScope stage(ALLOC_STAGE_SESSION);
+        LOG_INFO("=== DELEGATE: Session joined successfully ===");
+
+        // CRITICAL FIX: Set session state BEFORE updating UI
+        g_in_session = true;
+        LOG_DEBUG("Setting g_in_session = true (BEFORE UI update)");
+        openTranscriptLog();
+
+        // Initialize audio playback system
+        if (!g_audio_playback) {
+            LOG_INFO("Initializing audio playback system...");
+            g_audio_playback = new AudioPlayback();
+            if (!g_audio_playback->init()) {
+                LOG_ERROR("Failed to initialize audio playback");
+                delete g_audio_playback;
+                g_audio_playback = nullptr;
+            } else {
+                LOG_INFO("Audio playback system initialized successfully");
+            }
+        }
+
+        // Tell the front end without waiting for it
+        LOG_INFO("Posting session joined event...");
+        postSessionEvent(BOT_EVENT_SESSION_JOINED);
+
+        if (!g_virtualShareConfig.file.empty()) startVirtualShare();
+
+        LOG_INFO("Session state set to IN_SESSION");
+
+        if (enableChat) {
+            LOG_INFO("Attempting to send chat message...");
+            try {
+                IZoomVideoSDKChatHelper* pChatHelper = video_sdk_obj->getChatHelper();
+                if (pChatHelper) {
+                    LOG_INFO("Chat helper obtained");
+                    if (pChatHelper->isChatDisabled() == false && pChatHelper->isPrivateChatDisabled() == false) {
+                        ZoomVideoSDKErrors err = pChatHelper->sendChatToAll("hello world from Qt client");
+                        LOG_INFO("Chat message sent, status: %d", (int)err);
+                    } else {
+                        LOG_WARN("Chat is disabled");
+                    }
+                } else {
+                    LOG_ERROR("Could not get chat helper");
+                }
+            } catch (const std::exception& e) {
+                LOG_ERROR("EXCEPTION in chat: %s", e.what());
+            } catch (...) {
+                LOG_ERROR("UNKNOWN EXCEPTION in chat");
+            }
+        } else {
+            LOG_INFO("Chat disabled by configuration");
+        }
+
+        LOG_INFO("=== Session join callback complete ===");
+    }
+
+    /// \brief Triggered when session leaveSession
+    virtual void onSessionLeave()
+    {
+        AllocStageScope stage(ALLOC_STAGE_SESSION);
+        LOG_INFO("Left session.");
+        releaseAllRemoteHandlers();
+        releaseAllShares();
+        closeTranscriptLog();
+        if (CommandChannel* channel = botCommandChannelIfStarted()) {
+            channel->setConnected(false);
+            channel->clear();
+        }
+
+        // Clean up audio playback system
+        if (g_audio_playback) {
+            LOG_INFO("Cleaning up audio playback system");
+            delete g_audio_playback;
+            g_audio_playback = nullptr;
+        }
+
+        g_in_session = false;
+
+        // Tell the front end without waiting for it
+        postSessionEvent(BOT_EVENT_SESSION_LEFT, -1);
+    };
+
+    virtual void onSessionLeave(ZoomVideoSDKSessionLeaveReason eReason)
+    {
+        AllocStageScope stage(ALLOC_STAGE_SESSION);
+        LOG_INFO("Left session with reason: %d", (int)eReason);
+        releaseAllRemoteHandlers();
+        releaseAllShares();
+        closeTranscriptLog();
+        if (CommandChannel* channel = botCommandChannelIfStarted()) {
+            channel->setConnected(false);
+            channel->clear();
+        }
+
+        // Clean up audio playback system
+        if (g_audio_playback) {
+            LOG_INFO("Cleaning up audio playback system");
+            delete g_audio_playback;
+            g_audio_playback = nullptr;
+        }
+
+        g_in_session = false;
+
+        // Tell the front end without waiting for it
+        postSessionEvent(BOT_EVENT_SESSION_LEFT, (int)eReason);
+    };
+
+    virtual void onError(ZoomVideoSDKErrors errorCode, int detailErrorCode)
+    {
+        LOG_INFO("join session errorCode : %d  detailErrorCode: %d", (int)errorCode, detailErrorCode);
+
+        postSessionEvent(BOT_EVENT_SESSION_ERROR, (int)errorCode, detailErrorCode);
+    };
+
+    // Other delegate methods...
+    virtual void onUserJoin(IZoomVideoSDKUserHelper* pUserHelper, IVideoSDKVector<IZoomVideoSDKUser*>* userList) {}
+    virtual void onUserLeave(IZoomVideoSDKUserHelper* pUserHelper, IVideoSDKVector<IZoomVideoSDKUser*>* userList) {
+		AllocStageScope stage(ALLOC_STAGE_SESSION);
+		if (userList) {
+			std::lock_guard<std::mutex> lock(m_remoteMutex);
+			int count = userList->GetCount();
+			for (int index = 0; index < count; index++) {
+				IZoomVideoSDKUser* user = userList->GetItem(index);
+				releaseRemoteHandler(user);
+				if (user && user->getUserName()) g_subscriptionPolicy.removeUser(user->getUserName());
+			}
+		}
+		if (userList) {
+			std::lock_guard<std::mutex> lock(m_shareMutex);
+			int count = userList->GetCount();
+			for (int index = 0; index < count; index++) {
+				releaseSharesOf(userList->GetItem(index));
+			}
+		}
+	}
+	virtual void onUserVideoStatusChanged(IZoomVideoSDKVideoHelper* pVideoHelper, IVideoSDKVector<IZoomVideoSDKUser*>* userList) {
+		AllocStageScope stage(ALLOC_STAGE_SESSION);
+		if (userList && video_sdk_obj) {
+			// Get current user to exclude from remote video display
+			IZoomVideoSDKSession* session = video_sdk_obj->getSessionInfo();
+			IZoomVideoSDKUser* myself = session ? session->getMyself() : nullptr;
+
+			int count = userList->GetCount();
+			for (int index = 0; index < count; index++) {
+				IZoomVideoSDKUser* user = userList->GetItem(index);
+				if (user && user != myself) { // Only handle remote users, not myself
+					LOG_INFO("Video status changed for remote user: %s", user->getUserName());
+
+					std::lock_guard<std::mutex> lock(m_remoteMutex);
+					// The policy decides the resolution; applied below
+					bool hasVideo = user->GetVideoPipe() != nullptr;
+					g_subscriptionPolicy.setUserVideo(user->getUserName(), hasVideo);
+					if (hasVideo) {
+						// A stream the SDK turned off is subscribed again at once
+						auto existing = m_remoteHandlers.find(user);
+						if (existing == m_remoteHandlers.end() || !existing->second.handler->IsSubscribed()) {
+							g_subscriptionPolicy.markUnsubscribed(user->getUserName());
+						}
+					} else {
+						LOG_INFO("User %s has no video pipe - remote video disabled", user->getUserName());
+						releaseRemoteHandler(user);
+					}
+				}
+				else if (user == myself)
+				{
+					LOG_INFO("Self user detected in onUserVideoStatusChanged: %s - using preview handler", user->getUserName());
+				}
+			}
+			applySubscriptionPolicy();
+		}
+	}
+    virtual void onUserAudioStatusChanged(IZoomVideoSDKAudioHelper* pAudioHelper, IVideoSDKVector<IZoomVideoSDKUser*>* userList) {}
+    virtual void onUserShareStatusChanged(IZoomVideoSDKShareHelper* pShareHelper, IZoomVideoSDKUser* pUser, IZoomVideoSDKShareAction* pShareAction)
+    {
+        AllocStageScope stage(ALLOC_STAGE_SESSION);
+        if (!pUser || !pShareAction || !video_sdk_obj) return;
+
+        // Our own share is not received back
+        IZoomVideoSDKSession* session = video_sdk_obj->getSessionInfo();
+        if (session && pUser == session->getMyself()) return;
+
+        ZoomVideoSDKShareStatus status = pShareAction->getShareStatus();
+        LOG_INFO("Share %u from user %s changed status to %d", pShareAction->getShareSourceId(),
+                 pUser->getUserName(), (int)status);
+
+        std::lock_guard<std::mutex> lock(m_shareMutex);
+        if (status == ZoomVideoSDKShareStatus_Start || status == ZoomVideoSDKShareStatus_Resume) {
+            subscribeShare(pUser, pShareAction);
+        } else if (status == ZoomVideoSDKShareStatus_Stop) {
+            releaseShare(pShareAction->getShareSourceId());
+        }
+    }
+    virtual void onShareContentChanged(IZoomVideoSDKShareHelper* pShareHelper, IZoomVideoSDKUser* pUser, IZoomVideoSDKShareAction* pShareAction)
+    {
+        // The subscription carries on; sinks see the new content as changed tiles
+        if (pUser && pShareAction) {
+            LOG_INFO("Share %u from user %s switched content", pShareAction->getShareSourceId(), pUser->getUserName());
+        }
+    }
+    virtual void onFailedToStartShare(IZoomVideoSDKShareHelper* pShareHelper, IZoomVideoSDKUser* pUser) {}
+    virtual void onShareSettingChanged(ZoomVideoSDKShareSetting setting) {}
+    virtual void onUserRecordingConsent(IZoomVideoSDKUser* pUser) {}
+    virtual void onLiveStreamStatusChanged(IZoomVideoSDKLiveStreamHelper* pLiveStreamHelper, ZoomVideoSDKLiveStreamStatus status) {}
+    virtual void onChatNewMessageNotify(IZoomVideoSDKChatHelper* pChatHelper, IZoomVideoSDKChatMessage* messageItem) {}
+    virtual void onUserHostChanged(IZoomVideoSDKUserHelper* pUserHelper, IZoomVideoSDKUser* pUser) {}
+    virtual void onUserActiveAudioChanged(IZoomVideoSDKAudioHelper* pAudioHelper, IVideoSDKVector<IZoomVideoSDKUser*>* list)
+    {
+        std::vector<std::string> speakers;
+        int count = list ? list->GetCount() : 0;
+        for (int index = 0; index < count; index++) {
+            IZoomVideoSDKUser* user = list->GetItem(index);
+            if (user && user->getUserName()) speakers.push_back(user->getUserName());
+        }
+        // Speaker upgrades are debounced by the policy; the front end's
+        // timer applies them once they have held
+        g_subscriptionPolicy.setActiveSpeakers(speakers);
+        applySubscriptionPolicy();
+    }
+    virtual void onSessionNeedPassword(IZoomVideoSDKPasswordHandler* handler) {}
+    virtual void onSessionPasswordWrong(IZoomVideoSDKPasswordHandler* handler) {}
+    // SDK thread; parsing and handlers run on the channel's thread
+    virtual void onCommandReceived(IZoomVideoSDKUser* sender, const zchar_t* strCmd)
+    {
+        if (!strCmd) return;
+        botCommandChannel().receive(sender && sender->getUserName() ? sender->getUserName() : "", strCmd);
+    }
+    virtual void onCommandChannelConnectResult(bool isSuccess)
+    {
+        LOG_INFO("Command channel %s", isSuccess ? "connected" : "failed to connect");
+        botCommandChannel().setConnected(isSuccess);
+    }
+    virtual void onInviteByPhoneStatus(PhoneStatus status, PhoneFailedReason reason) {};
+    virtual void onCalloutJoinSuccess(IZoomVideoSDKUser* pUser, const zchar_t* phoneNumber) {};
+    virtual void onCloudRecordingStatus(RecordingStatus status, IZoomVideoSDKRecordingConsentHandler* pHandler) {};
+    virtual void onHostAskUnmute() {};
+    virtual void onMultiCameraStreamStatusChanged(ZoomVideoSDKMultiCameraStreamStatus status, IZoomVideoSDKUser* pUser, IZoomVideoSDKRawDataPipe* pVideoPipe) {}
+    virtual void onMicSpeakerVolumeChanged(unsigned int micVolume, unsigned int speakerVolume) {}
+    virtual void onAudioDeviceStatusChanged(ZoomVideoSDKAudioDeviceType type, ZoomVideoSDKAudioDeviceStatus status)
+    {
+        devicesChanged(type == ZoomVideoSDKAudioDeviceType_Speaker ? DEVICE_SPEAKER : DEVICE_MICROPHONE);
+    }
+    virtual void onTestMicStatusChanged(ZoomVideoSDK_TESTMIC_STATUS status) {}
+    virtual void onSelectedAudioDeviceChanged() { devicesChanged(DEVICE_MICROPHONE | DEVICE_SPEAKER); }
+    virtual void onCameraListChanged() { devicesChanged(DEVICE_CAMERA); }
+    virtual void onLiveTranscriptionStatus(ZoomVideoSDKLiveTranscriptionStatus status) {};
+    // The info callback below carries the same message plus its id, so only it is kept
+    virtual void onLiveTranscriptionMsgReceived(const zchar_t* ltMsg, IZoomVideoSDKUser* pUser, ZoomVideoSDKLiveTranscriptionOperationType type)
+    {
+        LOG_DEBUG("Transcription (%d) from %s: %s", (int)type, pUser && pUser->getUserName() ? pUser->getUserName() : "?",
+                  ltMsg ? ltMsg : "");
+    }
+
+    // SDK thread; appending is a copy into the mapped log, syncing happens on its own thread
+    virtual void onLiveTranscriptionMsgInfoReceived(ILiveTranscriptionMessageInfo* messageInfo)
+    {
+        std::shared_ptr<TranscriptLog> log = currentTranscriptLog();
+        if (!log || !messageInfo) return;
+        TranscriptEntry entry;
+        time_t spokenAt = messageInfo->getTimeStamp();
+        entry.timestampMs = spokenAt > 0 ? int64_t(spokenAt) * 1000 : int64_t(time(nullptr)) * 1000;
+        entry.operation = transcriptOperation(messageInfo->getMessageType());
+        if (messageInfo->getMessageID()) entry.messageId = messageInfo->getMessageID();
+        if (messageInfo->getSpeakerName()) entry.speaker = messageInfo->getSpeakerName();
+        if (messageInfo->getMessageContent()) entry.text = messageInfo->getMessageContent();
+        if (!log->append(entry)) {
+            LOG_RATE_LIMITED(LOG_LEVEL_WARN, 5000, "Transcript log full or unwritable, dropping messages");
+        }
+    }
+    virtual void onLiveTranscriptionMsgError(ILiveTranscriptionLanguage* spokenLanguage, ILiveTranscriptionLanguage* transcriptLanguage) {};
+    virtual void onSpokenLanguageChanged(ILiveTranscriptionLanguage* spokenLanguage) {}
+    virtual void onShareNetworkStatusChanged(ZoomVideoSDKNetworkStatus shareNetworkStatus, bool isSendingShare) {}
+    virtual void onAnnotationPrivilegeChange(IZoomVideoSDKUser* pUser, IZoomVideoSDKShareAction* pShareAction) {}
+    virtual void onSpotlightVideoChanged(IZoomVideoSDKVideoHelper* pVideoHelper, IVideoSDKVector<IZoomVideoSDKUser*>* userList) {}
+    virtual void onBindIncomingLiveStreamResponse(bool bSuccess, const zchar_t* strStreamKeyID) {}
+    virtual void onUnbindIncomingLiveStreamResponse(bool bSuccess, const zchar_t* strStreamKeyID) {}
+    virtual void onIncomingLiveStreamStatusResponse(bool bSuccess, IVideoSDKVector<IncomingLiveStreamStatus>* pStreamsStatusList) {}
+    virtual void onStartIncomingLiveStreamResponse(bool bSuccess, const zchar_t* strStreamKeyID) {}
+    virtual void onStopIncomingLiveStreamResponse(bool bSuccess, const zchar_t* strStreamKeyID) {}
+    virtual void onShareContentSizeChanged(IZoomVideoSDKShareHelper* pShareHelper, IZoomVideoSDKUser* pUser, IZoomVideoSDKShareAction* pShareAction) {}
+    virtual void onSubSessionStatusChanged(ZoomVideoSDKSubSessionStatus status, IVideoSDKVector<ISubSessionKit*>* pSubSessionKitList) {}
+    virtual void onSubSessionManagerHandle(IZoomVideoSDKSubSessionManager* pManager) {}
+    virtual void onSubSessionParticipantHandle(IZoomVideoSDKSubSessionParticipant* pParticipant) {}
+    virtual void onSubSessionUsersUpdate(ISubSessionKit* pSubSessionKit) {}
+    virtual void onBroadcastMessageFromMainSession(const zchar_t* sMessage, const zchar_t* sUserName) {}
+    virtual void onSubSessionUserHelpRequest(ISubSessionUserHelpRequestHandler* pHandler) {}
+    virtual void onSubSessionUserHelpRequestResult(ZoomVideoSDKUserHelpRequestResult eResult) {}
+    virtual void onChatMsgDeleteNotification(IZoomVideoSDKChatHelper* pChatHelper, const zchar_t* msgID, ZoomVideoSDKChatMessageDeleteType deleteBy) {};
+    virtual void onVirtualSpeakerMixedAudioReceived(AudioRawData* data_) {}
+    virtual void onVirtualSpeakerOneWayAudioReceived(AudioRawData* data_, IZoomVideoSDKUser* pUser) {}
+    virtual void onVirtualSpeakerSharedAudioReceived(AudioRawData* data_) {}
+    virtual void onOriginalLanguageMsgReceived(ILiveTranscriptionMessageInfo* messageInfo) {};
+    virtual void onChatPrivilegeChanged(IZoomVideoSDKChatHelper* pChatHelper, ZoomVideoSDKChatPrivilegeType privilege) {};
+    virtual void onSendFileStatus(IZoomVideoSDKSendFile* file, const FileTransferStatus& status) {};
+    virtual void onReceiveFileStatus(IZoomVideoSDKReceiveFile* file, const FileTransferStatus& status) {};
+    virtual void onProxyDetectComplete() {};
+    virtual void onProxySettingNotification(IZoomVideoSDKProxySettingHandler* handler) {};
+    virtual void onSSLCertVerifiedFailNotification(IZoomVideoSDKSSLCertificateInfo* info) {};
+    virtual void onUserVideoNetworkStatusChanged(ZoomVideoSDKNetworkStatus status, IZoomVideoSDKUser* pUser)
+    {
+        if (!pUser || !pUser->getUserName()) return;
+        NetworkQuality quality = NETWORK_UNKNOWN;
+        switch (status) {
+        case ZoomVideoSDKNetwork_Good:   quality = NETWORK_GOOD; break;
+        case ZoomVideoSDKNetwork_Normal: quality = NETWORK_NORMAL; break;
+        case ZoomVideoSDKNetwork_Bad:    quality = NETWORK_BAD; break;
+        default:                         break;
+        }
+        LOG_INFO("Video network status for user %s: %d", pUser->getUserName(), (int)status);
+        g_subscriptionPolicy.setNetwork(pUser->getUserName(), quality);
+        applySubscriptionPolicy();
+    }
+    virtual void onCallCRCDeviceStatusChanged(ZoomVideoSDKCRCCallStatus status) {};
+    virtual void onVideoCanvasSubscribeFail(ZoomVideoSDKSubscribeFailReason fail_reason, IZoomVideoSDKUser* pUser, void* handle) {};
+    virtual void onShareCanvasSubscribeFail(ZoomVideoSDKSubscribeFailReason fail_reason, IZoomVideoSDKUser* pUser, void* handle) {};
+    virtual void onAnnotationHelperCleanUp(IZoomVideoSDKAnnotationHelper* helper) {};
+    virtual void onAnnotationPrivilegeChange(IZoomVideoSDKUser* pUser, bool enable) {};
+    virtual void onAnnotationHelperActived(void* handle) {};
+    virtual void onVideoAlphaChannelStatusChanged(bool isAlphaModeOn)
+    {
+        // Frame conversion picks up the alpha plane from the next frame on
+        sdkVideoAlphaMode().store(isAlphaModeOn, std::memory_order_relaxed);
+        LOG_INFO("Video alpha channel mode %s", isAlphaModeOn ? "on" : "off");
+
+        BotEvent event;
+        event.type = BOT_EVENT_STATUS_MESSAGE;
+        event.text = isAlphaModeOn ? "Alpha video mode on" : "Alpha video mode off";
+        g_eventBus.post(std::move(event));
+    }
+    virtual void onUserManagerChanged(IZoomVideoSDKUser* pUser) {};
+    virtual void onUserNameChanged(IZoomVideoSDKUser* pUser) {};
+    virtual void onCameraControlRequestResult(IZoomVideoSDKUser* pUser, bool isApproved) {};
+    virtual void onCameraControlRequestReceived(IZoomVideoSDKUser* pUser, ZoomVideoSDKCameraControlRequestType requestType, IZoomVideoSDKCameraControlRequestHandler* pCameraControlRequestHandler) {};
+
+    // Video callbacks - self frames only when no preview pipe delivers them,
+    // so the camera is never converted twice
+    virtual void onOneWayVideoRawDataReceived(YUVRawDataI420* data_, IZoomVideoSDKUser* pUser) {
+        AllocStageScope stage(ALLOC_STAGE_VIDEO_RECEIVE);
+        if (data_ && pUser && g_selfHub.hasSinks() && !QtPreviewVideoHandler::isAnyPreviewActive()) {
+            // Check if this is our own video (for preview)
+            IZoomVideoSDKSession* session = video_sdk_obj ? video_sdk_obj->getSessionInfo() : nullptr;
+            IZoomVideoSDKUser* myself = session ? session->getMyself() : nullptr;
+
+            if (pUser == myself) {
+                LOG_RATE_LIMITED(LOG_LEVEL_DEBUG, 1000, "Received self video frame via callback: %dx%d",
+                                 data_->GetStreamWidth(), data_->GetStreamHeight());
+
+                I420Frame frame;
+                if (toI420Frame(data_, frame)) {
+                    g_selfHub.onVideoFrame(frame);
+
+                    static int self_frame_count = 0;
+                    if (++self_frame_count % 30 == 0) {
+                        LOG_DEBUG("Processed %d self video frames via callback", self_frame_count);
+                    }
+                }
+            }
+        }
+    };
+
+    virtual void onMixedVideoRawDataReceived(YUVRawDataI420* data_) {
+        AllocStageScope stage(ALLOC_STAGE_VIDEO_RECEIVE);
+        if (data_ && g_mixedHub.hasSinks()) {
+            LOG_RATE_LIMITED(LOG_LEVEL_DEBUG, 1000, "Received mixed video frame: %dx%d", data_->GetStreamWidth(), data_->GetStreamHeight());
+
+            I420Frame frame;
+            if (toI420Frame(data_, frame)) {
+                g_mixedHub.onVideoFrame(frame);
+
+                static int mixed_frame_count = 0;
+                if (++mixed_frame_count % 30 == 0) {
+                    LOG_DEBUG("Processed %d mixed video frames", mixed_frame_count);
+                }
+            }
+        }
+    };
+
+    // Audio raw data methods
+    virtual void onMixedAudioRawDataReceived(AudioRawData* data_) {
+        AllocStageScope stage(ALLOC_STAGE_AUDIO);
+        if (data_ && g_audio_playback) {
+            LOG_RATE_LIMITED(LOG_LEVEL_DEBUG, 1000, "Mixed audio received: buffer size %u bytes", data_->GetBufferLen());
+
+            // Process mixed audio data here
+            char* buffer = data_->GetBuffer();
+            if (buffer) {
+                // Route received audio to ALSA playback system
+                g_audio_playback->playAudio(buffer, data_->GetBufferLen());
+
+                static int audio_frame_count = 0;
+                if (++audio_frame_count % 100 == 0) { // Log every 100 frames
+                    LOG_DEBUG("Processed %d mixed audio frames", audio_frame_count);
+                }
+            }
+        }
+    };
+
+    virtual void onOneWayAudioRawDataReceived(AudioRawData* data_, IZoomVideoSDKUser* pUser) {
+        AllocStageScope stage(ALLOC_STAGE_AUDIO);
+        if (data_ && pUser && g_audio_playback) {
+            LOG_RATE_LIMITED(LOG_LEVEL_DEBUG, 1000, "One-way audio received from %s: buffer size %u bytes",
+                             pUser->getUserName(), data_->GetBufferLen());
+
+            // Process individual user audio data here
+            char* buffer = data_->GetBuffer();
+            if (buffer) {
+                // Route received audio to ALSA playback system
+                g_audio_playback->playAudio(buffer, data_->GetBufferLen());
+
+                static int user_audio_frame_count = 0;
+                if (++user_audio_frame_count % 100 == 0) { // Log every 100 frames
+                    LOG_DEBUG("Processed %d user audio frames from %s", user_audio_frame_count, pUser->getUserName());
+                }
+            }
+        }
+    };
+
+    virtual void onSharedAudioRawDataReceived(AudioRawData* data_) {
+        AllocStageScope stage(ALLOC_STAGE_AUDIO);
+        if (data_ && g_audio_playback) {
+            LOG_RATE_LIMITED(LOG_LEVEL_DEBUG, 1000, "Shared audio received: buffer size %u bytes", data_->GetBufferLen());
+
+            // Process shared audio data here (screen sharing audio)
+            char* buffer = data_->GetBuffer();
+            if (buffer) {
+                // Route received audio to ALSA playback system
+                g_audio_playback->playAudio(buffer, data_->GetBufferLen());
+
+                static int shared_audio_frame_count = 0;
+                if (++shared_audio_frame_count % 100 == 0) { // Log every 100 frames
+                    LOG_DEBUG("Processed %d shared audio frames", shared_audio_frame_count);
+                }
+            }
+        }
+    };
+
+public:
+    // Command channel transport; called on the channel's thread. An empty
+    // receiver sends to everyone in the session.
+    bool sendCommand(const std::string& receiver, const std::string& command)
+    {
+        IZoomVideoSDKCmdChannel* channel = video_sdk_obj && g_in_session ? video_sdk_obj->getCmdChannel() : nullptr;
+        if (!channel) return false;
+        IZoomVideoSDKUser* user = nullptr;
+        if (!receiver.empty() && !(user = findRemoteUser(receiver))) return false;
+        ZoomVideoSDKErrors err = channel->sendCommand(user, command.c_str());
+        if (err != ZoomVideoSDKErrors_Success) {
+            LOG_RATE_LIMITED(LOG_LEVEL_WARN, 1000, "Command channel send to %s failed: %d",
+                             receiver.empty() ? "everyone" : receiver.c_str(), (int)err);
+            return false;
+        }
+        return true;
+    }
+
+    // Stream watchdog thread: the user's stream went silent, so subscribe
+    // again at the same resolution
+    void resubscribeStalled(const std::string& userName)
+    {
+        std::lock_guard<std::mutex> lock(m_remoteMutex);
+        IZoomVideoSDKUser* user = findRemoteUser(userName);
+        auto it = user ? m_remoteHandlers.find(user) : m_remoteHandlers.end();
+        if (it == m_remoteHandlers.end()) return;
+        if (!it->second.handler->SubscribeToUser(user, it->second.resolution)) {
+            LOG_WARN("Stream watchdog: resubscribing %s failed", userName.c_str());
+        }
+    }
+
+    // Pin a remote user's video to a resolution in lines, or drop it (lines < 0).
+    // The choice overrides the policy inputs for the rest of the session.
+    // Returns false if the user is not in the session.
+    bool setRemoteVideo(const std::string& userName, int lines)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_remoteMutex);
+            if (!findRemoteUser(userName)) return false;
+            g_subscriptionPolicy.setOverride(userName, lines);
+        }
+        applySubscriptionPolicy();
+        return true;
+    }
+
+    // Subscribes, resubscribes or drops remote streams the policy changed
+    void applySubscriptionPolicy()
+    {
+        std::lock_guard<std::mutex> lock(m_remoteMutex);
+        for (const SubscriptionDecision& decision : g_subscriptionPolicy.evaluate(monotonicNs())) {
+            LOG_INFO("Subscription for %s: %dp (%s)", decision.user.c_str(), decision.lines, decision.reason.c_str());
+            IZoomVideoSDKUser* user = findRemoteUser(decision.user);
+            if (!user) continue;
+            if (decision.lines == 0 || !user->GetVideoPipe()) {
+                releaseRemoteHandler(user);
+            } else {
+                subscribeRemoteUser(user, resolutionForLines(decision.lines));
+            }
+        }
+    }
+
+private:
+    static void postSessionEvent(BotEventType type, int code = 0, int detail = 0)
+    {
+        BotEvent event;
+        event.type = type;
+        event.code = code;
+        event.detail = detail;
+        g_eventBus.post(std::move(event));
+    }
+
+    // Hot-plug: the cached lists are re-read for these kinds on the front end
+    // thread, which applies only the differences
+    static void devicesChanged(int kinds)
+    {
+        DeviceCache::instance().markDirty(kinds);
+        postSessionEvent(BOT_EVENT_DEVICES_CHANGED, kinds);
+    }
+
+    // A remote subscription and the hub its frames fan out from. Frames reach
+    // the hub through a strand on the frame executor, off the SDK thread.
+    struct RemoteStream
+    {
+        QtRemoteVideoHandler* handler = nullptr;
+        StrandedFrameSink* strand = nullptr;
+        FrameHub* hub = nullptr;
+        ZoomVideoSDKResolution resolution = ZoomVideoSDKResolution_90P;
+        std::shared_ptr<StreamWatch> watch;  // null with the watchdog off
+    };
+
+    // Upstream first: no frame can be in flight when the hub goes
+    static void destroyRemoteStream(RemoteStream& stream)
+    {
+        if (stream.watch) streamWatchdog().remove(stream.watch);
+        delete stream.handler;
+        delete stream.strand;
+        delete stream.hub;
+    }
+
+    static IZoomVideoSDKUser* findRemoteUser(const std::string& userName)
+    {
+        IZoomVideoSDKSession* session = video_sdk_obj ? video_sdk_obj->getSessionInfo() : nullptr;
+        IVideoSDKVector<IZoomVideoSDKUser*>* users = session ? session->getRemoteUsers() : nullptr;
+        int count = users ? users->GetCount() : 0;
+        for (int i = 0; i < count; i++) {
+            IZoomVideoSDKUser* user = users->GetItem(i);
+            if (user && user->getUserName() && userName == user->getUserName()) return user;
+        }
+        return nullptr;
+    }
+
+    // Caller holds m_remoteMutex
+    void subscribeRemoteUser(IZoomVideoSDKUser* user, ZoomVideoSDKResolution resolution)
+    {
+        LOG_INFO("User %s has video pipe available - checking for existing handler", user->getUserName());
+
+        // One handler per user; repeated status changes reuse it
+        auto existing = m_remoteHandlers.find(user);
+        if (existing != m_remoteHandlers.end() && existing->second.handler->IsSubscribed()
+            && existing->second.resolution == resolution) {
+            LOG_DEBUG("User %s already has a remote video handler", user->getUserName());
+            return;
+        }
+
+        // Reuse a handler whose stream was turned off earlier or changes resolution
+        bool isNew = (existing == m_remoteHandlers.end());
+        RemoteStream stream;
+        if (isNew) {
+            std::string streamName = std::string("remote:") + user->getUserName();
+            stream.hub = new FrameHub(streamName);
+            IBotFrontend* frontend = g_frontend.load(std::memory_order_acquire);
+            if (frontend) frontend->onRemoteVideoStarted(streamName, *stream.hub);
+            if (g_frameExport) {
+                std::shared_ptr<FrameExporter> exporter = std::make_shared<FrameExporter>(streamName);
+                if (exporter->open(g_frameExportSlots, (g_frameExportMaxLines * 16 / 9 + 1) & ~1, g_frameExportMaxLines)) {
+                    stream.hub->subscribe(exporter, FrameExporter::variant());
+                }
+            }
+            if (!g_recorderConfig.directory.empty()) {
+                std::shared_ptr<Y4MRecorder> recorder = std::make_shared<Y4MRecorder>(streamName, g_recorderConfig);
+                if (recorder->start()) stream.hub->subscribe(recorder, Y4MRecorder::variant());
+            }
+            std::vector<std::unique_ptr<IFrameAnalyzer>> analyzers;
+            for (const std::string& name : g_analysisPlugins) {
+                if (std::unique_ptr<IFrameAnalyzer> analyzer = createFrameAnalyzer(name, streamName)) {
+                    analyzers.push_back(std::move(analyzer));
+                }
+            }
+            if (!analyzers.empty()) {
+                stream.hub->subscribe(std::make_shared<FrameAnalysisStage>(streamName, std::move(analyzers), g_analysisConfig),
+                                      FrameAnalysisStage::variant());
+            }
+            if (!g_snapshotConfig.directory.empty()) {
+                SnapshotService& snapshots = SnapshotService::instance();
+                if (snapshots.running() || snapshots.start(g_snapshotConfig)) {
+                    std::shared_ptr<SnapshotSink> sink = std::make_shared<SnapshotSink>(streamName, g_snapshotConfig.width);
+                    stream.hub->subscribe(sink, SnapshotSink::variant());
+                    snapshots.add(sink);
+                }
+            }
+            stream.strand = new StrandedFrameSink(streamName, stream.hub, frameExecutor());
+            stream.handler = new QtRemoteVideoHandler(stream.strand);
+            if (g_watchdogConfig.minStallMs > 0) {
+                stream.watch = streamWatchdog().add(user->getUserName());
+                stream.handler->setWatch(stream.watch);
+            }
+        } else {
+            stream = existing->second;
+        }
+        stream.resolution = resolution;
+        if (stream.handler->SubscribeToUser(user, resolution)) {
+            LOG_INFO("Successfully subscribed to remote video for user: %s", user->getUserName());
+            m_remoteHandlers[user] = stream;
+        } else {
+            LOG_ERROR("Failed to subscribe to remote video for user: %s", user->getUserName());
+            if (isNew) {
+                destroyRemoteStream(stream);
+            } else {
+                releaseRemoteHandler(user);
+            }
+        }
+    }
+
+    // Caller holds m_remoteMutex
+    void releaseRemoteHandler(IZoomVideoSDKUser* user)
+    {
+        auto it = m_remoteHandlers.find(user);
+        if (it != m_remoteHandlers.end()) {
+            LOG_INFO("Releasing remote video handler for user: %s", user->getUserName());
+            destroyRemoteStream(it->second);
+            m_remoteHandlers.erase(it);
+        }
+    }
+
+    void releaseAllRemoteHandlers()
+    {
+        std::lock_guard<std::mutex> lock(m_remoteMutex);
+        for (auto& entry : m_remoteHandlers) {
+            destroyRemoteStream(entry.second);
+        }
+        m_remoteHandlers.clear();
+        // Policy inputs and overrides apply to one session only
+        g_subscriptionPolicy.clear();
+    }
+
+    // A received screen share and the hub its frames and cursor fan out from
+    struct ShareStream
+    {
+        QtShareVideoHandler* handler = nullptr;
+        FrameHub* hub = nullptr;
+        IZoomVideoSDKUser* user = nullptr;
+    };
+
+    // Caller holds m_shareMutex
+    void subscribeShare(IZoomVideoSDKUser* user, IZoomVideoSDKShareAction* action)
+    {
+        unsigned int sourceId = action->getShareSourceId();
+        auto existing = m_shares.find(sourceId);
+        if (existing != m_shares.end() && existing->second.handler->IsSubscribed()) {
+            return;  // resumed after a pause; the subscription survived it
+        }
+
+        bool isNew = (existing == m_shares.end());
+        ShareStream stream;
+        if (isNew) {
+            std::string streamName = std::string("share:") + user->getUserName();
+            stream.hub = new FrameHub(streamName);
+            stream.handler = new QtShareVideoHandler(stream.hub);
+            stream.user = user;
+            IBotFrontend* frontend = g_frontend.load(std::memory_order_acquire);
+            if (frontend) frontend->onShareStarted(streamName, *stream.hub);
+        } else {
+            stream = existing->second;
+        }
+
+        if (stream.handler->SubscribeToShare(user, action)) {
+            m_shares[sourceId] = stream;
+        } else if (isNew) {
+            delete stream.handler;
+            delete stream.hub;
+        } else {
+            releaseShare(sourceId);
+        }
+    }
+
+    // Caller holds m_shareMutex
+    void releaseShare(unsigned int sourceId)
+    {
+        auto it = m_shares.find(sourceId);
+        if (it == m_shares.end()) return;
+        LOG_INFO("Releasing share %u", sourceId);
+        delete it->second.handler;
+        delete it->second.hub;
+        m_shares.erase(it);
+    }
+
+    // Caller holds m_shareMutex
+    void releaseSharesOf(IZoomVideoSDKUser* user)
+    {
+        for (auto it = m_shares.begin(); it != m_shares.end();) {
+            if (it->second.user == user) {
+                delete it->second.handler;
+                delete it->second.hub;
+                it = m_shares.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void releaseAllShares()
+    {
+        std::lock_guard<std::mutex> lock(m_shareMutex);
+        for (auto& entry : m_shares) {
+            delete entry.second.handler;
+            delete entry.second.hub;
+        }
+        m_shares.clear();
+    }
+
+    // Remote video handlers keyed by user, so each user is subscribed once.
+    // Guarded by m_remoteMutex: user callbacks and control commands both touch it.
+    std::mutex m_remoteMutex;
+    std::map<IZoomVideoSDKUser*, RemoteStream> m_remoteHandlers;
+
+    // Received shares keyed by share source id; a user can share more than one
+    std::mutex m_shareMutex;
+    std::map<unsigned int, ShareStream> m_shares;
+};
+
+// Global delegate instance
+ZoomVideoSDKDelegate* g_delegate = nullptr;
+
+QString getSelfDirPath()
+{
+    char dest[PATH_MAX];
+    memset(dest, 0, sizeof(dest)); // readlink does not null terminate!
+    if (readlink("/proc/self/exe", dest, PATH_MAX) == -1)
+    {
+        return QString();
+    }
+
+    char* tmp = strrchr(dest, '/');
+    if (tmp)
+        *tmp = 0;
+    LOG_DEBUG("getpath");
+    return QString(dest);
+}
+
+void joinVideoSDKSession(const QString& session_name, const QString& session_psw, const QString& session_token,
+                         const QString& user_name)
+{
+    LOG_INFO("=== Starting Video SDK Session Join Process (Qt-Free) ===");
+
+    // Basic validation
+    if (session_name.isEmpty()) {
+        LOG_ERROR("Session name is empty!");
+        return;
+    }
+
+    if (session_token.isEmpty()) {
+        LOG_ERROR("Session token is empty!");
+        return;
+    }
+
+    LOG_DEBUG("Session Name: %s", session_name.toStdString().c_str());
+
+    // Check if SDK is already initialized
+    if (!video_sdk_obj) {
+        LOG_ERROR("SDK not initialized!");
+        return;
+    }
+
+    // If already in a session, leave it first
+    if (g_in_session) {
+        LOG_INFO("Leaving current session...");
+        video_sdk_obj->leaveSession(false);
+        g_in_session = false;
+    }
+
+    // Temporarily disable the delegate to avoid Qt interference during join
+    LOG_INFO("Temporarily disabling delegate for clean join...");
+    if (g_delegate) {
+        video_sdk_obj->removeListener(dynamic_cast<IZoomVideoSDKDelegate*>(g_delegate));
+    }
+
+    // Prepare session context (matching GTK exactly)
+    // FIX: Store std::string objects to avoid temporary destruction
+    std::string session_name_str = session_name.toStdString();
+    std::string session_psw_str = session_psw.toStdString();
+    std::string session_token_str = session_token.toStdString();
+    std::string user_name_str = user_name.toStdString();
+
+    ZoomVideoSDKSessionContext session_context;
+    session_context.sessionName = session_name_str.c_str();
+
+    if (!session_psw.isEmpty()) {
+        session_context.sessionPassword = session_psw_str.c_str();
+    }
+
+    session_context.userName = user_name_str.c_str();
+    session_context.token = session_token_str.c_str();
+    session_context.videoOption.localVideoOn = false;
+    session_context.audioOption.connect = true;
+    session_context.audioOption.mute = false;
+
+    // DEBUG: Print all session parameters before joining
+    LOG_DEBUG("=== SESSION JOIN PARAMETERS ===");
+    LOG_DEBUG("Username: %s", session_context.userName);
+    LOG_DEBUG("Session Name: %s", session_context.sessionName);
+    LOG_DEBUG("Session Password: %s", session_context.sessionPassword ? session_context.sessionPassword : "(empty)");
+    LOG_DEBUG("Token: %.50s...", session_context.token); // Truncate token for readability
+    LOG_DEBUG("Video On: %s", session_context.videoOption.localVideoOn ? "true" : "false");
+    LOG_DEBUG("Audio Connect: %s", session_context.audioOption.connect ? "true" : "false");
+    LOG_DEBUG("Audio Mute: %s", session_context.audioOption.mute ? "true" : "false");
+    LOG_DEBUG("===============================");
+
+    // Re-enable the delegate BEFORE joining so we can receive callbacks
+    LOG_INFO("Re-enabling delegate for callback handling...");
+    if (g_delegate) {
+        video_sdk_obj->addListener(dynamic_cast<IZoomVideoSDKDelegate*>(g_delegate));
+    }
+
+    LOG_INFO("Joining session (waiting for callback)...");
+    IZoomVideoSDKSession* session = video_sdk_obj->joinSession(session_context);
+
+    // Don't check session return value - success/failure comes through callbacks
+    LOG_INFO("Join session request sent - waiting for callback...");
+
+    // Update UI to show we're attempting to join
+    BotEvent event;
+    event.type = BOT_EVENT_STATUS_MESSAGE;
+    event.text = "Joining session...";
+    g_eventBus.post(std::move(event));
+
+    LOG_INFO("=== Session Join Process Complete ===");
+}
+
+bool loadBotConfig(const QString& path, BotConfig& config)
+{
+    QFile config_file(path);
+    if (!config_file.open(QIODevice::ReadOnly)) {
+        LOG_WARN("Config file not found: %s", path.toStdString().c_str());
+        return false;
+    }
+    QByteArray config_data = config_file.readAll();
+    config_file.close();
+
+    try {
+        Json config_json = Json::parse(config_data.toStdString());
+        if (!config_json.is_null()) {
+            if (config_json.contains("session_name"))
+                config.session_name = QString::fromStdString(config_json["session_name"]);
+            if (config_json.contains("session_psw"))
+                config.session_psw = QString::fromStdString(config_json["session_psw"]);
+            if (config_json.contains("token"))
+                config.token = QString::fromStdString(config_json["token"]);
+            if (config_json.contains("user_name"))
+                config.user_name = QString::fromStdString(config_json["user_name"]);
+            if (config_json.contains("memory_budget_mb"))
+                MemoryBudget::instance().setLimit(size_t(config_json["memory_budget_mb"].get<int>()) * 1024 * 1024);
+            SubscriptionPolicy::Config policy = g_subscriptionPolicy.config();
+            if (config_json.contains("subscription_pixel_budget_mpps"))
+                policy.maxPixelsPerSecond = config_json["subscription_pixel_budget_mpps"].get<double>() * 1e6;
+            if (config_json.contains("subscription_debounce_ms"))
+                policy.debounceMs = config_json["subscription_debounce_ms"].get<int>();
+            g_subscriptionPolicy.setConfig(policy);
+            if (config_json.contains("frame_worker_threads"))
+                g_frameWorkerThreads = config_json["frame_worker_threads"].get<int>();
+            if (config_json.contains("frame_export"))
+                g_frameExport = config_json["frame_export"].get<bool>();
+            if (config_json.contains("frame_export_slots"))
+                g_frameExportSlots = uint32_t(std::max(2, config_json["frame_export_slots"].get<int>()));
+            if (config_json.contains("frame_export_max_lines"))
+                g_frameExportMaxLines = std::max(90, config_json["frame_export_max_lines"].get<int>());
+            if (config_json.contains("record_dir"))
+                g_recorderConfig.directory = config_json["record_dir"].get<std::string>();
+            if (config_json.contains("record_segment_seconds"))
+                g_recorderConfig.segmentSeconds = std::max(1, config_json["record_segment_seconds"].get<int>());
+            if (config_json.contains("record_segment_mb"))
+                g_recorderConfig.segmentBytes = size_t(std::max(16, config_json["record_segment_mb"].get<int>())) * 1024 * 1024;
+            if (config_json.contains("record_queue_frames"))
+                g_recorderConfig.maxQueued = size_t(std::max(1, config_json["record_queue_frames"].get<int>()));
+            if (config_json.contains("analysis_plugins")) {
+                g_analysisPlugins.clear();
+                for (const std::string& name : config_json["analysis_plugins"].get<std::vector<std::string>>()) {
+                    if (createFrameAnalyzer(name, std::string())) {
+                        g_analysisPlugins.push_back(name);
+                    } else {
+                        LOG_WARN("Unknown analysis plugin \"%s\", ignored", name.c_str());
+                    }
+                }
+            }
+            if (config_json.contains("analysis_fps"))
+                g_analysisConfig.sampleFps = config_json["analysis_fps"].get<double>();
+            if (config_json.contains("analysis_budget_us"))
+                g_analysisConfig.budgetUs = std::max(1, config_json["analysis_budget_us"].get<int>());
+            if (config_json.contains("snapshot_dir"))
+                g_snapshotConfig.directory = config_json["snapshot_dir"].get<std::string>();
+            if (config_json.contains("snapshot_interval_sec"))
+                g_snapshotConfig.intervalSec = config_json["snapshot_interval_sec"].get<int>();
+            if (config_json.contains("snapshot_width"))
+                g_snapshotConfig.width = config_json["snapshot_width"].get<int>();
+            if (config_json.contains("snapshot_quality"))
+                g_snapshotConfig.quality = config_json["snapshot_quality"].get<int>();
+            if (config_json.contains("transcript_dir"))
+                g_transcriptConfig.directory = config_json["transcript_dir"].get<std::string>();
+            if (config_json.contains("watchdog_stall_ms"))
+                g_watchdogConfig.minStallMs = std::max(0, config_json["watchdog_stall_ms"].get<int>());
+            if (config_json.contains("watchdog_max_backoff_ms"))
+                g_watchdogConfig.maxBackoffMs = config_json["watchdog_max_backoff_ms"].get<int>();
+            if (config_json.contains("command_channel_rate"))
+                g_commandChannelConfig.commandsPerSecond = config_json["command_channel_rate"].get<double>();
+            if (config_json.contains("command_channel_burst"))
+                g_commandChannelConfig.burst = config_json["command_channel_burst"].get<int>();
+            if (config_json.contains("command_channel_batch_ms"))
+                g_commandChannelConfig.batchDelayMs = std::max(0, config_json["command_channel_batch_ms"].get<int>());
+            if (config_json.contains("transcript_flush_ms"))
+                g_transcriptConfig.flushIntervalMs = std::max(10, config_json["transcript_flush_ms"].get<int>());
+            if (config_json.contains("share_file"))
+                g_virtualShareConfig.file = config_json["share_file"].get<std::string>();
+            if (config_json.contains("share_fps"))
+                g_virtualShareConfig.maxFps = config_json["share_fps"].get<int>();
+            if (config_json.contains("share_keepalive_ms"))
+                g_virtualShareConfig.keepaliveMs = config_json["share_keepalive_ms"].get<int>();
+            if (config_json.contains("share_color_space")) {
+                std::string name = config_json["share_color_space"].get<std::string>();
+                if (!parseColorSpace(name, g_virtualShareConfig.colorSpace)) {
+                    LOG_WARN("Unknown share_color_space \"%s\", using auto-full", name.c_str());
+                }
+            }
+            if (config_json.contains("video_color_space")) {
+                ColorSpace space;
+                std::string name = config_json["video_color_space"].get<std::string>();
+                if (parseColorSpace(name, space)) {
+                    FrameHub::setDefaultColorSpace(space);
+                } else {
+                    LOG_WARN("Unknown video_color_space \"%s\", using auto", name.c_str());
+                }
+            }
+        }
+    } catch (Json::exception& ex) {
+        LOG_ERROR("Error parsing config.json: %s", ex.what());
+        return false;
+    }
+    return true;
+}
+
+// Creates and initializes the SDK and installs the delegate. video_sdk_obj is
+// only published once everything is in place, so a front end that checks it
+// never sees a half-initialized SDK.
+static bool createVideoSDK()
+{
+    StartupProfiler::mark("SDK init started");
+    IZoomVideoSDK* sdk = CreateZoomVideoSDKObj();
+    if (!sdk) {
+        LOG_ERROR("Failed to create SDK object");
+        return false;
+    }
+    StartupProfiler::mark("SDK object created");
+
+    ZoomVideoSDKInitParams init_params;
+    init_params.domain = "https://zoom.us";
+    init_params.enableLog = false;
+    init_params.logFilePrefix = "";
+    init_params.videoRawDataMemoryMode = ZoomVideoSDKRawDataMemoryModeHeap;
+    init_params.shareRawDataMemoryMode = ZoomVideoSDKRawDataMemoryModeHeap;
+    init_params.audioRawDataMemoryMode = ZoomVideoSDKRawDataMemoryModeHeap;
+    init_params.enableIndirectRawdata = false;
+
+    ZoomVideoSDKErrors err = sdk->initialize(init_params);
+    if (err != ZoomVideoSDKErrors_Success) {
+        LOG_ERROR("Failed to initialize SDK: %d", (int)err);
+        DestroyZoomVideoSDKObj();
+        return false;
+    }
+    StartupProfiler::mark("SDK initialized");
+    LOG_INFO("SDK initialized");
+
+    // Set up delegate once during SDK initialization
+    LOG_INFO("Setting up delegate...");
+    g_delegate = new ZoomVideoSDKDelegate();
+    sdk->addListener(dynamic_cast<IZoomVideoSDKDelegate*>(g_delegate));
+    LOG_INFO("Delegate added successfully");
+
+    video_sdk_obj = sdk;
+    g_sdkReady.store(true, std::memory_order_release);
+    return true;
+}
+
+static void postSdkReady(bool ok)
+{
+    BotEvent event;
+    event.type = BOT_EVENT_SDK_READY;
+    event.code = ok ? 1 : 0;
+    g_eventBus.post(std::move(event));
+}
+
+static void installWakeHandler()
+{
+    static std::once_flag once;
+    std::call_once(once, []() {
+        g_eventBus.setWakeHandler([]() {
+            IBotFrontend* frontend = g_frontend.load(std::memory_order_acquire);
+            if (frontend) frontend->requestEventDispatch();
+        });
+    });
+}
+
+void attachBotFrontend(IBotFrontend* frontend)
+{
+    installWakeHandler();
+    g_frontend.store(frontend, std::memory_order_release);
+    // Events posted before the front end existed found nobody to wake
+    if (frontend) frontend->requestEventDispatch();
+}
+
+bool initializeVideoSDK(IBotFrontend* frontend)
+{
+    attachBotFrontend(frontend);
+    bool ok = createVideoSDK();
+    postSdkReady(ok);
+    return ok;
+}
+
+void initializeVideoSDKAsync()
+{
+    installWakeHandler();
+    if (video_sdk_obj || g_init.thread.joinable()) return;
+    g_init.thread = std::thread([]() {
+        postSdkReady(createVideoSDK());
+    });
+}
+
+bool isVideoSDKReady()
+{
+    return g_sdkReady.load(std::memory_order_acquire);
+}
+
+EventBus& botEventBus()
+{
+    return g_eventBus;
+}
+
+StreamWatchdog& streamWatchdog()
+{
+    std::call_once(g_watchdogOnce, []() {
+        g_streamWatchdog.reset(new StreamWatchdog(g_watchdogConfig, [](const std::string& userName) {
+            if (g_delegate) g_delegate->resubscribeStalled(userName);
+        }));
+    });
+    return *g_streamWatchdog;
+}
+
+CommandChannel& botCommandChannel()
+{
+    std::call_once(g_commandChannelOnce, []() {
+        auto transport = [](const std::string& receiver, const std::string& command) {
+            return g_delegate && g_delegate->sendCommand(receiver, command);
+        };
+        g_commandChannel.reset(new CommandChannel(g_commandChannelConfig, transport));
+        // Liveness probe for controllers: echoes the data back to the sender
+        g_commandChannel->setHandler("ping", [](const CommandChannel::Message& message) {
+            g_commandChannel->send("pong", message.data, message.sender);
+        });
+        g_commandChannel->start();
+        g_commandChannelStarted.store(g_commandChannel.get(), std::memory_order_release);
+    });
+    return *g_commandChannel;
+}
+
+CommandChannel* botCommandChannelIfStarted()
+{
+    return g_commandChannelStarted.load(std::memory_order_acquire);
+}
+
+// Everyone in the session learns the bot's mute state; a burst of toggles
+// coalesces into the latest one
+static void publishSelfState()
+{
+    botCommandChannel().send("state", { { "audio_muted", g_audio_muted.load() }, { "video_muted", g_video_muted.load() } },
+                             std::string(), "self");
+}
+
+FrameHub& selfVideoHub()
+{
+    return g_selfHub;
+}
+
+FrameHub& mixedVideoHub()
+{
+    return g_mixedHub;
+}
+
+size_t dispatchBotEvents(IBotFrontend* frontend, size_t maxBatch)
+{
+    return g_eventBus.drain([frontend](const BotEvent& event) {
+        frontend->onSessionEvent(event);
+        switch (event.type) {
+        case BOT_EVENT_STATUS_MESSAGE:
+            frontend->onStatusMessage(event.text);
+            break;
+        case BOT_EVENT_SESSION_JOINED:
+            frontend->onStatusMessage("Session joined successfully");
+            frontend->onSessionStateChanged();
+            break;
+        case BOT_EVENT_SESSION_LEFT:
+            frontend->onStatusMessage("Left session");
+            frontend->onSessionStateChanged();
+            break;
+        case BOT_EVENT_SESSION_ERROR:
+            frontend->onStatusMessage("Session error occurred (" + std::to_string(event.code) + "/"
+                                      + std::to_string(event.detail) + ")");
+            break;
+        case BOT_EVENT_SDK_READY:
+            frontend->onStatusMessage(event.code ? "SDK initialized - ready to join session"
+                                                 : "Failed to initialize SDK");
+            frontend->onSessionStateChanged();
+            break;
+        default:
+            break;
+        }
+    }, maxBatch);
+}
+
+void leaveVideoSDKSession()
+{
+    if (video_sdk_obj && g_in_session) {
+        video_sdk_obj->leaveSession(false);
+        g_in_session = false;
+    }
+}
+
+bool setSelfAudioMuted(bool muted)
+{
+    if (!video_sdk_obj || !g_in_session) return false;
+    IZoomVideoSDKAudioHelper* audioHelper = video_sdk_obj->getAudioHelper();
+    IZoomVideoSDKSession* session = video_sdk_obj->getSessionInfo();
+    IZoomVideoSDKUser* myself = session ? session->getMyself() : nullptr;
+    if (!audioHelper || !myself) return false;
+
+    ZoomVideoSDKErrors err = muted ? audioHelper->muteAudio(myself) : audioHelper->unMuteAudio(myself);
+    if (err != ZoomVideoSDKErrors_Success) {
+        LOG_WARN("%s audio failed: %d", muted ? "Muting" : "Unmuting", (int)err);
+        return false;
+    }
+    g_audio_muted = muted;
+    publishSelfState();
+    return true;
+}
+
+bool setSelfVideoOn(bool on)
+{
+    if (!video_sdk_obj || !g_in_session) return false;
+    IZoomVideoSDKVideoHelper* videoHelper = video_sdk_obj->getVideoHelper();
+    if (!videoHelper) return false;
+
+    ZoomVideoSDKErrors err = on ? videoHelper->startVideo() : videoHelper->stopVideo();
+    if (err != ZoomVideoSDKErrors_Success) {
+        LOG_WARN("%s video failed: %d", on ? "Starting" : "Stopping", (int)err);
+        return false;
+    }
+    g_video_muted = !on;
+    publishSelfState();
+    return true;
+}
+
+VirtualShareSource& virtualShareSource()
+{
+    std::call_once(g_virtualShareOnce, []() {
+        g_virtualShare.reset(new VirtualShareSource(g_virtualShareConfig));
+        g_virtualShareStarted.store(g_virtualShare.get(), std::memory_order_release);
+    });
+    return *g_virtualShare;
+}
+
+VirtualShareSource* virtualShareSourceIfStarted()
+{
+    return g_virtualShareStarted.load(std::memory_order_acquire);
+}
+
+bool startVirtualShare()
+{
+    if (!video_sdk_obj || !g_in_session) return false;
+    IZoomVideoSDKShareHelper* shareHelper = video_sdk_obj->getShareHelper();
+    if (!shareHelper) return false;
+
+    // Frames flow once the SDK calls onShareSendStarted()
+    ZoomVideoSDKErrors err = shareHelper->startSharingExternalSource(&virtualShareSource());
+    if (err != ZoomVideoSDKErrors_Success) {
+        LOG_WARN("Starting the virtual share failed: %d", (int)err);
+        return false;
+    }
+    return true;
+}
+
+bool stopVirtualShare()
+{
+    if (!video_sdk_obj || !g_in_session) return false;
+    IZoomVideoSDKShareHelper* shareHelper = video_sdk_obj->getShareHelper();
+    if (!shareHelper) return false;
+
+    ZoomVideoSDKErrors err = shareHelper->stopShare();
+    if (err != ZoomVideoSDKErrors_Success) {
+        LOG_WARN("Stopping the virtual share failed: %d", (int)err);
+        return false;
+    }
+    return true;
+}
+
+bool setRemoteVideoSubscription(const std::string& userName, int resolutionLines)
+{
+    if (!g_delegate || !g_in_session) return false;
+
+    switch (resolutionLines) {
+    case 0:
+    case 90:
+    case 180:
+    case 360:
+    case 720:
+    case 1080:
+        break;
+    default:
+        LOG_WARN("Unsupported resolution %d for user %s", resolutionLines, userName.c_str());
+        return false;
+    }
+    return g_delegate->setRemoteVideo(userName, resolutionLines == 0 ? -1 : resolutionLines);
+}
+
+WorkStealingExecutor& frameExecutor()
+{
+    std::call_once(g_frameExecutorOnce, []() {
+        g_frameExecutor.reset(new WorkStealingExecutor(g_frameWorkerThreads));
+        g_frameExecutorStarted.store(g_frameExecutor.get(), std::memory_order_release);
+    });
+    return *g_frameExecutor;
+}
+
+WorkStealingExecutor* frameExecutorIfStarted()
+{
+    return g_frameExecutorStarted.load(std::memory_order_acquire);
+}
+
+SubscriptionPolicy& subscriptionPolicy()
+{
+    return g_subscriptionPolicy;
+}
+
+void applySubscriptionPolicy()
+{
+    if (g_delegate && g_in_session) g_delegate->applySubscriptionPolicy();
+}
+
+void cleanupVideoSDK()
+{
+    // A background initialization must finish before it can be undone
+    if (g_init.thread.joinable()) g_init.thread.join();
+    if (!video_sdk_obj) return;
+
+    leaveVideoSDKSession();
+    // Both call into the delegate from their own threads
+    if (CommandChannel* channel = botCommandChannelIfStarted()) channel->stop();
+    if (g_streamWatchdog) g_streamWatchdog->stop();
+    // Its thread hands frames to the SDK's share sender
+    if (VirtualShareSource* share = virtualShareSourceIfStarted()) share->stop();
+    if (g_delegate) {
+        video_sdk_obj->removeListener(dynamic_cast<IZoomVideoSDKDelegate*>(g_delegate));
+        delete g_delegate;
+        g_delegate = nullptr;
+    }
+    g_frontend.store(nullptr, std::memory_order_release);
+    g_sdkReady.store(false, std::memory_order_release);
+    SnapshotService::instance().stop();
+    closeTranscriptLog();
+    DeviceCache::instance().reset();
+    video_sdk_obj->cleanup();
+    DestroyZoomVideoSDKObj();
+    video_sdk_obj = nullptr;
+}
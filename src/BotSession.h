@@ -0,0 +1,143 @@
+#pragma once
+
+#include <QString>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "zoom_video_sdk_interface.h"
+
+USING_ZOOM_VIDEO_SDK_NAMESPACE
+
+class CommandChannel;
+class EventBus;
+class FrameHub;
+class StreamWatchdog;
+class SubscriptionPolicy;
+class TranscriptLog;
+class VirtualShareSource;
+class WorkStealingExecutor;
+struct BotEvent;
+
+// Session core shared by the Qt GUI and the headless bot. It owns the SDK
+// object, the delegate, remote video handlers and audio playback, and reports
+// to whichever front end is attached. Nothing here depends on QtWidgets.
+
+// Front end the delegate reports to: the Qt main window or the headless controller
+class IBotFrontend
+{
+public:
+    virtual ~IBotFrontend() {}
+
+    // Human-readable status updates and session state changes (g_in_session etc.).
+    // Called from dispatchBotEvents() on the front end's own thread.
+    virtual void onStatusMessage(const std::string& message) = 0;
+    virtual void onSessionStateChanged() = 0;
+    // Every dispatched event, before the callbacks above; for front ends that
+    // need the typed details (leave reason, error codes, post time)
+    virtual void onSessionEvent(const BotEvent&) {}
+
+    // Called from any thread when events are waiting; must not block, just
+    // arrange for dispatchBotEvents() to run on the front end's thread
+    virtual void requestEventDispatch() = 0;
+
+    // A remote user's video is subscribed; called on an SDK thread. The core
+    // owns the hub and destroys it, with all its subscriptions, when the
+    // subscription ends.
+    virtual void onRemoteVideoStarted(const std::string& /*streamName*/, FrameHub& /*hub*/) {}
+    // A remote screen share is subscribed; same threading and ownership. The
+    // hub also forwards the sharer's cursor (IFrameHubSink::onHubCursor).
+    virtual void onShareStarted(const std::string& /*streamName*/, FrameHub& /*hub*/) {}
+};
+
+// Session parameters from config.json
+struct BotConfig
+{
+    QString session_name;
+    QString session_psw;
+    QString token;
+    QString user_name;
+};
+
+// Session state shared with the front ends. Written on SDK callback and Qt
+// threads, read from the control server, command channel and timers.
+extern IZoomVideoSDK* video_sdk_obj;
+extern std::atomic<bool> g_in_session;
+extern std::atomic<bool> g_audio_muted;
+extern std::atomic<bool> g_video_muted;
+
+// Directory containing the running executable
+QString getSelfDirPath();
+
+// Reads session parameters and applies process-wide settings (memory budget)
+bool loadBotConfig(const QString& path, BotConfig& config);
+
+// Create and initialize the SDK and attach the delegate reporting to frontend.
+// Either way a BOT_EVENT_SDK_READY event reports the outcome.
+bool initializeVideoSDK(IBotFrontend* frontend);
+// Same, on a worker thread so the front end can build its UI meanwhile; attach
+// the front end with attachBotFrontend() whenever it exists. Nothing may touch
+// video_sdk_obj until BOT_EVENT_SDK_READY has been dispatched.
+void initializeVideoSDKAsync();
+void attachBotFrontend(IBotFrontend* frontend);
+bool isVideoSDKReady();
+void cleanupVideoSDK();
+
+// Events posted by the delegate (queue depth and dwell time in its stats)
+EventBus& botEventBus();
+
+// Rate-limited, batched control messages to and from other session
+// participants; front ends may add handlers. Answers "ping" with "pong" and
+// announces the bot's mute state as "state". botCommandChannelIfStarted() is
+// null until something first used the channel.
+CommandChannel& botCommandChannel();
+CommandChannel* botCommandChannelIfStarted();
+
+// Own camera video (preview pipe, or the one-way callback without one) and
+// the mixed stream; sinks subscribe with the format and size they need
+FrameHub& selfVideoHub();
+FrameHub& mixedVideoHub();
+
+// Runs remote streams' frame delivery (conversion and every hub sink) in
+// per-stream strands across all cores. frameExecutorIfStarted() is null
+// until the first remote stream started it.
+WorkStealingExecutor& frameExecutor();
+WorkStealingExecutor* frameExecutorIfStarted();
+
+// Watches every subscribed remote stream for frames that stop arriving and
+// resubscribes it with backoff; per-user stall and recovery counts
+StreamWatchdog& streamWatchdog();
+
+// Handle up to maxBatch pending events through the front end's callbacks
+size_t dispatchBotEvents(IBotFrontend* frontend, size_t maxBatch = 64);
+
+void joinVideoSDKSession(const QString& session_name, const QString& session_psw, const QString& session_token,
+                         const QString& user_name = "Linux Qt Bot");
+void leaveVideoSDKSession();
+
+// In-session controls for front ends and the control socket; false if not in
+// a session or the SDK refused
+bool setSelfAudioMuted(bool muted);
+bool setSelfVideoOn(bool on);
+// resolutionLines is 90/180/360/720/1080, or 0 to stop receiving that user's video
+bool setRemoteVideoSubscription(const std::string& userName, int resolutionLines);
+
+// Screen share of content the bot renders itself: RGB32 images handed to
+// virtualShareSource() from any thread, or its file (config share_file).
+// The source lives for the process; the share ends with the session.
+// virtualShareSourceIfStarted() is null until something first used it.
+VirtualShareSource& virtualShareSource();
+VirtualShareSource* virtualShareSourceIfStarted();
+bool startVirtualShare();
+bool stopVirtualShare();
+
+// Picks remote subscription resolutions (active speaker, tile size, network,
+// pixel budget). Front ends report their tile size to it and call
+// applySubscriptionPolicy() a few times a second so debounced changes land.
+SubscriptionPolicy& subscriptionPolicy();
+void applySubscriptionPolicy();
+
+// This session's live transcription log (config transcript_dir), or null when
+// off or not in a session; range queries go through its in-memory index
+std::shared_ptr<TranscriptLog> currentTranscriptLog();
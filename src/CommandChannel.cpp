@@ -0,0 +1,328 @@
+#include "CommandChannel.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <time.h>
+
+namespace {
+
+const char kBatchPrefix[] = "{\"v\":1,\"b\":[";
+const char kBatchSuffix[] = "]}";
+const size_t kBatchOverhead = sizeof(kBatchPrefix) - 1 + sizeof(kBatchSuffix) - 1;
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+} // namespace
+
+CommandChannel::CommandChannel(const Config& config, Transport transport)
+    : m_config(config)
+    , m_transport(std::move(transport))
+    , m_stop(false)
+    , m_connected(false)
+    , m_queuedBytes(0)
+    , m_tokens(0.0)
+    , m_refillNs(0)
+    , m_queued(0)
+    , m_coalesced(0)
+    , m_sent(0)
+    , m_commands(0)
+    , m_sendFailures(0)
+    , m_dropped(0)
+    , m_received(0)
+    , m_unhandled(0)
+    , m_parseErrors(0)
+    , m_inboundDropped(0)
+    , m_maxQueueDepth(0)
+    , m_totalLatencyMs(0.0)
+    , m_maxLatencyMs(0.0)
+{
+    m_config.commandsPerSecond = std::max(0.01, m_config.commandsPerSecond);
+    m_config.burst = std::max(1, m_config.burst);
+    m_config.maxCommandBytes = std::max<size_t>(m_config.maxCommandBytes, kBatchOverhead + 64);
+    m_tokens = m_config.burst;
+}
+
+CommandChannel::~CommandChannel()
+{
+    stop();
+}
+
+void CommandChannel::setHandler(const std::string& type, Handler handler)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_handlers[type] = std::move(handler);
+}
+
+void CommandChannel::start()
+{
+    if (m_thread.joinable()) return;
+    m_stop = false;
+    m_refillNs = monotonicNs();
+    m_thread = std::thread(&CommandChannel::run, this);
+}
+
+void CommandChannel::stop()
+{
+    if (!m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void CommandChannel::setConnected(bool connected)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_connected = connected;
+    }
+    m_wake.notify_one();
+}
+
+void CommandChannel::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_dropped += m_outgoing.size();
+    m_outgoing.clear();
+    m_byCoalesceId.clear();
+    m_queuedBytes = 0;
+    m_incoming.clear();
+}
+
+bool CommandChannel::send(const std::string& type, const nlohmann::json& data, const std::string& receiver,
+                          const std::string& coalesceKey)
+{
+    Outgoing message;
+    message.type = type;
+    message.receiver = receiver;
+    message.item = nlohmann::json({ { "t", type }, { "d", data } }).dump();
+    message.queuedNs = monotonicNs();
+    if (!coalesceKey.empty()) message.coalesceId = type + '\n' + coalesceKey + '\n' + receiver;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (message.item.size() + kBatchOverhead > m_config.maxCommandBytes) {
+        m_dropped++;
+        LOG_RATE_LIMITED(LOG_LEVEL_WARN, 1000, "Command channel: %s message of %zu bytes exceeds a command, dropped",
+                         type.c_str(), message.item.size());
+        return false;
+    }
+
+    // A newer state update takes the queued one's place and keeps its age,
+    // so steady updates can't starve it
+    if (!message.coalesceId.empty()) {
+        auto queued = m_byCoalesceId.find(message.coalesceId);
+        if (queued != m_byCoalesceId.end()) {
+            Outgoing& older = *queued->second;
+            m_queuedBytes += message.item.size();
+            m_queuedBytes -= older.item.size();
+            older.item = std::move(message.item);
+            m_coalesced++;
+            return true;
+        }
+    }
+
+    if (m_outgoing.size() >= m_config.maxQueued) {
+        m_dropped++;
+        LOG_RATE_LIMITED(LOG_LEVEL_WARN, 1000, "Command channel: send queue full, dropping %s message", type.c_str());
+        return false;
+    }
+    m_queuedBytes += message.item.size();
+    m_outgoing.push_back(std::move(message));
+    if (!m_outgoing.back().coalesceId.empty()) {
+        m_byCoalesceId[m_outgoing.back().coalesceId] = std::prev(m_outgoing.end());
+    }
+    m_queued++;
+    m_maxQueueDepth = std::max(m_maxQueueDepth, m_outgoing.size());
+    bool first = m_outgoing.size() == 1;
+    // Only the first message starts the batch timer; later ones just join it
+    if (first || m_queuedBytes + kBatchOverhead >= m_config.maxCommandBytes) m_wake.notify_one();
+    return true;
+}
+
+void CommandChannel::receive(const std::string& sender, const std::string& command)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_incoming.size() >= m_config.maxQueued) {
+            m_inboundDropped++;
+            LOG_RATE_LIMITED(LOG_LEVEL_WARN, 1000, "Command channel: receive queue full, dropping command from %s",
+                             sender.c_str());
+            return;
+        }
+        m_incoming.push_back({ sender, command });
+    }
+    m_wake.notify_one();
+}
+
+std::string CommandChannel::takeBatch(std::string& receiver, std::vector<int64_t>& queuedNs)
+{
+    receiver = m_outgoing.front().receiver;
+    std::string batch = kBatchPrefix;
+    size_t room = m_config.maxCommandBytes - kBatchOverhead;
+    bool first = true;
+    for (auto it = m_outgoing.begin(); it != m_outgoing.end();) {
+        // Other receivers keep their place; order only matters per receiver
+        if (it->receiver != receiver || it->item.size() + (first ? 0 : 1) > room) {
+            ++it;
+            continue;
+        }
+        if (!first) batch += ',';
+        batch += it->item;
+        room -= it->item.size() + (first ? 0 : 1);
+        first = false;
+        queuedNs.push_back(it->queuedNs);
+        m_queuedBytes -= it->item.size();
+        if (!it->coalesceId.empty()) m_byCoalesceId.erase(it->coalesceId);
+        it = m_outgoing.erase(it);
+    }
+    batch += kBatchSuffix;
+    return batch;
+}
+
+void CommandChannel::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop) {
+        if (!m_incoming.empty()) {
+            std::deque<Incoming> incoming;
+            incoming.swap(m_incoming);
+            lock.unlock();
+            for (const Incoming& command : incoming) dispatch(command);
+            lock.lock();
+            continue;
+        }
+
+        int64_t nowNs = monotonicNs();
+        int64_t wakeNs = 0;  // 0: until notified
+        if (m_connected && !m_outgoing.empty()) {
+            m_tokens = std::min<double>(m_config.burst,
+                                        m_tokens + (nowNs - m_refillNs) / 1e9 * m_config.commandsPerSecond);
+            m_refillNs = nowNs;
+            int64_t batchReadyNs = m_outgoing.front().queuedNs + int64_t(m_config.batchDelayMs) * 1000000;
+            bool full = m_queuedBytes + kBatchOverhead >= m_config.maxCommandBytes;
+            if (m_tokens >= 1.0 && (full || nowNs >= batchReadyNs)) {
+                m_tokens -= 1.0;
+                std::string receiver;
+                std::vector<int64_t> queuedNs;
+                std::string command = takeBatch(receiver, queuedNs);
+                lock.unlock();
+                bool ok = m_transport && m_transport(receiver, command);
+                int64_t sentNs = monotonicNs();
+                lock.lock();
+
+                m_commands++;
+                if (ok) {
+                    m_sent += queuedNs.size();
+                    for (int64_t queued : queuedNs) {
+                        double latencyMs = (sentNs - queued) / 1e6;
+                        m_totalLatencyMs += latencyMs;
+                        m_maxLatencyMs = std::max(m_maxLatencyMs, latencyMs);
+                    }
+                } else {
+                    m_sendFailures++;
+                    m_dropped += queuedNs.size();
+                    LOG_RATE_LIMITED(LOG_LEVEL_WARN, 1000, "Command channel: SDK refused a command, %zu messages dropped",
+                                     queuedNs.size());
+                }
+                continue;
+            }
+            int64_t tokenNs = m_tokens >= 1.0 ? nowNs
+                                              : nowNs + int64_t((1.0 - m_tokens) / m_config.commandsPerSecond * 1e9);
+            wakeNs = full ? tokenNs : std::max(tokenNs, batchReadyNs);
+        }
+        if (wakeNs) {
+            m_wake.wait_for(lock, std::chrono::nanoseconds(std::max<int64_t>(wakeNs - nowNs, 100000)));
+        } else {
+            m_wake.wait(lock);
+        }
+    }
+}
+
+void CommandChannel::dispatch(const Incoming& incoming)
+{
+    std::vector<Message> messages;
+    nlohmann::json parsed = nlohmann::json::parse(incoming.command, nullptr, false);
+    if (parsed.is_object() && parsed.contains("b") && parsed["b"].is_array()) {
+        for (const nlohmann::json& item : parsed["b"]) {
+            if (!item.is_object() || !item.contains("t") || !item["t"].is_string()) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_parseErrors++;
+                continue;
+            }
+            messages.push_back({ item["t"].get<std::string>(), item.value("d", nlohmann::json()), incoming.sender });
+        }
+    } else {
+        // Not one of ours; plain text from another client
+        if (parsed.is_discarded() && !incoming.command.empty() && incoming.command[0] == '{') {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_parseErrors++;
+        }
+        messages.push_back({ "text", incoming.command, incoming.sender });
+    }
+
+    uint64_t unhandled = 0;
+    for (const Message& message : messages) {
+        Handler handler;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto found = m_handlers.find(message.type);
+            if (found != m_handlers.end()) handler = found->second;
+        }
+        if (!handler) {
+            LOG_RATE_LIMITED(LOG_LEVEL_DEBUG, 1000, "Command channel: no handler for %s from %s",
+                             message.type.c_str(), message.sender.c_str());
+            unhandled++;
+            continue;
+        }
+        try {
+            handler(message);
+        } catch (const std::exception& e) {
+            LOG_WARN("Command channel: %s handler failed: %s", message.type.c_str(), e.what());
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_received += messages.size();
+    m_unhandled += unhandled;
+}
+
+CommandChannel::Stats CommandChannel::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats s;
+    s.queued = m_queued;
+    s.coalesced = m_coalesced;
+    s.sent = m_sent;
+    s.commands = m_commands;
+    s.sendFailures = m_sendFailures;
+    s.dropped = m_dropped;
+    s.received = m_received;
+    s.unhandled = m_unhandled;
+    s.parseErrors = m_parseErrors;
+    s.inboundDropped = m_inboundDropped;
+    s.queueDepth = m_outgoing.size();
+    s.maxQueueDepth = m_maxQueueDepth;
+    s.meanSendLatencyMs = m_sent ? m_totalLatencyMs / m_sent : 0.0;
+    s.maxSendLatencyMs = m_maxLatencyMs;
+    s.meanBatchMessages = m_commands > m_sendFailures ? double(m_sent) / (m_commands - m_sendFailures) : 0.0;
+    s.connected = m_connected;
+    return s;
+}
+
+void CommandChannel::report() const
+{
+    Stats s = stats();
+    LOG_INFO("Command channel: %llu sent in %llu commands (%.1f each), %llu coalesced, %llu dropped, depth %zu (max %zu), "
+             "latency mean %.1f ms max %.1f ms; %llu received, %llu unhandled",
+             (unsigned long long)s.sent, (unsigned long long)s.commands, s.meanBatchMessages,
+             (unsigned long long)s.coalesced, (unsigned long long)s.dropped, s.queueDepth, s.maxQueueDepth,
+             s.meanSendLatencyMs, s.maxSendLatencyMs, (unsigned long long)s.received, (unsigned long long)s.unhandled);
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "json.hpp"
+
+// Bot control messages over the SDK command channel. Every SDK command is
+// one JSON batch, {"v":1,"b":[{"t":type,"d":data}, ...]}, so several small
+// messages cost one send against the channel's rate limit. Outgoing messages
+// queue until the channel is connected and a token-bucket slot is free; a
+// message sent with a coalescing key replaces a queued one with the same
+// type, key and receiver, so only the latest state update goes out. Incoming
+// commands are copied off the SDK thread, parsed and dispatched on the
+// channel's own thread through a handler table keyed by message type;
+// commands that aren't batches (e.g. from other apps) arrive as type "text".
+class CommandChannel
+{
+public:
+    struct Config
+    {
+        double commandsPerSecond = 2.0;  // SDK sends, not messages
+        int burst = 4;
+        size_t maxCommandBytes = 1024;   // one SDK command
+        int batchDelayMs = 30;           // a lone message waits this long for company
+        size_t maxQueued = 256;          // each direction
+    };
+
+    // An incoming message as handed to its handler
+    struct Message
+    {
+        std::string type;
+        nlohmann::json data;
+        std::string sender;
+    };
+
+    struct Stats
+    {
+        uint64_t queued;
+        uint64_t coalesced;        // replaced by a newer update before sending
+        uint64_t sent;             // messages
+        uint64_t commands;         // SDK sends (batches)
+        uint64_t sendFailures;     // batches the transport refused; their messages are dropped
+        uint64_t dropped;          // queue full or larger than a command
+        uint64_t received;         // messages
+        uint64_t unhandled;        // no handler for the type
+        uint64_t parseErrors;
+        uint64_t inboundDropped;
+        size_t queueDepth;
+        size_t maxQueueDepth;
+        double meanSendLatencyMs;  // queued to handed to the SDK
+        double maxSendLatencyMs;
+        double meanBatchMessages;
+        bool connected;
+    };
+
+    using Handler = std::function<void(const Message&)>;
+    // Hands one serialized command to the SDK; true if it accepted it
+    using Transport = std::function<bool(const std::string& receiver, const std::string& command)>;
+
+    CommandChannel(const Config& config, Transport transport);
+    ~CommandChannel();
+
+    CommandChannel(const CommandChannel&) = delete;
+    CommandChannel& operator=(const CommandChannel&) = delete;
+
+    // Any thread; handlers run on the channel thread and should be quick
+    void setHandler(const std::string& type, Handler handler);
+
+    void start();
+    void stop();
+
+    // Connection state from the SDK; nothing is sent while disconnected
+    void setConnected(bool connected);
+    // Drops everything queued, e.g. on leaving a session
+    void clear();
+
+    // Any thread; never blocks on the SDK. False if the message was dropped.
+    bool send(const std::string& type, const nlohmann::json& data, const std::string& receiver = std::string(),
+              const std::string& coalesceKey = std::string());
+    // SDK thread: only copies the command for the channel thread
+    void receive(const std::string& sender, const std::string& command);
+
+    Stats stats() const;
+    void report() const;
+
+private:
+    struct Outgoing
+    {
+        std::string type;
+        std::string receiver;
+        std::string coalesceId;  // empty if this message never coalesces
+        std::string item;        // serialized {"t":...,"d":...}
+        int64_t queuedNs;
+    };
+
+    struct Incoming
+    {
+        std::string sender;
+        std::string command;
+    };
+
+    void run();
+    void dispatch(const Incoming& incoming);
+    // Caller holds m_mutex; moves the next batch out of the queue
+    std::string takeBatch(std::string& receiver, std::vector<int64_t>& queuedNs);
+
+    Config m_config;
+    Transport m_transport;
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Handler> m_handlers;
+    std::condition_variable m_wake;
+    bool m_stop;
+    bool m_connected;
+    std::list<Outgoing> m_outgoing;
+    std::unordered_map<std::string, std::list<Outgoing>::iterator> m_byCoalesceId;
+    size_t m_queuedBytes;
+    std::deque<Incoming> m_incoming;
+    double m_tokens;
+    int64_t m_refillNs;
+
+    uint64_t m_queued;
+    uint64_t m_coalesced;
+    uint64_t m_sent;
+    uint64_t m_commands;
+    uint64_t m_sendFailures;
+    uint64_t m_dropped;
+    uint64_t m_received;
+    uint64_t m_unhandled;
+    uint64_t m_parseErrors;
+    uint64_t m_inboundDropped;
+    size_t m_maxQueueDepth;
+    double m_totalLatencyMs;
+    double m_maxLatencyMs;
+
+    std::thread m_thread;
+};
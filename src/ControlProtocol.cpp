@@ -0,0 +1,20 @@
+#include "ControlProtocol.h"
+
+using Json = nlohmann::json;
+
+std::string controlLine(const Json& message)
+{
+    return message.dump(-1, ' ', false, Json::error_handler_t::replace);
+}
+
+bool parseControlRequest(const std::string& line, Json& request, std::string& errorLine)
+{
+    try {
+        request = Json::parse(line);
+        return true;
+    } catch (Json::exception& ex) {
+        // The parser's message quotes the offending input
+        errorLine = controlLine({ { "ok", false }, { "error", std::string("invalid JSON: ") + ex.what() } });
+        return false;
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+#include "json.hpp"
+
+// Line framing for the control socket, kept free of Qt and the SDK so it can
+// be tested on its own.
+
+// One reply or event line. Client input echoed in errors and SDK strings
+// (user names, transcript text) may hold invalid UTF-8; such bytes become
+// U+FFFD rather than throwing out of the event loop.
+std::string controlLine(const nlohmann::json& message);
+
+// Parses one request line. On failure returns false with the ok:false reply
+// to send in errorLine.
+bool parseControlRequest(const std::string& line, nlohmann::json& request, std::string& errorLine);
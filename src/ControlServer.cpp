@@ -0,0 +1,495 @@
+#include "ControlServer.h"
+#include "CommandChannel.h"
+#include "ControlProtocol.h"
+#include "EventBus.h"
+#include "FrameAnalysis.h"
+#include "Logger.h"
+#include "MemoryBudget.h"
+#include "ResourceSampler.h"
+#include "SnapshotService.h"
+#include "StartupProfiler.h"
+#include "StreamWatchdog.h"
+#include "SubscriptionPolicy.h"
+#include "TranscriptLog.h"
+#include "VirtualShareSource.h"
+#include "WorkStealingExecutor.h"
+
+#include "SocketWatcher.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#include "json.hpp"
+
+using Json = nlohmann::json;
+
+namespace {
+
+// A client that sends this much without a newline is dropped
+const size_t kMaxLineLength = 64 * 1024;
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+std::string stringField(const Json& j, const char* key, const QString& fallback)
+{
+    if (j.contains(key) && j[key].is_string()) return j[key].get<std::string>();
+    return fallback.toStdString();
+}
+
+} // namespace
+
+ControlServer::ControlServer()
+    : m_listenFd(-1)
+    , m_listenWatcher(nullptr)
+    , m_joinRequestedNs(0)
+    , m_sessionsJoined(0)
+    , m_lastJoinMs(0.0)
+    , m_minJoinMs(0.0)
+    , m_maxJoinMs(0.0)
+    , m_totalJoinMs(0.0)
+    , m_startNs(monotonicNs())
+{
+}
+
+ControlServer::~ControlServer()
+{
+    close();
+}
+
+bool ControlServer::listen(const std::string& path)
+{
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        LOG_ERROR("ControlServer: socket path too long: %s", path.c_str());
+        return false;
+    }
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0) {
+        LOG_ERROR("ControlServer: socket() failed: %s", strerror(errno));
+        return false;
+    }
+
+    // A previous instance may have left its socket file behind
+    unlink(path.c_str());
+    if (bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(m_listenFd, 16) != 0) {
+        LOG_ERROR("ControlServer: cannot listen on %s: %s", path.c_str(), strerror(errno));
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+    chmod(path.c_str(), 0600);
+    m_path = path;
+
+    m_listenWatcher = new SocketWatcher(m_listenFd, QSocketNotifier::Read, [this]() { acceptClients(); });
+    LOG_INFO("ControlServer: listening on %s", path.c_str());
+    return true;
+}
+
+void ControlServer::close()
+{
+    while (!m_clients.empty()) {
+        closeClient(m_clients.begin()->first);
+    }
+    if (m_listenWatcher) {
+        m_listenWatcher->setEnabled(false);
+        m_listenWatcher->deleteLater();
+        m_listenWatcher = nullptr;
+    }
+    if (m_listenFd >= 0) {
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        unlink(m_path.c_str());
+    }
+}
+
+void ControlServer::acceptClients()
+{
+    for (;;) {
+        int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                LOG_WARN("ControlServer: accept failed: %s", strerror(errno));
+            }
+            return;
+        }
+
+        std::unique_ptr<Client> client(new Client);
+        client->fd = fd;
+        client->readWatcher = new SocketWatcher(fd, QSocketNotifier::Read, [this, fd]() { readClient(fd); });
+        client->writeWatcher = new SocketWatcher(fd, QSocketNotifier::Write, [this, fd]() {
+            auto it = m_clients.find(fd);
+            if (it != m_clients.end()) flushClient(*it->second);
+        });
+        client->writeWatcher->setEnabled(false);
+        m_clients[fd] = std::move(client);
+        LOG_DEBUG("ControlServer: client %d connected", fd);
+    }
+}
+
+void ControlServer::readClient(int fd)
+{
+    auto it = m_clients.find(fd);
+    if (it == m_clients.end()) return;
+    Client& client = *it->second;
+
+    char buffer[4096];
+    bool eof = false;
+    for (;;) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            client.input.append(buffer, size_t(n));
+            continue;
+        }
+        if (n == 0) {
+            // Half-closed (echo ... | nc -U, shutdown(SHUT_WR)): answer what
+            // was sent before closing
+            eof = true;
+            break;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n < 0 && errno == EINTR) continue;
+        closeClient(fd);
+        return;
+    }
+
+    size_t start = 0;
+    size_t newline;
+    while ((newline = client.input.find('\n', start)) != std::string::npos) {
+        std::string line = client.input.substr(start, newline - start);
+        start = newline + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        send(client, handleCommand(line));
+        // A command may have closed this client
+        if (m_clients.find(fd) == m_clients.end()) return;
+    }
+    client.input.erase(0, start);
+
+    if (eof) {
+        // Otherwise flushClient() closes it once the replies are out
+        client.inputClosed = true;
+        client.readWatcher->setEnabled(false);
+        if (client.output.empty()) closeClient(fd);
+        return;
+    }
+    if (client.input.size() > kMaxLineLength) {
+        LOG_WARN("ControlServer: client %d sent an overlong line, disconnecting", fd);
+        closeClient(fd);
+    }
+}
+
+void ControlServer::send(Client& client, const std::string& line)
+{
+    client.output += line;
+    client.output += '\n';
+    flushClient(client);
+}
+
+void ControlServer::flushClient(Client& client)
+{
+    while (!client.output.empty()) {
+        ssize_t n = ::send(client.fd, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+        if (n > 0) {
+            client.output.erase(0, size_t(n));
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            closeClient(client.fd);
+            return;
+        }
+    }
+    if (client.output.empty() && client.inputClosed) {
+        closeClient(client.fd);
+        return;
+    }
+    // Only watch for writability while something is waiting
+    client.writeWatcher->setEnabled(!client.output.empty());
+}
+
+void ControlServer::closeClient(int fd)
+{
+    auto it = m_clients.find(fd);
+    if (it == m_clients.end()) return;
+
+    // Notifiers may be mid-signal, so let the event loop delete them
+    Client& client = *it->second;
+    client.readWatcher->setEnabled(false);
+    client.readWatcher->deleteLater();
+    client.writeWatcher->setEnabled(false);
+    client.writeWatcher->deleteLater();
+    ::close(fd);
+    m_clients.erase(it);
+    LOG_DEBUG("ControlServer: client %d disconnected", fd);
+}
+
+void ControlServer::broadcast(const std::string& line)
+{
+    std::vector<int> fds;
+    for (const auto& entry : m_clients) {
+        fds.push_back(entry.first);
+    }
+    for (int fd : fds) {
+        auto it = m_clients.find(fd);
+        if (it != m_clients.end()) send(*it->second, line);
+    }
+}
+
+std::string ControlServer::handleCommand(const std::string& line)
+{
+    Json request;
+    std::string errorLine;
+    if (!parseControlRequest(line, request, errorLine)) return errorLine;
+
+    Json reply = { { "ok", true } };
+    if (request.contains("id")) reply["id"] = request["id"];
+    std::string cmd = request.is_object() && request.contains("cmd") && request["cmd"].is_string()
+                    ? request["cmd"].get<std::string>() : std::string();
+
+    try {
+        dispatchCommand(cmd, request, reply);
+    } catch (Json::exception& ex) {
+        reply["ok"] = false;
+        reply["error"] = std::string("bad arguments: ") + ex.what();
+    }
+    return controlLine(reply);
+}
+
+void ControlServer::dispatchCommand(const std::string& cmd, const Json& request, Json& reply)
+{
+    if (cmd == "join") {
+        std::string session = stringField(request, "session", m_defaults.session_name);
+        std::string token = stringField(request, "token", m_defaults.token);
+        if (session.empty() || token.empty()) {
+            reply["ok"] = false;
+            reply["error"] = "session and token are required";
+        } else if (!isVideoSDKReady()) {
+            reply["ok"] = false;
+            reply["error"] = "SDK still initializing";
+        } else {
+            m_joinRequestedNs = monotonicNs();
+            std::string userName = stringField(request, "user_name", m_defaults.user_name);
+            joinVideoSDKSession(QString::fromStdString(session),
+                                QString::fromStdString(stringField(request, "password", m_defaults.session_psw)),
+                                QString::fromStdString(token),
+                                userName.empty() ? QString("Linux Headless Bot") : QString::fromStdString(userName));
+            reply["pending"] = true;
+        }
+    } else if (cmd == "leave") {
+        m_joinRequestedNs = 0;
+        reply["was_in_session"] = g_in_session.load();
+        leaveVideoSDKSession();
+    } else if (cmd == "subscribe") {
+        std::string user = request.value("user", std::string());
+        int resolution = request.value("resolution", 360);
+        if (user.empty() || !setRemoteVideoSubscription(user, resolution)) {
+            reply["ok"] = false;
+            reply["error"] = "unknown user, unsupported resolution or not in session";
+        }
+    } else if (cmd == "subscriptions") {
+        SubscriptionPolicy::Config config = subscriptionPolicy().config();
+        Json users = Json::array();
+        int64_t nowNs = monotonicNs();
+        for (const SubscriptionDecision& decision : subscriptionPolicy().decisions()) {
+            users.push_back({ { "user", decision.user }, { "resolution", decision.lines },
+                              { "wanted", decision.wantedLines }, { "reason", decision.reason },
+                              { "pending", decision.pending },
+                              { "held_sec", decision.sinceNs ? (nowNs - decision.sinceNs) / 1e9 : 0.0 } });
+        }
+        reply["users"] = users;
+        Json watched = Json::array();
+        for (const StreamWatchdog::StreamReport& r : streamWatchdog().streams()) {
+            watched.push_back({ { "user", r.name }, { "active", r.active }, { "stalled", r.stalled },
+                                { "frames", r.frames }, { "stalls", r.stalls }, { "resubscribes", r.resubscribes },
+                                { "recoveries", r.recoveries }, { "since_last_frame_ms", r.sinceLastFrameMs },
+                                { "expected_interval_ms", r.expectedIntervalMs },
+                                { "last_recovery_ms", r.lastRecoveryMs }, { "mean_recovery_ms", r.meanRecoveryMs },
+                                { "max_recovery_ms", r.maxRecoveryMs } });
+        }
+        reply["stream_watchdog"] = watched;
+        reply["pixels_per_sec"] = subscriptionPolicy().subscribedPixelsPerSecond();
+        reply["pixel_budget"] = config.maxPixelsPerSecond;
+        reply["debounce_ms"] = config.debounceMs;
+    } else if (cmd == "analysis") {
+        Json results = Json::array();
+        int64_t nowNs = monotonicNs();
+        for (const AnalysisStore::Entry& entry : AnalysisStore::instance().snapshot()) {
+            const AnalysisResult& result = entry.result;
+            results.push_back({ { "stream", entry.stream }, { "analyzer", entry.analyzer },
+                                { "values", std::vector<float>(result.values, result.values + result.count) },
+                                { "age_ms", (nowNs - result.timestampNs) / 1e6 },
+                                { "elapsed_us", result.elapsedUs }, { "stride", result.stride },
+                                { "overruns", result.overruns } });
+        }
+        reply["results"] = results;
+    } else if (cmd == "transcript") {
+        std::shared_ptr<TranscriptLog> log = currentTranscriptLog();
+        if (!log) {
+            reply["ok"] = false;
+            reply["error"] = "no transcript log";
+        } else {
+            int64_t fromMs = request.value("from_ms", INT64_MIN);
+            int64_t toMs = request.value("to_ms", INT64_MAX);
+            Json segments = Json::array();
+            for (const TranscriptSegment& segment : log->query(fromMs, toMs, request.value("speaker", std::string()),
+                                                               request.value("limit", size_t(200)))) {
+                segments.push_back({ { "id", segment.messageId }, { "speaker", segment.speaker },
+                                     { "text", segment.text }, { "start_ms", segment.startMs },
+                                     { "updated_ms", segment.updatedMs },
+                                     { "final", segment.operation == TRANSCRIPT_OP_COMPLETE },
+                                     { "revisions", segment.revisions } });
+            }
+            TranscriptLog::Stats s = log->stats();
+            reply["segments"] = segments;
+            reply["speakers"] = log->speakers();
+            reply["path"] = log->path();
+            reply["log"] = { { "records", s.records }, { "committed_bytes", s.committedBytes },
+                             { "flushes", s.flushes }, { "records_per_flush", s.meanRecordsPerFlush },
+                             { "max_flush_ms", s.maxFlushMs }, { "drops", s.drops } };
+        }
+    } else if (cmd == "channel_send") {
+        std::string type = request.value("type", std::string());
+        if (type.empty()) {
+            reply["ok"] = false;
+            reply["error"] = "type is required";
+        } else if (!botCommandChannel().send(type, request.value("data", Json()), request.value("to", std::string()),
+                                             request.value("key", std::string()))) {
+            reply["ok"] = false;
+            reply["error"] = "message dropped";
+        }
+    } else if (cmd == "mute") {
+        if (request.contains("audio") && !setSelfAudioMuted(request["audio"].get<bool>())) {
+            reply["ok"] = false;
+            reply["error"] = "audio change failed";
+        }
+        if (request.contains("video") && !setSelfVideoOn(!request["video"].get<bool>())) {
+            reply["ok"] = false;
+            reply["error"] = "video change failed";
+        }
+        reply["audio_muted"] = g_audio_muted.load();
+        reply["video_muted"] = g_video_muted.load();
+    } else if (cmd == "share") {
+        if (request.contains("file")) virtualShareSource().setFile(request["file"].get<std::string>());
+        bool on = request.value("on", true);
+        if (!(on ? startVirtualShare() : stopVirtualShare())) {
+            reply["ok"] = false;
+            reply["error"] = on ? "share start failed" : "share stop failed";
+        }
+    } else if (cmd == "stats") {
+        EventBus::Stats bus = botEventBus().stats();
+        reply["in_session"] = g_in_session.load();
+        reply["join_pending"] = m_joinRequestedNs != 0;
+        reply["uptime_sec"] = (monotonicNs() - m_startNs) / 1e9;
+        reply["sessions_joined"] = m_sessionsJoined;
+        reply["join_latency_ms"] = { { "last", m_lastJoinMs }, { "min", m_minJoinMs }, { "max", m_maxJoinMs },
+                                     { "mean", m_sessionsJoined ? m_totalJoinMs / m_sessionsJoined : 0.0 } };
+        reply["event_bus"] = { { "posted", bus.posted }, { "dropped", bus.dropped }, { "depth", bus.depth },
+                               { "max_depth", bus.maxDepth }, { "mean_dwell_us", bus.meanDwellUs },
+                               { "max_dwell_us", bus.maxDwellUs } };
+        reply["memory"] = { { "budget_used", MemoryBudget::instance().used() },
+                            { "budget_limit", MemoryBudget::instance().limit() },
+                            { "rss_bytes", ResourceSampler::currentRssBytes() } };
+        Json workers = Json::array();
+        if (WorkStealingExecutor* executor = frameExecutorIfStarted()) {
+            for (const WorkStealingExecutor::WorkerStats& worker : executor->stats()) {
+                workers.push_back({ { "tasks", worker.tasks }, { "steals", worker.steals },
+                                    { "utilisation", worker.utilisation } });
+            }
+        }
+        reply["frame_workers"] = workers;
+        if (SnapshotService::instance().running()) {
+            SnapshotService::Stats snapshots = SnapshotService::instance().stats();
+            reply["snapshots"] = { { "written", snapshots.snapshots }, { "failures", snapshots.failures },
+                                   { "last_encode_ms", snapshots.lastEncodeMs },
+                                   { "mean_encode_ms", snapshots.meanEncodeMs },
+                                   { "max_encode_ms", snapshots.maxEncodeMs }, { "last_bytes", snapshots.lastBytes },
+                                   { "mean_bytes", snapshots.meanBytes } };
+        }
+        if (CommandChannel* started = botCommandChannelIfStarted()) {
+            CommandChannel::Stats channel = started->stats();
+            reply["command_channel"] = { { "connected", channel.connected }, { "sent", channel.sent },
+                                         { "commands", channel.commands }, { "per_command", channel.meanBatchMessages },
+                                         { "coalesced", channel.coalesced }, { "dropped", channel.dropped },
+                                         { "send_failures", channel.sendFailures }, { "depth", channel.queueDepth },
+                                         { "max_depth", channel.maxQueueDepth },
+                                         { "latency_ms", { { "mean", channel.meanSendLatencyMs },
+                                                           { "max", channel.maxSendLatencyMs } } },
+                                         { "received", channel.received }, { "unhandled", channel.unhandled },
+                                         { "parse_errors", channel.parseErrors },
+                                         { "inbound_dropped", channel.inboundDropped } };
+        }
+        if (VirtualShareSource* started = virtualShareSourceIfStarted()) {
+            VirtualShareSource::Stats share = started->stats();
+            if (share.submitted > 0) {
+                reply["virtual_share"] = { { "sending", share.sending }, { "width", share.width },
+                                           { "height", share.height }, { "images", share.submitted },
+                                           { "changed", share.converted },
+                                           { "unchanged", share.unchanged }, { "superseded", share.superseded },
+                                           { "sent", share.sent }, { "keepalives", share.keepalives },
+                                           { "bytes_sent", share.bytesSent }, { "file_loads", share.fileLoads },
+                                           { "dirty_fraction", share.meanDirtyFraction },
+                                           { "convert_us", { { "mean", share.meanConvertUs },
+                                                             { "max", share.maxConvertUs } } } };
+            }
+        }
+        reply["sdk_ready"] = isVideoSDKReady();
+        Json startup = Json::array();
+        for (const StartupProfiler::Phase& phase : StartupProfiler::phases()) {
+            startup.push_back({ { "phase", phase.name }, { "ms", phase.sinceStartMs }, { "tid", phase.threadId } });
+        }
+        reply["startup"] = startup;
+    } else {
+        reply["ok"] = false;
+        reply["error"] = cmd.empty() ? "missing cmd" : "unknown cmd: " + cmd;
+    }
+}
+
+void ControlServer::onSessionEvent(const BotEvent& event)
+{
+    Json message;
+    switch (event.type) {
+    case BOT_EVENT_SESSION_JOINED:
+        message["event"] = "joined";
+        if (m_joinRequestedNs != 0) {
+            double latencyMs = (event.postedNs - m_joinRequestedNs) / 1e6;
+            m_joinRequestedNs = 0;
+            m_sessionsJoined++;
+            m_lastJoinMs = latencyMs;
+            m_totalJoinMs += latencyMs;
+            if (m_sessionsJoined == 1 || latencyMs < m_minJoinMs) m_minJoinMs = latencyMs;
+            if (latencyMs > m_maxJoinMs) m_maxJoinMs = latencyMs;
+            message["join_latency_ms"] = latencyMs;
+            LOG_INFO("ControlServer: in session %.1f ms after join command", latencyMs);
+        }
+        break;
+    case BOT_EVENT_SESSION_LEFT:
+        message["event"] = "left";
+        message["reason"] = event.code;
+        break;
+    case BOT_EVENT_SESSION_ERROR:
+        m_joinRequestedNs = 0;
+        message["event"] = "error";
+        message["code"] = event.code;
+        message["detail"] = event.detail;
+        break;
+    default:
+        return;
+    }
+    broadcast(controlLine(message));
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "BotSession.h"
+#include "json.hpp"
+
+class SocketWatcher;
+struct BotEvent;
+
+// Local control socket for a warm-standby bot. The SDK stays initialized and
+// the process is reused across sessions; clients connect to a Unix domain
+// socket and send one JSON object per line:
+//
+//   {"cmd":"join", "session":..., "password":..., "token":..., "user_name":...}
+//   {"cmd":"leave"}
+//   {"cmd":"subscribe", "user":"alice", "resolution":360}   (0 = unsubscribe; overrides the policy)
+//   {"cmd":"subscriptions"}                                 (policy decisions, reasons and stream watchdog)
+//   {"cmd":"analysis"}                                      (latest frame analyzer results per stream)
+//   {"cmd":"transcript", "from_ms":..., "to_ms":..., "speaker":"alice", "limit":200}
+//                                                           (live transcription segments, all fields optional)
+//   {"cmd":"channel_send", "type":"note", "data":{...}, "to":"alice", "key":"k"}
+//                                                           (command channel; no "to" = everyone, "key" coalesces)
+//   {"cmd":"mute", "audio":true, "video":false}
+//   {"cmd":"share", "on":true, "file":"/tmp/dashboard.ppm"}  (virtual screen share; "file" optional)
+//   {"cmd":"stats"}                                         (includes the startup profile)
+//
+// Each command gets one JSON reply line ({"ok":true,...} or {"ok":false,
+// "error":...}, echoing "id" if given). Session events are pushed to every
+// client as {"event":"joined","join_latency_ms":...}, "left" and "error".
+// Everything runs on the Qt event loop thread via socket notifiers.
+class ControlServer
+{
+public:
+    ControlServer();
+    ~ControlServer();
+
+    // Fields missing from a join command fall back to these
+    void setJoinDefaults(const BotConfig& config) { m_defaults = config; }
+
+    bool listen(const std::string& path);
+    void close();
+
+    // Forwarded by the front end from dispatchBotEvents()
+    void onSessionEvent(const BotEvent& event);
+
+private:
+    struct Client
+    {
+        int fd = -1;
+        SocketWatcher* readWatcher = nullptr;
+        SocketWatcher* writeWatcher = nullptr;
+        std::string input;
+        std::string output;
+        bool inputClosed = false;  // peer shut down its side; closed once replies are flushed
+    };
+
+    void acceptClients();
+    void readClient(int fd);
+    void flushClient(Client& client);
+    void closeClient(int fd);
+    void send(Client& client, const std::string& line);
+    void broadcast(const std::string& line);
+    std::string handleCommand(const std::string& line);
+    void dispatchCommand(const std::string& cmd, const nlohmann::json& request, nlohmann::json& reply);
+
+    int m_listenFd;
+    std::string m_path;
+    SocketWatcher* m_listenWatcher;
+    std::map<int, std::unique_ptr<Client>> m_clients;
+    BotConfig m_defaults;
+
+    // Command-to-in-session latency
+    int64_t m_joinRequestedNs;  // 0 when no join is pending
+    uint64_t m_sessionsJoined;
+    double m_lastJoinMs;
+    double m_minJoinMs;
+    double m_maxJoinMs;
+    double m_totalJoinMs;
+    int64_t m_startNs;
+};
@@ -0,0 +1,156 @@
+#include "DeviceCache.h"
+#include "BotSession.h"
+#include "Logger.h"
+
+#include <unordered_map>
+
+#include "helpers/zoom_video_sdk_audio_helper_interface.h"
+#include "helpers/zoom_video_sdk_video_helper_interface.h"
+#include "zoom_video_sdk_interface.h"
+
+USING_ZOOM_VIDEO_SDK_NAMESPACE
+
+namespace {
+
+const char* kindName(DeviceKind kind)
+{
+    switch (kind) {
+    case DEVICE_CAMERA:     return "camera";
+    case DEVICE_MICROPHONE: return "microphone";
+    case DEVICE_SPEAKER:    return "speaker";
+    default:                return "device";
+    }
+}
+
+template <typename Device>
+void appendDevices(IVideoSDKVector<Device*>* list, std::vector<DeviceInfo>& out)
+{
+    int count = list->GetCount();
+    for (int i = 0; i < count; i++) {
+        Device* device = list->GetItem(i);
+        if (!device || !device->getDeviceId()) continue;
+        DeviceInfo info;
+        info.id = device->getDeviceId();
+        info.name = device->getDeviceName() ? device->getDeviceName() : info.id;
+        info.selected = device->isSelectedDevice();
+        out.push_back(std::move(info));
+    }
+}
+
+} // namespace
+
+DeviceCache& DeviceCache::instance()
+{
+    static DeviceCache cache;
+    return cache;
+}
+
+DeviceCache::DeviceCache()
+    : m_dirty(DEVICE_ALL)
+    , m_enumerations(0)
+{
+}
+
+int DeviceCache::index(DeviceKind kind)
+{
+    return kind == DEVICE_CAMERA ? 0 : kind == DEVICE_MICROPHONE ? 1 : 2;
+}
+
+void DeviceCache::markDirty(int kinds)
+{
+    m_dirty.fetch_or(kinds & DEVICE_ALL, std::memory_order_acq_rel);
+}
+
+bool DeviceCache::isDirty(DeviceKind kind) const
+{
+    return (m_dirty.load(std::memory_order_acquire) & kind) != 0;
+}
+
+const std::vector<DeviceInfo>& DeviceCache::devices(DeviceKind kind) const
+{
+    return m_lists[index(kind)];
+}
+
+void DeviceCache::reset()
+{
+    for (std::vector<DeviceInfo>& list : m_lists) {
+        list.clear();
+    }
+    m_dirty.store(DEVICE_ALL, std::memory_order_release);
+}
+
+DeviceDiff DeviceCache::refresh(DeviceKind kind)
+{
+    // Cleared before enumerating so a callback racing with it dirties again
+    int previous = m_dirty.fetch_and(~kind, std::memory_order_acq_rel);
+    if (!(previous & kind)) return DeviceDiff();
+
+    std::vector<DeviceInfo> current;
+    if (!enumerate(kind, current)) {
+        markDirty(kind);
+        return DeviceDiff();
+    }
+    m_enumerations++;
+
+    std::vector<DeviceInfo>& cached = m_lists[index(kind)];
+    DeviceDiff changes = diff(cached, current);
+    if (!changes.empty()) {
+        LOG_INFO("Devices: %s list +%zu -%zu ~%zu%s", kindName(kind), changes.added.size(), changes.removed.size(),
+                 changes.renamed.size(), changes.selectionChanged ? ", selection changed" : "");
+    }
+    cached.swap(current);
+    return changes;
+}
+
+DeviceDiff DeviceCache::diff(const std::vector<DeviceInfo>& before, const std::vector<DeviceInfo>& after)
+{
+    DeviceDiff changes;
+    std::unordered_map<std::string, const DeviceInfo*> old;
+    std::string oldSelected;
+    for (const DeviceInfo& device : before) {
+        old[device.id] = &device;
+        if (device.selected) oldSelected = device.id;
+    }
+
+    for (const DeviceInfo& device : after) {
+        if (device.selected) changes.selectedId = device.id;
+        auto it = old.find(device.id);
+        if (it == old.end()) {
+            changes.added.push_back(device);
+        } else {
+            if (it->second->name != device.name) changes.renamed.push_back(device);
+            old.erase(it);
+        }
+    }
+    for (const DeviceInfo& device : before) {
+        if (old.count(device.id)) changes.removed.push_back(device.id);
+    }
+    changes.selectionChanged = changes.selectedId != oldSelected;
+    return changes;
+}
+
+bool DeviceCache::enumerate(DeviceKind kind, std::vector<DeviceInfo>& out)
+{
+    if (!isVideoSDKReady()) return false;
+
+    if (kind == DEVICE_CAMERA) {
+        IZoomVideoSDKVideoHelper* videoHelper = video_sdk_obj->getVideoHelper();
+        IVideoSDKVector<IZoomVideoSDKCameraDevice*>* cameras = videoHelper ? videoHelper->getCameraList() : nullptr;
+        if (!cameras) return false;
+        appendDevices(cameras, out);
+        return true;
+    }
+
+    IZoomVideoSDKAudioHelper* audioHelper = video_sdk_obj->getAudioHelper();
+    if (!audioHelper) return false;
+    if (kind == DEVICE_MICROPHONE) {
+        IVideoSDKVector<IZoomVideoSDKMicDevice*>* mics = audioHelper->getMicList();
+        if (!mics) return false;
+        appendDevices(mics, out);
+    } else {
+        IVideoSDKVector<IZoomVideoSDKSpeakerDevice*>* speakers = audioHelper->getSpeakerList();
+        if (!speakers) return false;
+        appendDevices(speakers, out);
+    }
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum DeviceKind
+{
+    DEVICE_CAMERA = 1,
+    DEVICE_MICROPHONE = 2,
+    DEVICE_SPEAKER = 4,
+    DEVICE_ALL = DEVICE_CAMERA | DEVICE_MICROPHONE | DEVICE_SPEAKER,
+};
+
+struct DeviceInfo
+{
+    std::string id;
+    std::string name;
+    bool selected = false;  // the SDK's current device of this kind
+};
+
+// Changes between two enumerations of one device kind
+struct DeviceDiff
+{
+    std::vector<DeviceInfo> added;
+    std::vector<std::string> removed;  // ids
+    std::vector<DeviceInfo> renamed;   // same id, new name
+    std::string selectedId;            // the SDK's selection after the change, empty if none
+    bool selectionChanged = false;
+
+    bool empty() const { return added.empty() && removed.empty() && renamed.empty() && !selectionChanged; }
+};
+
+// Cached camera, microphone and speaker lists. The SDK is only asked again
+// for a kind after a hot-plug callback marked it dirty, and callers get the
+// difference to apply instead of a fresh list to rebuild from.
+class DeviceCache
+{
+public:
+    static DeviceCache& instance();
+
+    // Any thread (SDK device callbacks); kinds is a DeviceKind mask
+    void markDirty(int kinds);
+    bool isDirty(DeviceKind kind) const;
+
+    // Front end thread, SDK ready. Re-enumerates the kind if dirty and
+    // returns what changed; an empty diff if it was clean.
+    DeviceDiff refresh(DeviceKind kind);
+    const std::vector<DeviceInfo>& devices(DeviceKind kind) const;
+
+    // Drops the cached lists (SDK cleanup)
+    void reset();
+
+    uint64_t enumerations() const { return m_enumerations; }
+
+    static DeviceDiff diff(const std::vector<DeviceInfo>& before, const std::vector<DeviceInfo>& after);
+
+private:
+    DeviceCache();
+
+    static int index(DeviceKind kind);
+    static bool enumerate(DeviceKind kind, std::vector<DeviceInfo>& out);
+
+    std::vector<DeviceInfo> m_lists[3];
+    std::atomic<int> m_dirty;
+    uint64_t m_enumerations;
+};
@@ -0,0 +1,100 @@
+#include "EventBus.h"
+#include "Logger.h"
+
+#include <time.h>
+
+namespace {
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+} // namespace
+
+EventBus::EventBus(size_t capacity)
+    : m_queue(capacity)
+    , m_wakePending(false)
+    , m_posted(0)
+    , m_dropped(0)
+    , m_maxDepth(0)
+    , m_handled(0)
+    , m_batches(0)
+    , m_totalDwellNs(0)
+    , m_maxDwellNs(0)
+{
+}
+
+bool EventBus::post(BotEvent event)
+{
+    event.postedNs = monotonicNs();
+    if (!m_queue.tryPush(std::move(event))) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        LOG_RATE_LIMITED(LOG_LEVEL_WARN, 1000, "EventBus: queue full, dropping event");
+        return false;
+    }
+    m_posted.fetch_add(1, std::memory_order_relaxed);
+
+    size_t depth = m_queue.sizeApprox();
+    size_t maxDepth = m_maxDepth.load(std::memory_order_relaxed);
+    while (depth > maxDepth && !m_maxDepth.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed)) {
+    }
+
+    // Only the first post since the last drain wakes the consumer
+    if (!m_wakePending.exchange(true, std::memory_order_acq_rel) && m_wake) {
+        m_wake();
+    }
+    return true;
+}
+
+size_t EventBus::drain(const std::function<void(const BotEvent&)>& handler, size_t maxBatch)
+{
+    // Cleared first so a post racing with this drain schedules another one
+    m_wakePending.store(false, std::memory_order_release);
+
+    size_t count = 0;
+    BotEvent event;
+    while (count < maxBatch && m_queue.tryPop(event)) {
+        int64_t dwell = monotonicNs() - event.postedNs;
+        m_totalDwellNs.fetch_add(dwell, std::memory_order_relaxed);
+        if (dwell > m_maxDwellNs.load(std::memory_order_relaxed)) {
+            m_maxDwellNs.store(dwell, std::memory_order_relaxed);
+        }
+        handler(event);
+        count++;
+    }
+
+    if (count > 0) {
+        m_handled.fetch_add(count, std::memory_order_relaxed);
+        m_batches.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Leftovers from a capped batch need another pass
+    if (!empty() && !m_wakePending.exchange(true, std::memory_order_acq_rel) && m_wake) {
+        m_wake();
+    }
+    return count;
+}
+
+EventBus::Stats EventBus::stats() const
+{
+    Stats s;
+    s.posted = m_posted.load(std::memory_order_relaxed);
+    s.dropped = m_dropped.load(std::memory_order_relaxed);
+    s.handled = m_handled.load(std::memory_order_relaxed);
+    s.batches = m_batches.load(std::memory_order_relaxed);
+    s.depth = m_queue.sizeApprox();
+    s.maxDepth = m_maxDepth.load(std::memory_order_relaxed);
+    s.meanDwellUs = s.handled ? m_totalDwellNs.load(std::memory_order_relaxed) / 1000.0 / s.handled : 0.0;
+    s.maxDwellUs = m_maxDwellNs.load(std::memory_order_relaxed) / 1000.0;
+    return s;
+}
+
+void EventBus::report() const
+{
+    Stats s = stats();
+    LOG_INFO("Event bus: %llu posted, %llu handled in %llu batches, %llu dropped, depth %zu (max %zu), dwell mean %.1f us max %.1f us",
+             (unsigned long long)s.posted, (unsigned long long)s.handled, (unsigned long long)s.batches,
+             (unsigned long long)s.dropped, s.depth, s.maxDepth, s.meanDwellUs, s.maxDwellUs);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "MpscQueue.h"
+
+// Typed events posted by SDK delegate callbacks for the front end
+enum BotEventType
+{
+    BOT_EVENT_NONE = 0,
+    BOT_EVENT_STATUS_MESSAGE,   // text
+    BOT_EVENT_SESSION_JOINED,
+    BOT_EVENT_SESSION_LEFT,     // code = leave reason, -1 if unknown
+    BOT_EVENT_SESSION_ERROR,    // code = SDK error, detail = detail code
+    BOT_EVENT_SDK_READY,        // code = 1 if initialization succeeded, 0 if it failed
+    BOT_EVENT_DEVICES_CHANGED,  // code = DeviceKind mask of lists to refresh
+};
+
+struct BotEvent
+{
+    BotEventType type = BOT_EVENT_NONE;
+    int code = 0;
+    int detail = 0;
+    std::string text;
+    int64_t postedNs = 0;  // set by EventBus::post
+};
+
+// Hands events from SDK threads to the front end's thread without blocking
+// either side. Producers push into a lock-free MPSC queue and return; the
+// first post after a drain calls the wake handler so the consumer schedules
+// a drain on its own thread, where events are handled in batches.
+class EventBus
+{
+public:
+    struct Stats
+    {
+        uint64_t posted;
+        uint64_t dropped;     // queue full
+        uint64_t handled;
+        uint64_t batches;
+        size_t depth;
+        size_t maxDepth;
+        double meanDwellUs;   // post to handling
+        double maxDwellUs;
+    };
+
+    explicit EventBus(size_t capacity = 1024);
+
+    // Set before any event is posted; called on the posting thread
+    void setWakeHandler(std::function<void()> wake) { m_wake = std::move(wake); }
+
+    // Any thread; never blocks. Returns false if the event was dropped.
+    bool post(BotEvent event);
+
+    // Consumer thread: handles up to maxBatch events, returns how many
+    size_t drain(const std::function<void(const BotEvent&)>& handler, size_t maxBatch);
+
+    bool empty() const { return m_queue.sizeApprox() == 0; }
+
+    Stats stats() const;
+    void report() const;
+
+private:
+    BoundedMpscQueue<BotEvent> m_queue;
+    std::function<void()> m_wake;
+    std::atomic<bool> m_wakePending;
+
+    std::atomic<uint64_t> m_posted;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<size_t> m_maxDepth;
+    // Written by the consumer only
+    std::atomic<uint64_t> m_handled;
+    std::atomic<uint64_t> m_batches;
+    std::atomic<int64_t> m_totalDwellNs;
+    std::atomic<int64_t> m_maxDwellNs;
+};
@@ -0,0 +1,174 @@
+#include "FrameAnalysis.h"
+#include "Logger.h"
+
+#include <string.h>
+#include <time.h>
+
+namespace {
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+const uint32_t kMaxStride = 64;
+
+} // namespace
+
+AnalysisStore::Slot::Slot()
+    : m_sequence(0)
+    , m_inUse(false)
+{
+    for (std::atomic<uint32_t>& word : m_words) word.store(0, std::memory_order_relaxed);
+}
+
+void AnalysisStore::Slot::store(const AnalysisResult& result)
+{
+    uint32_t words[kWords];
+    memcpy(words, &result, sizeof(words));
+
+    // Odd while writing; the fence keeps the word stores after it
+    uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kWords; i++) m_words[i].store(words[i], std::memory_order_relaxed);
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool AnalysisStore::Slot::load(AnalysisResult& result) const
+{
+    uint32_t words[kWords];
+    for (;;) {
+        uint32_t before = m_sequence.load(std::memory_order_acquire);
+        if (before == 0) return false;
+        if (before & 1) continue;
+        for (size_t i = 0; i < kWords; i++) words[i] = m_words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) == before) break;
+    }
+    memcpy(&result, words, sizeof(words));
+    return true;
+}
+
+AnalysisStore& AnalysisStore::instance()
+{
+    static AnalysisStore store;
+    return store;
+}
+
+AnalysisStore::Slot* AnalysisStore::allocate(const std::string& stream, const std::string& analyzer)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Slot* slot = nullptr;
+    for (const std::unique_ptr<Slot>& candidate : m_slots) {
+        if (!candidate->m_inUse) {
+            slot = candidate.get();
+            break;
+        }
+    }
+    if (!slot) {
+        m_slots.push_back(std::unique_ptr<Slot>(new Slot));
+        slot = m_slots.back().get();
+    }
+    // Reused slots start empty again; nobody writes a free slot
+    slot->m_sequence.store(0, std::memory_order_relaxed);
+    slot->m_stream = stream;
+    slot->m_analyzer = analyzer;
+    slot->m_inUse = true;
+    return slot;
+}
+
+void AnalysisStore::release(Slot* slot)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    slot->m_inUse = false;
+}
+
+std::vector<AnalysisStore::Entry> AnalysisStore::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Entry> entries;
+    for (const std::unique_ptr<Slot>& slot : m_slots) {
+        Entry entry;
+        if (!slot->m_inUse || !slot->load(entry.result)) continue;
+        entry.stream = slot->m_stream;
+        entry.analyzer = slot->m_analyzer;
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+FrameAnalysisStage::FrameAnalysisStage(const std::string& streamName,
+                                       std::vector<std::unique_ptr<IFrameAnalyzer>> analyzers, const Config& config)
+    : m_streamName(streamName)
+    , m_config(config)
+    , m_intervalNs(config.sampleFps > 0 ? int64_t(1e9 / config.sampleFps) : 0)
+    , m_lastSampleNs(0)
+{
+    for (std::unique_ptr<IFrameAnalyzer>& analyzer : analyzers) {
+        Plugin plugin;
+        plugin.slot = AnalysisStore::instance().allocate(streamName, analyzer->name());
+        plugin.analyzer = std::move(analyzer);
+        m_plugins.push_back(std::move(plugin));
+    }
+}
+
+FrameAnalysisStage::~FrameAnalysisStage()
+{
+    for (Plugin& plugin : m_plugins) {
+        if (plugin.overruns > 0) {
+            LOG_INFO("FrameAnalysisStage %s: %s went over its %d us budget %u times (stride %u)",
+                     m_streamName.c_str(), plugin.analyzer->name(), m_config.budgetUs, plugin.overruns, plugin.stride);
+        }
+        AnalysisStore::instance().release(plugin.slot);
+    }
+}
+
+void FrameAnalysisStage::onHubFrame(const HubFrame& frame)
+{
+    int64_t now = monotonicNs();
+    if (m_lastSampleNs != 0 && now - m_lastSampleNs < m_intervalNs) return;
+    m_lastSampleNs = now;
+
+    // Chroma is only handed to analyzers that asked for it
+    I420Frame lumaOnly = *frame.source;
+    lumaOnly.u = nullptr;
+    lumaOnly.v = nullptr;
+    lumaOnly.uStride = 0;
+    lumaOnly.vStride = 0;
+    lumaOnly.a = nullptr;
+    lumaOnly.aStride = 0;
+
+    int64_t budgetNs = int64_t(m_config.budgetUs) * 1000;
+    for (Plugin& plugin : m_plugins) {
+        if (plugin.countdown > 0) {
+            plugin.countdown--;
+            continue;
+        }
+
+        AnalysisResult result;
+        int64_t start = monotonicNs();
+        plugin.analyzer->analyze(plugin.analyzer->wantsChroma() ? *frame.source : lumaOnly, result);
+        int64_t elapsed = monotonicNs() - start;
+
+        if (elapsed > budgetNs) {
+            plugin.overruns++;
+            if (plugin.stride < kMaxStride) plugin.stride *= 2;
+            LOG_RATE_LIMITED(LOG_LEVEL_WARN, 10000, "FrameAnalysisStage %s: %s took %.0f us (budget %d us), stride %u",
+                             m_streamName.c_str(), plugin.analyzer->name(), elapsed / 1e3, m_config.budgetUs,
+                             plugin.stride);
+        } else if (elapsed * 2 < budgetNs && plugin.stride > 1) {
+            plugin.stride /= 2;
+        }
+        plugin.countdown = plugin.stride - 1;
+
+        result.frameSequence = frame.sequence;
+        result.timestampNs = start;
+        result.elapsedUs = float(elapsed / 1e3);
+        result.stride = plugin.stride;
+        result.overruns = plugin.overruns;
+        plugin.slot->store(result);
+    }
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "FrameHub.h"
+
+const int kMaxAnalysisValues = 20;
+
+// One analyzer's output for one frame. The meaning of values[] is fixed per
+// analyzer (see LumaAnalyzers.h).
+struct AnalysisResult
+{
+    uint64_t frameSequence = 0;  // hub sequence of the analysed frame
+    int64_t timestampNs = 0;     // CLOCK_MONOTONIC when it was analysed
+    float elapsedUs = 0.0f;      // time the analyzer took
+    uint32_t stride = 1;         // analysing every stride-th sample (raised when over budget)
+    uint32_t overruns = 0;       // samples that took longer than the budget
+    int32_t count = 0;
+    float values[kMaxAnalysisValues] = {};
+};
+
+// Plugin run on sampled frames before any RGB conversion. The frame is the
+// stream's native I420; u and v are null unless wantsChroma() says otherwise.
+// Called on a frame worker, never concurrently for one instance.
+class IFrameAnalyzer
+{
+public:
+    virtual ~IFrameAnalyzer() {}
+    virtual const char* name() const = 0;
+    virtual bool wantsChroma() const { return false; }
+    // Fills result.count and result.values
+    virtual void analyze(const I420Frame& frame, AnalysisResult& result) = 0;
+};
+
+// Latest result per stream and analyzer. Publishing is a seqlock write into
+// the slot (no lock, never waits for readers); readers retry while a write
+// is in progress. Only slot allocation, rare, takes the registry mutex.
+class AnalysisStore
+{
+public:
+    struct Entry
+    {
+        std::string stream;
+        std::string analyzer;
+        AnalysisResult result;
+    };
+
+    class Slot
+    {
+    public:
+        Slot();
+        // One writer at a time
+        void store(const AnalysisResult& result);
+        // False if nothing was published yet
+        bool load(AnalysisResult& result) const;
+
+    private:
+        friend class AnalysisStore;
+        static_assert(std::is_trivially_copyable<AnalysisResult>::value, "slot copies results word by word");
+        static_assert(sizeof(AnalysisResult) % sizeof(uint32_t) == 0, "slot copies results word by word");
+        static const size_t kWords = sizeof(AnalysisResult) / sizeof(uint32_t);
+
+        std::atomic<uint32_t> m_sequence;
+        std::atomic<uint32_t> m_words[kWords];
+        std::string m_stream;
+        std::string m_analyzer;
+        bool m_inUse;
+    };
+
+    static AnalysisStore& instance();
+
+    Slot* allocate(const std::string& stream, const std::string& analyzer);
+    void release(Slot* slot);
+
+    // Latest result of every slot that has published one
+    std::vector<Entry> snapshot() const;
+
+private:
+    AnalysisStore() {}
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Slot>> m_slots;  // never shrinks; slots are reused
+};
+
+// Runs analyzers on one stream. Subscribed to the stream's hub at the native
+// I420 variant, so analyzers read the planes in place with no copy or
+// conversion; remote hubs deliver on the stream's frame executor strand, so
+// this runs on the worker pool. Frames are sampled at most sampleFps times a
+// second. An analyzer that takes longer than budgetUs gets its stride
+// doubled (it then runs on every 2nd, 4th, ... sample) and is halved back
+// once it is comfortably under budget.
+class FrameAnalysisStage : public IFrameHubSink
+{
+public:
+    struct Config
+    {
+        double sampleFps = 2.0;
+        int budgetUs = 2000;
+    };
+
+    FrameAnalysisStage(const std::string& streamName, std::vector<std::unique_ptr<IFrameAnalyzer>> analyzers,
+                       const Config& config);
+    ~FrameAnalysisStage();
+
+    FrameAnalysisStage(const FrameAnalysisStage&) = delete;
+    FrameAnalysisStage& operator=(const FrameAnalysisStage&) = delete;
+
+    static FrameVariant variant()
+    {
+        FrameVariant v;
+        v.format = FRAME_FORMAT_I420;
+        return v;
+    }
+
+    // IFrameHubSink
+    void onHubFrame(const HubFrame& frame) override;
+
+private:
+    struct Plugin
+    {
+        std::unique_ptr<IFrameAnalyzer> analyzer;
+        AnalysisStore::Slot* slot = nullptr;
+        uint32_t stride = 1;
+        uint32_t countdown = 0;  // samples to skip before the next run
+        uint32_t overruns = 0;
+    };
+
+    std::string m_streamName;
+    Config m_config;
+    int64_t m_intervalNs;
+    int64_t m_lastSampleNs;
+    std::vector<Plugin> m_plugins;
+};
@@ -0,0 +1,379 @@
+#include "FrameConvert.h"
+
+#include <vector>
+
+namespace {
+
+constexpr int roundToInt(double value)
+{
+    return value < 0 ? int(value - 0.5) : int(value + 0.5);
+}
+
+// 8.8 fixed-point YCbCr to RGB coefficients, derived from the luma weights
+// Kr and Kb of the matrix and the code range. Everything is evaluated by the
+// compiler; the kernels only see integer constants.
+template <ColorMatrix Matrix, ColorRange Range>
+struct YuvCoefficients
+{
+    static constexpr double kr = Matrix == COLOR_MATRIX_BT709 ? 0.2126 : 0.299;
+    static constexpr double kb = Matrix == COLOR_MATRIX_BT709 ? 0.0722 : 0.114;
+    static constexpr double kg = 1.0 - kr - kb;
+    static constexpr double yGain = Range == COLOR_RANGE_LIMITED ? 255.0 / 219.0 : 1.0;
+    static constexpr double cGain = Range == COLOR_RANGE_LIMITED ? 255.0 / 224.0 : 1.0;
+
+    static constexpr int yOffset = Range == COLOR_RANGE_LIMITED ? 16 : 0;
+    static constexpr int y = roundToInt(256 * yGain);
+    static constexpr int rv = roundToInt(256 * cGain * 2 * (1 - kr));
+    static constexpr int gu = roundToInt(256 * cGain * 2 * kb * (1 - kb) / kg);
+    static constexpr int gv = roundToInt(256 * cGain * 2 * kr * (1 - kr) / kg);
+    static constexpr int bu = roundToInt(256 * cGain * 2 * (1 - kb));
+};
+
+// The historical integer BT.601 limited-range constants
+static_assert(YuvCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED>::y == 298, "BT.601 Y gain");
+static_assert(YuvCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED>::rv == 409, "BT.601 Cr to R");
+static_assert(YuvCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED>::gu == 100, "BT.601 Cb to G");
+static_assert(YuvCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED>::gv == 208, "BT.601 Cr to G");
+static_assert(YuvCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED>::bu == 516, "BT.601 Cb to B");
+
+// 8.8 fixed-point RGB to YCbCr coefficients, the inverse of the above. The
+// Y weights sum to exactly the luma gain and each chroma row to 0, so grey
+// stays grey. 8-bit weights keep every product and sum within 16 bits, which
+// lets the vectoriser use 16-bit lanes (twice as many, and plain SSE2
+// multiplies) instead of 32-bit ones.
+template <ColorMatrix Matrix, ColorRange Range>
+struct RgbCoefficients
+{
+    static constexpr double kr = YuvCoefficients<Matrix, Range>::kr;
+    static constexpr double kb = YuvCoefficients<Matrix, Range>::kb;
+    static constexpr double kg = 1.0 - kr - kb;
+    static constexpr double yGain = Range == COLOR_RANGE_LIMITED ? 219.0 / 255.0 : 1.0;
+    static constexpr double cGain = Range == COLOR_RANGE_LIMITED ? 224.0 / 255.0 : 1.0;
+
+    // Offsets include the rounding; chroma's is one short of a half so that
+    // the largest value, 255.5 for full-range blue, still fits
+    static constexpr int yOffset = ((Range == COLOR_RANGE_LIMITED ? 16 : 0) << 8) + 128;
+    static constexpr int yr = roundToInt(256 * yGain * kr);
+    static constexpr int yb = roundToInt(256 * yGain * kb);
+    static constexpr int yg = roundToInt(256 * yGain) - yr - yb;
+
+    static constexpr int cOffset = (128 << 8) + 127;
+    static constexpr int ur = roundToInt(-256 * cGain * kr / (2 * (1 - kb)));
+    static constexpr int ub = roundToInt(256 * cGain / 2);
+    static constexpr int ug = -ur - ub;
+    static constexpr int vr = ub;
+    static constexpr int vb = roundToInt(-256 * cGain * kb / (2 * (1 - kr)));
+    static constexpr int vg = -vr - vb;
+};
+
+// The usual integer BT.601 full-range weights
+static_assert(RgbCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_FULL>::yr == 77, "BT.601 R to Y");
+static_assert(RgbCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_FULL>::yg == 150, "BT.601 G to Y");
+static_assert(RgbCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_FULL>::yb == 29, "BT.601 B to Y");
+
+inline uint8_t clampToByte(int value)
+{
+    return value < 0 ? 0 : (value > 255 ? 255 : uint8_t(value));
+}
+
+template <typename C>
+inline uint32_t yuvToRGB32(int yValue, int d, int e)
+{
+    int c = (yValue - C::yOffset) * C::y + 128;
+    int r = (c + C::rv * e) >> 8;
+    int g = (c - C::gu * d - C::gv * e) >> 8;
+    int b = (c + C::bu * d) >> 8;
+    return 0xFF000000u | (uint32_t(clampToByte(r)) << 16) | (uint32_t(clampToByte(g)) << 8) | clampToByte(b);
+}
+
+// Premultiplied: each colour channel scaled by alpha / 255, rounded, using
+// shifts instead of a division so the loop stays vectorisable
+template <typename C>
+inline uint32_t yuvaToPremultiplied(int yValue, int d, int e, uint32_t alpha)
+{
+    int c = (yValue - C::yOffset) * C::y + 128;
+    uint32_t r = clampToByte((c + C::rv * e) >> 8) * alpha + 128;
+    uint32_t g = clampToByte((c - C::gu * d - C::gv * e) >> 8) * alpha + 128;
+    uint32_t b = clampToByte((c + C::bu * d) >> 8) * alpha + 128;
+    r = (r + (r >> 8)) >> 8;
+    g = (g + (g >> 8)) >> 8;
+    b = (b + (b >> 8)) >> 8;
+    return (alpha << 24) | (r << 16) | (g << 8) | b;
+}
+
+// Source column for every destination column (16.16 fixed point stepping)
+void buildColumnMap(int srcWidth, int dstWidth, std::vector<int>& map)
+{
+    map.resize(dstWidth);
+    uint32_t step = (uint32_t(srcWidth) << 16) / uint32_t(dstWidth);
+    uint32_t pos = 0;
+    for (int x = 0; x < dstWidth; x++, pos += step) {
+        map[x] = int(pos >> 16);
+    }
+}
+
+// 1:1 output: each chroma sample is loaded once for its two pixels
+template <ColorMatrix Matrix, ColorRange Range>
+void i420ToRGB32(const I420Frame& src, uint8_t* dst, int dstStride, int dstWidth, int dstHeight)
+{
+    typedef YuvCoefficients<Matrix, Range> C;
+    int width = dstWidth < src.width ? dstWidth : src.width;
+    int height = dstHeight < src.height ? dstHeight : src.height;
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* yRow = src.y + int64_t(y) * src.yStride;
+        const uint8_t* uRow = src.u + int64_t(y / 2) * src.uStride;
+        const uint8_t* vRow = src.v + int64_t(y / 2) * src.vStride;
+        uint32_t* row = reinterpret_cast<uint32_t*>(dst + int64_t(y) * dstStride);
+
+        int x = 0;
+        for (; x + 1 < width; x += 2) {
+            int d = uRow[x / 2] - 128;
+            int e = vRow[x / 2] - 128;
+            row[x] = yuvToRGB32<C>(yRow[x], d, e);
+            row[x + 1] = yuvToRGB32<C>(yRow[x + 1], d, e);
+        }
+        if (x < width) {
+            row[x] = yuvToRGB32<C>(yRow[x], uRow[x / 2] - 128, vRow[x / 2] - 128);
+        }
+    }
+}
+
+// Scaled output, nearest neighbour
+template <ColorMatrix Matrix, ColorRange Range>
+void i420ToRGB32Scaled(const I420Frame& src, uint8_t* dst, int dstStride, int dstWidth, int dstHeight)
+{
+    typedef YuvCoefficients<Matrix, Range> C;
+
+    // Reused per thread; only grows when a wider variant appears
+    thread_local std::vector<int> columns;
+    buildColumnMap(src.width, dstWidth, columns);
+
+    for (int y = 0; y < dstHeight; y++) {
+        int sy = int(int64_t(y) * src.height / dstHeight);
+        const uint8_t* yRow = src.y + int64_t(sy) * src.yStride;
+        const uint8_t* uRow = src.u + int64_t(sy / 2) * src.uStride;
+        const uint8_t* vRow = src.v + int64_t(sy / 2) * src.vStride;
+        uint32_t* row = reinterpret_cast<uint32_t*>(dst + int64_t(y) * dstStride);
+
+        for (int x = 0; x < dstWidth; x++) {
+            int sx = columns[x];
+            row[x] = yuvToRGB32<C>(yRow[sx], uRow[sx / 2] - 128, vRow[sx / 2] - 128);
+        }
+    }
+}
+
+// I420 plus alpha plane to premultiplied ARGB32; Scaled picks nearest-neighbour
+// sampling at compile time
+template <ColorMatrix Matrix, ColorRange Range, bool Scaled>
+void i420AlphaToARGB32(const I420Frame& src, uint8_t* dst, int dstStride, int dstWidth, int dstHeight)
+{
+    typedef YuvCoefficients<Matrix, Range> C;
+
+    thread_local std::vector<int> columns;
+    if (Scaled) {
+        buildColumnMap(src.width, dstWidth, columns);
+    } else {
+        dstWidth = dstWidth < src.width ? dstWidth : src.width;
+        dstHeight = dstHeight < src.height ? dstHeight : src.height;
+    }
+
+    for (int y = 0; y < dstHeight; y++) {
+        int sy = Scaled ? int(int64_t(y) * src.height / dstHeight) : y;
+        const uint8_t* yRow = src.y + int64_t(sy) * src.yStride;
+        const uint8_t* uRow = src.u + int64_t(sy / 2) * src.uStride;
+        const uint8_t* vRow = src.v + int64_t(sy / 2) * src.vStride;
+        const uint8_t* aRow = src.a + int64_t(sy) * src.aStride;
+        uint32_t* row = reinterpret_cast<uint32_t*>(dst + int64_t(y) * dstStride);
+
+        for (int x = 0; x < dstWidth; x++) {
+            int sx = Scaled ? columns[x] : x;
+            row[x] = yuvaToPremultiplied<C>(yRow[sx], uRow[sx / 2] - 128, vRow[sx / 2] - 128, aRow[sx]);
+        }
+    }
+}
+
+// [matrix][range][scaled]
+const I420ToRGB32Kernel kKernels[2][2][2] = {
+    { { i420ToRGB32<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED>, i420ToRGB32Scaled<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED> },
+      { i420ToRGB32<COLOR_MATRIX_BT601, COLOR_RANGE_FULL>, i420ToRGB32Scaled<COLOR_MATRIX_BT601, COLOR_RANGE_FULL> } },
+    { { i420ToRGB32<COLOR_MATRIX_BT709, COLOR_RANGE_LIMITED>, i420ToRGB32Scaled<COLOR_MATRIX_BT709, COLOR_RANGE_LIMITED> },
+      { i420ToRGB32<COLOR_MATRIX_BT709, COLOR_RANGE_FULL>, i420ToRGB32Scaled<COLOR_MATRIX_BT709, COLOR_RANGE_FULL> } },
+};
+
+const I420ToRGB32Kernel kAlphaKernels[2][2][2] = {
+    { { i420AlphaToARGB32<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED, false>, i420AlphaToARGB32<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED, true> },
+      { i420AlphaToARGB32<COLOR_MATRIX_BT601, COLOR_RANGE_FULL, false>, i420AlphaToARGB32<COLOR_MATRIX_BT601, COLOR_RANGE_FULL, true> } },
+    { { i420AlphaToARGB32<COLOR_MATRIX_BT709, COLOR_RANGE_LIMITED, false>, i420AlphaToARGB32<COLOR_MATRIX_BT709, COLOR_RANGE_LIMITED, true> },
+      { i420AlphaToARGB32<COLOR_MATRIX_BT709, COLOR_RANGE_FULL, false>, i420AlphaToARGB32<COLOR_MATRIX_BT709, COLOR_RANGE_FULL, true> } },
+};
+
+inline uint16_t red(uint32_t pixel) { return uint16_t((pixel >> 16) & 0xFF); }
+inline uint16_t green(uint32_t pixel) { return uint16_t((pixel >> 8) & 0xFF); }
+inline uint16_t blue(uint32_t pixel) { return uint16_t(pixel & 0xFF); }
+
+// All arithmetic wraps at 16 bits; the true results lie in 0-65535
+template <typename C>
+inline void rgb32ToLumaRow(const uint32_t* src, uint8_t* dst, int width)
+{
+    for (int x = 0; x < width; x++) {
+        uint32_t p = src[x];
+        uint16_t sum = uint16_t(C::yr * red(p)) + uint16_t(C::yg * green(p)) + uint16_t(C::yb * blue(p));
+        dst[x] = uint8_t(uint16_t(sum + C::yOffset) >> 8);
+    }
+}
+
+// r, g, b are the block's averages; negative weights wrap and cancel out
+template <typename C>
+inline void blockToChroma(uint16_t r, uint16_t g, uint16_t b, uint8_t& u, uint8_t& v)
+{
+    uint16_t uSum = uint16_t(C::ur * r) + uint16_t(C::ug * g) + uint16_t(C::ub * b);
+    uint16_t vSum = uint16_t(C::vr * r) + uint16_t(C::vg * g) + uint16_t(C::vb * b);
+    u = uint8_t(uint16_t(uSum + C::cOffset) >> 8);
+    v = uint8_t(uint16_t(vSum + C::cOffset) >> 8);
+}
+
+// Straight loops over whole rows, no lookups or branches per pixel, so the
+// compiler vectorises them (see CMakeLists.txt)
+template <ColorMatrix Matrix, ColorRange Range>
+void rgb32ToI420(const uint8_t* src, int srcStride, const I420Frame& dst)
+{
+    typedef RgbCoefficients<Matrix, Range> C;
+    int width = dst.width;
+    int pairs = width / 2;
+
+    for (int y = 0; y < dst.height; y += 2) {
+        const uint32_t* top = reinterpret_cast<const uint32_t*>(src + int64_t(y) * srcStride);
+        // An odd last row stands in for the row below it
+        bool hasBottom = y + 1 < dst.height;
+        const uint32_t* bottom = hasBottom ? reinterpret_cast<const uint32_t*>(src + int64_t(y + 1) * srcStride) : top;
+
+        rgb32ToLumaRow<C>(top, const_cast<uint8_t*>(dst.y) + int64_t(y) * dst.yStride, width);
+        if (hasBottom) rgb32ToLumaRow<C>(bottom, const_cast<uint8_t*>(dst.y) + int64_t(y + 1) * dst.yStride, width);
+
+        uint8_t* uRow = const_cast<uint8_t*>(dst.u) + int64_t(y / 2) * dst.uStride;
+        uint8_t* vRow = const_cast<uint8_t*>(dst.v) + int64_t(y / 2) * dst.vStride;
+        for (int x = 0; x < pairs; x++) {
+            uint32_t a = top[2 * x], b = top[2 * x + 1], c = bottom[2 * x], d = bottom[2 * x + 1];
+            uint16_t r = uint16_t(red(a) + red(b) + red(c) + red(d) + 2) >> 2;
+            uint16_t g = uint16_t(green(a) + green(b) + green(c) + green(d) + 2) >> 2;
+            uint16_t bl = uint16_t(blue(a) + blue(b) + blue(c) + blue(d) + 2) >> 2;
+            blockToChroma<C>(r, g, bl, uRow[x], vRow[x]);
+        }
+        if (width & 1) {
+            uint32_t a = top[width - 1], c = bottom[width - 1];
+            blockToChroma<C>(uint16_t(red(a) + red(c) + 1) >> 1, uint16_t(green(a) + green(c) + 1) >> 1,
+                             uint16_t(blue(a) + blue(c) + 1) >> 1, uRow[pairs], vRow[pairs]);
+        }
+    }
+}
+
+typedef void (*RGB32ToI420Kernel)(const uint8_t* src, int srcStride, const I420Frame& dst);
+
+// [matrix][range]
+const RGB32ToI420Kernel kRgbKernels[2][2] = {
+    { rgb32ToI420<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED>, rgb32ToI420<COLOR_MATRIX_BT601, COLOR_RANGE_FULL> },
+    { rgb32ToI420<COLOR_MATRIX_BT709, COLOR_RANGE_LIMITED>, rgb32ToI420<COLOR_MATRIX_BT709, COLOR_RANGE_FULL> },
+};
+
+ColorMatrix resolveMatrix(ColorMatrix matrix, int srcHeight)
+{
+    if (matrix != COLOR_MATRIX_AUTO) return matrix;
+    return srcHeight >= 720 ? COLOR_MATRIX_BT709 : COLOR_MATRIX_BT601;
+}
+
+void scalePlane(const uint8_t* src, int srcStride, int srcWidth, int srcHeight,
+                uint8_t* dst, int dstStride, int dstWidth, int dstHeight)
+{
+    thread_local std::vector<int> columns;
+    buildColumnMap(srcWidth, dstWidth, columns);
+    for (int y = 0; y < dstHeight; y++) {
+        const uint8_t* srcRow = src + (int64_t(y) * srcHeight / dstHeight) * srcStride;
+        uint8_t* dstRow = dst + int64_t(y) * dstStride;
+        for (int x = 0; x < dstWidth; x++) {
+            dstRow[x] = srcRow[columns[x]];
+        }
+    }
+}
+
+} // namespace
+
+bool parseColorSpace(const std::string& text, ColorSpace& out)
+{
+    ColorSpace space;
+    std::string matrix = text;
+    size_t dash = text.find('-');
+    if (dash != std::string::npos) {
+        matrix = text.substr(0, dash);
+        std::string range = text.substr(dash + 1);
+        if (range == "full") {
+            space.range = COLOR_RANGE_FULL;
+        } else if (range != "limited") {
+            return false;
+        }
+    }
+
+    if (matrix == "auto") {
+        space.matrix = COLOR_MATRIX_AUTO;
+    } else if (matrix == "bt601") {
+        space.matrix = COLOR_MATRIX_BT601;
+    } else if (matrix == "bt709") {
+        space.matrix = COLOR_MATRIX_BT709;
+    } else {
+        return false;
+    }
+    out = space;
+    return true;
+}
+
+const char* colorSpaceName(ColorSpace space)
+{
+    bool full = space.range == COLOR_RANGE_FULL;
+    switch (space.matrix) {
+    case COLOR_MATRIX_BT601: return full ? "bt601-full" : "bt601";
+    case COLOR_MATRIX_BT709: return full ? "bt709-full" : "bt709";
+    default:                 return full ? "auto-full" : "auto";
+    }
+}
+
+I420ToRGB32Kernel selectI420ToRGB32(ColorSpace space, int srcHeight, bool scaled)
+{
+    ColorMatrix matrix = resolveMatrix(space.matrix, srcHeight);
+    return kKernels[matrix == COLOR_MATRIX_BT709][space.range == COLOR_RANGE_FULL][scaled];
+}
+
+I420ToRGB32Kernel selectI420ToARGB32Premultiplied(ColorSpace space, int srcHeight, bool scaled, bool hasAlpha)
+{
+    if (!hasAlpha) return selectI420ToRGB32(space, srcHeight, scaled);
+    ColorMatrix matrix = resolveMatrix(space.matrix, srcHeight);
+    return kAlphaKernels[matrix == COLOR_MATRIX_BT709][space.range == COLOR_RANGE_FULL][scaled];
+}
+
+void convertI420ToRGB32(const I420Frame& src, uint8_t* dst, int dstStride, int dstWidth, int dstHeight,
+                        ColorSpace space)
+{
+    if (dstWidth <= 0 || dstHeight <= 0 || src.width <= 0 || src.height <= 0) return;
+    bool scaled = dstWidth != src.width || dstHeight != src.height;
+    selectI420ToRGB32(space, src.height, scaled)(src, dst, dstStride, dstWidth, dstHeight);
+}
+
+void scaleI420(const I420Frame& src, const I420Frame& dst)
+{
+    if (dst.width <= 0 || dst.height <= 0 || src.width <= 0 || src.height <= 0) return;
+
+    scalePlane(src.y, src.yStride, src.width, src.height,
+               const_cast<uint8_t*>(dst.y), dst.yStride, dst.width, dst.height);
+    int srcChromaW = (src.width + 1) / 2, srcChromaH = (src.height + 1) / 2;
+    int dstChromaW = (dst.width + 1) / 2, dstChromaH = (dst.height + 1) / 2;
+    scalePlane(src.u, src.uStride, srcChromaW, srcChromaH,
+               const_cast<uint8_t*>(dst.u), dst.uStride, dstChromaW, dstChromaH);
+    scalePlane(src.v, src.vStride, srcChromaW, srcChromaH,
+               const_cast<uint8_t*>(dst.v), dst.vStride, dstChromaW, dstChromaH);
+}
+
+void convertRGB32ToI420(const uint8_t* src, int srcStride, const I420Frame& dst, ColorSpace space)
+{
+    if (dst.width <= 0 || dst.height <= 0) return;
+    ColorMatrix matrix = resolveMatrix(space.matrix, dst.height);
+    kRgbKernels[matrix == COLOR_MATRIX_BT709][space.range == COLOR_RANGE_FULL](src, srcStride, dst);
+}
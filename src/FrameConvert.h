@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "VideoFrameSink.h"
+
+// Pixel conversion kernels shared by every video consumer; no Qt types.
+// Destinations smaller than the source are produced by nearest-neighbour
+// sampling in the same pass, so a thumbnail never converts the full frame.
+
+enum ColorMatrix
+{
+    COLOR_MATRIX_AUTO,   // BT.709 from 720 lines up, BT.601 below (what encoders assume when unsignalled)
+    COLOR_MATRIX_BT601,
+    COLOR_MATRIX_BT709,
+};
+
+enum ColorRange
+{
+    COLOR_RANGE_LIMITED,  // Y 16-235, UV 16-240
+    COLOR_RANGE_FULL,     // 0-255
+};
+
+struct ColorSpace
+{
+    ColorMatrix matrix = COLOR_MATRIX_AUTO;
+    ColorRange range = COLOR_RANGE_LIMITED;
+};
+
+// "auto", "bt601", "bt709", optionally with "-full" or "-limited"
+bool parseColorSpace(const std::string& text, ColorSpace& out);
+const char* colorSpaceName(ColorSpace space);
+
+// Writes 32-bit 0xFFRRGGBB words (the memory layout of QImage::Format_RGB32)
+typedef void (*I420ToRGB32Kernel)(const I420Frame& src, uint8_t* dst, int dstStride, int dstWidth, int dstHeight);
+
+// Picks the kernel for a colour space (AUTO resolved with srcHeight) and for
+// scaled or 1:1 output. Each kernel has its coefficients baked in at compile
+// time, so callers choose once per stream and the pixel loop never branches
+// on colour space.
+I420ToRGB32Kernel selectI420ToRGB32(ColorSpace space, int srcHeight, bool scaled);
+
+// Alpha-mode video: reads the frame's alpha plane and writes premultiplied
+// 0xAARRGGBB words (QImage::Format_ARGB32_Premultiplied) in the same pass.
+// Frames without an alpha plane get the opaque RGB32 kernel, whose output is
+// the same layout with alpha 0xFF.
+I420ToRGB32Kernel selectI420ToARGB32Premultiplied(ColorSpace space, int srcHeight, bool scaled, bool hasAlpha);
+
+// Convenience: select and run
+void convertI420ToRGB32(const I420Frame& src, uint8_t* dst, int dstStride, int dstWidth, int dstHeight,
+                        ColorSpace space = ColorSpace());
+
+// I420 to I420 at another size; dst planes are laid out as in I420Frame
+void scaleI420(const I420Frame& src, const I420Frame& dst);
+
+// Packed 0xAARRGGBB words (QImage::Format_RGB32/ARGB32 memory layout, alpha
+// ignored) to an I420 frame of dst's size; each chroma sample averages its
+// 2x2 block. dst planes are laid out as in I420Frame, and a sub-rectangle can
+// be converted by offsetting src and dst to an even position.
+void convertRGB32ToI420(const uint8_t* src, int srcStride, const I420Frame& dst,
+                        ColorSpace space = ColorSpace());
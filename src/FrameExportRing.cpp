@@ -0,0 +1,343 @@
+#include "FrameExportRing.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <new>
+
+namespace {
+
+const size_t kRingHeaderBytes = 4096;
+
+size_t roundUp(size_t n, size_t to)
+{
+    return (n + to - 1) / to * to;
+}
+
+size_t ringBytes(uint32_t slotCount, uint32_t slotBytes)
+{
+    return kRingHeaderBytes + size_t(slotCount) * slotBytes;
+}
+
+FrameExportSlotHeader* slotAt(uint8_t* slots, uint32_t slotBytes, uint32_t index)
+{
+    return reinterpret_cast<FrameExportSlotHeader*>(slots + size_t(index) * slotBytes);
+}
+
+const FrameExportSlotHeader* slotAt(const uint8_t* slots, uint32_t slotBytes, uint32_t index)
+{
+    return reinterpret_cast<const FrameExportSlotHeader*>(slots + size_t(index) * slotBytes);
+}
+
+void copyPlane(uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, int width, int height)
+{
+    for (int row = 0; row < height; row++) {
+        memcpy(dst + size_t(row) * dstStride, src + size_t(row) * srcStride, width);
+    }
+}
+
+} // namespace
+
+std::string frameExportShmName(const std::string& streamName)
+{
+    std::string name = "/zoombot.";
+    for (char c : streamName) {
+        bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '.';
+        name += safe ? c : '_';
+    }
+    return name.substr(0, 200);
+}
+
+uint32_t frameExportStreamId(const std::string& streamName)
+{
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : streamName) {
+        hash = (hash ^ c) * 16777619u;
+    }
+    return hash;
+}
+
+FrameExportWriter::FrameExportWriter()
+    : m_header(nullptr)
+    , m_slots(nullptr)
+    , m_size(0)
+{
+}
+
+FrameExportWriter::~FrameExportWriter()
+{
+    close();
+}
+
+bool FrameExportWriter::open(const std::string& shmName, const std::string& streamName, uint32_t slotCount,
+                             int maxWidth, int maxHeight)
+{
+    close();
+    if (slotCount < 2) slotCount = 2;
+
+    size_t maxFrameBytes = size_t(maxWidth) * maxHeight + 2 * size_t((maxWidth + 1) / 2) * ((maxHeight + 1) / 2);
+    size_t slotBytes = roundUp(sizeof(FrameExportSlotHeader) + maxFrameBytes, 4096);
+    size_t size = ringBytes(slotCount, uint32_t(slotBytes));
+
+    void* mapping;
+    if (shmName.empty()) {
+        mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    } else {
+        // A ring left behind by a crashed writer is replaced, not reused
+        shm_unlink(shmName.c_str());
+        int fd = shm_open(shmName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) {
+            fprintf(stderr, "FrameExportWriter: shm_open(%s) failed: %s\n", shmName.c_str(), strerror(errno));
+            return false;
+        }
+        if (ftruncate(fd, off_t(size)) != 0) {
+            fprintf(stderr, "FrameExportWriter: ftruncate(%s) failed: %s\n", shmName.c_str(), strerror(errno));
+            ::close(fd);
+            shm_unlink(shmName.c_str());
+            return false;
+        }
+        mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+    }
+    if (mapping == MAP_FAILED) {
+        if (!shmName.empty()) shm_unlink(shmName.c_str());
+        return false;
+    }
+
+    m_shmName = shmName;
+    m_size = size;
+    m_slots = static_cast<uint8_t*>(mapping) + kRingHeaderBytes;
+    m_header = new (mapping) FrameExportRingHeader();
+    m_header->slotCount = slotCount;
+    m_header->slotBytes = uint32_t(slotBytes);
+    m_header->maxFrameBytes = uint32_t(maxFrameBytes);
+    m_header->streamId = frameExportStreamId(streamName);
+    snprintf(m_header->streamName, sizeof(m_header->streamName), "%s", streamName.c_str());
+    m_header->framesWritten.store(0, std::memory_order_relaxed);
+    m_header->framesSkipped.store(0, std::memory_order_relaxed);
+    m_header->writerAlive.store(1, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < slotCount; i++) {
+        new (slotAt(m_slots, m_header->slotBytes, i)) FrameExportSlotHeader();
+    }
+    m_header->version = kFrameExportVersion;
+    // Readers check the magic last
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->magic = kFrameExportMagic;
+    return true;
+}
+
+void FrameExportWriter::close()
+{
+    if (!m_header) return;
+    m_header->writerAlive.store(0, std::memory_order_release);
+    munmap(m_header, m_size);
+    if (!m_shmName.empty()) shm_unlink(m_shmName.c_str());
+    m_shmName.clear();
+    m_header = nullptr;
+    m_slots = nullptr;
+    m_size = 0;
+}
+
+bool FrameExportWriter::write(const I420Frame& frame, int64_t timestampNs)
+{
+    if (!m_header) return false;
+
+    int chromaWidth = (frame.width + 1) / 2;
+    int chromaHeight = (frame.height + 1) / 2;
+    size_t bytes = size_t(frame.width) * frame.height + 2 * size_t(chromaWidth) * chromaHeight;
+    if (bytes > m_header->maxFrameBytes) {
+        m_header->framesSkipped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint64_t frameNumber = m_header->framesWritten.load(std::memory_order_relaxed);
+    FrameExportSlotHeader* slot = slotAt(m_slots, m_header->slotBytes, uint32_t(frameNumber % m_header->slotCount));
+
+    // Seqlock: odd while writing; the fence keeps the data stores after it
+    uint32_t sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->streamId = m_header->streamId;
+    slot->frameNumber = frameNumber;
+    slot->timestampNs = timestampNs;
+    slot->width = frame.width;
+    slot->height = frame.height;
+    slot->yStride = frame.width;
+    slot->uStride = chromaWidth;
+    slot->vStride = chromaWidth;
+    slot->dataBytes = uint32_t(bytes);
+
+    uint8_t* y = reinterpret_cast<uint8_t*>(slot) + sizeof(FrameExportSlotHeader);
+    uint8_t* u = y + size_t(frame.width) * frame.height;
+    uint8_t* v = u + size_t(chromaWidth) * chromaHeight;
+    copyPlane(y, frame.width, frame.y, frame.yStride, frame.width, frame.height);
+    copyPlane(u, chromaWidth, frame.u, frame.uStride, chromaWidth, chromaHeight);
+    copyPlane(v, chromaWidth, frame.v, frame.vStride, chromaWidth, chromaHeight);
+
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+    m_header->framesWritten.store(frameNumber + 1, std::memory_order_release);
+    return true;
+}
+
+FrameExportReader::FrameExportReader()
+    : m_header(nullptr)
+    , m_slots(nullptr)
+    , m_size(0)
+    , m_owned(false)
+    , m_nextFrame(0)
+    , m_stats()
+{
+}
+
+FrameExportReader::~FrameExportReader()
+{
+    close();
+}
+
+bool FrameExportReader::open(const std::string& shmName)
+{
+    close();
+    int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || size_t(st.st_size) < kRingHeaderBytes) {
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    const FrameExportRingHeader* header = static_cast<const FrameExportRingHeader*>(mapping);
+    bool valid = header->magic == kFrameExportMagic;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    valid = valid && header->version == kFrameExportVersion
+            && ringBytes(header->slotCount, header->slotBytes) <= size_t(st.st_size);
+    if (!valid) {
+        munmap(mapping, size_t(st.st_size));
+        return false;
+    }
+
+    m_header = header;
+    m_slots = static_cast<const uint8_t*>(mapping) + kRingHeaderBytes;
+    m_size = size_t(st.st_size);
+    m_owned = true;
+    // Start with what is being written now, not the history
+    m_nextFrame = header->framesWritten.load(std::memory_order_acquire);
+    return true;
+}
+
+bool FrameExportReader::attach(const FrameExportWriter& writer)
+{
+    close();
+    if (!writer.header()) return false;
+    m_header = writer.header();
+    m_slots = reinterpret_cast<const uint8_t*>(m_header) + kRingHeaderBytes;
+    m_size = writer.mappedBytes();
+    m_owned = false;
+    m_nextFrame = m_header->framesWritten.load(std::memory_order_acquire);
+    return true;
+}
+
+void FrameExportReader::close()
+{
+    if (m_header && m_owned) {
+        munmap(const_cast<FrameExportRingHeader*>(m_header), m_size);
+    }
+    m_header = nullptr;
+    m_slots = nullptr;
+    m_size = 0;
+    m_owned = false;
+}
+
+bool FrameExportReader::writerAlive() const
+{
+    return m_header && m_header->writerAlive.load(std::memory_order_acquire) != 0;
+}
+
+bool FrameExportReader::readSlot(uint64_t frameNumber, FrameExportView& view)
+{
+    uint32_t index = uint32_t(frameNumber % m_header->slotCount);
+    const FrameExportSlotHeader* slot = slotAt(m_slots, m_header->slotBytes, index);
+
+    uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+    if (sequence & 1) return false;  // being written
+
+    view.frameNumber = slot->frameNumber;
+    view.timestampNs = slot->timestampNs;
+    view.streamId = slot->streamId;
+    view.slot = index;
+    view.sequence = sequence;
+
+    I420Frame& frame = view.frame;
+    frame.width = slot->width;
+    frame.height = slot->height;
+    frame.yStride = slot->yStride;
+    frame.uStride = slot->uStride;
+    frame.vStride = slot->vStride;
+    frame.y = reinterpret_cast<const uint8_t*>(slot) + sizeof(FrameExportSlotHeader);
+    frame.u = frame.y + size_t(frame.yStride) * frame.height;
+    frame.v = frame.u + size_t(frame.uStride) * ((frame.height + 1) / 2);
+    frame.a = nullptr;
+    frame.aStride = 0;
+
+    // The header fields must belong to the frame we asked for and be untorn
+    return unchanged(view) && view.frameNumber == frameNumber
+           && slot->dataBytes <= m_header->maxFrameBytes;
+}
+
+bool FrameExportReader::next(FrameExportView& view)
+{
+    if (!m_header) return false;
+    uint64_t written = m_header->framesWritten.load(std::memory_order_acquire);
+    if (m_nextFrame >= written) return false;
+
+    // Lapped: the oldest frames were overwritten already
+    uint64_t oldest = written > m_header->slotCount - 1 ? written - (m_header->slotCount - 1) : 0;
+    if (m_nextFrame < oldest) {
+        m_stats.lost += oldest - m_nextFrame;
+        m_nextFrame = oldest;
+    }
+
+    uint64_t frameNumber = m_nextFrame++;
+    if (!readSlot(frameNumber, view)) {
+        m_stats.torn++;
+        return false;
+    }
+    m_stats.frames++;
+    return true;
+}
+
+bool FrameExportReader::latest(FrameExportView& view)
+{
+    if (!m_header) return false;
+    uint64_t written = m_header->framesWritten.load(std::memory_order_acquire);
+    if (written == 0) return false;
+    if (!readSlot(written - 1, view)) {
+        m_stats.torn++;
+        return false;
+    }
+    m_nextFrame = written;
+    m_stats.frames++;
+    return true;
+}
+
+bool FrameExportReader::validate(const FrameExportView& view)
+{
+    if (unchanged(view)) return true;
+    m_stats.invalidated++;
+    return false;
+}
+
+bool FrameExportReader::unchanged(const FrameExportView& view) const
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const FrameExportSlotHeader* slot = slotAt(m_slots, m_header->slotBytes, view.slot);
+    return slot->sequence.load(std::memory_order_relaxed) == view.sequence;
+}
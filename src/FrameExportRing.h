@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "VideoFrameSink.h"
+
+// Shared-memory ring of I420 frames for consumers in other processes. One
+// POSIX shared memory object per stream (/dev/shm/zoombot.<stream>) holds a
+// ring header followed by fixed-size slots. The writer overwrites the oldest
+// slot and never waits for readers; every slot header is a seqlock (odd while
+// being written), so a reader maps the ring read-only, uses the planes in
+// place and then checks the sequence to learn whether it was overwritten
+// meanwhile. Depends on nothing but POSIX, so consumers can build it alone.
+
+const uint32_t kFrameExportMagic = 0x5846425Au;  // "ZBFX"
+const uint32_t kFrameExportVersion = 1;
+
+struct FrameExportRingHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotBytes;          // header plus data, multiple of 64
+    uint32_t maxFrameBytes;      // largest I420 frame a slot holds
+    uint32_t streamId;           // hash of streamName, repeated in every slot
+    char streamName[104];        // e.g. "remote:alice", NUL-terminated
+    alignas(64) std::atomic<uint64_t> framesWritten;  // slot of frame n is n % slotCount
+    std::atomic<uint64_t> framesSkipped;              // larger than a slot
+    std::atomic<uint32_t> writerAlive;                // 0 once the writer closed the ring
+};
+
+struct alignas(64) FrameExportSlotHeader
+{
+    std::atomic<uint32_t> sequence;  // odd while the writer is in this slot
+    uint32_t streamId;
+    uint64_t frameNumber;
+    int64_t timestampNs;             // CLOCK_MONOTONIC when written
+    int32_t width;
+    int32_t height;
+    int32_t yStride;                 // planes follow the header: Y, U, V
+    int32_t uStride;
+    int32_t vStride;
+    uint32_t dataBytes;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "seqlock needs address-free atomics");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring index needs address-free atomics");
+
+// "remote:alice" -> "/zoombot.remote_alice"
+std::string frameExportShmName(const std::string& streamName);
+uint32_t frameExportStreamId(const std::string& streamName);
+
+// Producer side; single writer thread per ring
+class FrameExportWriter
+{
+public:
+    FrameExportWriter();
+    ~FrameExportWriter();
+
+    FrameExportWriter(const FrameExportWriter&) = delete;
+    FrameExportWriter& operator=(const FrameExportWriter&) = delete;
+
+    // Creates (replacing a stale one) and maps the ring. An empty shmName
+    // makes an anonymous ring for in-process tests.
+    bool open(const std::string& shmName, const std::string& streamName, uint32_t slotCount,
+              int maxWidth, int maxHeight);
+    // Marks the ring closed and unlinks it; mapped readers keep their view
+    void close();
+
+    // Copies the frame into the next slot. False if it does not fit a slot.
+    bool write(const I420Frame& frame, int64_t timestampNs);
+
+    size_t mappedBytes() const { return m_size; }
+    const FrameExportRingHeader* header() const { return m_header; }
+
+private:
+    std::string m_shmName;
+    FrameExportRingHeader* m_header;
+    uint8_t* m_slots;
+    size_t m_size;
+};
+
+// A frame in a mapped ring. The plane pointers point into shared memory and
+// are only trustworthy if FrameExportReader::validate() still returns true
+// after the consumer has finished with them.
+struct FrameExportView
+{
+    I420Frame frame;
+    uint64_t frameNumber;
+    int64_t timestampNs;
+    uint32_t streamId;
+    uint32_t slot;
+    uint32_t sequence;
+};
+
+// Consumer side; maps a ring read-only, never blocks the writer
+class FrameExportReader
+{
+public:
+    struct Stats
+    {
+        uint64_t frames;
+        uint64_t lost;         // overwritten before this reader got to them
+        uint64_t torn;         // overwritten while next()/latest() read the header
+        uint64_t invalidated;  // returned, then overwritten before validate()
+    };
+
+    FrameExportReader();
+    ~FrameExportReader();
+
+    FrameExportReader(const FrameExportReader&) = delete;
+    FrameExportReader& operator=(const FrameExportReader&) = delete;
+
+    bool open(const std::string& shmName);
+    // Reads a writer's ring in the same process (throughput tests)
+    bool attach(const FrameExportWriter& writer);
+    void close();
+
+    // Next frame after the previous one returned; skips ahead when lapped.
+    // False if no new frame is available.
+    bool next(FrameExportView& view);
+    // Most recent complete frame
+    bool latest(FrameExportView& view);
+    // True if the view's slot was not rewritten since next()/latest();
+    // failures count as invalidated
+    bool validate(const FrameExportView& view);
+
+    bool writerAlive() const;
+    const FrameExportRingHeader* header() const { return m_header; }
+    Stats stats() const { return m_stats; }
+
+private:
+    bool readSlot(uint64_t frameNumber, FrameExportView& view);
+    bool unchanged(const FrameExportView& view) const;
+
+    const FrameExportRingHeader* m_header;
+    const uint8_t* m_slots;
+    size_t m_size;
+    bool m_owned;  // mapped by open(), unmapped by close()
+    uint64_t m_nextFrame;
+    Stats m_stats;
+};
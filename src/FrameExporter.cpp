@@ -0,0 +1,65 @@
+#include "FrameExporter.h"
+#include "Logger.h"
+
+#include <time.h>
+
+namespace {
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+} // namespace
+
+FrameExporter::FrameExporter(const std::string& streamName)
+    : m_streamName(streamName)
+    , m_shmName(frameExportShmName(streamName))
+    , m_budgetAccount(streamName + " export")
+    , m_frames(0)
+    , m_skipped(0)
+{
+}
+
+FrameExporter::~FrameExporter()
+{
+    if (m_writer.header()) {
+        LOG_INFO("FrameExporter %s: %llu frames exported to %s, %llu too large for a slot",
+                 m_streamName.c_str(), (unsigned long long)m_frames.load(), m_shmName.c_str(),
+                 (unsigned long long)m_skipped.load());
+    }
+    m_writer.close();
+    m_budgetAccount.release(m_budgetAccount.chargedBytes());
+}
+
+bool FrameExporter::open(uint32_t slotCount, int maxWidth, int maxHeight)
+{
+    if (!m_writer.open(m_shmName, m_streamName, slotCount, maxWidth, maxHeight)) {
+        LOG_ERROR("FrameExporter %s: cannot create %s", m_streamName.c_str(), m_shmName.c_str());
+        return false;
+    }
+    // The slots are touched by every lap of the ring, so all of it is resident
+    if (!m_budgetAccount.tryCharge(m_writer.mappedBytes())) {
+        LOG_WARN("FrameExporter %s: memory budget refused %zu bytes, not exporting",
+                 m_streamName.c_str(), m_writer.mappedBytes());
+        m_writer.close();
+        return false;
+    }
+    LOG_INFO("FrameExporter %s: exporting to %s (%u slots, %zu bytes)", m_streamName.c_str(),
+             m_shmName.c_str(), m_writer.header()->slotCount, m_writer.mappedBytes());
+    return true;
+}
+
+void FrameExporter::onHubFrame(const HubFrame& frame)
+{
+    if (!m_writer.header()) return;
+    if (m_writer.write(*frame.source, monotonicNs())) {
+        m_frames.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_skipped.fetch_add(1, std::memory_order_relaxed);
+        LOG_RATE_LIMITED(LOG_LEVEL_WARN, 5000, "FrameExporter %s: %dx%d frame larger than a slot, skipped",
+                         m_streamName.c_str(), frame.source->width, frame.source->height);
+    }
+}
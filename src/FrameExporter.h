@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "FrameExportRing.h"
+#include "FrameHub.h"
+#include "MemoryBudget.h"
+
+// Publishes a stream's frames to a shared-memory ring (FrameExportRing) for
+// consumers in other processes. Subscribed to the stream's hub at the native
+// I420 variant, so the hub converts nothing; each frame costs one plane copy
+// into the next slot and never waits for a reader.
+class FrameExporter : public IFrameHubSink
+{
+public:
+    explicit FrameExporter(const std::string& streamName);
+    // Unlinks the ring; readers that still map it see writerAlive == 0
+    ~FrameExporter();
+
+    FrameExporter(const FrameExporter&) = delete;
+    FrameExporter& operator=(const FrameExporter&) = delete;
+
+    static FrameVariant variant()
+    {
+        FrameVariant v;
+        v.format = FRAME_FORMAT_I420;
+        return v;
+    }
+
+    // Creates the ring, sized for frames up to maxWidth x maxHeight pixels
+    // and charged to the memory budget. False if either fails.
+    bool open(uint32_t slotCount, int maxWidth, int maxHeight);
+
+    const std::string& shmName() const { return m_shmName; }
+
+    // IFrameHubSink
+    void onHubFrame(const HubFrame& frame) override;
+
+private:
+    std::string m_streamName;
+    std::string m_shmName;
+    FrameExportWriter m_writer;
+    MemoryBudget::Account m_budgetAccount;
+    std::atomic<uint64_t> m_frames;
+    std::atomic<uint64_t> m_skipped;
+};
@@ -0,0 +1,252 @@
+#include "FrameHub.h"
+#include "AllocationTracker.h"
+#include "FrameConvert.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+// Buffers per variant: one being written, one on screen, one queued
+const size_t kBuffersPerVariant = 3;
+
+// Packed ColorSpace (matrix | range << 8), set from config at startup
+std::atomic<int> g_defaultColorSpace{COLOR_MATRIX_AUTO};
+
+bool sameVariant(const FrameVariant& a, const FrameVariant& b)
+{
+    return a.format == b.format && a.width == b.width && a.height == b.height;
+}
+
+size_t bufferBytes(FramePixelFormat format, int width, int height)
+{
+    if (format != FRAME_FORMAT_I420) return size_t(width) * 4 * height;
+    return size_t(width) * height + 2 * size_t((width + 1) / 2) * ((height + 1) / 2);
+}
+
+} // namespace
+
+FrameBuffer::FrameBuffer(FramePixelFormat format, int width, int height)
+    : m_format(format)
+    , m_width(width)
+    , m_height(height)
+    , m_stride(format == FRAME_FORMAT_I420 ? width : width * 4)
+    , m_data(bufferBytes(format, width, height))
+    , m_sequence(0)
+    , m_hasAlpha(false)
+{
+}
+
+I420Frame FrameBuffer::asI420() const
+{
+    I420Frame frame;
+    int chromaStride = (m_width + 1) / 2;
+    size_t chromaBytes = size_t(chromaStride) * ((m_height + 1) / 2);
+    frame.y = m_data.data();
+    frame.u = frame.y + size_t(m_stride) * m_height;
+    frame.v = frame.u + chromaBytes;
+    frame.width = m_width;
+    frame.height = m_height;
+    frame.yStride = m_stride;
+    frame.uStride = chromaStride;
+    frame.vStride = chromaStride;
+    return frame;
+}
+
+FrameHub::FrameHub(const std::string& name)
+    : m_name(name)
+    , m_budgetAccount(name)
+    , m_sequence(0)
+    , m_hasColorSpace(false)
+    , m_framesIn(0)
+    , m_conversions(0)
+    , m_deliveries(0)
+    , m_drops(0)
+{
+}
+
+FrameHub::~FrameHub()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Variant& variant : m_variants) {
+        for (const std::shared_ptr<FrameBuffer>& buffer : variant.pool) {
+            m_budgetAccount.release(buffer->sizeInBytes());
+        }
+    }
+}
+
+void FrameHub::setColorSpace(ColorSpace space)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_hasColorSpace = true;
+    m_colorSpace = space;
+    for (Variant& variant : m_variants) {
+        variant.kernel = nullptr;
+    }
+}
+
+void FrameHub::setDefaultColorSpace(ColorSpace space)
+{
+    g_defaultColorSpace.store(int(space.matrix) | (int(space.range) << 8), std::memory_order_relaxed);
+}
+
+ColorSpace FrameHub::defaultColorSpace()
+{
+    int packed = g_defaultColorSpace.load(std::memory_order_relaxed);
+    ColorSpace space;
+    space.matrix = ColorMatrix(packed & 0xFF);
+    space.range = ColorRange(packed >> 8);
+    return space;
+}
+
+void FrameHub::subscribe(const std::shared_ptr<IFrameHubSink>& sink, const FrameVariant& variant)
+{
+    if (!sink) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (Variant& existing : m_variants) {
+        if (sameVariant(existing.requested, variant)) {
+            existing.sinks.push_back(sink);
+            return;
+        }
+    }
+    Variant added;
+    added.requested = variant;
+    added.sinks.push_back(sink);
+    m_variants.push_back(std::move(added));
+}
+
+void FrameHub::unsubscribe(IFrameHubSink* sink)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_variants.begin(); it != m_variants.end();) {
+        std::vector<std::shared_ptr<IFrameHubSink>>& sinks = it->sinks;
+        sinks.erase(std::remove_if(sinks.begin(), sinks.end(),
+                                   [sink](const std::shared_ptr<IFrameHubSink>& s) { return s.get() == sink; }),
+                    sinks.end());
+        if (sinks.empty()) {
+            // Nobody wants this variant any more; its buffers go back to the budget
+            for (const std::shared_ptr<FrameBuffer>& buffer : it->pool) {
+                m_budgetAccount.release(buffer->sizeInBytes());
+            }
+            it = m_variants.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool FrameHub::hasSinks() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_variants.empty();
+}
+
+std::shared_ptr<FrameBuffer> FrameHub::acquireBuffer(Variant& variant, FramePixelFormat format, int width, int height)
+{
+    size_t bytes = bufferBytes(format, width, height);
+
+    // A buffer only the pool references is free; nobody else can take a new
+    // reference while the hub mutex is held
+    for (auto it = variant.pool.begin(); it != variant.pool.end(); ++it) {
+        if (it->use_count() != 1) continue;
+        if ((*it)->width() == width && (*it)->height() == height) return *it;
+
+        // The source resolution changed: swap the idle buffer for one of the new size
+        m_budgetAccount.release((*it)->sizeInBytes());
+        variant.pool.erase(it);
+        break;
+    }
+
+    if (variant.pool.size() >= kBuffersPerVariant) return nullptr;
+    if (!m_budgetAccount.tryCharge(bytes)) {
+        LOG_RATE_LIMITED(LOG_LEVEL_WARN, 1000, "FrameHub %s: memory budget exhausted, dropping %dx%d frame",
+                         m_name.c_str(), width, height);
+        return nullptr;
+    }
+    std::shared_ptr<FrameBuffer> buffer = std::make_shared<FrameBuffer>(format, width, height);
+    variant.pool.push_back(buffer);
+    return buffer;
+}
+
+void FrameHub::onVideoFrame(const I420Frame& frame)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_variants.empty()) return;
+
+    AllocStageScope stage(ALLOC_STAGE_VIDEO_CONVERT);
+    m_framesIn++;
+    uint64_t sequence = ++m_sequence;
+
+    for (Variant& variant : m_variants) {
+        int width = variant.requested.width > 0 ? variant.requested.width : frame.width;
+        int height = variant.requested.height > 0 ? variant.requested.height : frame.height;
+
+        HubFrame out;
+        out.source = &frame;
+        out.sequence = sequence;
+        if (variant.requested.format == FRAME_FORMAT_I420 && width == frame.width && height == frame.height) {
+            // The source already is this variant
+        } else {
+            std::shared_ptr<FrameBuffer> buffer = acquireBuffer(variant, variant.requested.format, width, height);
+            if (!buffer) {
+                m_drops++;
+                continue;
+            }
+            if (variant.requested.format != FRAME_FORMAT_I420) {
+                bool premultiplied = variant.requested.format == FRAME_FORMAT_ARGB32_PREMULTIPLIED;
+                bool hasAlpha = premultiplied && frame.a != nullptr;
+                // Reselected only when the source size or alpha mode changes, never per pixel
+                if (!variant.kernel || variant.kernelSourceWidth != frame.width
+                    || variant.kernelSourceHeight != frame.height || variant.kernelHasAlpha != hasAlpha) {
+                    ColorSpace space = m_hasColorSpace ? m_colorSpace : defaultColorSpace();
+                    bool scaled = width != frame.width || height != frame.height;
+                    variant.kernel = premultiplied
+                                         ? selectI420ToARGB32Premultiplied(space, frame.height, scaled, hasAlpha)
+                                         : selectI420ToRGB32(space, frame.height, scaled);
+                    variant.kernelSourceWidth = frame.width;
+                    variant.kernelSourceHeight = frame.height;
+                    variant.kernelHasAlpha = hasAlpha;
+                }
+                variant.kernel(frame, buffer->m_data.data(), buffer->stride(), width, height);
+                buffer->m_hasAlpha = hasAlpha;
+            } else {
+                scaleI420(frame, buffer->asI420());
+            }
+            buffer->m_sequence = sequence;
+            out.converted = buffer;
+            m_conversions++;
+        }
+
+        for (const std::shared_ptr<IFrameHubSink>& sink : variant.sinks) {
+            sink->onHubFrame(out);
+            m_deliveries++;
+        }
+    }
+}
+
+void FrameHub::onShareCursor(int x, int y)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Variant& variant : m_variants) {
+        for (const std::shared_ptr<IFrameHubSink>& sink : variant.sinks) {
+            sink->onHubCursor(x, y);
+        }
+    }
+}
+
+FrameHub::Stats FrameHub::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats s;
+    s.framesIn = m_framesIn;
+    s.conversions = m_conversions;
+    s.deliveries = m_deliveries;
+    s.drops = m_drops;
+    s.variants = m_variants.size();
+    s.sinks = 0;
+    for (const Variant& variant : m_variants) {
+        s.sinks += variant.sinks.size();
+    }
+    return s;
+}
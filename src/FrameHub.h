@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "FrameConvert.h"
+#include "MemoryBudget.h"
+#include "VideoFrameSink.h"
+
+enum FramePixelFormat
+{
+    FRAME_FORMAT_I420,
+    FRAME_FORMAT_RGB32,  // 0xFFRRGGBB words, QImage::Format_RGB32 layout
+    // 0xAARRGGBB with colour premultiplied by alpha (Format_ARGB32_Premultiplied);
+    // opaque frames come out with alpha 0xFF, identical to RGB32
+    FRAME_FORMAT_ARGB32_PREMULTIPLIED,
+};
+
+// What a sink wants: a pixel format and a size (0 = the source size)
+struct FrameVariant
+{
+    FramePixelFormat format = FRAME_FORMAT_RGB32;
+    int width = 0;
+    int height = 0;
+};
+
+// One converted frame, shared read-only by every sink that asked for the
+// same variant. Sinks may keep the pointer past the callback; the hub only
+// reuses a buffer once nobody else holds it.
+class FrameBuffer
+{
+public:
+    FrameBuffer(FramePixelFormat format, int width, int height);
+
+    FramePixelFormat format() const { return m_format; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    int stride() const { return m_stride; }  // bytes per row (Y plane for I420)
+    const uint8_t* data() const { return m_data.data(); }
+    size_t sizeInBytes() const { return m_data.size(); }
+    uint64_t sequence() const { return m_sequence; }
+    // ARGB32_PREMULTIPLIED converted from a frame that carried an alpha plane
+    bool hasAlpha() const { return m_hasAlpha; }
+
+    // Plane view of an I420 buffer
+    I420Frame asI420() const;
+
+private:
+    friend class FrameHub;
+
+    FramePixelFormat m_format;
+    int m_width;
+    int m_height;
+    int m_stride;
+    std::vector<uint8_t> m_data;
+    uint64_t m_sequence;
+    bool m_hasAlpha;
+};
+
+typedef std::shared_ptr<const FrameBuffer> FrameBufferPtr;
+
+struct HubFrame
+{
+    const I420Frame* source;   // the SDK frame; only valid during the callback
+    FrameBufferPtr converted;  // the requested variant, or null if that is the source itself
+    uint64_t sequence;
+};
+
+class IFrameHubSink
+{
+public:
+    virtual ~IFrameHubSink() {}
+    // Called on the thread feeding the hub: the SDK callback thread for the
+    // self, mixed and share hubs; for remote video hubs a frame executor
+    // worker, through the stream's StrandedFrameSink, so one frame at a time
+    // and in order but not always on the same thread
+    virtual void onHubFrame(const HubFrame& frame) = 0;
+    // Screen-share pointer position in source pixels; shares only
+    virtual void onHubCursor(int /*x*/, int /*y*/) {}
+};
+
+// Per-stream fan-out point. The SDK handler feeds it I420 frames; each
+// distinct variant subscribers asked for is converted at most once per frame
+// into a pooled buffer charged to the memory budget and handed to all of its
+// sinks. A variant whose buffers are all still held is dropped for that frame.
+class FrameHub : public IVideoFrameSink
+{
+public:
+    struct Stats
+    {
+        uint64_t framesIn;
+        uint64_t conversions;
+        uint64_t deliveries;
+        uint64_t drops;  // variant skipped: pool busy or budget exhausted
+        size_t variants;
+        size_t sinks;
+    };
+
+    explicit FrameHub(const std::string& name);
+    ~FrameHub();
+
+    FrameHub(const FrameHub&) = delete;
+    FrameHub& operator=(const FrameHub&) = delete;
+
+    const std::string& name() const { return m_name; }
+
+    // Colour space of this stream's YUV; hubs without one use the process
+    // default (config.json video_color_space, AUTO unless set)
+    void setColorSpace(ColorSpace space);
+    static void setDefaultColorSpace(ColorSpace space);
+    static ColorSpace defaultColorSpace();
+
+    // Any thread. After unsubscribe() returns the sink gets no more frames.
+    void subscribe(const std::shared_ptr<IFrameHubSink>& sink, const FrameVariant& variant);
+    void unsubscribe(IFrameHubSink* sink);
+    bool hasSinks() const;
+
+    // IVideoFrameSink: one source frame in
+    void onVideoFrame(const I420Frame& frame) override;
+    // Forwards a share cursor move to every sink; no frame is converted
+    void onShareCursor(int x, int y);
+
+    Stats stats() const;
+
+private:
+    struct Variant
+    {
+        FrameVariant requested;
+        std::vector<std::shared_ptr<IFrameHubSink>> sinks;
+        std::vector<std::shared_ptr<FrameBuffer>> pool;
+        // RGB kernel chosen for the current source size and colour space
+        I420ToRGB32Kernel kernel = nullptr;
+        int kernelSourceWidth = 0;
+        int kernelSourceHeight = 0;
+        bool kernelHasAlpha = false;
+    };
+
+    std::shared_ptr<FrameBuffer> acquireBuffer(Variant& variant, FramePixelFormat format, int width, int height);
+
+    std::string m_name;
+    mutable std::mutex m_mutex;  // held while delivering, so unsubscribe is synchronous
+    std::vector<Variant> m_variants;
+    MemoryBudget::Account m_budgetAccount;
+    uint64_t m_sequence;
+    bool m_hasColorSpace;
+    ColorSpace m_colorSpace;
+
+    uint64_t m_framesIn;
+    uint64_t m_conversions;
+    uint64_t m_deliveries;
+    uint64_t m_drops;
+};
@@ -0,0 +1,195 @@
+#include "Logger.h"
+
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <time.h>
+
+namespace {
+
+struct LogRecord
+{
+    uint16_t length;
+    char text[Logger::kMaxLineLength];
+};
+
+// Fixed ring shared by all producers; the writer thread is the only consumer
+struct LogQueue
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    LogRecord records[Logger::kQueueCapacity];
+    uint32_t head = 0;    // next record to write out
+    uint32_t count = 0;
+    uint64_t dropped = 0;       // since the writer last reported
+    uint64_t droppedTotal = 0;
+    bool running = false;
+    bool stopping = false;
+    std::thread writer;
+};
+
+LogQueue& queue()
+{
+    static LogQueue q;
+    return q;
+}
+
+std::once_flag g_startOnce;
+
+const char kLevelTags[] = { 'D', 'I', 'W', 'E' };
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+int initialLevel()
+{
+    const char* env = getenv("BOT_LOG_LEVEL");
+    if (!env) return LOG_LEVEL_DEBUG;
+    if (!strcmp(env, "info")) return LOG_LEVEL_INFO;
+    if (!strcmp(env, "warn")) return LOG_LEVEL_WARN;
+    if (!strcmp(env, "error")) return LOG_LEVEL_ERROR;
+    if (!strcmp(env, "none")) return LOG_LEVEL_NONE;
+    return LOG_LEVEL_DEBUG;
+}
+
+void writerLoop()
+{
+    LogQueue& q = queue();
+    // Records are copied out under the lock and written without it
+    static char batch[64 * 1024];
+
+    std::unique_lock<std::mutex> lock(q.mutex);
+    for (;;) {
+        q.cv.wait(lock, [&q] { return q.count > 0 || q.stopping; });
+        if (q.count == 0 && q.stopping) break;
+
+        size_t used = 0;
+        uint64_t dropped = q.dropped;
+        q.dropped = 0;
+        while (q.count > 0 && used + Logger::kMaxLineLength <= sizeof(batch)) {
+            const LogRecord& rec = q.records[q.head];
+            memcpy(batch + used, rec.text, rec.length);
+            used += rec.length;
+            q.head = (q.head + 1) % Logger::kQueueCapacity;
+            q.count--;
+        }
+
+        lock.unlock();
+        if (dropped > 0) {
+            fprintf(stdout, "[logger] %llu messages dropped (queue full)\n", (unsigned long long)dropped);
+        }
+        fwrite(batch, 1, used, stdout);
+        fflush(stdout);
+        lock.lock();
+    }
+}
+
+void startWriter()
+{
+    LogQueue& q = queue();
+    q.running = true;
+    q.writer = std::thread(writerLoop);
+    atexit(Logger::shutdown);
+}
+
+void enqueue(LogLevel level, uint32_t suppressed, const char* fmt, va_list args)
+{
+    thread_local char line[Logger::kMaxLineLength];
+
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    tm local;
+    localtime_r(&now.tv_sec, &local);
+
+    int len = snprintf(line, sizeof(line), "%02d:%02d:%02d.%03ld %c ",
+                       local.tm_hour, local.tm_min, local.tm_sec, now.tv_nsec / 1000000,
+                       kLevelTags[level < LOG_LEVEL_NONE ? level : LOG_LEVEL_ERROR]);
+    int room = (int)sizeof(line) - len - 1; // keep space for the newline
+    int body = vsnprintf(line + len, room, fmt, args);
+    len += body < 0 ? 0 : (body < room ? body : room - 1);
+    if (suppressed > 0) {
+        room = (int)sizeof(line) - len - 1;
+        int extra = snprintf(line + len, room, " [+%u suppressed]", suppressed);
+        len += extra < 0 ? 0 : (extra < room ? extra : room - 1);
+    }
+    // Messages carried over from printf still end in '\n'
+    while (len > 0 && line[len - 1] == '\n') len--;
+    line[len++] = '\n';
+
+    std::call_once(g_startOnce, startWriter);
+
+    LogQueue& q = queue();
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.count == Logger::kQueueCapacity || q.stopping) {
+            q.dropped++;
+            q.droppedTotal++;
+            return;
+        }
+        LogRecord& rec = q.records[(q.head + q.count) % Logger::kQueueCapacity];
+        memcpy(rec.text, line, len);
+        rec.length = (uint16_t)len;
+        wake = (q.count++ == 0);
+    }
+    if (wake) q.cv.notify_one();
+}
+
+} // namespace
+
+std::atomic<int> Logger::s_runtimeLevel(initialLevel());
+
+void Logger::write(LogLevel level, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    enqueue(level, 0, fmt, args);
+    va_end(args);
+}
+
+void Logger::writeSuppressed(LogLevel level, uint32_t suppressed, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    enqueue(level, suppressed, fmt, args);
+    va_end(args);
+}
+
+void Logger::shutdown()
+{
+    LogQueue& q = queue();
+    {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.running || q.stopping) return;
+        q.stopping = true;
+    }
+    q.cv.notify_one();
+    if (q.writer.joinable()) q.writer.join();
+}
+
+uint64_t Logger::droppedCount()
+{
+    LogQueue& q = queue();
+    std::lock_guard<std::mutex> lock(q.mutex);
+    return q.droppedTotal;
+}
+
+bool LogRateLimiter::allow(uint32_t& suppressedOut)
+{
+    int64_t now = monotonicNs();
+    int64_t next = m_nextNs.load(std::memory_order_relaxed);
+    if (now < next || !m_nextNs.compare_exchange_strong(next, now + m_intervalNs, std::memory_order_relaxed)) {
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    suppressedOut = m_suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
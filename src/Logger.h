@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Asynchronous logger used on the SDK callback paths instead of printf/qDebug.
+// Messages are formatted into a thread-local buffer, copied into a fixed ring
+// and written to stdout in batches by a background thread, so callers never
+// touch the stdio lock or block on terminal I/O.
+
+enum LogLevel
+{
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO  = 1,
+    LOG_LEVEL_WARN  = 2,
+    LOG_LEVEL_ERROR = 3,
+    LOG_LEVEL_NONE  = 4
+};
+
+// Calls below this level are compiled out entirely (set from CMake)
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+class Logger
+{
+public:
+    static constexpr int kMaxLineLength = 512;
+    static constexpr int kQueueCapacity = 2048;
+
+    // Runtime level, initialised from BOT_LOG_LEVEL (debug/info/warn/error/none)
+    static bool isEnabled(LogLevel level) { return level >= s_runtimeLevel.load(std::memory_order_relaxed); }
+    static void setLevel(LogLevel level) { s_runtimeLevel.store(level, std::memory_order_relaxed); }
+
+    static void write(LogLevel level, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    static void writeSuppressed(LogLevel level, uint32_t suppressed, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+
+    // Drain everything queued so far and stop the writer thread
+    static void shutdown();
+
+    static uint64_t droppedCount();
+
+private:
+    static std::atomic<int> s_runtimeLevel;
+};
+
+// Per-call-site limiter: lets one message through per interval and counts the rest
+class LogRateLimiter
+{
+public:
+    explicit LogRateLimiter(int intervalMs) : m_intervalNs(int64_t(intervalMs) * 1000000), m_nextNs(0), m_suppressed(0) {}
+
+    // Returns true if the caller may log; suppressedOut receives the number of
+    // messages swallowed since the last one that was let through.
+    bool allow(uint32_t& suppressedOut);
+
+private:
+    const int64_t m_intervalNs;
+    std::atomic<int64_t> m_nextNs;
+    std::atomic<uint32_t> m_suppressed;
+};
+
+#define LOG_AT(level, ...)                                                  \
+    do {                                                                    \
+        if ((level) >= LOG_COMPILE_LEVEL && Logger::isEnabled(level))       \
+            Logger::write((level), __VA_ARGS__);                            \
+    } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)  LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_WARN(...)  LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+// At most one message per intervalMs from this call site, for per-frame paths
+#define LOG_RATE_LIMITED(level, intervalMs, ...)                                    \
+    do {                                                                            \
+        if ((level) >= LOG_COMPILE_LEVEL) {                                         \
+            static LogRateLimiter _logLimiter(intervalMs);                          \
+            uint32_t _logSuppressed = 0;                                            \
+            if (Logger::isEnabled(level) && _logLimiter.allow(_logSuppressed))      \
+                Logger::writeSuppressed((level), _logSuppressed, __VA_ARGS__);      \
+        }                                                                           \
+    } while (0)
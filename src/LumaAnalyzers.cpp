@@ -0,0 +1,142 @@
+#include "LumaAnalyzers.h"
+
+#include <string.h>
+
+void LumaHistogramAnalyzer::analyze(const I420Frame& frame, AnalysisResult& result)
+{
+    // Four interleaved sub-histograms so neighbouring pixels that fall in
+    // the same bin do not serialise on one counter
+    uint32_t bins[4][256] = {};
+    uint64_t sum = 0;
+    for (int row = 0; row < frame.height; row++) {
+        const uint8_t* y = frame.y + int64_t(row) * frame.yStride;
+        uint32_t rowSum = 0;
+        for (int x = 0; x < frame.width; x++) rowSum += y[x];
+        sum += rowSum;
+
+        int x = 0;
+        for (; x + 4 <= frame.width; x += 4) {
+            bins[0][y[x]]++;
+            bins[1][y[x + 1]]++;
+            bins[2][y[x + 2]]++;
+            bins[3][y[x + 3]]++;
+        }
+        for (; x < frame.width; x++) bins[0][y[x]]++;
+    }
+
+    double pixels = double(frame.width) * frame.height;
+    if (pixels <= 0) return;
+    uint32_t merged[256];
+    for (int i = 0; i < 256; i++) merged[i] = bins[0][i] + bins[1][i] + bins[2][i] + bins[3][i];
+
+    uint64_t dark = 0, bright = 0;
+    for (int i = 0; i <= 16; i++) dark += merged[i];
+    for (int i = 235; i < 256; i++) bright += merged[i];
+
+    result.values[0] = float(sum / pixels);
+    result.values[1] = float(dark / pixels);
+    result.values[2] = float(bright / pixels);
+    for (int bin = 0; bin < 16; bin++) {
+        uint64_t count = 0;
+        for (int i = 0; i < 16; i++) count += merged[bin * 16 + i];
+        result.values[3 + bin] = float(count / pixels);
+    }
+    result.count = 19;
+}
+
+MotionAnalyzer::MotionAnalyzer(const std::string& streamName)
+    : m_width(0)
+    , m_height(0)
+    , m_budgetAccount(streamName + " motion")
+{
+}
+
+MotionAnalyzer::~MotionAnalyzer()
+{
+    m_budgetAccount.release(m_previous.size());
+}
+
+void MotionAnalyzer::analyze(const I420Frame& frame, AnalysisResult& result)
+{
+    result.count = 2;
+    size_t bytes = size_t(frame.width) * frame.height;
+    bool comparable = frame.width == m_width && frame.height == m_height && m_previous.size() == bytes;
+
+    uint64_t sad = 0, changed = 0;
+    if (comparable) {
+        for (int row = 0; row < frame.height; row++) {
+            const uint8_t* y = frame.y + int64_t(row) * frame.yStride;
+            const uint8_t* p = m_previous.data() + size_t(row) * frame.width;
+            uint32_t rowSad = 0, rowChanged = 0;
+            for (int x = 0; x < frame.width; x++) {
+                int diff = y[x] > p[x] ? y[x] - p[x] : p[x] - y[x];
+                rowSad += uint32_t(diff);
+                rowChanged += diff > 24 ? 1u : 0u;
+            }
+            sad += rowSad;
+            changed += rowChanged;
+        }
+        double pixels = double(bytes);
+        result.values[0] = float(sad / pixels);
+        result.values[1] = float(changed / pixels);
+    } else {
+        result.values[0] = 0.0f;
+        result.values[1] = 0.0f;
+        if (m_previous.size() != bytes) {
+            m_budgetAccount.release(m_previous.size());
+            if (!m_budgetAccount.tryCharge(bytes)) {
+                std::vector<uint8_t>().swap(m_previous);
+                m_width = m_height = 0;
+                return;
+            }
+            m_previous.resize(bytes);
+        }
+        m_width = frame.width;
+        m_height = frame.height;
+    }
+
+    for (int row = 0; row < frame.height; row++) {
+        memcpy(m_previous.data() + size_t(row) * frame.width, frame.y + int64_t(row) * frame.yStride, frame.width);
+    }
+}
+
+void BlurAnalyzer::analyze(const I420Frame& frame, AnalysisResult& result)
+{
+    result.count = 2;
+    result.values[0] = 0.0f;
+    result.values[1] = 0.0f;
+    if (frame.width < 3 || frame.height < 3) return;
+
+    // Per row the sums fit 32/64-bit integers: |lap| <= 1020, lap^2 < 2^20
+    int64_t sum = 0, sumAbs = 0;
+    uint64_t sumSquares = 0;
+    for (int row = 1; row < frame.height - 1; row++) {
+        const uint8_t* above = frame.y + int64_t(row - 1) * frame.yStride;
+        const uint8_t* y = frame.y + int64_t(row) * frame.yStride;
+        const uint8_t* below = frame.y + int64_t(row + 1) * frame.yStride;
+        int32_t rowSum = 0, rowAbs = 0;
+        uint64_t rowSquares = 0;
+        for (int x = 1; x < frame.width - 1; x++) {
+            int32_t lap = int32_t(above[x]) + below[x] + y[x - 1] + y[x + 1] - 4 * int32_t(y[x]);
+            rowSum += lap;
+            rowAbs += lap < 0 ? -lap : lap;
+            rowSquares += uint64_t(uint32_t(lap * lap));
+        }
+        sum += rowSum;
+        sumAbs += rowAbs;
+        sumSquares += rowSquares;
+    }
+
+    double count = double(frame.width - 2) * (frame.height - 2);
+    double mean = sum / count;
+    result.values[0] = float(sumSquares / count - mean * mean);
+    result.values[1] = float(sumAbs / count);
+}
+
+std::unique_ptr<IFrameAnalyzer> createFrameAnalyzer(const std::string& name, const std::string& streamName)
+{
+    if (name == "luma_histogram") return std::unique_ptr<IFrameAnalyzer>(new LumaHistogramAnalyzer);
+    if (name == "motion") return std::unique_ptr<IFrameAnalyzer>(new MotionAnalyzer(streamName));
+    if (name == "blur") return std::unique_ptr<IFrameAnalyzer>(new BlurAnalyzer);
+    return nullptr;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FrameAnalysis.h"
+#include "MemoryBudget.h"
+
+// Reference analyzers working on the Y plane only. Inner loops are plain
+// C++ written so the compiler vectorises them (no cross-iteration
+// dependencies, narrow integer accumulators flushed per row), like the
+// conversion kernels in FrameConvert.
+
+// "luma_histogram": values[0] mean luma, [1] fraction of pixels at or below
+// 16 (crushed blacks), [2] fraction at or above 235 (blown highlights),
+// [3..18] 16-bin histogram as fractions
+class LumaHistogramAnalyzer : public IFrameAnalyzer
+{
+public:
+    const char* name() const override { return "luma_histogram"; }
+    void analyze(const I420Frame& frame, AnalysisResult& result) override;
+};
+
+// "motion": values[0] mean absolute luma difference to the previous sampled
+// frame (0-255), [1] fraction of pixels that changed by more than 24. Zero
+// on the first frame and after a resolution change.
+class MotionAnalyzer : public IFrameAnalyzer
+{
+public:
+    explicit MotionAnalyzer(const std::string& streamName);
+    ~MotionAnalyzer();
+
+    const char* name() const override { return "motion"; }
+    void analyze(const I420Frame& frame, AnalysisResult& result) override;
+
+private:
+    std::vector<uint8_t> m_previous;  // packed Y of the last sampled frame
+    int m_width;
+    int m_height;
+    MemoryBudget::Account m_budgetAccount;
+};
+
+// "blur": values[0] variance of the 4-neighbour Laplacian (low = blurry or
+// flat), [1] its mean absolute value
+class BlurAnalyzer : public IFrameAnalyzer
+{
+public:
+    const char* name() const override { return "blur"; }
+    void analyze(const I420Frame& frame, AnalysisResult& result) override;
+};
+
+// Analyzer by name ("luma_histogram", "motion", "blur"); null if unknown
+std::unique_ptr<IFrameAnalyzer> createFrameAnalyzer(const std::string& name, const std::string& streamName);
@@ -0,0 +1,156 @@
+#include "MemoryBudget.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+const size_t kDefaultLimit = size_t(512) * 1024 * 1024;
+
+// Half of the cgroup v2 (or v1) memory limit leaves room for the SDK itself
+size_t defaultLimit()
+{
+    const char* env = getenv("BOT_MEMORY_BUDGET_MB");
+    if (env && atoll(env) > 0) {
+        return size_t(atoll(env)) * 1024 * 1024;
+    }
+
+    const char* paths[] = { "/sys/fs/cgroup/memory.max", "/sys/fs/cgroup/memory/memory.limit_in_bytes" };
+    for (const char* path : paths) {
+        FILE* f = fopen(path, "r");
+        if (!f) continue;
+        unsigned long long value = 0;
+        int matched = fscanf(f, "%llu", &value);
+        fclose(f);
+        // "max" or an absurd v1 value means unlimited
+        if (matched == 1 && value > 0 && value < (1ULL << 50)) {
+            return size_t(value / 2);
+        }
+    }
+    return kDefaultLimit;
+}
+
+} // namespace
+
+MemoryBudget::Account::Account(const std::string& name)
+    : m_name(name)
+    , m_bytes(0)
+    , m_peakBytes(0)
+    , m_refusals(0)
+{
+    MemoryBudget::instance().registerAccount(this);
+}
+
+MemoryBudget::Account::~Account()
+{
+    MemoryBudget& budget = MemoryBudget::instance();
+    budget.unreserve(m_bytes.exchange(0));
+    budget.unregisterAccount(this);
+}
+
+void MemoryBudget::Account::setName(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(MemoryBudget::instance().m_registryMutex);
+    m_name = name;
+}
+
+bool MemoryBudget::Account::tryCharge(size_t bytes)
+{
+    if (!MemoryBudget::instance().reserve(bytes)) {
+        m_refusals.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    size_t now = m_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = m_peakBytes.load(std::memory_order_relaxed);
+    while (now > peak && !m_peakBytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+void MemoryBudget::Account::release(size_t bytes)
+{
+    m_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    MemoryBudget::instance().unreserve(bytes);
+}
+
+MemoryBudget& MemoryBudget::instance()
+{
+    static MemoryBudget budget;
+    return budget;
+}
+
+MemoryBudget::MemoryBudget()
+    : m_limit(defaultLimit())
+    , m_used(0)
+    , m_highWatermark(0.85)
+{
+}
+
+void MemoryBudget::setLimit(size_t bytes)
+{
+    m_limit.store(bytes, std::memory_order_relaxed);
+    LOG_INFO("Memory budget limit set to %zu MB", bytes / (1024 * 1024));
+}
+
+bool MemoryBudget::isUnderPressure() const
+{
+    return used() > size_t(limit() * m_highWatermark);
+}
+
+bool MemoryBudget::canAdmit(size_t bytes) const
+{
+    return used() + bytes <= size_t(limit() * m_highWatermark);
+}
+
+bool MemoryBudget::reserve(size_t bytes)
+{
+    size_t current = m_used.load(std::memory_order_relaxed);
+    do {
+        if (current + bytes > limit()) return false;
+    } while (!m_used.compare_exchange_weak(current, current + bytes, std::memory_order_relaxed));
+    return true;
+}
+
+void MemoryBudget::unreserve(size_t bytes)
+{
+    m_used.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void MemoryBudget::registerAccount(Account* account)
+{
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    m_accounts.push_back(account);
+}
+
+void MemoryBudget::unregisterAccount(Account* account)
+{
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    m_accounts.erase(std::remove(m_accounts.begin(), m_accounts.end(), account), m_accounts.end());
+}
+
+std::vector<MemoryBudget::AccountUsage> MemoryBudget::usage() const
+{
+    std::vector<AccountUsage> result;
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    result.reserve(m_accounts.size());
+    for (const Account* account : m_accounts) {
+        result.push_back({ account->m_name.empty() ? "(unnamed)" : account->m_name,
+                           account->m_bytes.load(std::memory_order_relaxed),
+                           account->m_peakBytes.load(std::memory_order_relaxed),
+                           account->m_refusals.load(std::memory_order_relaxed) });
+    }
+    return result;
+}
+
+void MemoryBudget::report() const
+{
+    LOG_INFO("Memory budget: %zu / %zu KB in use%s", used() / 1024, limit() / 1024,
+             isUnderPressure() ? " (under pressure)" : "");
+    for (const AccountUsage& account : usage()) {
+        if (account.peakBytes == 0 && account.refusals == 0) continue;
+        LOG_INFO("  %-24s %8zu KB (peak %zu KB, %llu refused)", account.name.c_str(),
+                 account.bytes / 1024, account.peakBytes / 1024, (unsigned long long)account.refusals);
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Process-wide budget for frame buffers and queues. Every long-lived video or
+// audio buffer is charged to a per-stream Account; a charge that would take
+// the total over the limit is refused and the caller sheds load (drops the
+// frame, or subscribes at a lower resolution) instead of growing RSS.
+class MemoryBudget
+{
+public:
+    class Account
+    {
+    public:
+        explicit Account(const std::string& name = std::string());
+        ~Account();
+
+        Account(const Account&) = delete;
+        Account& operator=(const Account&) = delete;
+
+        void setName(const std::string& name);
+
+        // Returns false (and counts a refusal) if the budget cannot cover it
+        bool tryCharge(size_t bytes);
+        void release(size_t bytes);
+
+        size_t chargedBytes() const { return m_bytes.load(std::memory_order_relaxed); }
+
+    private:
+        friend class MemoryBudget;
+
+        std::string m_name;  // guarded by the budget's registry mutex
+        std::atomic<size_t> m_bytes;
+        std::atomic<size_t> m_peakBytes;
+        std::atomic<uint64_t> m_refusals;
+    };
+
+    struct AccountUsage
+    {
+        std::string name;
+        size_t bytes;
+        size_t peakBytes;
+        uint64_t refusals;
+    };
+
+    static MemoryBudget& instance();
+
+    // Limit in bytes; defaults to half the cgroup memory limit, or 512 MB
+    void setLimit(size_t bytes);
+    size_t limit() const { return m_limit.load(std::memory_order_relaxed); }
+    size_t used() const { return m_used.load(std::memory_order_relaxed); }
+
+    // Fraction of the limit above which new high-resolution work is refused
+    void setHighWatermark(double fraction) { m_highWatermark = fraction; }
+
+    bool isUnderPressure() const;
+
+    // Whether a new stream needing this many bytes fits under the watermark
+    bool canAdmit(size_t bytes) const;
+
+    std::vector<AccountUsage> usage() const;
+    void report() const;
+
+private:
+    MemoryBudget();
+
+    bool reserve(size_t bytes);
+    void unreserve(size_t bytes);
+
+    void registerAccount(Account* account);
+    void unregisterAccount(Account* account);
+
+    std::atomic<size_t> m_limit;
+    std::atomic<size_t> m_used;
+    double m_highWatermark;
+
+    mutable std::mutex m_registryMutex;
+    std::vector<Account*> m_accounts;
+};
@@ -0,0 +1,94 @@
+#include "QtDeviceComboBox.h"
+#include "StartupProfiler.h"
+
+#include <QSignalBlocker>
+
+QtDeviceComboBox::QtDeviceComboBox(DeviceKind kind, QWidget* parent)
+    : QComboBox(parent)
+    , m_kind(kind)
+    , m_filled(false)
+    , m_userSelected(false)
+{
+    // activated is only emitted for user interaction
+    connect(this, QOverload<int>::of(&QComboBox::activated), this, [this](int) { m_userSelected = true; });
+}
+
+int QtDeviceComboBox::indexOfDevice(const std::string& id) const
+{
+    return id.empty() ? -1 : findData(QString::fromStdString(id));
+}
+
+void QtDeviceComboBox::fill()
+{
+    DeviceCache& cache = DeviceCache::instance();
+    cache.refresh(m_kind);
+    if (cache.isDirty(m_kind)) return;  // SDK not ready yet
+
+    QSignalBlocker blocker(this);
+    int selected = -1;
+    for (const DeviceInfo& device : cache.devices(m_kind)) {
+        if (device.selected) selected = count();
+        addItem(QString::fromStdString(device.name), QString::fromStdString(device.id));
+    }
+    // Shows the device the SDK already uses, so there is nothing to apply
+    setCurrentIndex(selected >= 0 ? selected : (count() > 0 ? 0 : -1));
+    m_filled = true;
+
+    static bool firstEnumeration = true;
+    if (firstEnumeration) {
+        StartupProfiler::mark("first device enumeration");
+        firstEnumeration = false;
+    }
+}
+
+void QtDeviceComboBox::applyDiff(const DeviceDiff& diff)
+{
+    if (!m_filled || diff.empty()) return;
+
+    std::string current = currentData().toString().toStdString();
+    {
+        QSignalBlocker blocker(this);
+        for (const std::string& id : diff.removed) {
+            int index = indexOfDevice(id);
+            if (index >= 0) removeItem(index);
+        }
+        for (const DeviceInfo& device : diff.renamed) {
+            int index = indexOfDevice(device.id);
+            if (index >= 0) setItemText(index, QString::fromStdString(device.name));
+        }
+        for (const DeviceInfo& device : diff.added) {
+            addItem(QString::fromStdString(device.name), QString::fromStdString(device.id));
+        }
+    }
+
+    int currentIndexNow = indexOfDevice(current);
+    int sdkIndex = indexOfDevice(diff.selectedId);
+    if (currentIndexNow >= 0) {
+        // Still present: keep the user's device, or follow the SDK if the user never chose
+        QSignalBlocker blocker(this);
+        setCurrentIndex(!m_userSelected && diff.selectionChanged && sdkIndex >= 0 ? sdkIndex : currentIndexNow);
+    } else if (sdkIndex >= 0) {
+        // The selected device went away and the SDK has already moved on
+        QSignalBlocker blocker(this);
+        setCurrentIndex(sdkIndex);
+        m_userSelected = false;
+    } else {
+        // Removal already moved the index while signals were blocked
+        m_userSelected = false;
+        {
+            QSignalBlocker blocker(this);
+            setCurrentIndex(count() > 0 ? 0 : -1);
+        }
+        if (currentIndex() >= 0) emit currentIndexChanged(currentIndex());
+    }
+}
+
+void QtDeviceComboBox::showPopup()
+{
+    if (!m_filled) {
+        fill();
+    } else if (DeviceCache::instance().isDirty(m_kind)) {
+        applyDiff(DeviceCache::instance().refresh(m_kind));
+    }
+    QComboBox::showPopup();
+}
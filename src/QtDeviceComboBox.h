@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QComboBox>
+
+#include "DeviceCache.h"
+
+// Device combo box backed by DeviceCache. It is filled from the cache the
+// first time its popup opens instead of at startup; after that hot-plug
+// diffs are applied item by item, so the list is never rebuilt and the
+// user's chosen device stays selected for as long as it exists.
+class QtDeviceComboBox : public QComboBox
+{
+    Q_OBJECT
+
+public:
+    explicit QtDeviceComboBox(DeviceKind kind, QWidget* parent = nullptr);
+
+    DeviceKind kind() const { return m_kind; }
+    bool isFilled() const { return m_filled; }
+
+    // Adds, removes and renames items in place. currentIndexChanged fires
+    // only if the selected device disappeared and another was picked.
+    void applyDiff(const DeviceDiff& diff);
+
+    void showPopup() override;
+
+private:
+    void fill();
+    int indexOfDevice(const std::string& id) const;
+
+    DeviceKind m_kind;
+    bool m_filled;
+    bool m_userSelected;  // the user picked a device; don't follow the SDK's selection
+};
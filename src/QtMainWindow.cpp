@@ -1,13 +1,25 @@
 #include "QtMainWindow.h"
 #include "QtVideoWidget.h"
+#include "QtVideoRenderer.h"
+#include "QtShareWidget.h"
+#include "QtStatusLog.h"
+#include "ShareCanvas.h"
 #include "QtPreviewVideoHandler.h"
+#include "QtDeviceComboBox.h"
+#include "FrameHub.h"
+#include "EventBus.h"
+#include "StartupProfiler.h"
+#include "SubscriptionPolicy.h"
+#include "VirtualShareSource.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFormLayout>
 #include <QGroupBox>
+#include <QImage>
 #include <QLabel>
-#include <QTimer>
-#include <QDebug>
+#include <QMetaObject>
+#include <QResizeEvent>
+#include "Logger.h"
 
 // Include Zoom SDK headers
 #include "zoom_video_sdk_def.h"
@@ -20,15 +32,6 @@
 // Use Zoom SDK namespace
 USING_ZOOM_VIDEO_SDK_NAMESPACE
 
-// Include external function
-extern void joinVideoSDKSession(const QString& session_name, const QString& session_psw, const QString& session_token);
-
-// External variables
-extern IZoomVideoSDK* video_sdk_obj;
-extern bool g_in_session;
-extern bool g_audio_muted;
-extern bool g_video_muted;
-
 QtMainWindow::QtMainWindow(QWidget* parent)
     : QMainWindow(parent)
     , m_selfVideoEnabled(false)
@@ -68,9 +71,10 @@ QtMainWindow::QtMainWindow(QWidget* parent)
     QGroupBox* deviceGroup = new QGroupBox("Device Settings");
     QFormLayout* deviceLayout = new QFormLayout(deviceGroup);
 
-    m_cameraCombo = new QComboBox();
-    m_microphoneCombo = new QComboBox();
-    m_speakerCombo = new QComboBox();
+    // Devices are enumerated when a list is first opened, not at startup
+    m_cameraCombo = new QtDeviceComboBox(DEVICE_CAMERA);
+    m_microphoneCombo = new QtDeviceComboBox(DEVICE_MICROPHONE);
+    m_speakerCombo = new QtDeviceComboBox(DEVICE_SPEAKER);
     m_resolutionCombo = new QComboBox();
 
     // Populate resolution combo
@@ -95,11 +99,16 @@ QtMainWindow::QtMainWindow(QWidget* parent)
     m_leaveButton = new QPushButton("Leave Session");
     m_muteAudioButton = new QPushButton("Mute Audio");
     m_selfVideoButton = new QPushButton("Start Video");
+    m_shareWindowButton = new QPushButton("Share Window");
 
     controlLayout->addWidget(m_joinButton);
     controlLayout->addWidget(m_leaveButton);
     controlLayout->addWidget(m_muteAudioButton);
     controlLayout->addWidget(m_selfVideoButton);
+    controlLayout->addWidget(m_shareWindowButton);
+
+    m_shareGrabTimer = new QTimer(this);
+    m_shareGrabTimer->setInterval(100);
 
     mainLayout->addLayout(controlLayout);
 
@@ -107,11 +116,10 @@ QtMainWindow::QtMainWindow(QWidget* parent)
     QGroupBox* statusGroup = new QGroupBox("Status");
     QVBoxLayout* statusLayout = new QVBoxLayout(statusGroup);
 
-    m_statusText = new QTextEdit();
-    m_statusText->setMaximumHeight(100);
-    m_statusText->setReadOnly(true);
+    m_statusLog = new QtStatusLog();
+    m_statusLog->setMaximumHeight(100);
 
-    statusLayout->addWidget(m_statusText);
+    statusLayout->addWidget(m_statusLog);
     mainLayout->addWidget(statusGroup);
 
     // Create video display area
@@ -130,16 +138,32 @@ QtMainWindow::QtMainWindow(QWidget* parent)
     m_remoteVideoWidget = new QtVideoWidget();
     remoteVideoLayout->addWidget(m_remoteVideoWidget);
 
+    // Screen share widget
+    QVBoxLayout* shareLayout = new QVBoxLayout();
+    shareLayout->addWidget(new QLabel("Screen Share"));
+    m_shareWidget = new QtShareWidget();
+    shareLayout->addWidget(m_shareWidget);
+
     videoLayout->addLayout(selfVideoLayout);
     videoLayout->addLayout(remoteVideoLayout);
+    videoLayout->addLayout(shareLayout);
 
     mainLayout->addWidget(videoGroup);
 
+    // Preview and one-way self frames both arrive through the self hub, so
+    // the camera is converted once whichever path delivers it
+    m_selfRenderer = std::make_shared<QtVideoRenderer>(m_selfVideoWidget);
+    selfVideoHub().subscribe(m_selfRenderer, QtVideoRenderer::variant());
+    m_mixedRenderer = std::make_shared<QtVideoRenderer>(m_remoteVideoWidget);
+    mixedVideoHub().subscribe(m_mixedRenderer, QtVideoRenderer::variant());
+
     // Connect signals
     connect(m_joinButton, &QPushButton::clicked, this, &QtMainWindow::onJoinSessionClicked);
     connect(m_leaveButton, &QPushButton::clicked, this, &QtMainWindow::onLeaveSessionClicked);
     connect(m_muteAudioButton, &QPushButton::clicked, this, &QtMainWindow::onMuteAudioClicked);
     connect(m_selfVideoButton, &QPushButton::clicked, this, &QtMainWindow::onSelfVideoClicked);
+    connect(m_shareWindowButton, &QPushButton::clicked, this, &QtMainWindow::onShareWindowClicked);
+    connect(m_shareGrabTimer, &QTimer::timeout, this, &QtMainWindow::grabForShare);
 
     connect(m_cameraCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &QtMainWindow::onCameraChanged);
     connect(m_microphoneCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &QtMainWindow::onMicrophoneChanged);
@@ -152,93 +176,105 @@ QtMainWindow::QtMainWindow(QWidget* parent)
 
 QtMainWindow::~QtMainWindow()
 {
+    delete m_previewHandler;
+    selfVideoHub().unsubscribe(m_selfRenderer.get());
+    mixedVideoHub().unsubscribe(m_mixedRenderer.get());
+}
+
+void QtMainWindow::onStatusMessage(const std::string& message)
+{
+    updateStatus(QString::fromStdString(message));
+}
+
+void QtMainWindow::onSessionStateChanged()
+{
+    updateButtonStates();
+}
+
+void QtMainWindow::onSessionEvent(const BotEvent& event)
+{
+    switch (event.type) {
+    case BOT_EVENT_SDK_READY:
+        if (event.code) StartupProfiler::markReady("ready to join");
+        break;
+    case BOT_EVENT_DEVICES_CHANGED:
+        onDevicesChanged(event.code);
+        break;
+    default:
+        break;
+    }
+}
+
+void QtMainWindow::requestEventDispatch()
+{
+    // Queued, so the SDK thread returns at once
+    QMetaObject::invokeMethod(this, "dispatchSessionEvents", Qt::QueuedConnection);
+}
+
+void QtMainWindow::dispatchSessionEvents()
+{
+    dispatchBotEvents(this);
+}
+
+void QtMainWindow::onRemoteVideoStarted(const std::string& streamName, FrameHub& hub)
+{
+    // The hub owns the renderer from here on and drops it with the subscription
+    LOG_DEBUG("Rendering %s", streamName.c_str());
+    hub.subscribe(std::make_shared<QtVideoRenderer>(m_remoteVideoWidget), QtVideoRenderer::variant());
+}
+
+void QtMainWindow::onShareStarted(const std::string& streamName, FrameHub& hub)
+{
+    // The newest share replaces the one shown; the widget keeps the canvas
+    // and the hub keeps feeding it until the share ends
+    LOG_DEBUG("Showing %s", streamName.c_str());
+    std::shared_ptr<ShareCanvas> canvas = std::make_shared<ShareCanvas>(streamName);
+    m_shareWidget->setCanvas(canvas);
+    hub.subscribe(canvas, ShareCanvas::variant());
 }
 
 void QtMainWindow::updateStatus(const QString& message)
 {
-    m_statusText->append(message);
-    // Scroll to bottom
-    QTextCursor cursor = m_statusText->textCursor();
-    cursor.movePosition(QTextCursor::End);
-    m_statusText->setTextCursor(cursor);
+    m_statusLog->post(message);
 }
 
 void QtMainWindow::updateButtonStates()
 {
-    printf("DEBUG: updateButtonStates() called, g_in_session = %s\n", g_in_session ? "true" : "false");
+    LOG_DEBUG("updateButtonStates() called, g_in_session = %s", g_in_session ? "true" : "false");
 
-    m_joinButton->setEnabled(!g_in_session);
+    m_joinButton->setEnabled(!g_in_session && isVideoSDKReady());
     m_leaveButton->setEnabled(g_in_session);
     m_muteAudioButton->setEnabled(g_in_session);
     m_selfVideoButton->setEnabled(g_in_session);
+    m_shareWindowButton->setEnabled(g_in_session);
+
+    // The share ends with the session
+    if (!g_in_session) m_shareGrabTimer->stop();
 
     m_muteAudioButton->setText(g_audio_muted ? "Unmute Audio" : "Mute Audio");
     m_selfVideoButton->setText(m_selfVideoEnabled ? "Stop Video" : "Start Video");
+    m_shareWindowButton->setText(m_shareGrabTimer->isActive() ? "Stop Sharing" : "Share Window");
 
-    printf("DEBUG: Buttons updated - Join:%s, Leave:%s, Mute:%s, Video:%s\n",
-           m_joinButton->isEnabled() ? "enabled" : "disabled",
-           m_leaveButton->isEnabled() ? "enabled" : "disabled",
-           m_muteAudioButton->isEnabled() ? "enabled" : "disabled",
-           m_selfVideoButton->isEnabled() ? "enabled" : "disabled");
+    LOG_DEBUG("Buttons updated - Join:%s, Leave:%s, Mute:%s, Video:%s",
+              m_joinButton->isEnabled() ? "enabled" : "disabled",
+              m_leaveButton->isEnabled() ? "enabled" : "disabled",
+              m_muteAudioButton->isEnabled() ? "enabled" : "disabled",
+              m_selfVideoButton->isEnabled() ? "enabled" : "disabled");
 }
 
-void QtMainWindow::populateDeviceDropdowns()
+void QtMainWindow::onDevicesChanged(int kinds)
 {
-    if (!video_sdk_obj) return;
-
-    // Populate camera dropdown
-    m_cameraCombo->clear();
-    IZoomVideoSDKVideoHelper* videoHelper = video_sdk_obj->getVideoHelper();
-    if (videoHelper) {
-        IVideoSDKVector<IZoomVideoSDKCameraDevice*>* cameraList = videoHelper->getCameraList();
-        if (cameraList) {
-            int count = cameraList->GetCount();
-            for (int i = 0; i < count; i++) {
-                IZoomVideoSDKCameraDevice* camera = cameraList->GetItem(i);
-                if (camera) {
-                    QString cameraName = camera->getDeviceName();
-                    QString cameraId = camera->getDeviceId();
-                    m_cameraCombo->addItem(cameraName, cameraId);
-                }
-            }
-            if (count > 0) m_cameraCombo->setCurrentIndex(0);
+    for (QtDeviceComboBox* combo : { m_cameraCombo, m_microphoneCombo, m_speakerCombo }) {
+        // Lists nobody has opened yet stay dirty until they are
+        if (!(kinds & combo->kind()) || !combo->isFilled()) continue;
+
+        DeviceDiff diff = DeviceCache::instance().refresh(combo->kind());
+        combo->applyDiff(diff);
+        for (const DeviceInfo& device : diff.added) {
+            updateStatus(QString("Device added: %1").arg(QString::fromStdString(device.name)));
         }
-    }
-
-    // Populate microphone dropdown
-    m_microphoneCombo->clear();
-    IZoomVideoSDKAudioHelper* audioHelper = video_sdk_obj->getAudioHelper();
-    if (audioHelper) {
-        IVideoSDKVector<IZoomVideoSDKMicDevice*>* micList = audioHelper->getMicList();
-        if (micList) {
-            int count = micList->GetCount();
-            for (int i = 0; i < count; i++) {
-                IZoomVideoSDKMicDevice* mic = micList->GetItem(i);
-                if (mic) {
-                    QString micName = mic->getDeviceName();
-                    QString micId = mic->getDeviceId();
-                    m_microphoneCombo->addItem(micName, micId);
-                }
-            }
-            if (count > 0) m_microphoneCombo->setCurrentIndex(0);
-        }
-    }
-
-    // Populate speaker dropdown
-    m_speakerCombo->clear();
-    if (audioHelper) {
-        IVideoSDKVector<IZoomVideoSDKSpeakerDevice*>* speakerList = audioHelper->getSpeakerList();
-        if (speakerList) {
-            int count = speakerList->GetCount();
-            for (int i = 0; i < count; i++) {
-                IZoomVideoSDKSpeakerDevice* speaker = speakerList->GetItem(i);
-                if (speaker) {
-                    QString speakerName = speaker->getDeviceName();
-                    QString speakerId = speaker->getDeviceId();
-                    m_speakerCombo->addItem(speakerName, speakerId);
-                }
-            }
-            if (count > 0) m_speakerCombo->setCurrentIndex(0);
+        if (!diff.removed.empty()) {
+            updateStatus(QString("%1 device(s) removed").arg(diff.removed.size()));
         }
     }
 }
@@ -259,16 +295,12 @@ void QtMainWindow::onJoinSessionClicked()
 
     // Join the session
     joinVideoSDKSession(sessionName, sessionPassword, signature);
-
-    // Populate device dropdowns after SDK initialization
-    QTimer::singleShot(1000, this, &QtMainWindow::populateDeviceDropdowns);
 }
 
 void QtMainWindow::onLeaveSessionClicked()
 {
     if (video_sdk_obj && g_in_session) {
-        video_sdk_obj->leaveSession(false);
-        g_in_session = false;
+        leaveVideoSDKSession();
         updateButtonStates();
         updateStatus("Left session");
     }
@@ -276,115 +308,91 @@ void QtMainWindow::onLeaveSessionClicked()
 
 void QtMainWindow::onMuteAudioClicked()
 {
-    printf("DEBUG: onMuteAudioClicked() called, current state: %s\n", g_audio_muted ? "muted" : "unmuted");
+    LOG_DEBUG("onMuteAudioClicked() called, current state: %s", g_audio_muted ? "muted" : "unmuted");
 
-    if (video_sdk_obj && g_in_session) {
-        IZoomVideoSDKAudioHelper* audioHelper = video_sdk_obj->getAudioHelper();
-        if (audioHelper) {
-            IZoomVideoSDKSession* session = video_sdk_obj->getSessionInfo();
-            if (session) {
-                IZoomVideoSDKUser* currentUser = session->getMyself();
-                if (currentUser) {
-                    printf("DEBUG: Current user obtained: %s\n", currentUser->getUserName());
-
-                    if (g_audio_muted) {
-                        printf("DEBUG: Calling audioHelper->unMuteAudio()\n");
-                        ZoomVideoSDKErrors err = audioHelper->unMuteAudio(currentUser);
-                        printf("DEBUG: unMuteAudio() returned: %d\n", (int)err);
-                        if (err == ZoomVideoSDKErrors_Success) {
-                            g_audio_muted = false;
-                            updateStatus("Audio unmuted");
-                        } else {
-                            updateStatus("Failed to unmute audio");
-                        }
-                    } else {
-                        printf("DEBUG: Calling audioHelper->muteAudio()\n");
-                        ZoomVideoSDKErrors err = audioHelper->muteAudio(currentUser);
-                        printf("DEBUG: muteAudio() returned: %d\n", (int)err);
-                        if (err == ZoomVideoSDKErrors_Success) {
-                            g_audio_muted = true;
-                            updateStatus("Audio muted");
-                        } else {
-                            updateStatus("Failed to mute audio");
-                        }
-                    }
-                    updateButtonStates();
-                } else {
-                    printf("DEBUG: ERROR - Current user is NULL!\n");
-                    updateStatus("Failed to get current user");
-                }
-            } else {
-                printf("DEBUG: ERROR - Session is NULL!\n");
-                updateStatus("Session not available");
-            }
-        } else {
-            printf("DEBUG: ERROR - Audio helper is NULL!\n");
-            updateStatus("Audio helper not available");
-        }
-    } else {
-        printf("DEBUG: Not in session or SDK not initialized\n");
+    if (!video_sdk_obj || !g_in_session) {
+        LOG_DEBUG("Not in session or SDK not initialized");
         updateStatus("Not in session or SDK not initialized");
+        return;
+    }
+
+    // Goes through the session so the command channel announces the change
+    bool mute = !g_audio_muted;
+    if (setSelfAudioMuted(mute)) {
+        updateStatus(mute ? "Audio muted" : "Audio unmuted");
+    } else {
+        updateStatus(mute ? "Failed to mute audio" : "Failed to unmute audio");
     }
+    updateButtonStates();
+}
+
+void QtMainWindow::onShareWindowClicked()
+{
+    if (m_shareGrabTimer->isActive()) {
+        m_shareGrabTimer->stop();
+        stopVirtualShare();
+        updateStatus("Stopped sharing the window");
+    } else if (startVirtualShare()) {
+        grabForShare();
+        m_shareGrabTimer->start();
+        updateStatus("Sharing the window");
+    } else {
+        updateStatus("Failed to start sharing the window");
+    }
+    updateButtonStates();
+}
+
+void QtMainWindow::grabForShare()
+{
+    // The source reads 0xAARRGGBB words; for the usual RGB32 grab the
+    // conversion is a no-op
+    QImage image = grab().toImage().convertToFormat(QImage::Format_RGB32);
+    virtualShareSource().submitRGB32(image.constBits(), image.bytesPerLine(), image.width(), image.height());
 }
 
 void QtMainWindow::onSelfVideoClicked()
 {
-    printf("DEBUG: onSelfVideoClicked() called, current state: %s\n", m_selfVideoEnabled ? "enabled" : "disabled");
+    LOG_DEBUG("onSelfVideoClicked() called, current state: %s", m_selfVideoEnabled ? "enabled" : "disabled");
 
-    if (video_sdk_obj && g_in_session) {
-        IZoomVideoSDKVideoHelper* videoHelper = video_sdk_obj->getVideoHelper();
-        if (videoHelper) {
-            if (m_selfVideoEnabled) {
-                // Stop self video: stop transmission and clean up preview handler
-                printf("DEBUG: Calling videoHelper->stopVideo()\n");
-                ZoomVideoSDKErrors err = videoHelper->stopVideo();
-                printf("DEBUG: videoHelper->stopVideo() returned: %d\n", (int)err);
-
-                // Clean up preview handler
-                if (m_previewHandler) {
-                    m_previewHandler->StopPreview();
-                    delete m_previewHandler;
-                    m_previewHandler = nullptr;
-                    printf("DEBUG: Preview handler stopped and cleaned up\n");
-                }
-
-                m_selfVideoEnabled = false;
-                updateStatus("Video stopped");
+    if (!video_sdk_obj || !g_in_session) {
+        LOG_DEBUG("video_sdk_obj=%p, g_in_session=%s", (void*)video_sdk_obj, g_in_session ? "true" : "false");
+        updateStatus("Not in session or SDK not initialized");
+        return;
+    }
+
+    if (m_selfVideoEnabled) {
+        // Stop self video: stop transmission and clean up preview handler
+        bool stopped = setSelfVideoOn(false);
+
+        if (m_previewHandler) {
+            m_previewHandler->StopPreview();
+            delete m_previewHandler;
+            m_previewHandler = nullptr;
+            LOG_DEBUG("Preview handler stopped and cleaned up");
+        }
+
+        m_selfVideoEnabled = false;
+        updateStatus(stopped ? "Video stopped" : "Failed to stop video transmission");
+    } else if (setSelfVideoOn(true)) {
+        // Create preview handler for self video display
+        if (!m_previewHandler) {
+            m_previewHandler = new QtPreviewVideoHandler(&selfVideoHub());
+            if (m_previewHandler->StartPreview()) {
+                LOG_DEBUG("Preview handler started successfully");
+                updateStatus("Video started - preview active");
             } else {
-                // Start self video: start transmission and create preview handler
-                printf("DEBUG: Calling videoHelper->startVideo()\n");
-                ZoomVideoSDKErrors err = videoHelper->startVideo();
-                printf("DEBUG: videoHelper->startVideo() returned: %d\n", (int)err);
-
-                if (err == ZoomVideoSDKErrors_Success) {
-                    // Create preview handler for self video display
-                    if (!m_previewHandler && m_selfVideoWidget) {
-                        m_previewHandler = new QtPreviewVideoHandler(m_selfVideoWidget);
-                        if (m_previewHandler->StartPreview()) {
-                            printf("DEBUG: Preview handler started successfully\n");
-                            updateStatus("Video started - preview active");
-                        } else {
-                            printf("DEBUG: Failed to start preview handler\n");
-                            delete m_previewHandler;
-                            m_previewHandler = nullptr;
-                            updateStatus("Video started but preview failed");
-                        }
-                    }
-
-                    m_selfVideoEnabled = true;
-                } else {
-                    updateStatus("Failed to start video transmission");
-                }
+                LOG_WARN("Failed to start preview handler");
+                delete m_previewHandler;
+                m_previewHandler = nullptr;
+                updateStatus("Video started but preview failed");
             }
-            updateButtonStates();
-        } else {
-            printf("DEBUG: videoHelper is NULL!\n");
-            updateStatus("Video helper not available");
         }
+
+        m_selfVideoEnabled = true;
     } else {
-        printf("DEBUG: video_sdk_obj=%p, g_in_session=%s\n", video_sdk_obj, g_in_session ? "true" : "false");
-        updateStatus("Not in session or SDK not initialized");
+        updateStatus("Failed to start video transmission");
     }
+    updateButtonStates();
 }
 
 void QtMainWindow::onCameraChanged()
@@ -439,11 +447,23 @@ void QtMainWindow::onSpeakerChanged()
 
 void QtMainWindow::onResolutionChanged()
 {
-    if (!video_sdk_obj || !g_in_session) return;
-
     int resolutionValue = m_resolutionCombo->currentData().toInt();
     ZOOMVIDEOSDK::ZoomVideoSDKResolution resolution = static_cast<ZOOMVIDEOSDK::ZoomVideoSDKResolution>(resolutionValue);
 
-    updateStatus(QString("Resolution changed to: %1 (enum value: %2)")
-                .arg(m_resolutionCombo->currentText()).arg((int)resolution));
+    // The lowest resolution remote users are subscribed at; the speaker and
+    // the tile size can raise it
+    int lines = SubscriptionPolicy::kTiers[0];
+    if (resolution >= 0 && resolution < 5) lines = SubscriptionPolicy::kTiers[resolution];
+    SubscriptionPolicy::Config config = subscriptionPolicy().config();
+    config.defaultLines = lines;
+    subscriptionPolicy().setConfig(config);
+    applySubscriptionPolicy();
+
+    updateStatus(QString("Minimum remote resolution: %1").arg(m_resolutionCombo->currentText()));
+}
+
+void QtMainWindow::resizeEvent(QResizeEvent* event)
+{
+    QMainWindow::resizeEvent(event);
+    subscriptionPolicy().setTileHeight(m_remoteVideoWidget->height());
 }
@@ -4,14 +4,20 @@
 #include <QLineEdit>
 #include <QPushButton>
 #include <QComboBox>
-#include <QTextEdit>
 #include <QGroupBox>
+#include <QTimer>
+#include <memory>
+#include "BotSession.h"
 
 class QtVideoWidget;
+class QtVideoRenderer;
+class QtShareWidget;
+class QtStatusLog;
+class QtDeviceComboBox;
 class QtPreviewVideoHandler;
 class QtRemoteVideoHandler;
 
-class QtMainWindow : public QMainWindow
+class QtMainWindow : public QMainWindow, public IBotFrontend
 {
     Q_OBJECT
 
@@ -20,20 +26,36 @@ public:
     ~QtMainWindow();
 
     void updateButtonStates();
-    void populateDeviceDropdowns();
 
     // Video widget accessors for delegate
     QtVideoWidget* getSelfVideoWidget() { return m_selfVideoWidget; }
     QtVideoWidget* getRemoteVideoWidget() { return m_remoteVideoWidget; }
 
+    // IBotFrontend implementation; only requestEventDispatch() is called off the GUI thread
+    void onStatusMessage(const std::string& message) override;
+    void onSessionStateChanged() override;
+    void onSessionEvent(const BotEvent& event) override;
+    void requestEventDispatch() override;
+    void onRemoteVideoStarted(const std::string& streamName, FrameHub& hub) override;
+    void onShareStarted(const std::string& streamName, FrameHub& hub) override;
+
 public slots:
+    // Any thread; never blocks
     void updateStatus(const QString& message);
 
+    // Handle a batch of session events posted by the SDK delegate
+    void dispatchSessionEvents();
+
+protected:
+    // Reports the remote tile size to the subscription policy
+    void resizeEvent(QResizeEvent* event) override;
+
 private slots:
     void onJoinSessionClicked();
     void onLeaveSessionClicked();
     void onMuteAudioClicked();
     void onSelfVideoClicked();
+    void onShareWindowClicked();
     void onCameraChanged();
     void onMicrophoneChanged();
     void onSpeakerChanged();
@@ -50,16 +72,30 @@ private:
     QPushButton* m_leaveButton;
     QPushButton* m_muteAudioButton;
     QPushButton* m_selfVideoButton;
+    QPushButton* m_shareWindowButton;
 
-    QComboBox* m_cameraCombo;
-    QComboBox* m_microphoneCombo;
-    QComboBox* m_speakerCombo;
+    // While sharing, hands a grab of the window to the virtual share source,
+    // which skips the grabs where nothing changed
+    QTimer* m_shareGrabTimer;
+    void grabForShare();
+
+    // Applies hot-plug changes to the device combos that have been filled
+    void onDevicesChanged(int kinds);
+
+    QtDeviceComboBox* m_cameraCombo;
+    QtDeviceComboBox* m_microphoneCombo;
+    QtDeviceComboBox* m_speakerCombo;
     QComboBox* m_resolutionCombo;
 
-    QTextEdit* m_statusText;
+    QtStatusLog* m_statusLog;
 
     QtVideoWidget* m_selfVideoWidget;
     QtVideoWidget* m_remoteVideoWidget;
+    QtShareWidget* m_shareWidget;
+
+    // Subscribed to the self and mixed hubs for the window's lifetime
+    std::shared_ptr<QtVideoRenderer> m_selfRenderer;
+    std::shared_ptr<QtVideoRenderer> m_mixedRenderer;
 
     // Video handlers (equivalent to GTK's handlers)
     QtPreviewVideoHandler* m_previewHandler;
@@ -1,9 +1,9 @@
 #include "QtRemoteVideoHandler.h"
-#include "QtVideoWidget.h"
-#include "QtVideoRenderer.h"
-#include <QTimer>
-#include <QPainter>
-#include <QDebug>
+#include "AllocationTracker.h"
+#include "SdkVideoFrame.h"
+#include "Logger.h"
+#include "MemoryBudget.h"
+#include "StreamWatchdog.h"
 
 // Include Zoom SDK headers for video functionality
 #include "zoom_video_sdk_api.h"
@@ -13,27 +13,49 @@
 
 USING_ZOOM_VIDEO_SDK_NAMESPACE
 
+namespace {
+
+// Budget needed by one subscribed stream: the StrandedFrameSink's pool of up
+// to three I420 frames copied off the SDK thread, plus the FrameHub's pool of
+// three converted ARGB32 frames for the renderer's variant at source size
+size_t estimateStreamBytes(ZoomVideoSDKResolution resolution)
+{
+    size_t width, height;
+    switch (resolution) {
+    case ZoomVideoSDKResolution_90P:  width = 160;  height = 90;   break;
+    case ZoomVideoSDKResolution_180P: width = 320;  height = 180;  break;
+    case ZoomVideoSDKResolution_360P: width = 640;  height = 360;  break;
+    case ZoomVideoSDKResolution_720P: width = 1280; height = 720;  break;
+    default:                          width = 1920; height = 1080; break;
+    }
+    size_t i420 = width * height * 3 / 2;
+    size_t argb = width * height * 4;
+    return 3 * i420 + 3 * argb;
+}
+
+} // namespace
+
 // Qt equivalent of GTK's RemoteVideoRawDataHandler for remote video
-QtRemoteVideoHandler::QtRemoteVideoHandler(QtVideoWidget* widget)
+QtRemoteVideoHandler::QtRemoteVideoHandler(IVideoFrameSink* sink)
     : QObject(nullptr)
-    , m_videoWidget(widget)
+    , m_sink(sink)
     , m_currentUser(nullptr)
     , m_videoPipe(nullptr)
     , m_isSubscribed(false)
 {
-    qDebug() << "QtRemoteVideoHandler: Created new handler instance";
+    LOG_DEBUG("QtRemoteVideoHandler: Created new handler instance");
 }
 
 QtRemoteVideoHandler::~QtRemoteVideoHandler()
 {
     Unsubscribe();
-    qDebug() << "QtRemoteVideoHandler: Destroyed handler instance";
+    LOG_DEBUG("QtRemoteVideoHandler: Destroyed handler instance");
 }
 
 bool QtRemoteVideoHandler::SubscribeToUser(IZoomVideoSDKUser* user, ZoomVideoSDKResolution resolution)
 {
-    if (!user || !m_videoWidget) {
-        qDebug() << "QtRemoteVideoHandler: Invalid user or widget";
+    if (!user) {
+        LOG_WARN("QtRemoteVideoHandler: Invalid user");
         return false;
     }
 
@@ -43,21 +65,39 @@ bool QtRemoteVideoHandler::SubscribeToUser(IZoomVideoSDKUser* user, ZoomVideoSDK
     // Get the user's video pipe
     m_videoPipe = user->GetVideoPipe();
     if (!m_videoPipe) {
-        qDebug() << "QtRemoteVideoHandler: No video pipe available for user" << user->getUserName();
+        LOG_WARN("QtRemoteVideoHandler: No video pipe available for user %s", user->getUserName());
+        return false;
+    }
+
+    // Step down to a resolution the memory budget can still hold
+    MemoryBudget& budget = MemoryBudget::instance();
+    ZoomVideoSDKResolution requested = resolution;
+    while (resolution > ZoomVideoSDKResolution_90P && !budget.canAdmit(estimateStreamBytes(resolution))) {
+        resolution = static_cast<ZoomVideoSDKResolution>(resolution - 1);
+    }
+    if (!budget.canAdmit(estimateStreamBytes(resolution))) {
+        LOG_WARN("QtRemoteVideoHandler: Memory budget exhausted, refusing subscription for user %s",
+                 user->getUserName());
+        m_videoPipe = nullptr;
         return false;
     }
+    if (resolution != requested) {
+        LOG_WARN("QtRemoteVideoHandler: Memory budget under pressure, subscribing user %s at resolution %d instead of %d",
+                 user->getUserName(), (int)resolution, (int)requested);
+    }
 
     // Subscribe to raw data from the video pipe with specified resolution
     ZoomVideoSDKErrors err = m_videoPipe->subscribe(resolution, this);
     if (err == ZoomVideoSDKErrors_Success) {
         m_currentUser = user;
         m_isSubscribed = true;
-        qDebug() << "QtRemoteVideoHandler: Successfully subscribed to raw data for user" << user->getUserName() 
-                 << "at resolution" << (int)resolution;
+        if (m_watch) m_watch->setActive(true);
+        LOG_INFO("QtRemoteVideoHandler: Successfully subscribed to raw data for user %s at resolution %d",
+                 user->getUserName(), (int)resolution);
         return true;
     } else {
-        qDebug() << "QtRemoteVideoHandler: Failed to subscribe to raw data for user" << user->getUserName() 
-                 << "at resolution" << (int)resolution << ", error:" << (int)err;
+        LOG_ERROR("QtRemoteVideoHandler: Failed to subscribe to raw data for user %s at resolution %d, error: %d",
+                  user->getUserName(), (int)resolution, (int)err);
         m_videoPipe = nullptr;
         return false;
     }
@@ -68,9 +108,9 @@ bool QtRemoteVideoHandler::Unsubscribe()
     if (m_isSubscribed && m_videoPipe) {
         ZoomVideoSDKErrors err = m_videoPipe->unSubscribe(this);
         if (err == ZoomVideoSDKErrors_Success) {
-            qDebug() << "QtRemoteVideoHandler: Successfully unsubscribed from raw data";
+            LOG_INFO("QtRemoteVideoHandler: Successfully unsubscribed from raw data");
         } else {
-            qDebug() << "QtRemoteVideoHandler: Failed to unsubscribe from raw data, error:" << (int)err;
+            LOG_ERROR("QtRemoteVideoHandler: Failed to unsubscribe from raw data, error: %d", (int)err);
         }
     }
     
@@ -82,49 +122,37 @@ bool QtRemoteVideoHandler::Unsubscribe()
 
 void QtRemoteVideoHandler::onRawDataFrameReceived(YUVRawDataI420* data)
 {
-    if (!data || !m_videoWidget) {
+    AllocStageScope stage(ALLOC_STAGE_VIDEO_RECEIVE);
+
+    if (m_watch) m_watch->onFrame();
+
+    I420Frame frame;
+    if (!toI420Frame(data, frame)) {
         return;
     }
 
-    const int width = data->GetStreamWidth();
-    const int height = data->GetStreamHeight();
-    
-    // Get YUV data pointers
-    const char* y_data = reinterpret_cast<const char*>(data->GetYBuffer());
-    const char* u_data = reinterpret_cast<const char*>(data->GetUBuffer());
-    const char* v_data = reinterpret_cast<const char*>(data->GetVBuffer());
-    
-    // Calculate strides (assuming standard YUV420 layout)
-    const int y_stride = width;
-    const int u_stride = width / 2;
-    const int v_stride = width / 2;
-    
-    // Render the remote video frame using QtVideoRenderer
-    QtVideoRenderer renderer(m_videoWidget);
-    renderer.renderVideoFrame(y_data, u_data, v_data, width, height, y_stride, u_stride, v_stride);
-    
-    // Debug output (can be removed later)
-    static int frame_count = 0;
-    if (++frame_count % 30 == 0) { // Print every 30 frames
-        qDebug() << "QtRemoteVideoHandler: Rendered remote video frame" << frame_count 
-                 << "(" << width << "x" << height << ")";
-        if (m_currentUser) {
-            qDebug() << "from user" << m_currentUser->getUserName();
-        }
+    if (m_sink) {
+        m_sink->onVideoFrame(frame);
     }
+
+    // Debug output, at most once a second
+    static int frame_count = 0;
+    ++frame_count;
+    LOG_RATE_LIMITED(LOG_LEVEL_DEBUG, 1000, "QtRemoteVideoHandler: Rendered remote video frame %d (%dx%d) from user %s",
+                     frame_count, frame.width, frame.height, m_currentUser ? m_currentUser->getUserName() : "?");
 }
 
 void QtRemoteVideoHandler::onRawDataStatusChanged(RawDataStatus status)
 {
     const char* status_str = (status == RawData_On) ? "ON" : "OFF";
-    qDebug() << "QtRemoteVideoHandler: Raw data status changed to" << status_str;
-    if (m_currentUser) {
-        qDebug() << "for user" << m_currentUser->getUserName();
-    }
+    LOG_INFO("QtRemoteVideoHandler: Raw data status changed to %s for user %s",
+             status_str, m_currentUser ? m_currentUser->getUserName() : "?");
 
     // Update subscription status based on raw data status
     if (status == RawData_Off && m_isSubscribed) {
-        qDebug() << "QtRemoteVideoHandler: Raw data turned off, cleaning up subscription";
+        LOG_INFO("QtRemoteVideoHandler: Raw data turned off, cleaning up subscription");
+        // Silence from here on is expected, not a stall
+        if (m_watch) m_watch->setActive(false);
         Unsubscribe();
     }
 }
@@ -133,31 +161,6 @@ void QtRemoteVideoHandler::onShareCursorDataReceived(ZoomVideoSDKShareCursorData
 {
     // Handle cursor data if needed for remote video rendering
     // For now, just log the event
-    qDebug() << "QtRemoteVideoHandler: Share cursor data received";
-    if (m_currentUser) {
-        qDebug() << "for user" << m_currentUser->getUserName();
-    }
-}
-
-// Legacy methods (kept for compatibility)
-void QtRemoteVideoHandler::onRemoteVideoFrameReceived(const QImage& frame)
-{
-    if (!m_isSubscribed || !m_videoWidget) {
-        return;
-    }
-
-    // Pass frame to video widget for display
-    m_videoWidget->updateVideoFrame(frame);
-}
-
-void QtRemoteVideoHandler::onYUVFrameReceived(const char* y_data, const char* u_data, const char* v_data,
-                                             int width, int height, int y_stride, int u_stride, int v_stride)
-{
-    if (!m_isSubscribed || !m_videoWidget) {
-        return;
-    }
-
-    // Use QtVideoRenderer to convert YUV to RGB and display
-    QtVideoRenderer renderer(m_videoWidget);
-    renderer.renderVideoFrame(y_data, u_data, v_data, width, height, y_stride, u_stride, v_stride);
+    LOG_RATE_LIMITED(LOG_LEVEL_DEBUG, 1000, "QtRemoteVideoHandler: Share cursor data received for user %s",
+                     m_currentUser ? m_currentUser->getUserName() : "?");
 }
@@ -1,12 +1,13 @@
 #pragma once
 
 #include <QObject>
-#include <QImage>
+#include <memory>
+#include "VideoFrameSink.h"
 #include "helpers/zoom_video_sdk_user_helper_interface.h"
 
 USING_ZOOM_VIDEO_SDK_NAMESPACE
 
-class QtVideoWidget;
+class StreamWatch;
 
 // Qt equivalent of GTK's RemoteVideoRawDataHandler for remote video
 class QtRemoteVideoHandler : public QObject, private IZoomVideoSDKRawDataPipeDelegate
@@ -14,11 +15,16 @@ class QtRemoteVideoHandler : public QObject, private IZoomVideoSDKRawDataPipeDel
     Q_OBJECT
 
 public:
-    QtRemoteVideoHandler(QtVideoWidget* widget);
+    QtRemoteVideoHandler(IVideoFrameSink* sink);
     ~QtRemoteVideoHandler();
 
     bool SubscribeToUser(IZoomVideoSDKUser* user, ZoomVideoSDKResolution resolution = ZoomVideoSDKResolution_90P);
     bool Unsubscribe();
+    bool IsSubscribed() const { return m_isSubscribed; }
+
+    // Told about every frame and about raw data going on and off, so the
+    // stream watchdog can tell a stall from video that was turned off
+    void setWatch(std::shared_ptr<StreamWatch> watch) { m_watch = std::move(watch); }
 
 private:
     // IZoomVideoSDKRawDataPipeDelegate implementation
@@ -26,13 +32,9 @@ private:
     virtual void onRawDataStatusChanged(RawDataStatus status) override;
     virtual void onShareCursorDataReceived(ZoomVideoSDKShareCursorData info) override;
 
-    QtVideoWidget* m_videoWidget;
+    IVideoFrameSink* m_sink;
     IZoomVideoSDKUser* m_currentUser;
     IZoomVideoSDKRawDataPipe* m_videoPipe;
     bool m_isSubscribed;
-
-    // Legacy methods (kept for compatibility)
-    void onRemoteVideoFrameReceived(const QImage& frame);
-    void onYUVFrameReceived(const char* y_data, const char* u_data, const char* v_data,
-                           int width, int height, int y_stride, int u_stride, int v_stride);
+    std::shared_ptr<StreamWatch> m_watch;
 };
@@ -0,0 +1,108 @@
+#include "QtShareVideoHandler.h"
+#include "AllocationTracker.h"
+#include "FrameHub.h"
+#include "SdkVideoFrame.h"
+#include "Logger.h"
+#include "MemoryBudget.h"
+
+#include "zoom_video_sdk_def.h"
+#include "zoom_video_sdk_interface.h"
+
+USING_ZOOM_VIDEO_SDK_NAMESPACE
+
+namespace {
+
+// A 1080p RGB32 canvas; shares are usually that size or larger
+const size_t kShareCanvasBytes = size_t(1920) * 1080 * 4;
+
+} // namespace
+
+QtShareVideoHandler::QtShareVideoHandler(FrameHub* hub)
+    : m_hub(hub)
+    , m_user(nullptr)
+    , m_sharePipe(nullptr)
+    , m_isSubscribed(false)
+{
+}
+
+QtShareVideoHandler::~QtShareVideoHandler()
+{
+    Unsubscribe();
+}
+
+bool QtShareVideoHandler::SubscribeToShare(IZoomVideoSDKUser* user, IZoomVideoSDKShareAction* action)
+{
+    if (!user || !action) {
+        LOG_WARN("QtShareVideoHandler: Invalid share");
+        return false;
+    }
+
+    Unsubscribe();
+
+    m_sharePipe = action->getSharePipe();
+    if (!m_sharePipe) {
+        LOG_WARN("QtShareVideoHandler: No share pipe available for user %s", user->getUserName());
+        return false;
+    }
+
+    if (!MemoryBudget::instance().canAdmit(kShareCanvasBytes)) {
+        LOG_WARN("QtShareVideoHandler: Memory budget exhausted, refusing share from user %s", user->getUserName());
+        m_sharePipe = nullptr;
+        return false;
+    }
+
+    // Shares come at their own size; the resolution only caps it
+    ZoomVideoSDKErrors err = m_sharePipe->subscribe(ZoomVideoSDKResolution_1080P, this);
+    if (err != ZoomVideoSDKErrors_Success) {
+        LOG_ERROR("QtShareVideoHandler: Failed to subscribe to share from user %s, error: %d",
+                  user->getUserName(), (int)err);
+        m_sharePipe = nullptr;
+        return false;
+    }
+
+    m_user = user;
+    m_isSubscribed = true;
+    LOG_INFO("QtShareVideoHandler: Subscribed to share %u from user %s", action->getShareSourceId(),
+             user->getUserName());
+    return true;
+}
+
+bool QtShareVideoHandler::Unsubscribe()
+{
+    if (m_isSubscribed && m_sharePipe) {
+        ZoomVideoSDKErrors err = m_sharePipe->unSubscribe(this);
+        if (err != ZoomVideoSDKErrors_Success) {
+            LOG_ERROR("QtShareVideoHandler: Failed to unsubscribe from share, error: %d", (int)err);
+        }
+    }
+    m_user = nullptr;
+    m_sharePipe = nullptr;
+    m_isSubscribed = false;
+    return true;
+}
+
+void QtShareVideoHandler::onRawDataFrameReceived(YUVRawDataI420* data)
+{
+    AllocStageScope stage(ALLOC_STAGE_VIDEO_RECEIVE);
+
+    I420Frame frame;
+    if (!toI420Frame(data, frame)) {
+        return;
+    }
+    m_hub->onVideoFrame(frame);
+
+    LOG_RATE_LIMITED(LOG_LEVEL_DEBUG, 1000, "QtShareVideoHandler: share frame %dx%d from user %s",
+                     frame.width, frame.height, m_user ? m_user->getUserName() : "?");
+}
+
+void QtShareVideoHandler::onRawDataStatusChanged(RawDataStatus status)
+{
+    LOG_INFO("QtShareVideoHandler: Raw data status changed to %s for user %s", status == RawData_On ? "ON" : "OFF",
+             m_user ? m_user->getUserName() : "?");
+}
+
+void QtShareVideoHandler::onShareCursorDataReceived(ZoomVideoSDKShareCursorData info)
+{
+    // Drawn as an overlay by the sinks; the frame itself is not touched
+    m_hub->onShareCursor(info.x, info.y);
+}
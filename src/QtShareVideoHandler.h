@@ -0,0 +1,32 @@
+#pragma once
+
+#include "helpers/zoom_video_sdk_share_helper_interface.h"
+#include "helpers/zoom_video_sdk_user_helper_interface.h"
+
+USING_ZOOM_VIDEO_SDK_NAMESPACE
+
+class FrameHub;
+
+// Receives one screen share's raw frames and cursor and feeds them to the
+// share's FrameHub
+class QtShareVideoHandler : private IZoomVideoSDKRawDataPipeDelegate
+{
+public:
+    QtShareVideoHandler(FrameHub* hub);
+    ~QtShareVideoHandler();
+
+    bool SubscribeToShare(IZoomVideoSDKUser* user, IZoomVideoSDKShareAction* action);
+    bool Unsubscribe();
+    bool IsSubscribed() const { return m_isSubscribed; }
+
+private:
+    // IZoomVideoSDKRawDataPipeDelegate implementation
+    virtual void onRawDataFrameReceived(YUVRawDataI420* data) override;
+    virtual void onRawDataStatusChanged(RawDataStatus status) override;
+    virtual void onShareCursorDataReceived(ZoomVideoSDKShareCursorData info) override;
+
+    FrameHub* m_hub;
+    IZoomVideoSDKUser* m_user;
+    IZoomVideoSDKRawDataPipe* m_sharePipe;
+    bool m_isSubscribed;
+};
@@ -0,0 +1,202 @@
+#include "QtShareWidget.h"
+#include <QImage>
+#include <QMetaObject>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QPolygon>
+
+namespace {
+
+// Arrow pointer drawn over the share, in widget pixels
+const int kCursorSize = 16;
+
+} // namespace
+
+QtShareWidget::QtShareWidget(QWidget* parent)
+    : QWidget(parent)
+    , m_fullRepaint(false)
+    , m_hasCursor(false)
+    , m_cursorMoved(false)
+    , m_flushQueued(false)
+{
+    setMinimumSize(320, 240);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+QtShareWidget::~QtShareWidget()
+{
+    // Waits out a listener call in progress on the SDK thread
+    if (m_canvas) m_canvas->setListener(nullptr);
+}
+
+void QtShareWidget::setCanvas(const std::shared_ptr<ShareCanvas>& canvas)
+{
+    std::shared_ptr<ShareCanvas> previous;
+    {
+        QMutexLocker locker(&m_mutex);
+        previous = m_canvas;
+        m_canvas = canvas;
+        m_canvasSize = QSize();
+        m_pendingDamage = QRegion();
+        m_hasCursor = false;
+        m_fullRepaint = true;
+        scheduleFlush();
+    }
+    // Outside m_mutex: the canvas calls into us while holding its listener lock
+    if (previous) previous->setListener(nullptr);
+    if (canvas) canvas->setListener(this);
+}
+
+void QtShareWidget::onShareDamaged(const std::vector<TileRect>& rects, int width, int height)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_canvasSize != QSize(width, height)) {
+        m_canvasSize = QSize(width, height);
+        m_fullRepaint = true;
+    }
+    for (const TileRect& rect : rects) {
+        m_pendingDamage += QRect(rect.x, rect.y, rect.width, rect.height);
+    }
+    scheduleFlush();
+}
+
+void QtShareWidget::onShareCursorMoved(int x, int y)
+{
+    QMutexLocker locker(&m_mutex);
+    m_hasCursor = true;
+    m_cursor = QPoint(x, y);
+    m_cursorMoved = true;
+    scheduleFlush();
+}
+
+void QtShareWidget::scheduleFlush()
+{
+    // One queued flush at a time; later changes join the pending one
+    if (m_flushQueued) return;
+    m_flushQueued = true;
+    QMetaObject::invokeMethod(this, "flushDamage", Qt::QueuedConnection);
+}
+
+void QtShareWidget::flushDamage()
+{
+    QRegion damage;
+    QSize canvasSize;
+    bool fullRepaint;
+    bool cursorMoved;
+    QPoint cursor;
+    QPoint paintedCursor;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_flushQueued = false;
+        damage.swap(m_pendingDamage);
+        canvasSize = m_canvasSize;
+        fullRepaint = m_fullRepaint;
+        cursorMoved = m_cursorMoved && m_hasCursor;
+        cursor = m_cursor;
+        paintedCursor = m_paintedCursor;
+        m_fullRepaint = false;
+        m_cursorMoved = false;
+    }
+
+    if (fullRepaint || canvasSize.isEmpty()) {
+        update();
+        return;
+    }
+
+    QRectF target = targetRect(canvasSize);
+    double scale = target.width() / canvasSize.width();
+    for (const QRect& rect : damage) {
+        QRectF mapped(target.x() + rect.x() * scale, target.y() + rect.y() * scale,
+                      rect.width() * scale, rect.height() * scale);
+        update(mapped.toAlignedRect().adjusted(-1, -1, 1, 1));
+    }
+    if (cursorMoved) {
+        update(cursorArea(paintedCursor, canvasSize));
+        update(cursorArea(cursor, canvasSize));
+    }
+}
+
+QRectF QtShareWidget::targetRect(const QSize& canvasSize) const
+{
+    if (canvasSize.isEmpty()) return QRectF();
+    double scale = qMin((double)width() / canvasSize.width(), (double)height() / canvasSize.height());
+    double targetWidth = canvasSize.width() * scale;
+    double targetHeight = canvasSize.height() * scale;
+    return QRectF((width() - targetWidth) / 2, (height() - targetHeight) / 2, targetWidth, targetHeight);
+}
+
+QRect QtShareWidget::cursorArea(const QPoint& canvasPos, const QSize& canvasSize) const
+{
+    QRectF target = targetRect(canvasSize);
+    double scale = canvasSize.isEmpty() ? 1.0 : target.width() / canvasSize.width();
+    QPoint tip(int(target.x() + canvasPos.x() * scale), int(target.y() + canvasPos.y() * scale));
+    return QRect(tip, QSize(kCursorSize + 2, kCursorSize + 2)).adjusted(-1, -1, 0, 0);
+}
+
+void QtShareWidget::paintEvent(QPaintEvent* event)
+{
+    QPainter painter(this);
+
+    std::shared_ptr<ShareCanvas> canvas;
+    QSize canvasSize;
+    bool hasCursor;
+    QPoint cursor;
+    {
+        QMutexLocker locker(&m_mutex);
+        canvas = m_canvas;
+        canvasSize = m_canvasSize;
+        hasCursor = m_hasCursor;
+        cursor = m_cursor;
+        m_paintedCursor = cursor;
+    }
+
+    bool drawn = false;
+    if (canvas) {
+        canvas->readPixels([&](const uint8_t* data, int canvasWidth, int canvasHeight, int stride) {
+            QSize size(canvasWidth, canvasHeight);
+            QRectF target = targetRect(size);
+            double scale = target.width() / canvasWidth;
+
+            // Borders around the share
+            QRegion border = event->region() - target.toAlignedRect();
+            for (const QRect& rect : border) {
+                painter.fillRect(rect, Qt::black);
+            }
+
+            // Read-only wrapper: no copy of the canvas. Each exposed rect is
+            // drawn from just the canvas area behind it.
+            QImage image(data, canvasWidth, canvasHeight, stride, QImage::Format_RGB32);
+            for (const QRect& rect : event->region()) {
+                QRectF exposed = QRectF(rect).intersected(target);
+                if (exposed.isEmpty()) continue;
+                QRectF source((exposed.x() - target.x()) / scale, (exposed.y() - target.y()) / scale,
+                              exposed.width() / scale, exposed.height() / scale);
+                painter.drawImage(exposed, image, source);
+            }
+            canvasSize = size;
+            drawn = true;
+        });
+    }
+
+    if (!drawn) {
+        painter.fillRect(rect(), Qt::black);
+        painter.setPen(Qt::white);
+        painter.drawText(rect(), Qt::AlignCenter, "No screen share");
+        return;
+    }
+
+    if (hasCursor) {
+        QRect area = cursorArea(cursor, canvasSize);
+        if (event->region().intersects(area)) {
+            QPoint tip = area.topLeft() + QPoint(1, 1);
+            QPolygon arrow;
+            arrow << tip << tip + QPoint(0, kCursorSize) << tip + QPoint(kCursorSize / 4, kCursorSize * 3 / 4)
+                  << tip + QPoint(kCursorSize * 3 / 4, kCursorSize * 3 / 4);
+            painter.setRenderHint(QPainter::Antialiasing);
+            painter.setPen(Qt::black);
+            painter.setBrush(Qt::white);
+            painter.drawPolygon(arrow);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QWidget>
+#include <QMutex>
+#include <QPoint>
+#include <QRegion>
+#include <QSize>
+#include <memory>
+#include "ShareCanvas.h"
+
+QT_BEGIN_NAMESPACE
+class QPaintEvent;
+QT_END_NAMESPACE
+
+// Shows a ShareCanvas. Only the changed tiles are repainted, mapped into the
+// aspect-preserving target rect; the cursor is painted on top of the canvas
+// and moving it repaints just the old and new cursor areas.
+class QtShareWidget : public QWidget, public IShareCanvasListener
+{
+    Q_OBJECT
+
+public:
+    QtShareWidget(QWidget* parent = nullptr);
+    ~QtShareWidget();
+
+    // Any thread; replaces the share being shown
+    void setCanvas(const std::shared_ptr<ShareCanvas>& canvas);
+
+    // IShareCanvasListener implementation; SDK thread
+    void onShareDamaged(const std::vector<TileRect>& rects, int width, int height) override;
+    void onShareCursorMoved(int x, int y) override;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private slots:
+    // GUI thread: turns the damage collected since the last flush into update() calls
+    void flushDamage();
+
+private:
+    // Caller holds m_mutex
+    void scheduleFlush();
+
+    // Where a canvas of this size is drawn, keeping its aspect ratio
+    QRectF targetRect(const QSize& canvasSize) const;
+    QRect cursorArea(const QPoint& canvasPos, const QSize& canvasSize) const;
+
+    QMutex m_mutex;  // everything below
+    std::shared_ptr<ShareCanvas> m_canvas;
+    QSize m_canvasSize;
+    QRegion m_pendingDamage;  // canvas pixels
+    bool m_fullRepaint;
+    bool m_hasCursor;
+    QPoint m_cursor;
+    QPoint m_paintedCursor;
+    bool m_cursorMoved;
+    bool m_flushQueued;
+};
@@ -0,0 +1,72 @@
+#include "QtStatusLog.h"
+
+#include <QMetaObject>
+#include <QScrollBar>
+#include <QTime>
+
+QtStatusLog::QtStatusLog(int maxLines, int flushIntervalMs, size_t ringCapacity, QWidget* parent)
+    : QPlainTextEdit(parent)
+    , m_pending(ringCapacity)
+    , m_flushScheduled(false)
+    , m_dropped(0)
+    , m_droppedReported(0)
+    , m_flushIntervalMs(flushIntervalMs)
+{
+    setReadOnly(true);
+    setMaximumBlockCount(maxLines);
+    // Long lines scroll sideways instead of rewrapping every block on resize
+    setLineWrapMode(QPlainTextEdit::NoWrap);
+    setUndoRedoEnabled(false);
+
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &QtStatusLog::flush);
+    m_sinceFlush.start();
+}
+
+void QtStatusLog::post(const QString& line)
+{
+    QString stamped = QTime::currentTime().toString("HH:mm:ss.zzz ") + line;
+    if (!m_pending.tryPush(std::move(stamped))) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Only the first post since the last flush crosses to the GUI thread
+    if (!m_flushScheduled.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, "scheduleFlush", Qt::QueuedConnection);
+    }
+}
+
+void QtStatusLog::scheduleFlush()
+{
+    if (m_flushTimer.isActive()) return;
+    // A quiet log shows a line at once; a busy one at most every interval
+    qint64 wait = m_flushIntervalMs - m_sinceFlush.elapsed();
+    m_flushTimer.start(wait > 0 ? int(wait) : 0);
+}
+
+void QtStatusLog::flush()
+{
+    // Cleared first so a post racing with this flush schedules another one
+    m_flushScheduled.store(false, std::memory_order_release);
+    m_sinceFlush.restart();
+
+    QString batch;
+    QString line;
+    int lines = 0;
+    while (m_pending.tryPop(line)) {
+        if (lines++) batch += '\n';
+        batch += line;
+    }
+    uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_droppedReported) {
+        if (lines++) batch += '\n';
+        batch += QString("[%1 status lines dropped]").arg(dropped - m_droppedReported);
+        m_droppedReported = dropped;
+    }
+    if (lines == 0) return;
+
+    // Follow new lines only if the user hasn't scrolled up to read
+    QScrollBar* bar = verticalScrollBar();
+    bool atBottom = bar->value() >= bar->maximum() - 2;
+    appendPlainText(batch);
+    if (atBottom) bar->setValue(bar->maximum());
+}
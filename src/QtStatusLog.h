@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QPlainTextEdit>
+#include <QString>
+#include <QTimer>
+#include <atomic>
+#include <cstdint>
+
+#include "MpscQueue.h"
+
+// Status panel that stays cheap over long sessions. Lines from any thread go
+// into a fixed-capacity lock-free ring and the caller returns at once; the
+// GUI thread takes them out in one batch at most every flush interval and
+// appends them with a single edit. The view keeps only the newest maxLines
+// blocks, so memory and layout cost don't grow with the session. When the
+// ring overflows between flushes, the newest lines are dropped and a note
+// says how many.
+class QtStatusLog : public QPlainTextEdit
+{
+    Q_OBJECT
+
+public:
+    explicit QtStatusLog(int maxLines = 500, int flushIntervalMs = 100, size_t ringCapacity = 1024,
+                         QWidget* parent = nullptr);
+
+    // Any thread; never blocks. Stamped with the time of the call.
+    void post(const QString& line);
+
+    uint64_t droppedLines() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private slots:
+    void scheduleFlush();
+    void flush();
+
+private:
+    BoundedMpscQueue<QString> m_pending;
+    std::atomic<bool> m_flushScheduled;  // set by the first post since the last flush
+    std::atomic<uint64_t> m_dropped;
+    uint64_t m_droppedReported;          // GUI thread
+    int m_flushIntervalMs;
+    QTimer m_flushTimer;
+    QElapsedTimer m_sinceFlush;
+};
@@ -1,20 +1,44 @@
 #pragma once
 
 #include <QImage>
+#include "FrameHub.h"
 
 class QtVideoWidget;
 
-class QtVideoRenderer
+// Shows a FrameHub's frames in a QtVideoWidget. The hub does the conversion
+// to premultiplied ARGB32; the QImage handed to the widget wraps the shared
+// buffer without copying it, and keeps it alive while displayed. Alpha-mode
+// frames are tagged Format_ARGB32_Premultiplied so the widget composites
+// them directly; opaque ones are tagged Format_RGB32 (same bytes).
+class QtVideoRenderer : public IFrameHubSink
 {
 public:
     QtVideoRenderer(QtVideoWidget* widget);
     ~QtVideoRenderer();
 
-    void renderVideoFrame(const char* y_data, const char* u_data, const char* v_data,
-                         int width, int height, int y_stride, int u_stride, int v_stride);
+    // What to subscribe with: premultiplied ARGB32 at the source size
+    static FrameVariant variant()
+    {
+        FrameVariant v;
+        v.format = FRAME_FORMAT_ARGB32_PREMULTIPLIED;
+        return v;
+    }
+
+    // IFrameHubSink implementation
+    void onHubFrame(const HubFrame& frame) override;
 
 private:
+    // QImage wrappers for the hub's pooled buffers, reused while the pool is
+    // stable so the steady state allocates nothing per frame
+    struct WrappedBuffer
+    {
+        const uint8_t* data = nullptr;
+        QImage image;
+    };
+
+    const QImage& wrap(const FrameBuffer& buffer);
+
     QtVideoWidget* m_videoWidget;
-    QImage convertYUVtoRGB(const char* y_data, const char* u_data, const char* v_data,
-                          int width, int height, int y_stride, int u_stride, int v_stride);
+    WrappedBuffer m_wrapped[4];
+    int m_nextWrapped;
 };
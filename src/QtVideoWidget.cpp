@@ -1,10 +1,11 @@
 #include "QtVideoWidget.h"
+#include "Logger.h"
 #include <QPainter>
-#include <QDebug>
 
 QtVideoWidget::QtVideoWidget(QWidget* parent)
     : QWidget(parent)
     , m_renderer(nullptr)
+    , m_background(Qt::black)
 {
     setMinimumSize(320, 240);
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -20,18 +21,30 @@ void QtVideoWidget::setVideoRenderer(QtVideoRenderer* renderer)
     m_renderer = renderer;
 }
 
-void QtVideoWidget::updateVideoFrame(const QImage& frame)
+void QtVideoWidget::setBackground(const QBrush& background)
 {
-    QMutexLocker locker(&m_frameMutex);
-    m_currentFrame = frame;
-    printf("DEBUG: QtVideoWidget received frame: %dx%d\n", frame.width(), frame.height());
+    m_background = background;
+    update();
+}
+
+void QtVideoWidget::updateVideoFrame(const QImage& frame, const FrameBufferPtr& buffer)
+{
+    // The previous buffer is released outside the lock; the hub reuses it
+    FrameBufferPtr previous;
+    {
+        QMutexLocker locker(&m_frameMutex);
+        m_currentFrame = frame;
+        previous.swap(m_currentBuffer);
+        m_currentBuffer = buffer;
+    }
+    LOG_RATE_LIMITED(LOG_LEVEL_DEBUG, 1000, "QtVideoWidget received frame: %dx%d", frame.width(), frame.height());
     update(); // Trigger repaint
 }
 
 void QtVideoWidget::paintEvent(QPaintEvent* event)
 {
     QPainter painter(this);
-    painter.fillRect(rect(), Qt::black); // Fill with black background
+    painter.fillRect(rect(), m_background);
 
     QMutexLocker locker(&m_frameMutex);
     if (!m_currentFrame.isNull()) {
@@ -50,6 +63,8 @@ void QtVideoWidget::paintEvent(QPaintEvent* event)
         int offsetX = (targetRect.width() - scaledWidth) / 2;
         int offsetY = (targetRect.height() - scaledHeight) / 2;
 
+        // Premultiplied alpha frames blend over the background with the
+        // default SourceOver mode; no per-paint premultiply or conversion
         QRect drawRect(offsetX, offsetY, scaledWidth, scaledHeight);
         painter.drawImage(drawRect, m_currentFrame);
     } else {
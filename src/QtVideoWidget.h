@@ -1,8 +1,10 @@
 #pragma once
 
 #include <QWidget>
+#include <QBrush>
 #include <QImage>
 #include <QMutex>
+#include "FrameHub.h"
 
 QT_BEGIN_NAMESPACE
 class QPaintEvent;
@@ -19,13 +21,18 @@ public:
     ~QtVideoWidget();
 
     void setVideoRenderer(QtVideoRenderer* renderer);
-    void updateVideoFrame(const QImage& frame);
+    // buffer keeps the pixels of an image that wraps hub memory alive
+    void updateVideoFrame(const QImage& frame, const FrameBufferPtr& buffer = FrameBufferPtr());
+    // What alpha-mode video is composited over; black by default
+    void setBackground(const QBrush& background);
 
 protected:
     void paintEvent(QPaintEvent* event) override;
 
 private:
     QtVideoRenderer* m_renderer;
+    QBrush m_background;
     QImage m_currentFrame;
+    FrameBufferPtr m_currentBuffer;
     QMutex m_frameMutex;
 };
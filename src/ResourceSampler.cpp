@@ -0,0 +1,78 @@
+#include "ResourceSampler.h"
+
+#include <stdio.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+ResourceSampler::ResourceSampler()
+    : m_startUs(0)
+    , m_startCpuUs(0)
+    , m_lastUs(0)
+    , m_lastCpuUs(0)
+{
+    start();
+}
+
+void ResourceSampler::start()
+{
+    m_startUs = m_lastUs = monotonicUs();
+    m_startCpuUs = m_lastCpuUs = cpuTimeUs();
+    m_samples.clear();
+}
+
+const ResourceSampler::Sample& ResourceSampler::sample()
+{
+    int64_t now = monotonicUs();
+    int64_t cpu = cpuTimeUs();
+
+    Sample s;
+    s.elapsedSec = (now - m_startUs) / 1e6;
+    s.cpuPercent = now > m_lastUs ? 100.0 * (cpu - m_lastCpuUs) / (now - m_lastUs) : 0.0;
+    s.rssBytes = currentRssBytes();
+    m_samples.push_back(s);
+
+    m_lastUs = now;
+    m_lastCpuUs = cpu;
+    return m_samples.back();
+}
+
+double ResourceSampler::averageCpuPercent() const
+{
+    int64_t elapsed = m_lastUs - m_startUs;
+    return elapsed > 0 ? 100.0 * (m_lastCpuUs - m_startCpuUs) / elapsed : 0.0;
+}
+
+size_t ResourceSampler::peakRssBytes() const
+{
+    size_t peak = 0;
+    for (const Sample& s : m_samples) {
+        if (s.rssBytes > peak) peak = s.rssBytes;
+    }
+    return peak;
+}
+
+size_t ResourceSampler::currentRssBytes()
+{
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long size = 0, resident = 0;
+    int matched = fscanf(f, "%lu %lu", &size, &resident);
+    fclose(f);
+    return matched == 2 ? size_t(resident) * size_t(sysconf(_SC_PAGESIZE)) : 0;
+}
+
+int64_t ResourceSampler::cpuTimeUs()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return int64_t(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000
+         + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+int64_t ResourceSampler::monotonicUs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
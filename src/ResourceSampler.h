@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Process CPU and RSS over time, from getrusage() and /proc/self/statm.
+// Not thread-safe; call sample() from one thread (the measurement loop).
+class ResourceSampler
+{
+public:
+    struct Sample
+    {
+        double elapsedSec;
+        double cpuPercent;   // user+system over the interval, 100 = one core
+        size_t rssBytes;
+    };
+
+    ResourceSampler();
+
+    // Reset the baseline; samples are relative to this point
+    void start();
+    const Sample& sample();
+
+    const std::vector<Sample>& samples() const { return m_samples; }
+    double averageCpuPercent() const;
+    size_t peakRssBytes() const;
+
+    static size_t currentRssBytes();
+
+private:
+    static int64_t cpuTimeUs();
+    static int64_t monotonicUs();
+
+    int64_t m_startUs;
+    int64_t m_startCpuUs;
+    int64_t m_lastUs;
+    int64_t m_lastCpuUs;
+    std::vector<Sample> m_samples;
+};
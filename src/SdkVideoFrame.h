@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+
+#include "VideoFrameSink.h"
+#include "zoom_video_sdk_def.h"
+
+USING_ZOOM_VIDEO_SDK_NAMESPACE
+
+// Set from onVideoAlphaChannelStatusChanged; the SDK only fills the alpha
+// buffer while alpha mode is on
+inline std::atomic<bool>& sdkVideoAlphaMode()
+{
+    static std::atomic<bool> on{false};
+    return on;
+}
+
+// Describe an SDK raw frame as an I420Frame (assuming standard YUV420 layout)
+inline bool toI420Frame(YUVRawDataI420* data, I420Frame& frame)
+{
+    if (!data || !data->GetYBuffer() || !data->GetUBuffer() || !data->GetVBuffer()) {
+        return false;
+    }
+
+    frame.y = reinterpret_cast<const uint8_t*>(data->GetYBuffer());
+    frame.u = reinterpret_cast<const uint8_t*>(data->GetUBuffer());
+    frame.v = reinterpret_cast<const uint8_t*>(data->GetVBuffer());
+    frame.width = data->GetStreamWidth();
+    frame.height = data->GetStreamHeight();
+    frame.yStride = frame.width;
+    frame.uStride = frame.width / 2;
+    frame.vStride = frame.width / 2;
+    frame.a = nullptr;
+    frame.aStride = 0;
+    if (sdkVideoAlphaMode().load(std::memory_order_relaxed) && data->GetAlphaBuffer()) {
+        frame.a = reinterpret_cast<const uint8_t*>(data->GetAlphaBuffer());
+        frame.aStride = frame.width;
+    }
+    return true;
+}
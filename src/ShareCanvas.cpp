@@ -0,0 +1,130 @@
+#include "ShareCanvas.h"
+#include "AllocationTracker.h"
+#include "Logger.h"
+
+ShareCanvas::ShareCanvas(const std::string& name)
+    : m_name(name)
+    , m_width(0)
+    , m_height(0)
+    , m_stride(0)
+    , m_kernel(nullptr)
+    , m_budgetAccount(name + " canvas")
+    , m_hasCursor(false)
+    , m_cursorX(0)
+    , m_cursorY(0)
+    , m_stats()
+    , m_listener(nullptr)
+{
+}
+
+ShareCanvas::~ShareCanvas()
+{
+    m_budgetAccount.release(m_pixels.size());
+    uint64_t tiles = m_stats.tilesConverted + m_stats.tilesSkipped;
+    LOG_INFO("ShareCanvas %s: %llu frames, %llu of %llu tiles converted, %llu cursor moves, %llu drops",
+             m_name.c_str(), (unsigned long long)m_stats.frames, (unsigned long long)m_stats.tilesConverted,
+             (unsigned long long)tiles, (unsigned long long)m_stats.cursorMoves, (unsigned long long)m_stats.drops);
+}
+
+void ShareCanvas::setListener(IShareCanvasListener* listener)
+{
+    std::lock_guard<std::mutex> lock(m_listenerMutex);
+    m_listener = listener;
+}
+
+void ShareCanvas::readPixels(const std::function<void(const uint8_t*, int, int, int)>& fn) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pixels.empty()) return;
+    fn(m_pixels.data(), m_width, m_height, m_stride);
+}
+
+bool ShareCanvas::cursorPosition(int& x, int& y) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    x = m_cursorX;
+    y = m_cursorY;
+    return m_hasCursor;
+}
+
+ShareCanvas::Stats ShareCanvas::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+bool ShareCanvas::resize(int width, int height)
+{
+    size_t bytes = size_t(width) * 4 * height;
+    m_budgetAccount.release(m_pixels.size());
+    if (!m_budgetAccount.tryCharge(bytes)) {
+        std::vector<uint8_t>().swap(m_pixels);
+        m_width = 0;
+        m_height = 0;
+        return false;
+    }
+    m_pixels.assign(bytes, 0);
+    m_width = width;
+    m_height = height;
+    m_stride = width * 4;
+    // Shares have no per-stream colour space; the configured default applies
+    m_kernel = selectI420ToRGB32(FrameHub::defaultColorSpace(), height, false);
+    m_tracker.reset();
+    return true;
+}
+
+void ShareCanvas::onHubFrame(const HubFrame& frame)
+{
+    const I420Frame& source = *frame.source;
+    AllocStageScope stage(ALLOC_STAGE_VIDEO_CONVERT);
+
+    int width;
+    int height;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if ((source.width != m_width || source.height != m_height) && !resize(source.width, source.height)) {
+            m_stats.drops++;
+            LOG_RATE_LIMITED(LOG_LEVEL_WARN, 1000, "ShareCanvas %s: memory budget exhausted, dropping %dx%d frame",
+                             m_name.c_str(), source.width, source.height);
+            return;
+        }
+
+        const std::vector<TileRect>& rects = m_tracker.update(source);
+        m_stats.frames++;
+        m_stats.tilesConverted += m_tracker.dirtyTiles();
+        m_stats.tilesSkipped += m_tracker.cleanTiles();
+        if (rects.empty()) return;
+
+        // Tiles start on even coordinates, so each one is a valid I420 sub-frame
+        for (const TileRect& rect : rects) {
+            I420Frame tile = source;
+            tile.y = source.y + int64_t(rect.y) * source.yStride + rect.x;
+            tile.u = source.u + int64_t(rect.y / 2) * source.uStride + rect.x / 2;
+            tile.v = source.v + int64_t(rect.y / 2) * source.vStride + rect.x / 2;
+            tile.width = rect.width;
+            tile.height = rect.height;
+            uint8_t* dst = m_pixels.data() + int64_t(rect.y) * m_stride + int64_t(rect.x) * 4;
+            m_kernel(tile, dst, m_stride, rect.width, rect.height);
+        }
+        // Only the frame thread touches m_damage, so it can outlive the lock
+        m_damage.assign(rects.begin(), rects.end());
+        width = m_width;
+        height = m_height;
+    }
+
+    std::lock_guard<std::mutex> lock(m_listenerMutex);
+    if (m_listener) m_listener->onShareDamaged(m_damage, width, height);
+}
+
+void ShareCanvas::onHubCursor(int x, int y)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hasCursor = true;
+        m_cursorX = x;
+        m_cursorY = y;
+        m_stats.cursorMoves++;
+    }
+    std::lock_guard<std::mutex> lock(m_listenerMutex);
+    if (m_listener) m_listener->onShareCursorMoved(x, y);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "FrameConvert.h"
+#include "FrameHub.h"
+#include "MemoryBudget.h"
+#include "TileDamage.h"
+
+// Receives a share canvas's changes on the SDK thread that delivered them.
+// Must not call back into the canvas.
+class IShareCanvasListener
+{
+public:
+    virtual ~IShareCanvasListener() {}
+    // Canvas pixels that changed, plus the canvas size
+    virtual void onShareDamaged(const std::vector<TileRect>& rects, int width, int height) = 0;
+    virtual void onShareCursorMoved(int x, int y) = 0;
+};
+
+// RGB32 image of a screen share kept up to date tile by tile. Subscribed to
+// a share hub at the native I420 variant, so the hub converts nothing; each
+// frame's changed tiles are found by TileDamageTracker and only those are
+// converted into the persistent canvas. Cursor moves are passed on as-is and
+// never touch the pixels.
+class ShareCanvas : public IFrameHubSink
+{
+public:
+    struct Stats
+    {
+        uint64_t frames;
+        uint64_t tilesConverted;
+        uint64_t tilesSkipped;
+        uint64_t cursorMoves;
+        uint64_t drops;  // frames refused by the memory budget
+    };
+
+    explicit ShareCanvas(const std::string& name);
+    ~ShareCanvas();
+
+    ShareCanvas(const ShareCanvas&) = delete;
+    ShareCanvas& operator=(const ShareCanvas&) = delete;
+
+    // Native frames; the canvas converts what changed itself
+    static FrameVariant variant()
+    {
+        FrameVariant v;
+        v.format = FRAME_FORMAT_I420;
+        return v;
+    }
+
+    // Any thread. Once it returns, the previous listener gets no more calls.
+    void setListener(IShareCanvasListener* listener);
+
+    // Runs fn with the canvas pixels (0xFFRRGGBB rows) under the canvas lock;
+    // does nothing before the first frame
+    void readPixels(const std::function<void(const uint8_t* data, int width, int height, int stride)>& fn) const;
+
+    // Last cursor position; false if none was received
+    bool cursorPosition(int& x, int& y) const;
+
+    Stats stats() const;
+
+    // IFrameHubSink implementation
+    void onHubFrame(const HubFrame& frame) override;
+    void onHubCursor(int x, int y) override;
+
+private:
+    // Caller holds m_mutex
+    bool resize(int width, int height);
+
+    std::string m_name;
+    mutable std::mutex m_mutex;  // canvas pixels, tracker and stats
+    TileDamageTracker m_tracker;
+    std::vector<TileRect> m_damage;  // last frame's, handed to the listener
+    std::vector<uint8_t> m_pixels;
+    int m_width;
+    int m_height;
+    int m_stride;
+    I420ToRGB32Kernel m_kernel;
+    MemoryBudget::Account m_budgetAccount;
+    bool m_hasCursor;
+    int m_cursorX;
+    int m_cursorY;
+    Stats m_stats;
+
+    // Held while calling the listener so setListener() can wait it out
+    std::mutex m_listenerMutex;
+    IShareCanvasListener* m_listener;
+};
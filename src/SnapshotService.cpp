@@ -0,0 +1,351 @@
+#include "SnapshotService.h"
+#include "FrameConvert.h"
+#include "Logger.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include <jpeglib.h>
+
+namespace {
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+std::string fileSafe(const std::string& name)
+{
+    std::string out;
+    for (char c : name) {
+        bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '.';
+        out += safe ? c : '_';
+    }
+    return out;
+}
+
+// libjpeg reports fatal errors through error_exit, which must not return
+struct JpegError
+{
+    jpeg_error_mgr mgr;
+    jmp_buf jump;
+};
+
+void jpegErrorExit(j_common_ptr cinfo)
+{
+    longjmp(reinterpret_cast<JpegError*>(cinfo->err)->jump, 1);
+}
+
+// JPEG (JFIF) wants full-range YCbCr; video is normally limited range
+void expandRange(const I420Frame& frame, std::vector<uint8_t>& out)
+{
+    static uint8_t lumaLut[256], chromaLut[256];
+    static bool built = false;
+    if (!built) {
+        for (int i = 0; i < 256; i++) {
+            lumaLut[i] = uint8_t(std::min(255, std::max(0, ((i - 16) * 255 + 109) / 219)));
+            chromaLut[i] = uint8_t(std::min(255, std::max(0, 128 + ((i - 128) * 255 + (i >= 128 ? 112 : -112)) / 224)));
+        }
+        built = true;
+    }
+    int chromaWidth = (frame.width + 1) / 2;
+    int chromaHeight = (frame.height + 1) / 2;
+    size_t lumaBytes = size_t(frame.width) * frame.height;
+    size_t chromaBytes = size_t(chromaWidth) * chromaHeight;
+    out.resize(lumaBytes + 2 * chromaBytes);
+    for (size_t i = 0; i < lumaBytes; i++) out[i] = lumaLut[frame.y[i]];
+    for (size_t i = 0; i < chromaBytes; i++) {
+        out[lumaBytes + i] = chromaLut[frame.u[i]];
+        out[lumaBytes + chromaBytes + i] = chromaLut[frame.v[i]];
+    }
+}
+
+// Encodes packed I420 (strides = widths) as 4:2:0 JPEG without going
+// through RGB. False on a libjpeg error.
+bool encodeJpeg(const uint8_t* planes, int width, int height, int quality, std::vector<uint8_t>& out)
+{
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    const uint8_t* y = planes;
+    const uint8_t* u = y + size_t(width) * height;
+    const uint8_t* v = u + size_t(chromaWidth) * chromaHeight;
+
+    jpeg_compress_struct cinfo;
+    JpegError error;
+    cinfo.err = jpeg_std_error(&error.mgr);
+    error.mgr.error_exit = jpegErrorExit;
+    unsigned char* buffer = nullptr;
+    unsigned long size = 0;
+    if (setjmp(error.jump)) {
+        jpeg_destroy_compress(&cinfo);
+        free(buffer);
+        return false;
+    }
+
+    jpeg_create_compress(&cinfo);
+    jpeg_mem_dest(&cinfo, &buffer, &size);
+    cinfo.image_width = JDIMENSION(width);
+    cinfo.image_height = JDIMENSION(height);
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_YCbCr;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_colorspace(&cinfo, JCS_YCbCr);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    cinfo.raw_data_in = TRUE;
+    cinfo.comp_info[0].h_samp_factor = 2;
+    cinfo.comp_info[0].v_samp_factor = 2;
+    for (int c = 1; c < 3; c++) {
+        cinfo.comp_info[c].h_samp_factor = 1;
+        cinfo.comp_info[c].v_samp_factor = 1;
+    }
+    jpeg_start_compress(&cinfo, TRUE);
+
+    // One MCU row is 16 luma and 8 chroma lines; the bottom edge repeats
+    // the last line
+    JSAMPROW yRows[16], uRows[8], vRows[8];
+    JSAMPARRAY rows[3] = { yRows, uRows, vRows };
+    while (cinfo.next_scanline < cinfo.image_height) {
+        int top = int(cinfo.next_scanline);
+        for (int i = 0; i < 16; i++) {
+            yRows[i] = const_cast<uint8_t*>(y + size_t(std::min(top + i, height - 1)) * width);
+        }
+        for (int i = 0; i < 8; i++) {
+            size_t row = size_t(std::min(top / 2 + i, chromaHeight - 1)) * chromaWidth;
+            uRows[i] = const_cast<uint8_t*>(u + row);
+            vRows[i] = const_cast<uint8_t*>(v + row);
+        }
+        jpeg_write_raw_data(&cinfo, rows, 16);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+
+    out.assign(buffer, buffer + size);
+    free(buffer);
+    return true;
+}
+
+} // namespace
+
+SnapshotSink::SnapshotSink(const std::string& streamName, int thumbnailWidth)
+    : m_streamName(streamName)
+    , m_thumbnailWidth(thumbnailWidth)
+    , m_state(IDLE)
+    , m_view()
+    , m_budgetAccount(streamName + " snapshot")
+{
+}
+
+SnapshotSink::~SnapshotSink()
+{
+    m_budgetAccount.release(m_thumbnail.size());
+}
+
+void SnapshotSink::arm()
+{
+    int expected = IDLE;
+    m_state.compare_exchange_strong(expected, ARMED, std::memory_order_acq_rel);
+}
+
+void SnapshotSink::onHubFrame(const HubFrame& hubFrame)
+{
+    // The common case: nobody asked for a snapshot
+    if (m_state.load(std::memory_order_relaxed) != ARMED) return;
+    int expected = ARMED;
+    if (!m_state.compare_exchange_strong(expected, CAPTURING, std::memory_order_acquire)) return;
+
+    const I420Frame& frame = *hubFrame.source;
+    int width = std::min(m_thumbnailWidth, frame.width) & ~1;
+    int height = int(int64_t(frame.height) * width / std::max(1, frame.width)) & ~1;
+    if (width < 2 || height < 2) {
+        m_state.store(ARMED, std::memory_order_release);
+        return;
+    }
+
+    int chromaWidth = width / 2;
+    int chromaHeight = height / 2;
+    size_t bytes = size_t(width) * height + 2 * size_t(chromaWidth) * chromaHeight;
+    if (m_thumbnail.size() != bytes) {
+        m_budgetAccount.release(m_thumbnail.size());
+        if (!m_budgetAccount.tryCharge(bytes)) {
+            std::vector<uint8_t>().swap(m_thumbnail);
+            m_state.store(IDLE, std::memory_order_release);
+            return;
+        }
+        m_thumbnail.resize(bytes);
+    }
+
+    m_view.y = m_thumbnail.data();
+    m_view.u = m_view.y + size_t(width) * height;
+    m_view.v = m_view.u + size_t(chromaWidth) * chromaHeight;
+    m_view.width = width;
+    m_view.height = height;
+    m_view.yStride = width;
+    m_view.uStride = chromaWidth;
+    m_view.vStride = chromaWidth;
+    scaleI420(frame, m_view);
+    m_state.store(READY, std::memory_order_release);
+}
+
+SnapshotService& SnapshotService::instance()
+{
+    static SnapshotService service;
+    return service;
+}
+
+SnapshotService::SnapshotService()
+    : m_stopping(false)
+    , m_snapshots(0)
+    , m_failures(0)
+    , m_lastEncodeNs(0)
+    , m_totalEncodeNs(0)
+    , m_maxEncodeNs(0)
+    , m_lastBytes(0)
+    , m_totalBytes(0)
+{
+}
+
+SnapshotService::~SnapshotService()
+{
+    stop();
+}
+
+bool SnapshotService::start(const Config& config)
+{
+    if (running() || config.directory.empty()) return false;
+    if (mkdir(config.directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        LOG_ERROR("SnapshotService: cannot create %s: %s", config.directory.c_str(), strerror(errno));
+        return false;
+    }
+    m_config = config;
+    m_config.intervalSec = std::max(1, m_config.intervalSec);
+    m_config.width = std::max(16, m_config.width);
+    m_config.quality = std::min(100, std::max(1, m_config.quality));
+    m_stopping = false;
+    m_thread = std::thread(&SnapshotService::run, this);
+    LOG_INFO("SnapshotService: %dpx thumbnails every %d s into %s", m_config.width, m_config.intervalSec,
+             m_config.directory.c_str());
+    return true;
+}
+
+void SnapshotService::stop()
+{
+    if (!running()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    Stats s = stats();
+    LOG_INFO("SnapshotService: %llu snapshots, %llu failures, encode mean %.2f ms max %.2f ms, mean %.0f bytes",
+             (unsigned long long)s.snapshots, (unsigned long long)s.failures, s.meanEncodeMs, s.maxEncodeMs,
+             s.meanBytes);
+}
+
+void SnapshotService::add(const std::shared_ptr<SnapshotSink>& sink)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sinks.push_back(sink);
+}
+
+void SnapshotService::run()
+{
+    // Dashboards can wait; frame delivery and the SDK cannot
+    setpriority(PRIO_PROCESS, pid_t(syscall(SYS_gettid)), 19);
+
+    const auto poll = std::chrono::milliseconds(100);
+    int64_t nextRoundNs = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopping) {
+        int64_t now = monotonicNs();
+        bool arm = now >= nextRoundNs;
+        if (arm) nextRoundNs = now + int64_t(m_config.intervalSec) * 1000000000;
+
+        std::vector<std::shared_ptr<SnapshotSink>> sinks;
+        for (auto it = m_sinks.begin(); it != m_sinks.end();) {
+            if (std::shared_ptr<SnapshotSink> sink = it->lock()) {
+                sinks.push_back(sink);
+                ++it;
+            } else {
+                it = m_sinks.erase(it);
+            }
+        }
+        lock.unlock();
+
+        for (const std::shared_ptr<SnapshotSink>& sink : sinks) {
+            if (sink->ready()) {
+                writeSnapshot(*sink);
+                sink->consumed();
+            }
+            if (arm) sink->arm();
+        }
+        sinks.clear();
+
+        lock.lock();
+        m_wake.wait_for(lock, poll);
+    }
+}
+
+void SnapshotService::writeSnapshot(SnapshotSink& sink)
+{
+    const I420Frame& thumbnail = sink.thumbnail();
+    int64_t start = monotonicNs();
+
+    thread_local std::vector<uint8_t> fullRange;
+    const uint8_t* planes = thumbnail.y;
+    if (FrameHub::defaultColorSpace().range == COLOR_RANGE_LIMITED) {
+        expandRange(thumbnail, fullRange);
+        planes = fullRange.data();
+    }
+    std::vector<uint8_t> jpeg;
+    if (!encodeJpeg(planes, thumbnail.width, thumbnail.height, m_config.quality, jpeg)) {
+        m_failures.fetch_add(1, std::memory_order_relaxed);
+        LOG_RATE_LIMITED(LOG_LEVEL_WARN, 10000, "SnapshotService: JPEG encoding failed for %s", sink.streamName().c_str());
+        return;
+    }
+    int64_t elapsed = monotonicNs() - start;
+
+    // Readers see either the old image or the new one, never a partial file
+    std::string path = m_config.directory + "/" + fileSafe(sink.streamName()) + ".jpg";
+    std::string temp = path + ".tmp";
+    int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    bool ok = fd >= 0 && write(fd, jpeg.data(), jpeg.size()) == ssize_t(jpeg.size());
+    if (fd >= 0) ok = (close(fd) == 0) && ok;
+    if (!ok || rename(temp.c_str(), path.c_str()) != 0) {
+        m_failures.fetch_add(1, std::memory_order_relaxed);
+        LOG_RATE_LIMITED(LOG_LEVEL_WARN, 10000, "SnapshotService: cannot write %s: %s", path.c_str(), strerror(errno));
+        unlink(temp.c_str());
+        return;
+    }
+
+    m_snapshots.fetch_add(1, std::memory_order_relaxed);
+    m_lastEncodeNs.store(elapsed, std::memory_order_relaxed);
+    m_totalEncodeNs.fetch_add(elapsed, std::memory_order_relaxed);
+    if (elapsed > m_maxEncodeNs.load(std::memory_order_relaxed)) m_maxEncodeNs.store(elapsed, std::memory_order_relaxed);
+    m_lastBytes.store(jpeg.size(), std::memory_order_relaxed);
+    m_totalBytes.fetch_add(jpeg.size(), std::memory_order_relaxed);
+}
+
+SnapshotService::Stats SnapshotService::stats() const
+{
+    Stats s;
+    s.snapshots = m_snapshots.load(std::memory_order_relaxed);
+    s.failures = m_failures.load(std::memory_order_relaxed);
+    s.lastEncodeMs = m_lastEncodeNs.load(std::memory_order_relaxed) / 1e6;
+    s.meanEncodeMs = s.snapshots ? m_totalEncodeNs.load(std::memory_order_relaxed) / 1e6 / s.snapshots : 0.0;
+    s.maxEncodeMs = m_maxEncodeNs.load(std::memory_order_relaxed) / 1e6;
+    s.lastBytes = m_lastBytes.load(std::memory_order_relaxed);
+    s.meanBytes = s.snapshots ? double(m_totalBytes.load(std::memory_order_relaxed)) / s.snapshots : 0.0;
+    return s;
+}
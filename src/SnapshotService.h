@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FrameHub.h"
+#include "MemoryBudget.h"
+
+// Grabs a stream's thumbnail when the snapshot service asks for one. Sits on
+// the stream's hub at the native I420 variant and does nothing per frame
+// but check an atomic; only the first frame after the service armed it is
+// downscaled, in YUV, into a small I420 buffer the service encodes later.
+class SnapshotSink : public IFrameHubSink
+{
+public:
+    SnapshotSink(const std::string& streamName, int thumbnailWidth);
+    ~SnapshotSink();
+
+    SnapshotSink(const SnapshotSink&) = delete;
+    SnapshotSink& operator=(const SnapshotSink&) = delete;
+
+    static FrameVariant variant()
+    {
+        FrameVariant v;
+        v.format = FRAME_FORMAT_I420;
+        return v;
+    }
+
+    const std::string& streamName() const { return m_streamName; }
+
+    // IFrameHubSink
+    void onHubFrame(const HubFrame& frame) override;
+
+private:
+    friend class SnapshotService;
+
+    enum State
+    {
+        IDLE,
+        ARMED,      // service wants the next frame
+        CAPTURING,  // delivery thread is writing m_thumbnail
+        READY,      // m_thumbnail holds a frame for the service
+    };
+
+    // Service thread
+    void arm();
+    bool ready() const { return m_state.load(std::memory_order_acquire) == READY; }
+    const I420Frame& thumbnail() const { return m_view; }
+    void consumed() { m_state.store(IDLE, std::memory_order_release); }
+
+    std::string m_streamName;
+    int m_thumbnailWidth;
+    std::atomic<int> m_state;
+    std::vector<uint8_t> m_thumbnail;
+    I420Frame m_view;
+    MemoryBudget::Account m_budgetAccount;
+};
+
+// Keeps a JPEG thumbnail of every remote participant fresh for dashboards.
+// Every interval a low-priority thread arms each registered SnapshotSink,
+// then JPEG-encodes the thumbnails they captured straight from YUV (no RGB
+// step) and writes <directory>/<stream>.jpg through a temp file and
+// rename(), so readers never see a partial image. Encode time and output
+// size are tracked. The one downscale per stream per interval runs on that
+// stream's delivery strand (see SnapshotSink): a thumbnail is smaller than
+// the copy of the source frame needed to scale it here. Encoding and file
+// I/O stay on this thread.
+class SnapshotService
+{
+public:
+    struct Config
+    {
+        std::string directory;  // empty = off; /dev/shm/... keeps it in shared memory
+        int intervalSec = 5;
+        int width = 320;        // thumbnail width; height keeps the aspect ratio
+        int quality = 75;
+    };
+
+    struct Stats
+    {
+        uint64_t snapshots;
+        uint64_t failures;
+        double lastEncodeMs;
+        double meanEncodeMs;
+        double maxEncodeMs;
+        size_t lastBytes;
+        double meanBytes;
+    };
+
+    static SnapshotService& instance();
+
+    bool start(const Config& config);
+    void stop();
+    bool running() const { return m_thread.joinable(); }
+    const Config& config() const { return m_config; }
+
+    // Any thread; the service only keeps a weak reference
+    void add(const std::shared_ptr<SnapshotSink>& sink);
+
+    Stats stats() const;
+
+private:
+    SnapshotService();
+    ~SnapshotService();
+
+    void run();
+    void writeSnapshot(SnapshotSink& sink);
+
+    Config m_config;
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopping;
+    std::vector<std::weak_ptr<SnapshotSink>> m_sinks;
+
+    // Written by the service thread
+    std::atomic<uint64_t> m_snapshots;
+    std::atomic<uint64_t> m_failures;
+    std::atomic<int64_t> m_lastEncodeNs;
+    std::atomic<int64_t> m_totalEncodeNs;
+    std::atomic<int64_t> m_maxEncodeNs;
+    std::atomic<size_t> m_lastBytes;
+    std::atomic<uint64_t> m_totalBytes;
+};
@@ -0,0 +1,14 @@
+#include "SocketWatcher.h"
+
+SocketWatcher::SocketWatcher(int fd, QSocketNotifier::Type type, std::function<void()> callback)
+    : QObject(nullptr)
+    , m_notifier(new QSocketNotifier(fd, type, this))
+    , m_callback(std::move(callback))
+{
+    connect(m_notifier, SIGNAL(activated(int)), this, SLOT(onActivated()));
+}
+
+void SocketWatcher::onActivated()
+{
+    if (m_callback) m_callback();
+}
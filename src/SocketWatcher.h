@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QObject>
+#include <QSocketNotifier>
+#include <functional>
+
+// Runs a callback on the Qt event loop when a file descriptor becomes
+// readable or writable. QSocketNotifier::activated has different overloads
+// across Qt 5 releases, so the signal is connected by name here once rather
+// than at every call site.
+class SocketWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    SocketWatcher(int fd, QSocketNotifier::Type type, std::function<void()> callback);
+
+    void setEnabled(bool enabled) { m_notifier->setEnabled(enabled); }
+
+private slots:
+    void onActivated();
+
+private:
+    QSocketNotifier* m_notifier;
+    std::function<void()> m_callback;
+};
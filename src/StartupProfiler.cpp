@@ -0,0 +1,113 @@
+#include "StartupProfiler.h"
+#include "Logger.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+const int kMaxPhases = 64;
+
+struct Entry
+{
+    const char* name;
+    int64_t ns;
+    int threadId;
+    std::atomic<bool> published;
+};
+
+Entry g_entries[kMaxPhases];
+std::atomic<int> g_count{0};
+std::atomic<bool> g_ready{false};
+
+int64_t bootTimeNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Process start in CLOCK_BOOTTIME terms, from field 22 of /proc/self/stat
+int64_t processStartNs()
+{
+    static const int64_t startNs = []() {
+        FILE* f = fopen("/proc/self/stat", "r");
+        if (!f) return bootTimeNs();
+        char buffer[1024];
+        size_t n = fread(buffer, 1, sizeof(buffer) - 1, f);
+        fclose(f);
+        buffer[n] = 0;
+
+        // The command name may contain spaces; fields resume after the last ')'
+        const char* p = nullptr;
+        for (size_t i = 0; i < n; i++) {
+            if (buffer[i] == ')') p = buffer + i + 1;
+        }
+        unsigned long long startTicks = 0;
+        if (!p || sscanf(p, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu",
+                         &startTicks) != 1) {
+            return bootTimeNs();
+        }
+        return int64_t(startTicks) * 1000000000 / sysconf(_SC_CLK_TCK);
+    }();
+    return startNs;
+}
+
+} // namespace
+
+void StartupProfiler::mark(const char* name)
+{
+    int64_t now = bootTimeNs();
+    int index = g_count.fetch_add(1, std::memory_order_relaxed);
+    if (index >= kMaxPhases) return;
+
+    Entry& entry = g_entries[index];
+    entry.name = name;
+    entry.ns = now;
+    entry.threadId = (int)syscall(SYS_gettid);
+    entry.published.store(true, std::memory_order_release);
+}
+
+void StartupProfiler::markReady(const char* name)
+{
+    mark(name);
+    if (!g_ready.exchange(true)) {
+        report();
+    }
+}
+
+bool StartupProfiler::isReady()
+{
+    return g_ready.load();
+}
+
+std::vector<StartupProfiler::Phase> StartupProfiler::phases()
+{
+    int64_t start = processStartNs();
+    int count = g_count.load(std::memory_order_relaxed);
+    if (count > kMaxPhases) count = kMaxPhases;
+
+    std::vector<Phase> result;
+    result.reserve(count);
+    for (int i = 0; i < count; i++) {
+        const Entry& entry = g_entries[i];
+        if (!entry.published.load(std::memory_order_acquire)) continue;
+        result.push_back({ entry.name, (entry.ns - start) / 1e6, entry.threadId });
+    }
+    return result;
+}
+
+void StartupProfiler::report()
+{
+    std::vector<Phase> list = phases();
+    LOG_INFO("Startup profile (ms since process start):");
+    double previous = 0.0;
+    for (const Phase& phase : list) {
+        LOG_INFO("  %8.1f  (+%7.1f)  [tid %d] %s", phase.sinceStartMs, phase.sinceStartMs - previous,
+                 phase.threadId, phase.name);
+        previous = phase.sinceStartMs;
+    }
+}
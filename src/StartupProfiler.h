@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Timestamped startup phases, measured from the moment the kernel started
+// the process (so dynamic loading of the SDK before main() is included).
+// mark() is lock-free and may be called from any thread; phase names must
+// be string literals.
+class StartupProfiler
+{
+public:
+    struct Phase
+    {
+        const char* name;
+        double sinceStartMs;  // since process start
+        int threadId;
+    };
+
+    static void mark(const char* name);
+
+    // Marks the application as ready to join; logs the profile the first time
+    static void markReady(const char* name);
+    static bool isReady();
+
+    static std::vector<Phase> phases();
+    static void report();
+};
@@ -0,0 +1,128 @@
+#include "StrandedFrameSink.h"
+#include "AllocationTracker.h"
+#include "Logger.h"
+
+#include <string.h>
+
+namespace {
+
+size_t i420Bytes(int width, int height)
+{
+    return size_t(width) * height + 2 * size_t((width + 1) / 2) * ((height + 1) / 2);
+}
+
+void copyPlane(uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, int width, int height)
+{
+    for (int row = 0; row < height; row++) {
+        memcpy(dst + int64_t(row) * dstStride, src + int64_t(row) * srcStride, width);
+    }
+}
+
+} // namespace
+
+StrandedFrameSink::StrandedFrameSink(const std::string& name, IVideoFrameSink* target,
+                                     WorkStealingExecutor& executor, size_t maxQueued)
+    : m_name(name)
+    , m_target(target)
+    , m_maxQueued(maxQueued)
+    , m_budgetAccount(name + " queue")
+    , m_frames(0)
+    , m_drops(0)
+    , m_strand(executor)
+{
+}
+
+StrandedFrameSink::~StrandedFrameSink()
+{
+    // No delivery may still read a pooled frame once its budget is released
+    m_strand.close();
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    for (const std::unique_ptr<PooledFrame>& frame : m_pool) {
+        m_budgetAccount.release(frame->data.size());
+    }
+}
+
+StrandedFrameSink::PooledFrame* StrandedFrameSink::acquire(int width, int height, bool alpha)
+{
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    size_t bytes = i420Bytes(width, height) + (alpha ? size_t(width) * height : 0);
+
+    PooledFrame* frame = nullptr;
+    for (const std::unique_ptr<PooledFrame>& candidate : m_pool) {
+        if (!candidate->queued) {
+            frame = candidate.get();
+            break;
+        }
+    }
+    if (!frame) {
+        if (m_pool.size() >= m_maxQueued) return nullptr;
+        m_pool.push_back(std::unique_ptr<PooledFrame>(new PooledFrame));
+        frame = m_pool.back().get();
+    }
+
+    if (frame->data.size() != bytes) {
+        m_budgetAccount.release(frame->data.size());
+        if (!m_budgetAccount.tryCharge(bytes)) {
+            std::vector<uint8_t>().swap(frame->data);
+            return nullptr;
+        }
+        frame->data.resize(bytes);
+    }
+
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    I420Frame& view = frame->view;
+    view.y = frame->data.data();
+    view.u = view.y + size_t(width) * height;
+    view.v = view.u + size_t(chromaWidth) * chromaHeight;
+    view.width = width;
+    view.height = height;
+    view.yStride = width;
+    view.uStride = chromaWidth;
+    view.vStride = chromaWidth;
+    view.a = alpha ? view.v + size_t(chromaWidth) * chromaHeight : nullptr;
+    view.aStride = alpha ? width : 0;
+    frame->queued = true;
+    return frame;
+}
+
+void StrandedFrameSink::onVideoFrame(const I420Frame& frame)
+{
+    AllocStageScope stage(ALLOC_STAGE_VIDEO_RECEIVE);
+    m_frames.fetch_add(1, std::memory_order_relaxed);
+
+    PooledFrame* pooled = acquire(frame.width, frame.height, frame.a != nullptr);
+    if (!pooled) {
+        m_drops.fetch_add(1, std::memory_order_relaxed);
+        LOG_RATE_LIMITED(LOG_LEVEL_WARN, 1000, "StrandedFrameSink %s: stream behind, dropping %dx%d frame",
+                         m_name.c_str(), frame.width, frame.height);
+        return;
+    }
+
+    // The SDK's planes are only valid during this call
+    int chromaWidth = (frame.width + 1) / 2;
+    int chromaHeight = (frame.height + 1) / 2;
+    uint8_t* y = pooled->data.data();
+    uint8_t* u = y + size_t(frame.width) * frame.height;
+    uint8_t* v = u + size_t(chromaWidth) * chromaHeight;
+    copyPlane(y, frame.width, frame.y, frame.yStride, frame.width, frame.height);
+    copyPlane(u, chromaWidth, frame.u, frame.uStride, chromaWidth, chromaHeight);
+    copyPlane(v, chromaWidth, frame.v, frame.vStride, chromaWidth, chromaHeight);
+    if (frame.a) {
+        copyPlane(v + size_t(chromaWidth) * chromaHeight, frame.width, frame.a, frame.aStride, frame.width, frame.height);
+    }
+
+    m_strand.post([this, pooled]() {
+        m_target->onVideoFrame(pooled->view);
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        pooled->queued = false;
+    });
+}
+
+StrandedFrameSink::Stats StrandedFrameSink::stats() const
+{
+    Stats s;
+    s.frames = m_frames.load(std::memory_order_relaxed);
+    s.drops = m_drops.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "MemoryBudget.h"
+#include "VideoFrameSink.h"
+#include "WorkStealingExecutor.h"
+
+// Takes a stream's frames off the SDK callback thread. Each frame is copied
+// into a pooled I420 buffer charged to the memory budget and handed to the
+// target sink (normally the stream's FrameHub) on the frame executor,
+// through a strand so the stream's frames stay in order while other streams
+// run in parallel. When every pooled buffer is still queued the stream is
+// behind, and the new frame is dropped.
+class StrandedFrameSink : public IVideoFrameSink
+{
+public:
+    struct Stats
+    {
+        uint64_t frames;
+        uint64_t drops;  // pool busy or budget exhausted
+    };
+
+    StrandedFrameSink(const std::string& name, IVideoFrameSink* target, WorkStealingExecutor& executor,
+                      size_t maxQueued = 3);
+    // Drops queued frames and waits for one being delivered
+    ~StrandedFrameSink();
+
+    StrandedFrameSink(const StrandedFrameSink&) = delete;
+    StrandedFrameSink& operator=(const StrandedFrameSink&) = delete;
+
+    // IVideoFrameSink: SDK thread; copies and returns
+    void onVideoFrame(const I420Frame& frame) override;
+
+    Stats stats() const;
+
+private:
+    struct PooledFrame
+    {
+        std::vector<uint8_t> data;
+        I420Frame view;
+        bool queued = false;
+    };
+
+    PooledFrame* acquire(int width, int height, bool alpha);
+
+    std::string m_name;
+    IVideoFrameSink* m_target;
+    size_t m_maxQueued;
+    std::mutex m_poolMutex;
+    std::vector<std::unique_ptr<PooledFrame>> m_pool;
+    MemoryBudget::Account m_budgetAccount;
+    std::atomic<uint64_t> m_frames;
+    std::atomic<uint64_t> m_drops;
+    // Declared last: destroyed first, so no task outlives the pool
+    Strand m_strand;
+};
@@ -0,0 +1,101 @@
+#include "StreamStats.h"
+
+#include <cmath>
+#include <cstring>
+#include <time.h>
+
+StreamStats::StreamStats(const std::string& name)
+    : m_name(name)
+    , m_frames(0)
+    , m_bytes(0)
+    , m_firstNs(0)
+    , m_lastNs(0)
+    , m_lastIntervalMs(-1.0)
+    , m_jitterMs(0.0)
+    , m_maxIntervalMs(0.0)
+    , m_intervals(0)
+    , m_meanMs(0.0)
+    , m_m2(0.0)
+{
+    memset(m_histogram, 0, sizeof(m_histogram));
+}
+
+void StreamStats::setName(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_name = name;
+}
+
+int64_t StreamStats::nowNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void StreamStats::onDelivery(size_t bytes)
+{
+    onDelivery(bytes, nowNs());
+}
+
+void StreamStats::onDelivery(size_t bytes, int64_t now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frames++;
+    m_bytes += bytes;
+    if (m_frames == 1) {
+        m_firstNs = m_lastNs = now;
+        return;
+    }
+
+    double intervalMs = (now - m_lastNs) / 1e6;
+    m_lastNs = now;
+
+    m_intervals++;
+    double delta = intervalMs - m_meanMs;
+    m_meanMs += delta / m_intervals;
+    m_m2 += delta * (intervalMs - m_meanMs);
+
+    if (m_lastIntervalMs >= 0.0) {
+        m_jitterMs += (std::fabs(intervalMs - m_lastIntervalMs) - m_jitterMs) / 16.0;
+    }
+    m_lastIntervalMs = intervalMs;
+    if (intervalMs > m_maxIntervalMs) m_maxIntervalMs = intervalMs;
+
+    int bucket = int(intervalMs / kBucketMs);
+    if (bucket >= kBucketCount) bucket = kBucketCount - 1;
+    m_histogram[bucket]++;
+}
+
+double StreamStats::percentileMs(double fraction) const
+{
+    if (m_intervals == 0) return 0.0;
+    uint64_t target = uint64_t(std::ceil(fraction * m_intervals));
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; i++) {
+        seen += m_histogram[i];
+        if (seen >= target) return (i + 1) * kBucketMs;
+    }
+    return m_maxIntervalMs;
+}
+
+StreamStats::Summary StreamStats::summary() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Summary s = {};
+    s.name = m_name;
+    s.frames = m_frames;
+    s.bytes = m_bytes;
+    s.durationSec = (m_lastNs - m_firstNs) / 1e9;
+    if (s.durationSec > 0.0) {
+        s.framesPerSec = m_intervals / s.durationSec;
+        s.bytesPerSec = m_bytes / s.durationSec;
+    }
+    s.meanIntervalMs = m_meanMs;
+    s.stddevIntervalMs = m_intervals > 1 ? std::sqrt(m_m2 / (m_intervals - 1)) : 0.0;
+    s.jitterMs = m_jitterMs;
+    s.p50IntervalMs = percentileMs(0.50);
+    s.p99IntervalMs = percentileMs(0.99);
+    s.maxIntervalMs = m_maxIntervalMs;
+    return s;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Delivery statistics for one stream (a user's video, mixed audio, ...):
+// frame and byte counts plus the spread of inter-arrival times. onDelivery()
+// is cheap enough for the SDK callback thread; summary() may be called from
+// any thread.
+class StreamStats
+{
+public:
+    struct Summary
+    {
+        std::string name;
+        uint64_t frames;
+        uint64_t bytes;
+        double durationSec;       // first to last delivery
+        double framesPerSec;
+        double bytesPerSec;
+        double meanIntervalMs;
+        double stddevIntervalMs;
+        double jitterMs;          // RFC 3550 style smoothed |D(i) - D(i-1)|
+        double p50IntervalMs;
+        double p99IntervalMs;
+        double maxIntervalMs;
+    };
+
+    explicit StreamStats(const std::string& name = std::string());
+
+    void setName(const std::string& name);
+
+    void onDelivery(size_t bytes);
+    void onDelivery(size_t bytes, int64_t nowNs);
+
+    Summary summary() const;
+
+    static int64_t nowNs();
+
+private:
+    // Inter-arrival histogram: 0.5 ms buckets up to 500 ms, the last one open
+    static constexpr int kBucketCount = 1001;
+    static constexpr double kBucketMs = 0.5;
+
+    double percentileMs(double fraction) const;
+
+    mutable std::mutex m_mutex;
+    std::string m_name;
+    uint64_t m_frames;
+    uint64_t m_bytes;
+    int64_t m_firstNs;
+    int64_t m_lastNs;
+    double m_lastIntervalMs;
+    double m_jitterMs;
+    double m_maxIntervalMs;
+    // Welford running mean/variance of the intervals
+    uint64_t m_intervals;
+    double m_meanMs;
+    double m_m2;
+    uint32_t m_histogram[kBucketCount];
+};
@@ -0,0 +1,254 @@
+#include "StreamWatchdog.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <time.h>
+
+namespace {
+
+const int64_t kMaxSmoothedIntervalNs = 1000000000;  // longer gaps are stalls, not frame rate
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+} // namespace
+
+StreamWatch::StreamWatch(uint64_t id, const std::string& name)
+    : m_id(id)
+    , m_name(name)
+    , m_active(true)
+    , m_lastFrameNs(monotonicNs())
+    , m_intervalNs(0)
+    , m_frames(0)
+    , m_stalled(false)
+    , m_recoveredNs(0)
+{
+}
+
+void StreamWatch::onFrame()
+{
+    int64_t nowNs = monotonicNs();
+    // Single writer: plain load/store, no read-modify-write on the frame path
+    uint64_t frames = m_frames.load(std::memory_order_relaxed);
+    int64_t interval = nowNs - m_lastFrameNs.load(std::memory_order_relaxed);
+    if (frames > 0 && interval < kMaxSmoothedIntervalNs) {
+        int64_t smoothed = m_intervalNs.load(std::memory_order_relaxed);
+        m_intervalNs.store(smoothed ? smoothed + (interval - smoothed) / 8 : interval, std::memory_order_relaxed);
+    }
+    m_lastFrameNs.store(nowNs, std::memory_order_relaxed);
+    m_frames.store(frames + 1, std::memory_order_relaxed);
+    if (m_stalled.load(std::memory_order_acquire)) {
+        int64_t none = 0;
+        m_recoveredNs.compare_exchange_strong(none, nowNs, std::memory_order_acq_rel);
+    }
+}
+
+void StreamWatch::setActive(bool active)
+{
+    if (active) m_lastFrameNs.store(monotonicNs(), std::memory_order_relaxed);
+    m_active.store(active, std::memory_order_relaxed);
+}
+
+StreamWatchdog::StreamWatchdog(const Config& config, Resubscribe resubscribe)
+    : m_config(config)
+    , m_resubscribe(std::move(resubscribe))
+    , m_stop(false)
+    , m_nextId(1)
+    , m_tick(0)
+    , m_startNs(0)
+    , m_wheel(kWheelSlots)
+{
+    m_config.tickMs = std::max(10, m_config.tickMs);
+    m_config.initialBackoffMs = std::max(m_config.tickMs, m_config.initialBackoffMs);
+    m_config.maxBackoffMs = std::max(m_config.initialBackoffMs, m_config.maxBackoffMs);
+}
+
+StreamWatchdog::~StreamWatchdog()
+{
+    stop();
+}
+
+std::shared_ptr<StreamWatch> StreamWatchdog::add(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_thread.joinable()) {
+        m_stop = false;
+        m_startNs = monotonicNs();
+        m_tick = 0;
+        m_thread = std::thread(&StreamWatchdog::run, this);
+    }
+    std::shared_ptr<StreamWatch> watch = std::make_shared<StreamWatch>(m_nextId++, name);
+    Entry& entry = m_entries[watch->m_id];
+    entry = Entry();
+    entry.watch = watch;
+    int64_t nowNs = monotonicNs();
+    schedule(entry, nowNs + stallAfterNs(*watch), nowNs);
+    return watch;
+}
+
+void StreamWatchdog::remove(const std::shared_ptr<StreamWatch>& watch)
+{
+    if (!watch) return;
+    // Its wheel slot still names it; the id is skipped when the slot comes round
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.erase(watch->m_id);
+}
+
+void StreamWatchdog::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_thread.joinable()) return;
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+int64_t StreamWatchdog::stallAfterNs(const StreamWatch& watch) const
+{
+    int64_t expected = int64_t(watch.m_intervalNs.load(std::memory_order_relaxed) * m_config.stallFactor);
+    return std::max(expected, int64_t(m_config.minStallMs) * 1000000);
+}
+
+void StreamWatchdog::schedule(Entry& entry, int64_t deadlineNs, int64_t nowNs)
+{
+    int64_t tickNs = int64_t(m_config.tickMs) * 1000000;
+    int64_t ticks = std::max<int64_t>(1, (deadlineNs - nowNs + tickNs - 1) / tickNs);
+    entry.dueTick = m_tick + uint64_t(ticks);
+    m_wheel[entry.dueTick % kWheelSlots].push_back(entry.watch->m_id);
+}
+
+bool StreamWatchdog::check(Entry& entry, int64_t nowNs)
+{
+    StreamWatch& watch = *entry.watch;
+    if (!watch.m_active.load(std::memory_order_relaxed)) {
+        // Deliberately off; a stall in progress ends without a recovery
+        watch.m_stalled.store(false, std::memory_order_release);
+        schedule(entry, nowNs + stallAfterNs(watch), nowNs);
+        return false;
+    }
+
+    if (watch.m_stalled.load(std::memory_order_relaxed)) {
+        int64_t recoveredNs = watch.m_recoveredNs.load(std::memory_order_acquire);
+        if (recoveredNs != 0) {
+            double recoveryMs = (recoveredNs - entry.stallDetectedNs) / 1e6;
+            entry.recoveries++;
+            entry.lastRecoveryMs = recoveryMs;
+            entry.totalRecoveryMs += recoveryMs;
+            entry.maxRecoveryMs = std::max(entry.maxRecoveryMs, recoveryMs);
+            watch.m_stalled.store(false, std::memory_order_release);
+            LOG_INFO("Stream watchdog: %s recovered after %.0f ms (%llu resubscribes so far)", watch.m_name.c_str(),
+                     recoveryMs, (unsigned long long)entry.resubscribes);
+            schedule(entry, watch.m_lastFrameNs.load(std::memory_order_relaxed) + stallAfterNs(watch), nowNs);
+            return false;
+        }
+        // Still silent: try again, waiting twice as long each time
+        entry.backoffNs = std::min(entry.backoffNs * 2, int64_t(m_config.maxBackoffMs) * 1000000);
+        entry.resubscribes++;
+        schedule(entry, nowNs + entry.backoffNs, nowNs);
+        return true;
+    }
+
+    int64_t deadlineNs = watch.m_lastFrameNs.load(std::memory_order_relaxed) + stallAfterNs(watch);
+    if (nowNs < deadlineNs) {
+        // Frames kept coming; follow the stream to its new deadline
+        schedule(entry, deadlineNs, nowNs);
+        return false;
+    }
+
+    entry.stalls++;
+    entry.resubscribes++;
+    entry.stallDetectedNs = nowNs;
+    entry.backoffNs = int64_t(m_config.initialBackoffMs) * 1000000;
+    watch.m_recoveredNs.store(0, std::memory_order_relaxed);
+    watch.m_stalled.store(true, std::memory_order_release);
+    LOG_WARN("Stream watchdog: %s delivered nothing for %.0f ms, resubscribing",
+             watch.m_name.c_str(), (nowNs - watch.m_lastFrameNs.load(std::memory_order_relaxed)) / 1e6);
+    schedule(entry, nowNs + entry.backoffNs, nowNs);
+    return true;
+}
+
+void StreamWatchdog::run()
+{
+    int64_t tickNs = int64_t(m_config.tickMs) * 1000000;
+    std::vector<std::string> resubscribe;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop) {
+        m_wake.wait_for(lock, std::chrono::milliseconds(m_config.tickMs));
+        if (m_stop) break;
+
+        // Catch up on ticks missed while descheduled, at most one revolution
+        int64_t nowNs = monotonicNs();
+        uint64_t targetTick = uint64_t((nowNs - m_startNs) / tickNs);
+        if (targetTick > m_tick + kWheelSlots) m_tick = targetTick - kWheelSlots;
+        while (m_tick < targetTick) {
+            m_tick++;
+            std::vector<uint64_t> due;
+            due.swap(m_wheel[m_tick % kWheelSlots]);
+            for (uint64_t id : due) {
+                auto found = m_entries.find(id);
+                if (found == m_entries.end()) continue;
+                Entry& entry = found->second;
+                if (entry.dueTick > m_tick) {
+                    m_wheel[m_tick % kWheelSlots].push_back(id);  // a later revolution
+                    continue;
+                }
+                if (check(entry, nowNs)) resubscribe.push_back(entry.watch->m_name);
+            }
+        }
+
+        if (!resubscribe.empty()) {
+            lock.unlock();
+            for (const std::string& name : resubscribe) {
+                if (m_resubscribe) m_resubscribe(name);
+            }
+            resubscribe.clear();
+            lock.lock();
+        }
+    }
+}
+
+std::vector<StreamWatchdog::StreamReport> StreamWatchdog::streams() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int64_t nowNs = monotonicNs();
+    std::vector<StreamReport> reports;
+    for (const auto& item : m_entries) {
+        const Entry& entry = item.second;
+        const StreamWatch& watch = *entry.watch;
+        StreamReport r;
+        r.name = watch.m_name;
+        r.active = watch.m_active.load(std::memory_order_relaxed);
+        r.stalled = watch.m_stalled.load(std::memory_order_relaxed);
+        r.frames = watch.m_frames.load(std::memory_order_relaxed);
+        r.stalls = entry.stalls;
+        r.resubscribes = entry.resubscribes;
+        r.recoveries = entry.recoveries;
+        r.sinceLastFrameMs = (nowNs - watch.m_lastFrameNs.load(std::memory_order_relaxed)) / 1e6;
+        r.expectedIntervalMs = watch.m_intervalNs.load(std::memory_order_relaxed) / 1e6;
+        r.lastRecoveryMs = entry.lastRecoveryMs;
+        r.meanRecoveryMs = entry.recoveries ? entry.totalRecoveryMs / entry.recoveries : 0.0;
+        r.maxRecoveryMs = entry.maxRecoveryMs;
+        reports.push_back(r);
+    }
+    std::sort(reports.begin(), reports.end(),
+              [](const StreamReport& a, const StreamReport& b) { return a.name < b.name; });
+    return reports;
+}
+
+void StreamWatchdog::report() const
+{
+    for (const StreamReport& r : streams()) {
+        if (r.stalls == 0) continue;
+        LOG_INFO("Stream watchdog: %s %s, %llu stalls, %llu resubscribes, %llu recoveries (last %.0f ms, mean %.0f ms, max %.0f ms)",
+                 r.name.c_str(), r.stalled ? "STALLED" : "ok", (unsigned long long)r.stalls,
+                 (unsigned long long)r.resubscribes, (unsigned long long)r.recoveries, r.lastRecoveryMs,
+                 r.meanRecoveryMs, r.maxRecoveryMs);
+    }
+}
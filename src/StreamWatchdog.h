@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class StreamWatchdog;
+
+// One watched stream. The frame path only calls onFrame(), which records the
+// arrival time and a smoothed frame interval with relaxed atomics; all
+// decisions are made by the watchdog thread.
+class StreamWatch
+{
+public:
+    StreamWatch(uint64_t id, const std::string& name);
+
+    // Frame callback thread (one per stream)
+    void onFrame();
+    // Subscribed and expected to deliver, or deliberately off (raw data
+    // off, video stopped); inactive watches never stall. Activating restarts
+    // the grace period.
+    void setActive(bool active);
+
+    const std::string& name() const { return m_name; }
+
+private:
+    friend class StreamWatchdog;
+
+    const uint64_t m_id;
+    const std::string m_name;
+    std::atomic<bool> m_active;
+    std::atomic<int64_t> m_lastFrameNs;   // or activation time before the first frame
+    std::atomic<int64_t> m_intervalNs;    // smoothed, gaps over a second left out
+    std::atomic<uint64_t> m_frames;
+    std::atomic<bool> m_stalled;
+    std::atomic<int64_t> m_recoveredNs;   // first frame after a stall, 0 until then
+};
+
+// Finds remote streams that stopped delivering without the SDK saying so.
+// All watches share one hashed timer wheel driven by a single thread: each
+// stream sits in the slot of the time it would count as stalled, and frames
+// never touch the wheel; when the slot comes round, a stream that received
+// frames meanwhile is simply moved to its new deadline. A stream is stalled
+// once it has been silent for its expected interval times stallFactor (at
+// least minStallMs). It is then resubscribed at once and, until a frame
+// arrives, again after 1, 2, 4, ... seconds up to maxBackoffMs. Stalls,
+// resubscriptions and time to recovery are kept per stream.
+class StreamWatchdog
+{
+public:
+    struct Config
+    {
+        int tickMs = 100;
+        int minStallMs = 2000;
+        double stallFactor = 8.0;
+        int initialBackoffMs = 1000;
+        int maxBackoffMs = 30000;
+    };
+
+    struct StreamReport
+    {
+        std::string name;
+        bool active;
+        bool stalled;
+        uint64_t frames;
+        uint64_t stalls;
+        uint64_t resubscribes;
+        uint64_t recoveries;
+        double sinceLastFrameMs;
+        double expectedIntervalMs;
+        double lastRecoveryMs;  // stall detected to first frame
+        double meanRecoveryMs;
+        double maxRecoveryMs;
+    };
+
+    // Called on the watchdog thread, without its lock held
+    using Resubscribe = std::function<void(const std::string& name)>;
+
+    StreamWatchdog(const Config& config, Resubscribe resubscribe);
+    ~StreamWatchdog();
+
+    StreamWatchdog(const StreamWatchdog&) = delete;
+    StreamWatchdog& operator=(const StreamWatchdog&) = delete;
+
+    // Starts watching (and the thread, on first use); the watch starts active
+    std::shared_ptr<StreamWatch> add(const std::string& name);
+    void remove(const std::shared_ptr<StreamWatch>& watch);
+    void stop();
+
+    std::vector<StreamReport> streams() const;
+    void report() const;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<StreamWatch> watch;
+        uint64_t dueTick = 0;
+        int64_t stallDetectedNs = 0;
+        int64_t backoffNs = 0;
+        uint64_t stalls = 0;
+        uint64_t resubscribes = 0;
+        uint64_t recoveries = 0;
+        double lastRecoveryMs = 0.0;
+        double totalRecoveryMs = 0.0;
+        double maxRecoveryMs = 0.0;
+    };
+
+    void run();
+    // Caller holds m_mutex; returns true if the stream needs a resubscribe now
+    bool check(Entry& entry, int64_t nowNs);
+    void schedule(Entry& entry, int64_t deadlineNs, int64_t nowNs);
+    int64_t stallAfterNs(const StreamWatch& watch) const;
+
+    static const size_t kWheelSlots = 512;
+
+    Config m_config;
+    Resubscribe m_resubscribe;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stop;
+    uint64_t m_nextId;
+    uint64_t m_tick;           // wheel position
+    int64_t m_startNs;         // time of tick 0
+    std::vector<std::vector<uint64_t>> m_wheel;  // watch ids per slot; stale ids are skipped
+    std::unordered_map<uint64_t, Entry> m_entries;
+
+    std::thread m_thread;
+};
@@ -0,0 +1,264 @@
+#include "SubscriptionPolicy.h"
+
+#include <algorithm>
+
+const int SubscriptionPolicy::kTiers[5] = { 90, 180, 360, 720, 1080 };
+
+namespace {
+
+int tierAtLeast(int lines)
+{
+    for (int tier : SubscriptionPolicy::kTiers) {
+        if (tier >= lines) return tier;
+    }
+    return 1080;
+}
+
+int tierBelow(int lines)
+{
+    int below = SubscriptionPolicy::kTiers[0];
+    for (int tier : SubscriptionPolicy::kTiers) {
+        if (tier >= lines) break;
+        below = tier;
+    }
+    return below;
+}
+
+} // namespace
+
+double SubscriptionPolicy::pixelsPerSecond(int lines, double framesPerSecond)
+{
+    if (lines <= 0) return 0.0;
+    return double(lines) * (lines * 16 / 9) * framesPerSecond;
+}
+
+void SubscriptionPolicy::setConfig(const Config& config)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+}
+
+SubscriptionPolicy::Config SubscriptionPolicy::config() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_config;
+}
+
+void SubscriptionPolicy::setUserVideo(const std::string& user, bool hasVideo)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_users[user].hasVideo = hasVideo;
+}
+
+void SubscriptionPolicy::removeUser(const std::string& user)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_users.erase(user);
+}
+
+void SubscriptionPolicy::markUnsubscribed(const std::string& user)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_users.find(user);
+    if (it != m_users.end()) it->second.lines = 0;
+}
+
+void SubscriptionPolicy::setActiveSpeakers(const std::vector<std::string>& users)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& entry : m_users) {
+        entry.second.speaker = std::find(users.begin(), users.end(), entry.first) != users.end();
+    }
+}
+
+void SubscriptionPolicy::setNetwork(const std::string& user, NetworkQuality quality)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_users[user].network = quality;
+}
+
+void SubscriptionPolicy::setTileHeight(int pixels)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tileHeight = pixels;
+}
+
+void SubscriptionPolicy::setOverride(const std::string& user, int lines)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    UserState& state = m_users[user];
+    state.hasOverride = true;
+    state.overrideLines = lines;
+}
+
+void SubscriptionPolicy::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_users.clear();
+}
+
+void SubscriptionPolicy::computeWanted(UserState& state) const
+{
+    state.urgent = false;
+    if (!state.hasVideo) {
+        state.wantedLines = 0;
+        state.reason = "no video";
+        state.urgent = true;
+        return;
+    }
+    if (state.hasOverride) {
+        state.wantedLines = state.overrideLines < 0 ? 0 : state.overrideLines;
+        state.reason = state.overrideLines < 0 ? "turned off by request" : "requested";
+        state.urgent = true;
+        return;
+    }
+
+    int lines = tierAtLeast(m_config.defaultLines);
+    state.reason = "default";
+    if (m_tileHeight > 0 && tierAtLeast(m_tileHeight) > lines) {
+        lines = tierAtLeast(m_tileHeight);
+        state.reason = "tile " + std::to_string(m_tileHeight) + "px";
+    }
+    if (state.speaker && m_config.speakerLines > lines) {
+        lines = tierAtLeast(m_config.speakerLines);
+        state.reason = "active speaker";
+    }
+
+    int cap = state.network == NETWORK_BAD ? 180 : state.network == NETWORK_NORMAL ? 360 : 1080;
+    if (lines > cap) {
+        lines = cap;
+        state.reason += state.network == NETWORK_BAD ? ", network bad" : ", network normal";
+        state.urgent = true;
+    }
+    state.wantedLines = lines;
+}
+
+void SubscriptionPolicy::applyBudget()
+{
+    double total = 0.0;
+    for (const auto& entry : m_users) {
+        total += pixelsPerSecond(entry.second.wantedLines, m_config.framesPerSecond);
+    }
+
+    // Step the least important stream down one tier until the total fits:
+    // non-speakers before speakers, larger streams first; overrides stay
+    while (total > m_config.maxPixelsPerSecond) {
+        UserState* victim = nullptr;
+        for (auto& entry : m_users) {
+            UserState& state = entry.second;
+            if (state.hasOverride || state.wantedLines <= kTiers[0]) continue;
+            if (!victim || (victim->speaker && !state.speaker)
+                || (victim->speaker == state.speaker && state.wantedLines > victim->wantedLines)) {
+                victim = &state;
+            }
+        }
+        if (!victim) break;
+
+        int lower = tierBelow(victim->wantedLines);
+        total -= pixelsPerSecond(victim->wantedLines, m_config.framesPerSecond)
+                 - pixelsPerSecond(lower, m_config.framesPerSecond);
+        victim->wantedLines = lower;
+        if (victim->reason.find("pixel budget") == std::string::npos) victim->reason += ", pixel budget";
+        victim->urgent = true;
+    }
+}
+
+double SubscriptionPolicy::appliedPixelsPerSecond() const
+{
+    double total = 0.0;
+    for (const auto& entry : m_users) {
+        total += pixelsPerSecond(entry.second.lines, m_config.framesPerSecond);
+    }
+    return total;
+}
+
+std::vector<SubscriptionDecision> SubscriptionPolicy::evaluate(int64_t nowNs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& entry : m_users) {
+        computeWanted(entry.second);
+    }
+    applyBudget();
+
+    std::vector<SubscriptionDecision> changes;
+    auto apply = [&](const std::string& name, UserState& state, int lines) {
+        state.lines = lines;
+        state.sinceNs = nowNs;
+        state.pendingLines = -1;
+        SubscriptionDecision decision;
+        decision.user = name;
+        decision.lines = lines;
+        decision.wantedLines = state.wantedLines;
+        decision.reason = state.reason;
+        decision.sinceNs = nowNs;
+        changes.push_back(decision);
+    };
+
+    // Reductions first, so the upgrades below see the freed budget
+    for (int pass = 0; pass < 2; pass++) {
+        for (auto& entry : m_users) {
+            UserState& state = entry.second;
+            int wanted = state.wantedLines;
+            if (wanted == state.lines) {
+                state.pendingLines = -1;
+                continue;
+            }
+            bool lower = wanted < state.lines;
+            if (lower != (pass == 0)) continue;
+
+            bool immediate = state.lines == 0 || (lower && state.urgent);
+            if (!immediate) {
+                if (state.pendingLines != wanted) {
+                    state.pendingLines = wanted;
+                    state.pendingSinceNs = nowNs;
+                }
+                if (nowNs - state.pendingSinceNs < m_config.debounceMs * 1000000) continue;
+            }
+            // An upgrade waits while the streams actually subscribed leave no room
+            if (!lower && !state.hasOverride) {
+                double after = appliedPixelsPerSecond() + pixelsPerSecond(wanted, m_config.framesPerSecond)
+                               - pixelsPerSecond(state.lines, m_config.framesPerSecond);
+                if (after > m_config.maxPixelsPerSecond) continue;
+            }
+            apply(entry.first, state, wanted);
+        }
+    }
+
+    // Entries that hold no input and no subscription have nothing left to
+    // track. A network status or speaker flag that arrived before the
+    // user's video must survive until the video starts.
+    for (auto it = m_users.begin(); it != m_users.end();) {
+        const UserState& state = it->second;
+        if (!state.hasVideo && !state.hasOverride && state.lines == 0 && state.network == NETWORK_UNKNOWN
+            && !state.speaker) {
+            it = m_users.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return changes;
+}
+
+std::vector<SubscriptionDecision> SubscriptionPolicy::decisions() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<SubscriptionDecision> result;
+    for (const auto& entry : m_users) {
+        const UserState& state = entry.second;
+        SubscriptionDecision decision;
+        decision.user = entry.first;
+        decision.lines = state.lines;
+        decision.wantedLines = state.wantedLines;
+        decision.reason = state.reason;
+        decision.pending = state.pendingLines >= 0;
+        decision.sinceNs = state.sinceNs;
+        result.push_back(decision);
+    }
+    return result;
+}
+
+double SubscriptionPolicy::subscribedPixelsPerSecond() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return appliedPixelsPerSecond();
+}
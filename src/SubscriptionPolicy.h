@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum NetworkQuality
+{
+    NETWORK_UNKNOWN,
+    NETWORK_GOOD,
+    NETWORK_NORMAL,  // caps the user at 360p
+    NETWORK_BAD,     // caps the user at 180p
+};
+
+// The resolution chosen for one remote user and why
+struct SubscriptionDecision
+{
+    std::string user;
+    int lines = 0;        // subscribed resolution (90..1080), 0 = not subscribed
+    int wantedLines = 0;  // what the inputs ask for, after the pixel budget
+    std::string reason;
+    bool pending = false;  // a debounced change to wantedLines is waiting
+    int64_t sinceNs = 0;   // when lines took effect (CLOCK_MONOTONIC)
+};
+
+// Picks each remote user's subscription resolution from what the session
+// reports: the layout's tile size, the active speaker (720p), each user's
+// video network status and manual overrides. The total decoded pixel rate
+// of all subscriptions is kept under a budget by stepping the least
+// important streams down a tier at a time. Changes that only follow the
+// conversation (speaker or layout) must hold for the debounce interval
+// before they are applied, so a quick back-and-forth does not resubscribe;
+// new streams and downgrades forced by the network or the budget apply at
+// once. Inputs and evaluate() may be called from any thread.
+class SubscriptionPolicy
+{
+public:
+    struct Config
+    {
+        int defaultLines = 90;    // floor for users in no particular role
+        int speakerLines = 720;
+        double maxPixelsPerSecond = 1280.0 * 720 * 30 * 2;  // two 720p30 streams
+        double framesPerSecond = 30;                        // assumed per stream
+        int64_t debounceMs = 2000;
+    };
+
+    // Subscription tiers, smallest first; 16:9
+    static const int kTiers[5];
+    static double pixelsPerSecond(int lines, double framesPerSecond);
+
+    void setConfig(const Config& config);
+    Config config() const;
+
+    // Inputs
+    void setUserVideo(const std::string& user, bool hasVideo);
+    void removeUser(const std::string& user);
+    // The user's stream was dropped outside the policy; resubscribe it at once
+    void markUnsubscribed(const std::string& user);
+    void setActiveSpeakers(const std::vector<std::string>& users);
+    void setNetwork(const std::string& user, NetworkQuality quality);
+    // Height in pixels of the tile every remote user is shown in; 0 = none
+    void setTileHeight(int pixels);
+    // Manual choice that bypasses the inputs above: lines, or -1 for off
+    void setOverride(const std::string& user, int lines);
+    void clear();
+
+    // Decisions whose subscribed resolution changes now; apply each one
+    std::vector<SubscriptionDecision> evaluate(int64_t nowNs);
+
+    // Current decision for every known user, for inspection
+    std::vector<SubscriptionDecision> decisions() const;
+    // Decoded pixel rate of the resolutions currently subscribed
+    double subscribedPixelsPerSecond() const;
+
+private:
+    struct UserState
+    {
+        bool hasVideo = false;
+        NetworkQuality network = NETWORK_UNKNOWN;
+        bool hasOverride = false;
+        int overrideLines = 0;
+        bool speaker = false;
+
+        int lines = 0;  // applied
+        int64_t sinceNs = 0;
+        int wantedLines = 0;
+        bool urgent = false;  // wanted lower because of network, budget or override
+        std::string reason;
+        int pendingLines = -1;
+        int64_t pendingSinceNs = 0;
+    };
+
+    // Caller holds m_mutex
+    void computeWanted(UserState& state) const;
+    void applyBudget();
+    double appliedPixelsPerSecond() const;
+
+    mutable std::mutex m_mutex;
+    Config m_config;
+    int m_tileHeight = 0;
+    std::map<std::string, UserState> m_users;
+};
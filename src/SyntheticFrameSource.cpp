@@ -0,0 +1,102 @@
+#include "SyntheticFrameSource.h"
+#include "Logger.h"
+
+#include <chrono>
+#include <cstring>
+
+SyntheticFrameSource::SyntheticFrameSource(int width, int height, int fps)
+    : m_width(width & ~1)
+    , m_height(height & ~1)
+    , m_fps(fps > 0 ? fps : 30)
+    , m_running(false)
+    , m_framesDelivered(0)
+    , m_lateTicks(0)
+{
+}
+
+SyntheticFrameSource::~SyntheticFrameSource()
+{
+    stop();
+}
+
+void SyntheticFrameSource::addStream(IVideoFrameSink* sink)
+{
+    if (m_running.load()) return;
+
+    size_t lumaSize = size_t(m_width) * m_height;
+    Stream stream;
+    stream.sink = sink;
+    stream.planes.resize(lumaSize + lumaSize / 2);
+    memset(stream.planes.data(), 16, lumaSize);
+    memset(stream.planes.data() + lumaSize, 128, lumaSize / 2);
+    m_streams.push_back(std::move(stream));
+}
+
+void SyntheticFrameSource::start()
+{
+    if (m_running.exchange(true)) return;
+    LOG_INFO("SyntheticFrameSource: %zu streams at %dx%d, %d fps", m_streams.size(), m_width, m_height, m_fps);
+    m_thread = std::thread(&SyntheticFrameSource::run, this);
+}
+
+void SyntheticFrameSource::stop()
+{
+    if (!m_running.exchange(false)) return;
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void SyntheticFrameSource::drawFrame(Stream& stream, uint64_t tick, size_t index)
+{
+    // Clear the previous bar and draw it one step further; offset per stream
+    const int barWidth = m_width / 16 > 0 ? m_width / 16 : 1;
+    uint8_t* y = stream.planes.data();
+    int previous = int(((tick - 1) * 4 + index * 37) % m_width);
+    int current = int((tick * 4 + index * 37) % m_width);
+    for (int row = 0; row < m_height; row++) {
+        uint8_t* line = y + size_t(row) * m_width;
+        for (int i = 0; i < barWidth; i++) {
+            line[(previous + i) % m_width] = 16;
+        }
+        for (int i = 0; i < barWidth; i++) {
+            line[(current + i) % m_width] = 235;
+        }
+    }
+}
+
+void SyntheticFrameSource::run()
+{
+    const auto interval = std::chrono::nanoseconds(1000000000LL / m_fps);
+    const size_t lumaSize = size_t(m_width) * m_height;
+    auto next = std::chrono::steady_clock::now();
+    uint64_t tick = 1;
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        for (size_t i = 0; i < m_streams.size(); i++) {
+            Stream& stream = m_streams[i];
+            drawFrame(stream, tick, i);
+
+            I420Frame frame;
+            frame.y = stream.planes.data();
+            frame.u = frame.y + lumaSize;
+            frame.v = frame.u + lumaSize / 4;
+            frame.width = m_width;
+            frame.height = m_height;
+            frame.yStride = m_width;
+            frame.uStride = m_width / 2;
+            frame.vStride = m_width / 2;
+            stream.sink->onVideoFrame(frame);
+        }
+        m_framesDelivered.fetch_add(m_streams.size(), std::memory_order_relaxed);
+        tick++;
+
+        // Keep the schedule; if a tick overran, count it and skip ahead
+        next += interval;
+        auto now = std::chrono::steady_clock::now();
+        if (now > next) {
+            m_lateTicks.fetch_add(1, std::memory_order_relaxed);
+            next = now;
+        } else {
+            std::this_thread::sleep_until(next);
+        }
+    }
+}
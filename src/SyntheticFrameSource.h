@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "VideoFrameSink.h"
+
+// Stand-in for the SDK's raw video delivery, for capacity tests without a
+// session. One thread paces all streams at a fixed frame rate and hands each
+// sink an I420 frame with a moving bar, so consumers see changing content.
+class SyntheticFrameSource
+{
+public:
+    SyntheticFrameSource(int width, int height, int fps);
+    ~SyntheticFrameSource();
+
+    // Sinks must outlive the source, or at least stop()
+    void addStream(IVideoFrameSink* sink);
+
+    void start();
+    void stop();
+
+    uint64_t framesDelivered() const { return m_framesDelivered.load(std::memory_order_relaxed); }
+    // Ticks where delivering every stream took longer than a frame interval
+    uint64_t lateTicks() const { return m_lateTicks.load(std::memory_order_relaxed); }
+
+private:
+    struct Stream
+    {
+        IVideoFrameSink* sink;
+        std::vector<uint8_t> planes;  // Y then U then V
+    };
+
+    void run();
+    void drawFrame(Stream& stream, uint64_t tick, size_t index);
+
+    const int m_width;
+    const int m_height;
+    const int m_fps;
+    std::vector<Stream> m_streams;
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<uint64_t> m_framesDelivered;
+    std::atomic<uint64_t> m_lateTicks;
+};
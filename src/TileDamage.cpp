@@ -0,0 +1,139 @@
+#include "TileDamage.h"
+
+#include <cstring>
+
+namespace {
+
+const uint64_t kPrime = 0x9E3779B97F4A7C15ull;
+
+inline uint64_t mix(uint64_t h, uint64_t word)
+{
+    h ^= word;
+    h *= kPrime;
+    return h ^ (h >> 29);
+}
+
+// Hashes one row of a plane eight bytes at a time
+inline uint64_t hashRow(uint64_t h, const uint8_t* row, int bytes)
+{
+    int i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        memcpy(&word, row + i, sizeof(word));
+        h = mix(h, word);
+    }
+    uint64_t tail = 0;
+    for (int shift = 0; i < bytes; i++, shift += 8) {
+        tail |= uint64_t(row[i]) << shift;
+    }
+    return mix(h, tail);
+}
+
+struct PackedImage
+{
+    const uint8_t* pixels;
+    int stride;
+};
+
+} // namespace
+
+TileDamageTracker::TileDamageTracker()
+    : m_width(0)
+    , m_height(0)
+    , m_columns(0)
+    , m_rows(0)
+    , m_cleanTiles(0)
+    , m_dirtyTiles(0)
+{
+}
+
+void TileDamageTracker::reset()
+{
+    m_width = 0;
+    m_height = 0;
+}
+
+uint64_t TileDamageTracker::hashTile(const void* image, int tx, int ty, int width, int height)
+{
+    const I420Frame& frame = *static_cast<const I420Frame*>(image);
+    uint64_t h = kPrime;
+    for (int row = 0; row < height; row++) {
+        h = hashRow(h, frame.y + int64_t(ty + row) * frame.yStride + tx, width);
+    }
+    int chromaX = tx / 2;
+    int chromaY = ty / 2;
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    for (int row = 0; row < chromaHeight; row++) {
+        h = hashRow(h, frame.u + int64_t(chromaY + row) * frame.uStride + chromaX, chromaWidth);
+        h = hashRow(h, frame.v + int64_t(chromaY + row) * frame.vStride + chromaX, chromaWidth);
+    }
+    return h;
+}
+
+uint64_t TileDamageTracker::hashTileRGB32(const void* image, int tx, int ty, int width, int height)
+{
+    const PackedImage& packed = *static_cast<const PackedImage*>(image);
+    uint64_t h = kPrime;
+    for (int row = 0; row < height; row++) {
+        h = hashRow(h, packed.pixels + int64_t(ty + row) * packed.stride + int64_t(tx) * 4, width * 4);
+    }
+    return h;
+}
+
+const std::vector<TileRect>& TileDamageTracker::update(const I420Frame& frame)
+{
+    return track(frame.width, frame.height, hashTile, &frame);
+}
+
+const std::vector<TileRect>& TileDamageTracker::updateRGB32(const uint8_t* pixels, int stride, int width, int height)
+{
+    PackedImage image = { pixels, stride };
+    return track(width, height, hashTileRGB32, &image);
+}
+
+const std::vector<TileRect>& TileDamageTracker::track(int frameWidth, int frameHeight, TileHash hash, const void* image)
+{
+    bool resized = frameWidth != m_width || frameHeight != m_height;
+    if (resized) {
+        m_width = frameWidth;
+        m_height = frameHeight;
+        m_columns = (frameWidth + kTileSize - 1) / kTileSize;
+        m_rows = (frameHeight + kTileSize - 1) / kTileSize;
+        m_hashes.assign(size_t(m_columns) * m_rows, 0);
+    }
+
+    m_damage.clear();
+    m_cleanTiles = 0;
+    m_dirtyTiles = 0;
+
+    for (int row = 0; row < m_rows; row++) {
+        int ty = row * kTileSize;
+        int height = frameHeight - ty < kTileSize ? frameHeight - ty : kTileSize;
+        bool inRun = false;
+
+        for (int column = 0; column < m_columns; column++) {
+            int tx = column * kTileSize;
+            int width = frameWidth - tx < kTileSize ? frameWidth - tx : kTileSize;
+
+            uint64_t tileHash = hash(image, tx, ty, width, height);
+            uint64_t& previous = m_hashes[size_t(row) * m_columns + column];
+            bool dirty = resized || tileHash != previous;
+            previous = tileHash;
+
+            if (!dirty) {
+                m_cleanTiles++;
+                inRun = false;
+                continue;
+            }
+            m_dirtyTiles++;
+            if (inRun) {
+                m_damage.back().width += width;
+            } else {
+                m_damage.push_back(TileRect{ tx, ty, width, height });
+                inRun = true;
+            }
+        }
+    }
+    return m_damage;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "VideoFrameSink.h"
+
+// A changed area in luma pixel coordinates
+struct TileRect
+{
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+// Finds which parts of an I420 frame changed since the previous one. The
+// frame is cut into fixed-size luma tiles (with their chroma); each tile's
+// Y, U and V bytes are hashed and compared with the hash kept from the last
+// frame. Screen shares are mostly static, so usually only a few tiles differ.
+// Packed RGB32 images can be tracked the same way, before any conversion.
+// Not thread-safe; one tracker per stream.
+class TileDamageTracker
+{
+public:
+    // Tile edge in luma pixels; even so chroma tiles line up
+    static const int kTileSize = 64;
+
+    TileDamageTracker();
+
+    // Compares the frame with the previous one and returns the changed
+    // tiles, horizontally adjacent ones merged into one rect. The first
+    // frame and any size change damage the whole frame.
+    const std::vector<TileRect>& update(const I420Frame& frame);
+    // Same for 32-bit pixels (QImage::Format_RGB32 layout); don't mix the
+    // two kinds of image in one tracker
+    const std::vector<TileRect>& updateRGB32(const uint8_t* pixels, int stride, int width, int height);
+
+    // Forget the previous frame so the next one is fully damaged
+    void reset();
+
+    int columns() const { return m_columns; }
+    int rows() const { return m_rows; }
+    // Tiles found unchanged / changed by the last update()
+    int cleanTiles() const { return m_cleanTiles; }
+    int dirtyTiles() const { return m_dirtyTiles; }
+
+private:
+    typedef uint64_t (*TileHash)(const void* image, int tx, int ty, int width, int height);
+
+    static uint64_t hashTile(const void* image, int tx, int ty, int width, int height);
+    static uint64_t hashTileRGB32(const void* image, int tx, int ty, int width, int height);
+    const std::vector<TileRect>& track(int width, int height, TileHash hash, const void* image);
+
+    int m_width;
+    int m_height;
+    int m_columns;
+    int m_rows;
+    std::vector<uint64_t> m_hashes;
+    std::vector<TileRect> m_damage;
+    int m_cleanTiles;
+    int m_dirtyTiles;
+};
@@ -0,0 +1,492 @@
+#include "TranscriptLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <new>
+
+namespace {
+
+const uint64_t kGrowBytes = 1024 * 1024;  // file allocation step
+const size_t kMaxTextBytes = 64 * 1024;
+
+uint64_t roundUp(uint64_t n, uint64_t to)
+{
+    return (n + to - 1) / to * to;
+}
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+int64_t unixMs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return int64_t(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Longest prefix of at most limit bytes that ends on a UTF-8 character
+// boundary: a cut that lands on a continuation byte (10xxxxxx) backs off to
+// the start of that character
+size_t utf8Prefix(const std::string& text, size_t limit)
+{
+    if (text.size() <= limit) return text.size();
+    size_t n = limit;
+    while (n > 0 && (uint8_t(text[n]) & 0xC0) == 0x80) n--;
+    return n;
+}
+
+std::string safeName(const std::string& name)
+{
+    std::string safe;
+    for (char c : name) {
+        bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '.';
+        safe += ok ? c : '_';
+    }
+    return safe.empty() ? "session" : safe.substr(0, 100);
+}
+
+// Validates the record at offset against the committed end; null if damaged
+const TranscriptRecordHeader* recordAt(const uint8_t* base, uint64_t offset, uint64_t end)
+{
+    if (offset + sizeof(TranscriptRecordHeader) > end) return nullptr;
+    const TranscriptRecordHeader* record = reinterpret_cast<const TranscriptRecordHeader*>(base + offset);
+    if (record->magic != kTranscriptRecordMagic || record->recordBytes % 8 != 0 ||
+        record->recordBytes < sizeof(TranscriptRecordHeader) || offset + record->recordBytes > end) {
+        return nullptr;
+    }
+    uint64_t payload = uint64_t(record->messageIdBytes) + record->speakerBytes + record->textBytes;
+    if (sizeof(TranscriptRecordHeader) + payload > record->recordBytes) return nullptr;
+    return record;
+}
+
+void decodeRecord(const TranscriptRecordHeader* record, TranscriptEntry& entry)
+{
+    const char* payload = reinterpret_cast<const char*>(record + 1);
+    entry.sequence = record->sequence;
+    entry.timestampMs = record->timestampMs;
+    entry.operation = TranscriptOperation(record->operation);
+    entry.messageId.assign(payload, record->messageIdBytes);
+    payload += record->messageIdBytes;
+    entry.speaker.assign(payload, record->speakerBytes);
+    payload += record->speakerBytes;
+    entry.text.assign(payload, record->textBytes);
+}
+
+} // namespace
+
+uint32_t transcriptSpeakerHash(const std::string& speaker)
+{
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : speaker) {
+        hash = (hash ^ c) * 16777619u;
+    }
+    return hash;
+}
+
+TranscriptLog::TranscriptLog(const Config& config)
+    : m_config(config)
+    , m_fd(-1)
+    , m_base(nullptr)
+    , m_header(nullptr)
+    , m_stop(false)
+    , m_flushRequested(false)
+    , m_appendBytes(0)
+    , m_fileBytes(0)
+    , m_syncedBytes(0)
+    , m_nextSequence(0)
+    , m_drops(0)
+    , m_flushes(0)
+    , m_flushedRecords(0)
+    , m_maxFlushMs(0.0)
+{
+    m_config.flushIntervalMs = std::max(1, m_config.flushIntervalMs);
+    m_config.maxBytes = std::max<size_t>(m_config.maxBytes, kTranscriptLogHeaderBytes + kGrowBytes);
+}
+
+TranscriptLog::~TranscriptLog()
+{
+    close();
+}
+
+bool TranscriptLog::open(const std::string& path, const std::string& sessionName)
+{
+    close();
+    m_syncedBytes = 0;
+    m_path = path;
+    if (m_path.empty()) {
+        time_t now = time(nullptr);
+        tm local;
+        localtime_r(&now, &local);
+        char stamp[32];
+        strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local);
+        m_path = m_config.directory + "/" + safeName(sessionName) + "-" + stamp + ".tlog";
+    }
+
+    m_fd = ::open(m_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        fprintf(stderr, "TranscriptLog: cannot create %s: %s\n", m_path.c_str(), strerror(errno));
+        return false;
+    }
+    m_fileBytes = 0;
+    if (!reserve(kTranscriptLogHeaderBytes)) {
+        close();
+        return false;
+    }
+    // Reserve the address range once so appends never remap
+    void* base = mmap(nullptr, m_config.maxBytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "TranscriptLog: cannot map %s: %s\n", m_path.c_str(), strerror(errno));
+        m_base = nullptr;
+        close();
+        return false;
+    }
+    m_base = static_cast<uint8_t*>(base);
+
+    m_header = new (m_base) TranscriptLogHeader();
+    m_header->magic = kTranscriptLogMagic;
+    m_header->version = kTranscriptLogVersion;
+    m_header->headerBytes = uint32_t(kTranscriptLogHeaderBytes);
+    m_header->recordHeaderBytes = uint32_t(sizeof(TranscriptRecordHeader));
+    m_header->reservedBytes = m_config.maxBytes;
+    m_header->createdUnixMs = unixMs();
+    snprintf(m_header->sessionName, sizeof(m_header->sessionName), "%s", sessionName.c_str());
+    m_header->committedBytes.store(kTranscriptLogHeaderBytes, std::memory_order_relaxed);
+    m_header->committedRecords.store(0, std::memory_order_relaxed);
+    m_header->writerAlive.store(1, std::memory_order_release);
+    msync(m_base, kTranscriptLogHeaderBytes, MS_SYNC);
+
+    m_appendBytes = kTranscriptLogHeaderBytes;
+    m_syncedBytes = kTranscriptLogHeaderBytes;
+    m_nextSequence = 0;
+    m_drops = 0;
+    m_flushes = 0;
+    m_flushedRecords = 0;
+    m_maxFlushMs = 0.0;
+    m_stop = false;
+    m_thread = std::thread(&TranscriptLog::commitLoop, this);
+    return true;
+}
+
+void TranscriptLog::close()
+{
+    if (m_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+    // Under the lock so appends and queries racing with close see no mapping
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_header) {
+        m_header->writerAlive.store(0, std::memory_order_release);
+        msync(m_base, kTranscriptLogHeaderBytes, MS_SYNC);
+    }
+    if (m_base) {
+        munmap(m_base, m_config.maxBytes);
+        m_base = nullptr;
+        m_header = nullptr;
+    }
+    if (m_fd >= 0) {
+        // Drop the preallocated tail
+        if (m_syncedBytes && ftruncate(m_fd, off_t(m_syncedBytes)) != 0) {
+            fprintf(stderr, "TranscriptLog: cannot trim %s: %s\n", m_path.c_str(), strerror(errno));
+        }
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_committed.notify_all();
+    m_segments.clear();
+    m_byTime.clear();
+    m_bySpeaker.clear();
+    m_byMessageId.clear();
+}
+
+bool TranscriptLog::reserve(uint64_t end)
+{
+    if (end <= m_fileBytes) return true;
+    if (end > m_config.maxBytes) return false;
+    uint64_t grown = std::min<uint64_t>(roundUp(end, kGrowBytes), m_config.maxBytes);
+    // Real blocks, so a full disk fails here rather than as SIGBUS in memcpy
+    int err = posix_fallocate(m_fd, off_t(m_fileBytes), off_t(grown - m_fileBytes));
+    if (err != 0) {
+        fprintf(stderr, "TranscriptLog: cannot grow %s to %llu bytes: %s\n", m_path.c_str(),
+                (unsigned long long)grown, strerror(err));
+        return false;
+    }
+    m_fileBytes = grown;
+    return true;
+}
+
+bool TranscriptLog::append(TranscriptEntry& entry)
+{
+    size_t messageIdBytes = utf8Prefix(entry.messageId, UINT16_MAX);
+    size_t speakerBytes = utf8Prefix(entry.speaker, UINT16_MAX);
+    size_t textBytes = utf8Prefix(entry.text, kMaxTextBytes);
+    uint32_t recordBytes = uint32_t(roundUp(sizeof(TranscriptRecordHeader) + messageIdBytes + speakerBytes + textBytes, 8));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_base || !reserve(m_appendBytes + recordBytes)) {
+        m_drops++;
+        return false;
+    }
+    uint64_t offset = m_appendBytes;
+    entry.sequence = m_nextSequence++;
+
+    TranscriptRecordHeader* record = reinterpret_cast<TranscriptRecordHeader*>(m_base + offset);
+    record->magic = kTranscriptRecordMagic;
+    record->recordBytes = recordBytes;
+    record->sequence = entry.sequence;
+    record->timestampMs = entry.timestampMs;
+    record->speakerHash = transcriptSpeakerHash(entry.speaker);
+    record->operation = uint16_t(entry.operation);
+    record->messageIdBytes = uint16_t(messageIdBytes);
+    record->speakerBytes = uint16_t(speakerBytes);
+    record->reserved = 0;
+    record->textBytes = uint32_t(textBytes);
+    uint8_t* payload = reinterpret_cast<uint8_t*>(record + 1);
+    memcpy(payload, entry.messageId.data(), messageIdBytes);
+    payload += messageIdBytes;
+    memcpy(payload, entry.speaker.data(), speakerBytes);
+    payload += speakerBytes;
+    memcpy(payload, entry.text.data(), textBytes);
+    payload += textBytes;
+    memset(payload, 0, m_base + offset + recordBytes - payload);
+    m_appendBytes += recordBytes;
+
+    // Updates of a known message move its segment to the new revision
+    auto known = entry.messageId.empty() ? m_byMessageId.end() : m_byMessageId.find(entry.messageId);
+    if (known != m_byMessageId.end()) {
+        Segment& segment = m_segments[known->second];
+        segment.latestOffset = offset;
+        segment.revisions++;
+        segment.deleted = entry.operation == TRANSCRIPT_OP_DELETE;
+    } else {
+        uint32_t index = uint32_t(m_segments.size());
+        m_segments.push_back({ entry.timestampMs, offset, 1, entry.operation == TRANSCRIPT_OP_DELETE });
+        insertByTime(m_byTime, index);
+        insertByTime(m_bySpeaker[entry.speaker], index);
+        if (!entry.messageId.empty()) m_byMessageId[entry.messageId] = index;
+    }
+
+    if (m_appendBytes - m_syncedBytes >= m_config.flushBytes) m_wake.notify_one();
+    return true;
+}
+
+void TranscriptLog::insertByTime(std::vector<uint32_t>& list, uint32_t segment)
+{
+    int64_t startMs = m_segments[segment].startMs;
+    if (list.empty() || m_segments[list.back()].startMs <= startMs) {
+        list.push_back(segment);
+        return;
+    }
+    auto at = std::upper_bound(list.begin(), list.end(), startMs,
+                               [this](int64_t ms, uint32_t other) { return ms < m_segments[other].startMs; });
+    list.insert(at, segment);
+}
+
+void TranscriptLog::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_thread.joinable()) return;
+    uint64_t target = m_appendBytes;
+    m_flushRequested = true;
+    m_wake.notify_one();
+    m_committed.wait(lock, [&] { return m_syncedBytes >= target || m_stop; });
+}
+
+void TranscriptLog::commitLoop()
+{
+    long pageBytes = sysconf(_SC_PAGESIZE);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait_for(lock, std::chrono::milliseconds(m_config.flushIntervalMs), [&] {
+            return m_stop || m_flushRequested || m_appendBytes - m_syncedBytes >= m_config.flushBytes;
+        });
+        m_flushRequested = false;
+        uint64_t from = m_syncedBytes;
+        uint64_t target = m_appendBytes;
+        uint64_t records = m_nextSequence;
+        if (target == from) {
+            if (m_stop) break;
+            continue;
+        }
+
+        // One sync for everything appended since the last one; appenders
+        // keep writing past target meanwhile
+        lock.unlock();
+        int64_t startNs = monotonicNs();
+        uint64_t alignedFrom = from / pageBytes * pageBytes;
+        if (msync(m_base + alignedFrom, target - alignedFrom, MS_SYNC) != 0) {
+            fprintf(stderr, "TranscriptLog: msync of %s failed: %s\n", m_path.c_str(), strerror(errno));
+        }
+        m_header->committedRecords.store(records, std::memory_order_relaxed);
+        m_header->committedBytes.store(target, std::memory_order_release);
+        msync(m_base, kTranscriptLogHeaderBytes, MS_ASYNC);
+        double flushMs = (monotonicNs() - startNs) / 1e6;
+        lock.lock();
+
+        m_flushedRecords = records;
+        m_syncedBytes = target;
+        m_flushes++;
+        m_maxFlushMs = std::max(m_maxFlushMs, flushMs);
+        m_committed.notify_all();
+    }
+}
+
+TranscriptEntry TranscriptLog::decode(uint64_t offset) const
+{
+    TranscriptEntry entry;
+    decodeRecord(reinterpret_cast<const TranscriptRecordHeader*>(m_base + offset), entry);
+    return entry;
+}
+
+std::vector<TranscriptSegment> TranscriptLog::query(int64_t fromMs, int64_t toMs, const std::string& speaker,
+                                                    size_t limit) const
+{
+    std::vector<TranscriptSegment> result;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_base) return result;
+
+    const std::vector<uint32_t>* list = &m_byTime;
+    if (!speaker.empty()) {
+        auto found = m_bySpeaker.find(speaker);
+        if (found == m_bySpeaker.end()) return result;
+        list = &found->second;
+    }
+    auto it = std::lower_bound(list->begin(), list->end(), fromMs,
+                               [this](uint32_t segment, int64_t ms) { return m_segments[segment].startMs < ms; });
+    for (; it != list->end() && m_segments[*it].startMs <= toMs; ++it) {
+        const Segment& segment = m_segments[*it];
+        if (segment.deleted) continue;
+        TranscriptEntry latest = decode(segment.latestOffset);
+        TranscriptSegment out;
+        out.messageId = std::move(latest.messageId);
+        out.speaker = std::move(latest.speaker);
+        out.text = std::move(latest.text);
+        out.startMs = segment.startMs;
+        out.updatedMs = latest.timestampMs;
+        out.operation = latest.operation;
+        out.revisions = segment.revisions;
+        out.sequence = latest.sequence;
+        result.push_back(std::move(out));
+        if (limit && result.size() >= limit) break;
+    }
+    return result;
+}
+
+std::vector<std::string> TranscriptLog::speakers() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::string> names;
+    for (const auto& entry : m_bySpeaker) names.push_back(entry.first);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+TranscriptLog::Stats TranscriptLog::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats s;
+    s.records = m_nextSequence;
+    s.drops = m_drops;
+    s.appendedBytes = m_appendBytes;
+    s.committedBytes = m_syncedBytes;
+    s.flushes = m_flushes;
+    s.meanRecordsPerFlush = m_flushes ? double(m_flushedRecords) / m_flushes : 0.0;
+    s.maxFlushMs = m_maxFlushMs;
+    s.segments = m_segments.size();
+    s.speakers = m_bySpeaker.size();
+    return s;
+}
+
+TranscriptLogReader::TranscriptLogReader()
+    : m_base(nullptr)
+    , m_header(nullptr)
+    , m_size(0)
+    , m_offset(0)
+    , m_corrupt(false)
+{
+}
+
+TranscriptLogReader::~TranscriptLogReader()
+{
+    close();
+}
+
+bool TranscriptLogReader::open(const std::string& path)
+{
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "TranscriptLogReader: cannot open %s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+    struct stat st;
+    TranscriptLogHeader probe;
+    bool ok = fstat(fd, &st) == 0 && size_t(st.st_size) >= kTranscriptLogHeaderBytes &&
+              pread(fd, &probe, sizeof(probe), 0) == ssize_t(sizeof(probe)) &&
+              probe.magic == kTranscriptLogMagic && probe.version == kTranscriptLogVersion &&
+              probe.recordHeaderBytes == sizeof(TranscriptRecordHeader) && probe.headerBytes >= sizeof(probe);
+    if (!ok) {
+        fprintf(stderr, "TranscriptLogReader: %s is not a transcript log\n", path.c_str());
+        ::close(fd);
+        return false;
+    }
+    // Mapped at the writer's reservation so the view covers every later append
+    void* base = mmap(nullptr, probe.reservedBytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "TranscriptLogReader: cannot map %s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+    m_base = static_cast<const uint8_t*>(base);
+    m_header = reinterpret_cast<const TranscriptLogHeader*>(m_base);
+    m_size = probe.reservedBytes;
+    m_offset = probe.headerBytes;
+    m_corrupt = false;
+    return true;
+}
+
+void TranscriptLogReader::close()
+{
+    if (m_base) {
+        munmap(const_cast<uint8_t*>(m_base), m_size);
+        m_base = nullptr;
+        m_header = nullptr;
+        m_size = 0;
+    }
+}
+
+bool TranscriptLogReader::next(TranscriptEntry& entry)
+{
+    if (!m_base || m_corrupt) return false;
+    uint64_t committed = std::min<uint64_t>(m_header->committedBytes.load(std::memory_order_acquire), m_size);
+    if (m_offset >= committed) return false;
+    const TranscriptRecordHeader* record = recordAt(m_base, m_offset, committed);
+    if (!record) {
+        m_corrupt = true;
+        return false;
+    }
+    decodeRecord(record, entry);
+    m_offset += record->recordBytes;
+    return true;
+}
+
+bool TranscriptLogReader::writerAlive() const
+{
+    return m_header && m_header->writerAlive.load(std::memory_order_acquire) != 0;
+}
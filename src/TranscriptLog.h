@@ -0,0 +1,220 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Append-only transcript log for live transcription. One file per session
+// holds a page-sized header followed by records, each a fixed-size header and
+// then its message id, speaker name and UTF-8 text, padded to 8 bytes. The
+// writer maps the file once at its maximum size and grows it underneath, so
+// appending is a memcpy under a short lock. A background thread syncs what
+// was appended in groups and only then advances committedBytes in the file
+// header; readers in other processes map the file read-only and follow that
+// offset, so they never see a record that could be lost in a crash. Depends
+// on nothing but POSIX, so consumers can build it alone.
+
+const uint32_t kTranscriptLogMagic = 0x4C54425Au;     // "ZBTL"
+const uint32_t kTranscriptLogVersion = 1;
+const uint32_t kTranscriptRecordMagic = 0x43455254u;  // "TREC"
+const size_t kTranscriptLogHeaderBytes = 4096;
+
+// Same order as ZoomVideoSDKLiveTranscriptionOperationType
+enum TranscriptOperation
+{
+    TRANSCRIPT_OP_NONE = 0,
+    TRANSCRIPT_OP_ADD,       // new message, possibly partial
+    TRANSCRIPT_OP_UPDATE,    // replaces the text of an earlier message id
+    TRANSCRIPT_OP_DELETE,
+    TRANSCRIPT_OP_COMPLETE,  // final text
+};
+
+struct TranscriptLogHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerBytes;        // records start here
+    uint32_t recordHeaderBytes;  // sizeof(TranscriptRecordHeader)
+    uint64_t reservedBytes;      // the file never grows past this
+    int64_t createdUnixMs;
+    char sessionName[128];       // NUL-terminated
+    alignas(64) std::atomic<uint64_t> committedBytes;  // end of the last synced record
+    std::atomic<uint64_t> committedRecords;
+    std::atomic<uint32_t> writerAlive;                 // 0 once the writer closed the log
+};
+
+struct TranscriptRecordHeader
+{
+    uint32_t magic;
+    uint32_t recordBytes;     // header, payload and padding; multiple of 8
+    uint64_t sequence;        // record number in this log
+    int64_t timestampMs;      // Unix time the message was spoken
+    uint32_t speakerHash;     // transcriptSpeakerHash(speaker)
+    uint16_t operation;       // TranscriptOperation
+    uint16_t messageIdBytes;  // payload: message id, speaker, text
+    uint16_t speakerBytes;
+    uint16_t reserved;
+    uint32_t textBytes;
+};
+
+static_assert(sizeof(TranscriptRecordHeader) == 40, "record header layout is part of the file format");
+static_assert(sizeof(TranscriptLogHeader) <= kTranscriptLogHeaderBytes, "log header must fit its page");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "committed offset needs address-free atomics");
+
+// One record as appended or read back
+struct TranscriptEntry
+{
+    uint64_t sequence = 0;
+    int64_t timestampMs = 0;
+    TranscriptOperation operation = TRANSCRIPT_OP_NONE;
+    std::string messageId;  // empty for messages without one; each is its own segment
+    std::string speaker;
+    std::string text;
+};
+
+// A message with all its updates applied, as returned by range queries
+struct TranscriptSegment
+{
+    std::string messageId;
+    std::string speaker;
+    std::string text;            // latest revision
+    int64_t startMs;             // first revision's timestamp
+    int64_t updatedMs;           // latest revision's timestamp
+    TranscriptOperation operation;  // of the latest revision
+    uint32_t revisions;
+    uint64_t sequence;           // of the latest revision
+};
+
+uint32_t transcriptSpeakerHash(const std::string& speaker);
+
+// Producer side; any thread may append and query
+class TranscriptLog
+{
+public:
+    struct Config
+    {
+        std::string directory;
+        int flushIntervalMs = 200;        // group commit period
+        size_t flushBytes = 64 * 1024;    // or as soon as this much is pending
+        size_t maxBytes = size_t(256) * 1024 * 1024;
+    };
+
+    struct Stats
+    {
+        uint64_t records;
+        uint64_t drops;            // log full, oversized or file growth failed
+        uint64_t appendedBytes;
+        uint64_t committedBytes;
+        uint64_t flushes;
+        double meanRecordsPerFlush;
+        double maxFlushMs;
+        size_t segments;
+        size_t speakers;
+    };
+
+    explicit TranscriptLog(const Config& config);
+    // Commits what was appended and closes the file
+    ~TranscriptLog();
+
+    TranscriptLog(const TranscriptLog&) = delete;
+    TranscriptLog& operator=(const TranscriptLog&) = delete;
+
+    // Creates the file (replacing one at the same path) and starts the commit
+    // thread. An empty path makes a name from the directory and session name.
+    bool open(const std::string& path, const std::string& sessionName);
+    void close();
+
+    // Copies the record into the log and indexes it; durable and visible to
+    // other processes after the next group commit. Sets entry.sequence.
+    bool append(TranscriptEntry& entry);
+    // Blocks until everything appended so far is committed
+    void flush();
+
+    // Segments whose first revision lies in [fromMs, toMs], oldest first,
+    // optionally only one speaker's; deleted messages are left out. Uses the
+    // in-memory index and reads the latest revisions from the mapping.
+    std::vector<TranscriptSegment> query(int64_t fromMs, int64_t toMs, const std::string& speaker = std::string(),
+                                         size_t limit = 0) const;
+    std::vector<std::string> speakers() const;
+
+    const std::string& path() const { return m_path; }
+    Stats stats() const;
+
+private:
+    struct Segment
+    {
+        int64_t startMs;
+        uint64_t latestOffset;
+        uint32_t revisions;
+        bool deleted;
+    };
+
+    void commitLoop();
+    bool reserve(uint64_t end);
+    TranscriptEntry decode(uint64_t offset) const;
+    // Keeps list ordered by segment start time; appends are nearly always in order
+    void insertByTime(std::vector<uint32_t>& list, uint32_t segment);
+
+    Config m_config;
+    std::string m_path;
+    int m_fd;
+    uint8_t* m_base;
+    TranscriptLogHeader* m_header;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;       // commit thread
+    std::condition_variable m_committed;  // flush() waiters
+    bool m_stop;
+    bool m_flushRequested;   // flush() is waiting
+    uint64_t m_appendBytes;    // end of the last appended record
+    uint64_t m_fileBytes;      // allocated so far
+    uint64_t m_syncedBytes;    // end of the last committed record
+    uint64_t m_nextSequence;
+    uint64_t m_drops;
+    uint64_t m_flushes;
+    uint64_t m_flushedRecords;
+    double m_maxFlushMs;
+
+    std::vector<Segment> m_segments;                    // in arrival order
+    std::vector<uint32_t> m_byTime;                     // segment indices by start time
+    std::unordered_map<std::string, std::vector<uint32_t>> m_bySpeaker;  // same, per speaker
+    std::unordered_map<std::string, uint32_t> m_byMessageId;
+
+    std::thread m_thread;
+};
+
+// Consumer side; follows a log from another process without blocking the
+// writer
+class TranscriptLogReader
+{
+public:
+    TranscriptLogReader();
+    ~TranscriptLogReader();
+
+    TranscriptLogReader(const TranscriptLogReader&) = delete;
+    TranscriptLogReader& operator=(const TranscriptLogReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    // Next committed record after the previous one returned. False if there
+    // is none yet, or the log is damaged (corrupt() tells which).
+    bool next(TranscriptEntry& entry);
+
+    bool writerAlive() const;
+    bool corrupt() const { return m_corrupt; }
+    const TranscriptLogHeader* header() const { return m_header; }
+
+private:
+    const uint8_t* m_base;
+    const TranscriptLogHeader* m_header;
+    size_t m_size;
+    uint64_t m_offset;
+    bool m_corrupt;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+// One I420 frame as delivered by the SDK. The plane pointers are only valid
+// for the duration of the call that hands the frame over.
+struct I420Frame
+{
+    const uint8_t* y;
+    const uint8_t* u;
+    const uint8_t* v;
+    int width;
+    int height;
+    int yStride;
+    int uStride;
+    int vStride;
+    // Full-resolution alpha plane of alpha-mode video, null otherwise
+    const uint8_t* a = nullptr;
+    int aStride = 0;
+};
+
+// Consumer of decoded video frames (renderer, recorder, analysis, ...).
+// Called on whichever SDK thread delivered the frame.
+class IVideoFrameSink
+{
+public:
+    virtual ~IVideoFrameSink() {}
+    virtual void onVideoFrame(const I420Frame& frame) = 0;
+};
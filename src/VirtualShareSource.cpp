@@ -0,0 +1,412 @@
+#include "VirtualShareSource.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+namespace {
+
+// Largest image width or height shared; 64 MB per RGB32 buffer
+const int kMaxDimension = 4096;
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Next header token of a PPM, skipping whitespace and # comments
+bool readPPMToken(FILE* file, int& value)
+{
+    int c = fgetc(file);
+    while (c == '#' || (c != EOF && isspace(c))) {
+        if (c == '#') {
+            while (c != EOF && c != '\n') c = fgetc(file);
+        }
+        c = fgetc(file);
+    }
+    if (c == EOF || !isdigit(c)) return false;
+    value = 0;
+    while (c != EOF && isdigit(c)) {
+        value = value * 10 + (c - '0');
+        if (value > 65535) return false;
+        c = fgetc(file);
+    }
+    // Exactly one whitespace byte ends the last header token
+    return c != EOF && isspace(c);
+}
+
+// Binary PPM (P6, 8 bits per channel) to 0xFFRRGGBB words
+bool loadPPM(const std::string& path, std::vector<uint32_t>& pixels, int& width, int& height)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    char magic[2];
+    int maxValue = 0;
+    bool ok = fread(magic, 1, 2, file) == 2 && magic[0] == 'P' && magic[1] == '6' && readPPMToken(file, width) &&
+              readPPMToken(file, height) && readPPMToken(file, maxValue) && maxValue == 255 && width > 0 && height > 0 &&
+              width <= kMaxDimension && height <= kMaxDimension;
+    if (ok) {
+        std::vector<uint8_t> row(size_t(width) * 3);
+        pixels.resize(size_t(width) * height);
+        for (int y = 0; ok && y < height; y++) {
+            ok = fread(row.data(), 1, row.size(), file) == row.size();
+            uint32_t* out = pixels.data() + size_t(y) * width;
+            for (int x = 0; ok && x < width; x++) {
+                out[x] = 0xFF000000u | (uint32_t(row[3 * x]) << 16) | (uint32_t(row[3 * x + 1]) << 8) | row[3 * x + 2];
+            }
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+} // namespace
+
+VirtualShareSource::VirtualShareSource(const Config& config)
+    : m_config(config)
+    , m_stop(false)
+    , m_hasPending(false)
+    , m_pendingWidth(0)
+    , m_pendingHeight(0)
+    , m_file(config.file)
+    , m_fileChanged(true)
+    , m_nextPollNs(0)
+    , m_sending(false)
+    , m_lastSendNs(0)
+    , m_width(0)
+    , m_height(0)
+    , m_sender(nullptr)
+    , m_nextSendNs(0)
+    , m_fileMtimeNs(-1)
+    , m_fileSize(-1)
+    , m_submitted(0)
+    , m_superseded(0)
+    , m_unchanged(0)
+    , m_sent(0)
+    , m_keepalives(0)
+    , m_bytesSent(0)
+    , m_fileLoads(0)
+    , m_converted(0)
+    , m_totalConvertUs(0.0)
+    , m_maxConvertUs(0.0)
+    , m_totalDirtyFraction(0.0)
+    , m_budgetAccount("virtual share")
+{
+    m_config.maxFps = std::max(1, m_config.maxFps);
+    m_config.keepaliveMs = std::max(100, m_config.keepaliveMs);
+    m_config.filePollMs = std::max(10, m_config.filePollMs);
+}
+
+VirtualShareSource::~VirtualShareSource()
+{
+    stop();
+    m_budgetAccount.release((m_pending.size() + m_spare.size() + m_image.size()) * sizeof(uint32_t) + m_frame.size());
+}
+
+void VirtualShareSource::submitRGB32(const uint8_t* pixels, int stride, int width, int height)
+{
+    // The SDK's I420 frames have whole chroma samples
+    width &= ~1;
+    height &= ~1;
+    if (!pixels || width < 2 || height < 2) return;
+    if (width > kMaxDimension || height > kMaxDimension) {
+        LOG_RATE_LIMITED(LOG_LEVEL_WARN, 5000, "Virtual share: %dx%d image is over %dx%d, dropped", width, height,
+                         kMaxDimension, kMaxDimension);
+        return;
+    }
+
+    // Copy outside the lock into a spare buffer, then swap it in
+    std::vector<uint32_t> image;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        image.swap(m_spare);
+    }
+    size_t pixelCount = size_t(width) * height;
+    if (image.size() != pixelCount) {
+        m_budgetAccount.release(image.size() * sizeof(uint32_t));
+        if (!m_budgetAccount.tryCharge(pixelCount * sizeof(uint32_t))) {
+            LOG_RATE_LIMITED(LOG_LEVEL_WARN, 5000, "Virtual share: memory budget exhausted, dropping %dx%d image",
+                             width, height);
+            return;
+        }
+        image.resize(pixelCount);
+    }
+    for (int y = 0; y < height; y++) {
+        memcpy(image.data() + size_t(y) * width, pixels + int64_t(y) * stride, size_t(width) * 4);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        image.swap(m_pending);
+        m_spare.swap(image);
+        m_pendingWidth = width;
+        m_pendingHeight = height;
+        m_submitted++;
+        if (m_hasPending) m_superseded++;
+        m_hasPending = true;
+    }
+    // Only another submit racing this one leaves a buffer here
+    m_budgetAccount.release(image.size() * sizeof(uint32_t));
+    m_wake.notify_one();
+}
+
+void VirtualShareSource::setFile(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_file = path;
+        m_fileChanged = true;
+        m_nextPollNs = 0;
+    }
+    m_wake.notify_one();
+}
+
+void VirtualShareSource::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_thread.joinable()) return;
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void VirtualShareSource::onShareSendStarted(IZoomVideoSDKShareSender* pSender)
+{
+    LOG_INFO("Virtual share: sending started");
+    {
+        std::lock_guard<std::mutex> lock(m_sendMutex);
+        m_sender = pSender;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sending = true;
+        // Whatever frame is retained goes out at once
+        m_lastSendNs = 0;
+        if (!m_thread.joinable()) {
+            m_stop = false;
+            m_thread = std::thread(&VirtualShareSource::run, this);
+        }
+    }
+    m_wake.notify_one();
+}
+
+void VirtualShareSource::onShareSendStopped()
+{
+    LOG_INFO("Virtual share: sending stopped");
+    {
+        std::lock_guard<std::mutex> lock(m_sendMutex);
+        m_sender = nullptr;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sending = false;
+}
+
+void VirtualShareSource::run()
+{
+    int64_t frameNs = 1000000000LL / m_config.maxFps;
+    int64_t keepaliveNs = int64_t(m_config.keepaliveMs) * 1000000;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop) {
+        int64_t nowNs = monotonicNs();
+        if (!m_file.empty() && nowNs >= m_nextPollNs) {
+            lock.unlock();
+            pollFile(nowNs);
+            lock.lock();
+            continue;
+        }
+        if (m_hasPending && nowNs >= m_nextSendNs) {
+            // The previous image becomes the next submit's buffer
+            m_image.swap(m_pending);
+            m_width = m_pendingWidth;
+            m_height = m_pendingHeight;
+            m_hasPending = false;
+            m_nextSendNs = nowNs + frameNs;
+            lock.unlock();
+            sendImage();
+            lock.lock();
+            continue;
+        }
+        bool keepalive = m_sending && !m_frame.empty();
+        if (keepalive && nowNs >= m_lastSendNs + keepaliveNs) {
+            lock.unlock();
+            sendFrame(true);
+            lock.lock();
+            continue;
+        }
+
+        int64_t wakeNs = keepalive ? m_lastSendNs + keepaliveNs : INT64_MAX;
+        if (m_hasPending) wakeNs = std::min(wakeNs, m_nextSendNs);
+        if (!m_file.empty()) wakeNs = std::min(wakeNs, m_nextPollNs);
+        if (wakeNs == INT64_MAX) {
+            m_wake.wait(lock);
+        } else {
+            m_wake.wait_for(lock, std::chrono::nanoseconds(std::max<int64_t>(wakeNs - nowNs, 100000)));
+        }
+    }
+}
+
+void VirtualShareSource::sendImage()
+{
+    int64_t startNs = monotonicNs();
+    const uint8_t* pixels = reinterpret_cast<const uint8_t*>(m_image.data());
+    int stride = m_width * 4;
+    const std::vector<TileRect>& damage = m_tracker.updateRGB32(pixels, stride, m_width, m_height);
+    if (damage.empty()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_unchanged++;
+        return;
+    }
+
+    // A size change damages every tile, so the whole frame is rewritten
+    int chromaWidth = m_width / 2;
+    size_t lumaBytes = size_t(m_width) * m_height;
+    size_t chromaBytes = size_t(chromaWidth) * (m_height / 2);
+    size_t frameBytes = lumaBytes + 2 * chromaBytes;
+    if (m_frame.size() != frameBytes) {
+        m_budgetAccount.release(m_frame.size());
+        if (!m_budgetAccount.tryCharge(frameBytes)) {
+            // Nothing retained to resend; the next image starts from scratch
+            std::vector<uint8_t>().swap(m_frame);
+            m_tracker.reset();
+            LOG_RATE_LIMITED(LOG_LEVEL_WARN, 5000, "Virtual share: memory budget exhausted, dropping %dx%d frame",
+                             m_width, m_height);
+            return;
+        }
+        m_frame.resize(frameBytes);
+    }
+    uint8_t* yPlane = m_frame.data();
+    uint8_t* uPlane = yPlane + lumaBytes;
+    uint8_t* vPlane = uPlane + chromaBytes;
+
+    // Tiles are converted one at a time, so AUTO is decided by the image
+    ColorSpace space = m_config.colorSpace;
+    if (space.matrix == COLOR_MATRIX_AUTO) space.matrix = m_height >= 720 ? COLOR_MATRIX_BT709 : COLOR_MATRIX_BT601;
+
+    // Tile origins are multiples of 64, so every rect starts on a chroma sample
+    for (const TileRect& rect : damage) {
+        I420Frame region;
+        region.y = yPlane + int64_t(rect.y) * m_width + rect.x;
+        region.u = uPlane + int64_t(rect.y / 2) * chromaWidth + rect.x / 2;
+        region.v = vPlane + int64_t(rect.y / 2) * chromaWidth + rect.x / 2;
+        region.width = rect.width;
+        region.height = rect.height;
+        region.yStride = m_width;
+        region.uStride = chromaWidth;
+        region.vStride = chromaWidth;
+        convertRGB32ToI420(pixels + int64_t(rect.y) * stride + int64_t(rect.x) * 4, stride, region, space);
+    }
+
+    double convertUs = (monotonicNs() - startNs) / 1e3;
+    int tiles = m_tracker.dirtyTiles() + m_tracker.cleanTiles();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_converted++;
+        m_totalConvertUs += convertUs;
+        m_maxConvertUs = std::max(m_maxConvertUs, convertUs);
+        m_totalDirtyFraction += tiles ? double(m_tracker.dirtyTiles()) / tiles : 1.0;
+    }
+    sendFrame(false);
+}
+
+void VirtualShareSource::sendFrame(bool keepalive)
+{
+    FrameDataFormat format =
+        m_config.colorSpace.range == COLOR_RANGE_FULL ? FrameDataFormat_I420_FULL : FrameDataFormat_I420_LIMITED;
+    bool sent = false;
+    {
+        std::lock_guard<std::mutex> lock(m_sendMutex);
+        if (m_sender) {
+            // The SDK copies the frame before returning
+            m_sender->sendShareFrame(reinterpret_cast<char*>(m_frame.data()), m_width, m_height, int(m_frame.size()),
+                                     format);
+            sent = true;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lastSendNs = monotonicNs();
+    if (!sent) return;
+    if (keepalive) {
+        m_keepalives++;
+    } else {
+        m_sent++;
+    }
+    m_bytesSent += m_frame.size();
+}
+
+void VirtualShareSource::pollFile(int64_t nowNs)
+{
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nextPollNs = nowNs + int64_t(m_config.filePollMs) * 1000000;
+        path = m_file;
+        if (m_fileChanged) {
+            m_fileChanged = false;
+            m_fileMtimeNs = -1;
+        }
+    }
+
+    struct stat st;
+    if (path.empty() || stat(path.c_str(), &st) != 0) return;
+    int64_t mtimeNs = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    if (mtimeNs == m_fileMtimeNs && int64_t(st.st_size) == m_fileSize) return;
+
+    std::vector<uint32_t> pixels;
+    int width = 0;
+    int height = 0;
+    if (!loadPPM(path, pixels, width, height)) {
+        // Maybe caught mid-write; the next poll tries again
+        LOG_RATE_LIMITED(LOG_LEVEL_WARN, 5000, "Virtual share: %s is not a complete binary PPM", path.c_str());
+        return;
+    }
+    m_fileMtimeNs = mtimeNs;
+    m_fileSize = int64_t(st.st_size);
+    submitRGB32(reinterpret_cast<const uint8_t*>(pixels.data()), width * 4, width, height);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fileLoads++;
+}
+
+VirtualShareSource::Stats VirtualShareSource::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats s;
+    s.submitted = m_submitted;
+    s.superseded = m_superseded;
+    s.unchanged = m_unchanged;
+    s.sent = m_sent;
+    s.keepalives = m_keepalives;
+    s.bytesSent = m_bytesSent;
+    s.fileLoads = m_fileLoads;
+    s.converted = m_converted;
+    s.meanConvertUs = m_converted ? m_totalConvertUs / m_converted : 0.0;
+    s.maxConvertUs = m_maxConvertUs;
+    s.meanDirtyFraction = m_converted ? m_totalDirtyFraction / m_converted : 0.0;
+    s.width = m_width;
+    s.height = m_height;
+    s.sending = m_sending;
+    return s;
+}
+
+void VirtualShareSource::report() const
+{
+    Stats s = stats();
+    if (s.submitted == 0) return;
+    LOG_INFO("Virtual share %dx%d: %llu images, %llu changed (%.0f%% of tiles converted, %.0f us mean, %.0f us max), "
+             "%llu unchanged, %llu superseded; %llu sent, %llu keepalives, %.1f MB",
+             s.width, s.height, (unsigned long long)s.submitted, (unsigned long long)s.converted,
+             s.meanDirtyFraction * 100.0, s.meanConvertUs, s.maxConvertUs, (unsigned long long)s.unchanged,
+             (unsigned long long)s.superseded, (unsigned long long)s.sent, (unsigned long long)s.keepalives,
+             s.bytesSent / 1e6);
+}
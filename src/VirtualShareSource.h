@@ -0,0 +1,136 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FrameConvert.h"
+#include "MemoryBudget.h"
+#include "TileDamage.h"
+#include "zoom_video_sdk_def.h"
+#include "helpers/zoom_video_sdk_share_helper_interface.h"
+
+USING_ZOOM_VIDEO_SDK_NAMESPACE
+
+// Screen share of content the bot renders itself (dashboards drawn into an
+// offscreen QImage or grabbed from a widget, or an image file another
+// process keeps rewriting). Callers hand over RGB32 images whenever they
+// like; the sender thread sends at most maxFps of them. Each image's 64x64
+// tiles are hashed before any conversion: an image with no changed tile is
+// not sent at all, and for the rest only the changed tiles are converted
+// into the retained I420 frame. While nothing changes, that frame is resent
+// every keepaliveMs so receivers don't time the share out. Images are capped
+// at 4096x4096 and their buffers are charged to the memory budget; an image
+// the budget cannot cover is dropped.
+class VirtualShareSource : public IZoomVideoSDKShareSource
+{
+public:
+    struct Config
+    {
+        int maxFps = 10;
+        int keepaliveMs = 1000;
+        ColorSpace colorSpace = { COLOR_MATRIX_AUTO, COLOR_RANGE_FULL };  // range picks the SDK's I420 format
+        std::string file;          // binary PPM (P6), reloaded when it changes
+        int filePollMs = 250;
+    };
+
+    struct Stats
+    {
+        uint64_t submitted;
+        uint64_t superseded;       // replaced by a newer image before the sender took it
+        uint64_t unchanged;        // no tile changed; nothing converted or sent
+        uint64_t converted;        // images with changed tiles
+        uint64_t sent;             // frames with changes handed to the SDK
+        uint64_t keepalives;       // unchanged frame resent
+        uint64_t bytesSent;
+        uint64_t fileLoads;
+        double meanConvertUs;      // per changed image, hashing included
+        double maxConvertUs;
+        double meanDirtyFraction;  // share of tiles converted per changed image
+        int width;
+        int height;
+        bool sending;
+    };
+
+    explicit VirtualShareSource(const Config& config);
+    ~VirtualShareSource();
+
+    VirtualShareSource(const VirtualShareSource&) = delete;
+    VirtualShareSource& operator=(const VirtualShareSource&) = delete;
+
+    // Any thread; copies the image (QImage::Format_RGB32 or ARGB32 layout,
+    // e.g. image.constBits() and image.bytesPerLine()). An odd last row or
+    // column is dropped, and so is an image over 4096 pixels either way.
+    void submitRGB32(const uint8_t* pixels, int stride, int width, int height);
+    // Shares this file from now on, or stops reading one if empty
+    void setFile(const std::string& path);
+
+    // Stops the sender thread; the SDK may still call onShareSendStopped()
+    void stop();
+
+    Stats stats() const;
+    void report() const;
+
+    // IZoomVideoSDKShareSource, on SDK threads
+    void onShareSendStarted(IZoomVideoSDKShareSender* pSender) override;
+    void onShareSendStopped() override;
+
+private:
+    void run();
+    // Sender thread: hashes m_image and sends its changed tiles
+    void sendImage();
+    void sendFrame(bool keepalive);
+    void pollFile(int64_t nowNs);
+
+    Config m_config;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stop;
+    bool m_hasPending;
+    std::vector<uint32_t> m_pending;  // packed rows, width pixels each
+    std::vector<uint32_t> m_spare;    // next submit's buffer
+    int m_pendingWidth;
+    int m_pendingHeight;
+    std::string m_file;
+    bool m_fileChanged;
+    int64_t m_nextPollNs;
+    bool m_sending;
+    int64_t m_lastSendNs;
+    int m_width;               // of m_image; written by the sender thread
+    int m_height;
+
+    // Held while a frame is handed to the SDK, so onShareSendStopped()
+    // returns only when the sender is no longer in use
+    std::mutex m_sendMutex;
+    IZoomVideoSDKShareSender* m_sender;
+
+    // Sender thread only
+    std::vector<uint32_t> m_image;
+    TileDamageTracker m_tracker;
+    std::vector<uint8_t> m_frame;  // I420, planes back to back
+    int64_t m_nextSendNs;
+    int64_t m_fileMtimeNs;
+    int64_t m_fileSize;
+
+    uint64_t m_submitted;
+    uint64_t m_superseded;
+    uint64_t m_unchanged;
+    uint64_t m_sent;
+    uint64_t m_keepalives;
+    uint64_t m_bytesSent;
+    uint64_t m_fileLoads;
+    uint64_t m_converted;
+    double m_totalConvertUs;
+    double m_maxConvertUs;
+    double m_totalDirtyFraction;
+
+    // m_pending, m_spare, m_image and m_frame; buffers are charged when
+    // resized, so swapping them around leaves the total unchanged
+    MemoryBudget::Account m_budgetAccount;
+
+    std::thread m_thread;
+};
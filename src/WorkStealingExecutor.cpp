@@ -0,0 +1,238 @@
+#include "WorkStealingExecutor.h"
+#include "Logger.h"
+
+#include <stdio.h>
+#include <string>
+#include <time.h>
+
+namespace {
+
+// Tasks a strand runs before giving its worker back
+const int kStrandBatch = 4;
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Index of the executor worker running on this thread, -1 elsewhere
+thread_local const WorkStealingExecutor* t_executor = nullptr;
+thread_local int t_workerIndex = -1;
+
+} // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(int threads)
+    : m_nextWorker(0)
+    , m_queued(0)
+    , m_stopping(false)
+    , m_startNs(monotonicNs())
+    , m_lastReportNs(m_startNs)
+{
+    if (threads <= 0) {
+        threads = int(std::thread::hardware_concurrency());
+        if (threads <= 0) threads = 2;
+    }
+    for (int i = 0; i < threads; i++) {
+        m_workers.push_back(std::unique_ptr<Worker>(new Worker));
+    }
+    m_lastReport.resize(threads);
+    m_lastBusyNs.resize(threads, 0);
+    for (int i = 0; i < threads; i++) {
+        m_workers[i]->thread = std::thread(&WorkStealingExecutor::run, this, i);
+    }
+    LOG_INFO("WorkStealingExecutor: %d workers", threads);
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        worker->thread.join();
+    }
+}
+
+void WorkStealingExecutor::post(Task task)
+{
+    int index;
+    if (t_executor == this) {
+        index = t_workerIndex;
+    } else {
+        index = int(m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size());
+    }
+    {
+        Worker& worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    m_queued.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders this against a worker deciding to sleep
+    { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+    m_wake.notify_one();
+}
+
+bool WorkStealingExecutor::popLocal(Worker& worker, Task& task)
+{
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) return false;
+    task = worker.tasks.take_front();
+    return true;
+}
+
+bool WorkStealingExecutor::steal(int thief, Task& task)
+{
+    size_t count = m_workers.size();
+    for (size_t offset = 1; offset < count; offset++) {
+        Worker& victim = *m_workers[(thief + offset) % count];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.tasks.empty()) continue;
+        task = victim.tasks.take_back();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingExecutor::run(int index)
+{
+    t_executor = this;
+    t_workerIndex = index;
+    Worker& self = *m_workers[index];
+
+    for (;;) {
+        Task task;
+        bool stolen = false;
+        if (!popLocal(self, task)) {
+            stolen = steal(index, task);
+        }
+
+        if (task) {
+            m_queued.fetch_sub(1, std::memory_order_acq_rel);
+            if (stolen) self.steals.fetch_add(1, std::memory_order_relaxed);
+            int64_t start = monotonicNs();
+            task();
+            self.busyNs.fetch_add(monotonicNs() - start, std::memory_order_relaxed);
+            self.tasksRun.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        if (m_queued.load(std::memory_order_acquire) > 0) continue;  // a steal lost a try_lock race
+        if (m_stopping) break;
+        m_wake.wait(lock);
+    }
+}
+
+std::vector<WorkStealingExecutor::WorkerStats> WorkStealingExecutor::stats() const
+{
+    double elapsedNs = double(monotonicNs() - m_startNs);
+    std::vector<WorkerStats> result;
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        WorkerStats s;
+        s.tasks = worker->tasksRun.load(std::memory_order_relaxed);
+        s.steals = worker->steals.load(std::memory_order_relaxed);
+        s.utilisation = elapsedNs > 0 ? worker->busyNs.load(std::memory_order_relaxed) / elapsedNs : 0.0;
+        result.push_back(s);
+    }
+    return result;
+}
+
+void WorkStealingExecutor::report() const
+{
+    std::lock_guard<std::mutex> lock(m_reportMutex);
+    int64_t now = monotonicNs();
+    double intervalNs = double(now - m_lastReportNs);
+    m_lastReportNs = now;
+
+    std::string line;
+    uint64_t totalTasks = 0;
+    uint64_t totalSteals = 0;
+    for (size_t i = 0; i < m_workers.size(); i++) {
+        const Worker& worker = *m_workers[i];
+        WorkerStats current;
+        current.tasks = worker.tasksRun.load(std::memory_order_relaxed);
+        current.steals = worker.steals.load(std::memory_order_relaxed);
+        int64_t busy = worker.busyNs.load(std::memory_order_relaxed);
+        double utilisation = intervalNs > 0 ? (busy - m_lastBusyNs[i]) / intervalNs : 0.0;
+
+        uint64_t tasks = current.tasks - m_lastReport[i].tasks;
+        uint64_t steals = current.steals - m_lastReport[i].steals;
+        totalTasks += tasks;
+        totalSteals += steals;
+        char buf[64];
+        snprintf(buf, sizeof(buf), " %.0f%%", utilisation * 100.0);
+        line += buf;
+
+        m_lastReport[i] = current;
+        m_lastBusyNs[i] = busy;
+    }
+    LOG_INFO("Frame executor: %llu tasks, %llu stolen, utilisation per worker:%s",
+             (unsigned long long)totalTasks, (unsigned long long)totalSteals, line.c_str());
+}
+
+Strand::Strand(WorkStealingExecutor& executor)
+    : m_executor(executor)
+    , m_scheduled(false)
+    , m_closed(false)
+{
+}
+
+Strand::~Strand()
+{
+    close();
+}
+
+void Strand::close()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_queue.clear();
+    m_idle.wait(lock, [this]() { return !m_scheduled; });
+}
+
+void Strand::post(WorkStealingExecutor::Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_closed) return;
+        m_queue.push_back(std::move(task));
+        if (m_scheduled) return;
+        m_scheduled = true;
+    }
+    m_executor.post([this]() { runBatch(); });
+}
+
+size_t Strand::pending() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size();
+}
+
+void Strand::runBatch()
+{
+    for (int i = 0; i < kStrandBatch; i++) {
+        WorkStealingExecutor::Task task;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_queue.empty()) break;
+            task = m_queue.take_front();
+        }
+        task();
+    }
+
+    // Still busy: requeue behind whatever else is waiting. The strand stays
+    // scheduled throughout, so no other worker can run it meanwhile.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_queue.empty() && !m_closed) {
+        lock.unlock();
+        m_executor.post([this]() { runBatch(); });
+        return;
+    }
+    m_scheduled = false;
+    m_idle.notify_all();
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// FIFO of tasks that can also be taken from the back. Unlike std::deque,
+// which frees and reallocates a block every few pushes even at a constant
+// depth, the ring only allocates when it grows past its deepest point so far,
+// so posting per frame stays allocation-free once the pipeline is warm.
+// Not thread-safe; owners lock around it.
+template <typename T>
+class TaskRing
+{
+public:
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+
+    void push_back(T item)
+    {
+        if (m_size == m_slots.size()) grow();
+        m_slots[(m_head + m_size) % m_slots.size()] = std::move(item);
+        m_size++;
+    }
+
+    T take_front()
+    {
+        T item = std::move(m_slots[m_head]);
+        m_slots[m_head] = nullptr;
+        m_head = (m_head + 1) % m_slots.size();
+        m_size--;
+        return item;
+    }
+
+    T take_back()
+    {
+        T& slot = m_slots[(m_head + m_size - 1) % m_slots.size()];
+        T item = std::move(slot);
+        slot = nullptr;
+        m_size--;
+        return item;
+    }
+
+    void clear()
+    {
+        while (m_size > 0) take_front();
+    }
+
+private:
+    void grow()
+    {
+        std::vector<T> slots(m_slots.empty() ? 16 : m_slots.size() * 2);
+        for (size_t i = 0; i < m_size; i++) {
+            slots[i] = std::move(m_slots[(m_head + i) % m_slots.size()]);
+        }
+        m_slots.swap(slots);
+        m_head = 0;
+    }
+
+    std::vector<T> m_slots;
+    size_t m_head = 0;
+    size_t m_size = 0;
+};
+
+// Thread pool for per-frame pipeline work (convert, scale, analyse, record).
+// Every worker has its own deque, run oldest-first: tasks posted from a
+// worker go to the back of its own deque, tasks posted from other threads
+// are spread round-robin. An idle worker steals from the back of another
+// worker's deque, so a burst on one stream spreads across all cores instead
+// of queueing behind one thread.
+class WorkStealingExecutor
+{
+public:
+    typedef std::function<void()> Task;
+
+    struct WorkerStats
+    {
+        uint64_t tasks;
+        uint64_t steals;        // tasks this worker took from another one
+        double utilisation;     // busy fraction since the executor started
+    };
+
+    // threads <= 0: one per core
+    explicit WorkStealingExecutor(int threads = 0);
+    // Runs what is still queued, then joins the workers
+    ~WorkStealingExecutor();
+
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+    // Any thread
+    void post(Task task);
+
+    int workerCount() const { return int(m_workers.size()); }
+    std::vector<WorkerStats> stats() const;
+    // Logs tasks, steals and utilisation per worker since the last report
+    void report() const;
+
+private:
+    struct Worker
+    {
+        std::mutex mutex;
+        TaskRing<Task> tasks;
+        std::thread thread;
+        std::atomic<uint64_t> tasksRun{0};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<int64_t> busyNs{0};
+    };
+
+    void run(int index);
+    bool popLocal(Worker& worker, Task& task);
+    bool steal(int thief, Task& task);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<unsigned> m_nextWorker;
+    std::atomic<int64_t> m_queued;  // tasks in all deques
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    bool m_stopping;  // guarded by m_sleepMutex
+    int64_t m_startNs;
+
+    // Previous report(), for per-interval figures
+    mutable std::mutex m_reportMutex;
+    mutable int64_t m_lastReportNs;
+    mutable std::vector<WorkerStats> m_lastReport;
+    mutable std::vector<int64_t> m_lastBusyNs;
+};
+
+// Runs tasks one at a time in the order they were posted, on whichever
+// executor worker is free. Different strands run in parallel. A strand gives
+// its worker back after a few tasks so one busy stream cannot starve the
+// others sharing that worker.
+class Strand
+{
+public:
+    explicit Strand(WorkStealingExecutor& executor);
+    // close()s the strand
+    ~Strand();
+
+    Strand(const Strand&) = delete;
+    Strand& operator=(const Strand&) = delete;
+
+    // Drops queued tasks, waits for a running one and ignores later posts;
+    // must not be called from a task of this strand
+    void close();
+
+    // Any thread
+    void post(WorkStealingExecutor::Task task);
+    size_t pending() const;
+
+private:
+    void runBatch();
+
+    WorkStealingExecutor& m_executor;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_idle;
+    TaskRing<WorkStealingExecutor::Task> m_queue;
+    bool m_scheduled;  // a runBatch() is queued or running
+    bool m_closed;
+};
@@ -0,0 +1,404 @@
+#include "Y4MRecorder.h"
+#include "AllocationTracker.h"
+#include "Logger.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+
+namespace {
+
+// Writes go out in chunks of this size at chunk-aligned file offsets
+const size_t kChunkBytes = size_t(4) * 1024 * 1024;
+const size_t kPageBytes = 4096;
+const int64_t kReportIntervalNs = int64_t(10) * 1000000000;
+// Nominal rate for the Y4M header; real capture times are in the index
+const int kNominalFps = 30;
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+size_t i420Bytes(int width, int height)
+{
+    return size_t(width) * height + 2 * size_t((width + 1) / 2) * ((height + 1) / 2);
+}
+
+void copyPlane(uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, int width, int height)
+{
+    for (int row = 0; row < height; row++) {
+        memcpy(dst + int64_t(row) * dstStride, src + int64_t(row) * srcStride, width);
+    }
+}
+
+std::string fileSafe(const std::string& name)
+{
+    std::string out;
+    for (char c : name) {
+        bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '.';
+        out += safe ? c : '_';
+    }
+    return out;
+}
+
+} // namespace
+
+Y4MRecorder::Y4MRecorder(const std::string& streamName, const Config& config)
+    : m_streamName(streamName)
+    , m_config(config)
+    , m_budgetAccount(streamName + " recorder")
+    , m_stopping(false)
+    , m_maxQueueDepth(0)
+    , m_fd(-1)
+    , m_index(nullptr)
+    , m_segmentWidth(0)
+    , m_segmentHeight(0)
+    , m_segmentStartNs(0)
+    , m_segmentSequence(0)
+    , m_fileBytes(0)
+    , m_chunkOffset(0)
+    , m_staging(nullptr)
+    , m_stagingUsed(0)
+    , m_lastReportNs(0)
+    , m_reportBytes(0)
+    , m_frames(0)
+    , m_framesWritten(0)
+    , m_drops(0)
+    , m_bytesWritten(0)
+    , m_segments(0)
+    , m_maxWriteNs(0)
+{
+    if (m_config.maxQueued < 1) m_config.maxQueued = 1;
+}
+
+Y4MRecorder::~Y4MRecorder()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+
+    for (const std::unique_ptr<PooledFrame>& frame : m_pool) {
+        m_budgetAccount.release(frame->data.size());
+    }
+    if (m_staging) {
+        m_budgetAccount.release(kChunkBytes);
+        free(m_staging);
+    }
+    Stats s = stats();
+    LOG_INFO("Y4MRecorder %s: %llu of %llu frames written in %llu segments (%.1f MB), %llu drops",
+             m_streamName.c_str(), (unsigned long long)s.framesWritten, (unsigned long long)s.frames,
+             (unsigned long long)s.segments, s.bytesWritten / 1e6, (unsigned long long)s.drops);
+}
+
+bool Y4MRecorder::start()
+{
+    if (mkdir(m_config.directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        LOG_ERROR("Y4MRecorder %s: cannot create %s: %s", m_streamName.c_str(), m_config.directory.c_str(),
+                  strerror(errno));
+        return false;
+    }
+    void* staging = nullptr;
+    if (!m_budgetAccount.tryCharge(kChunkBytes)) {
+        LOG_WARN("Y4MRecorder %s: memory budget refused the write buffer, not recording", m_streamName.c_str());
+        return false;
+    }
+    if (posix_memalign(&staging, kPageBytes, kChunkBytes) != 0) {
+        m_budgetAccount.release(kChunkBytes);
+        return false;
+    }
+    m_staging = static_cast<uint8_t*>(staging);
+    m_lastReportNs = monotonicNs();
+    m_thread = std::thread(&Y4MRecorder::run, this);
+    LOG_INFO("Y4MRecorder %s: recording to %s", m_streamName.c_str(), m_config.directory.c_str());
+    return true;
+}
+
+Y4MRecorder::PooledFrame* Y4MRecorder::acquire(int width, int height)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopping) return nullptr;
+
+    PooledFrame* frame = nullptr;
+    for (const std::unique_ptr<PooledFrame>& candidate : m_pool) {
+        if (!candidate->inUse) {
+            frame = candidate.get();
+            break;
+        }
+    }
+    if (!frame) {
+        if (m_pool.size() >= m_config.maxQueued) return nullptr;
+        m_pool.push_back(std::unique_ptr<PooledFrame>(new PooledFrame));
+        frame = m_pool.back().get();
+    }
+
+    size_t bytes = i420Bytes(width, height);
+    if (frame->data.size() != bytes) {
+        m_budgetAccount.release(frame->data.size());
+        if (!m_budgetAccount.tryCharge(bytes)) {
+            std::vector<uint8_t>().swap(frame->data);
+            return nullptr;
+        }
+        frame->data.resize(bytes);
+    }
+    frame->width = width;
+    frame->height = height;
+    frame->inUse = true;
+    return frame;
+}
+
+void Y4MRecorder::release(PooledFrame* frame)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    frame->inUse = false;
+}
+
+void Y4MRecorder::onHubFrame(const HubFrame& hubFrame)
+{
+    AllocStageScope stage(ALLOC_STAGE_VIDEO_RECEIVE);
+    const I420Frame& frame = *hubFrame.source;
+    // Numbered before any drop, so gaps in the index show what was lost
+    uint64_t frameNumber = m_frames.fetch_add(1, std::memory_order_relaxed);
+
+    PooledFrame* pooled = acquire(frame.width, frame.height);
+    if (!pooled) {
+        m_drops.fetch_add(1, std::memory_order_relaxed);
+        LOG_RATE_LIMITED(LOG_LEVEL_WARN, 1000, "Y4MRecorder %s: disk behind, dropping %dx%d frame",
+                         m_streamName.c_str(), frame.width, frame.height);
+        return;
+    }
+
+    int chromaWidth = (frame.width + 1) / 2;
+    int chromaHeight = (frame.height + 1) / 2;
+    uint8_t* y = pooled->data.data();
+    uint8_t* u = y + size_t(frame.width) * frame.height;
+    uint8_t* v = u + size_t(chromaWidth) * chromaHeight;
+    copyPlane(y, frame.width, frame.y, frame.yStride, frame.width, frame.height);
+    copyPlane(u, chromaWidth, frame.u, frame.uStride, chromaWidth, chromaHeight);
+    copyPlane(v, chromaWidth, frame.v, frame.vStride, chromaWidth, chromaHeight);
+    pooled->frameNumber = frameNumber;
+    pooled->timestampNs = monotonicNs();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(pooled);
+        m_maxQueueDepth = std::max(m_maxQueueDepth, m_queue.size());
+    }
+    m_wake.notify_one();
+}
+
+void Y4MRecorder::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        if (m_queue.empty()) {
+            if (m_stopping) break;
+            m_wake.wait_for(lock, std::chrono::seconds(1));
+        }
+        if (!m_queue.empty()) {
+            PooledFrame* frame = m_queue.front();
+            m_queue.pop_front();
+            lock.unlock();
+            writeFrame(*frame);
+            release(frame);
+            lock.lock();
+        }
+
+        int64_t now = monotonicNs();
+        if (now - m_lastReportNs >= kReportIntervalNs) {
+            lock.unlock();
+            report();
+            lock.lock();
+        }
+    }
+    lock.unlock();
+    closeSegment();
+}
+
+void Y4MRecorder::writeFrame(const PooledFrame& frame)
+{
+    static const char kFrameLine[] = "FRAME\n";
+    uint64_t frameBytes = sizeof(kFrameLine) - 1 + frame.data.size();
+
+    if (m_fd >= 0) {
+        bool resized = frame.width != m_segmentWidth || frame.height != m_segmentHeight;
+        bool tooOld = frame.timestampNs - m_segmentStartNs >= int64_t(m_config.segmentSeconds) * 1000000000;
+        bool tooBig = m_fileBytes + frameBytes > m_config.segmentBytes;
+        if (resized || tooOld || tooBig) closeSegment();
+    }
+    if (m_fd < 0 && !openSegment(frame)) {
+        m_drops.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Y4MIndexRecord record;
+    record.frameNumber = frame.frameNumber;
+    record.offset = m_fileBytes;
+    record.timestampNs = frame.timestampNs;
+
+    if (!append(reinterpret_cast<const uint8_t*>(kFrameLine), sizeof(kFrameLine) - 1)
+        || !append(frame.data.data(), frame.data.size())) {
+        m_drops.fetch_add(1, std::memory_order_relaxed);
+        closeSegment();
+        return;
+    }
+    if (m_index) fwrite(&record, sizeof(record), 1, m_index);
+    m_framesWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool Y4MRecorder::openSegment(const PooledFrame& first)
+{
+    time_t now = time(nullptr);
+    struct tm local;
+    localtime_r(&now, &local);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local);
+
+    char suffix[64];
+    snprintf(suffix, sizeof(suffix), "-%s-%03llu", stamp, (unsigned long long)m_segmentSequence++);
+    std::string base = m_config.directory + "/" + fileSafe(m_streamName) + suffix;
+    std::string videoPath = base + ".y4m";
+
+    m_fd = open(videoPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        LOG_RATE_LIMITED(LOG_LEVEL_ERROR, 5000, "Y4MRecorder %s: cannot create %s: %s", m_streamName.c_str(),
+                         videoPath.c_str(), strerror(errno));
+        return false;
+    }
+
+    // Reserve the expected segment up front so the file system can lay it
+    // out contiguously; KEEP_SIZE leaves the visible size at what was written
+    uint64_t frameBytes = 6 + first.data.size();
+    uint64_t expected = std::min<uint64_t>(m_config.segmentBytes,
+                                           frameBytes * kNominalFps * uint64_t(m_config.segmentSeconds));
+    expected = (expected + kChunkBytes - 1) / kChunkBytes * kChunkBytes;
+    if (fallocate(m_fd, FALLOC_FL_KEEP_SIZE, 0, off_t(expected)) != 0) {
+        LOG_RATE_LIMITED(LOG_LEVEL_WARN, 60000, "Y4MRecorder %s: fallocate failed (%s), writing without preallocation",
+                         m_streamName.c_str(), strerror(errno));
+    }
+
+    m_index = fopen((base + ".idx").c_str(), "wb");
+    if (m_index) {
+        Y4MIndexHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "Y4MIDX1", 8);
+        header.width = uint32_t(first.width);
+        header.height = uint32_t(first.height);
+        header.recordBytes = sizeof(Y4MIndexRecord);
+        fwrite(&header, sizeof(header), 1, m_index);
+    } else {
+        LOG_WARN("Y4MRecorder %s: cannot create index for %s", m_streamName.c_str(), videoPath.c_str());
+    }
+
+    m_segmentWidth = first.width;
+    m_segmentHeight = first.height;
+    m_segmentStartNs = first.timestampNs;
+    m_fileBytes = 0;
+    m_chunkOffset = 0;
+    m_stagingUsed = 0;
+    m_segments.fetch_add(1, std::memory_order_relaxed);
+
+    char header[128];
+    int length = snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", first.width,
+                          first.height, kNominalFps);
+    LOG_INFO("Y4MRecorder %s: segment %s (%dx%d)", m_streamName.c_str(), videoPath.c_str(), first.width, first.height);
+    return append(reinterpret_cast<const uint8_t*>(header), size_t(length));
+}
+
+void Y4MRecorder::closeSegment()
+{
+    if (m_fd < 0) return;
+    if (m_stagingUsed > 0) writeChunk(m_stagingUsed);
+    // Gives back the preallocated blocks that were not used
+    if (ftruncate(m_fd, off_t(m_fileBytes)) != 0) {
+        LOG_WARN("Y4MRecorder %s: ftruncate failed: %s", m_streamName.c_str(), strerror(errno));
+    }
+    ::close(m_fd);
+    m_fd = -1;
+    if (m_index) {
+        fclose(m_index);
+        m_index = nullptr;
+    }
+}
+
+bool Y4MRecorder::append(const uint8_t* data, size_t bytes)
+{
+    while (bytes > 0) {
+        size_t n = std::min(bytes, kChunkBytes - m_stagingUsed);
+        memcpy(m_staging + m_stagingUsed, data, n);
+        m_stagingUsed += n;
+        m_fileBytes += n;
+        data += n;
+        bytes -= n;
+        if (m_stagingUsed == kChunkBytes && !writeChunk(kChunkBytes)) return false;
+    }
+    return true;
+}
+
+bool Y4MRecorder::writeChunk(size_t bytes)
+{
+    int64_t startNs = monotonicNs();
+    size_t done = 0;
+    while (done < bytes) {
+        ssize_t n = pwrite(m_fd, m_staging + done, bytes - done, off_t(m_chunkOffset + done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            LOG_RATE_LIMITED(LOG_LEVEL_ERROR, 5000, "Y4MRecorder %s: write failed: %s", m_streamName.c_str(),
+                             strerror(errno));
+            m_stagingUsed = 0;
+            return false;
+        }
+        done += size_t(n);
+    }
+    int64_t elapsed = monotonicNs() - startNs;
+    if (elapsed > m_maxWriteNs.load(std::memory_order_relaxed)) {
+        m_maxWriteNs.store(elapsed, std::memory_order_relaxed);
+    }
+    m_bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+    // Only full chunks advance; a partial tail is rewritten from the start
+    if (bytes == kChunkBytes) {
+        m_chunkOffset += kChunkBytes;
+        m_stagingUsed = 0;
+    }
+    return true;
+}
+
+void Y4MRecorder::report()
+{
+    int64_t now = monotonicNs();
+    uint64_t bytes = m_bytesWritten.load(std::memory_order_relaxed);
+    double seconds = (now - m_lastReportNs) / 1e9;
+    Stats s = stats();
+    LOG_INFO("Y4MRecorder %s: %.1f MB/s, %llu frames written, queue %zu/%zu (max %zu), %llu drops, max write %.1f ms",
+             m_streamName.c_str(), seconds > 0 ? (bytes - m_reportBytes) / seconds / 1e6 : 0.0,
+             (unsigned long long)s.framesWritten, s.queueDepth, m_config.maxQueued, s.maxQueueDepth,
+             (unsigned long long)s.drops, s.maxWriteMs);
+    m_lastReportNs = now;
+    m_reportBytes = bytes;
+    if (m_index) fflush(m_index);
+}
+
+Y4MRecorder::Stats Y4MRecorder::stats() const
+{
+    Stats s;
+    s.frames = m_frames.load(std::memory_order_relaxed);
+    s.framesWritten = m_framesWritten.load(std::memory_order_relaxed);
+    s.drops = m_drops.load(std::memory_order_relaxed);
+    s.bytesWritten = m_bytesWritten.load(std::memory_order_relaxed);
+    s.segments = m_segments.load(std::memory_order_relaxed);
+    s.maxWriteMs = m_maxWriteNs.load(std::memory_order_relaxed) / 1e6;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    s.queueDepth = m_queue.size();
+    s.maxQueueDepth = m_maxQueueDepth;
+    return s;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FrameHub.h"
+#include "MemoryBudget.h"
+
+// Sidecar index (<segment>.idx) written next to every .y4m segment: this
+// header, then one record per frame in file order, so frame n of a segment
+// is record n and a reader can seek by frame number or timestamp without
+// parsing the Y4M stream.
+struct Y4MIndexHeader
+{
+    char magic[8];        // "Y4MIDX1\0"
+    uint32_t width;
+    uint32_t height;
+    uint32_t recordBytes;  // sizeof(Y4MIndexRecord)
+    uint32_t reserved;
+};
+
+struct Y4MIndexRecord
+{
+    uint64_t frameNumber;  // per recorder, across segments; gaps are drops
+    uint64_t offset;       // of the frame's "FRAME" line in the .y4m
+    int64_t timestampNs;   // CLOCK_MONOTONIC at capture
+};
+
+// Records one stream's I420 frames as Y4M segments. Subscribed to the
+// stream's hub at the native variant. The frame callback only copies into a
+// pooled, budget-charged buffer and queues it; a dedicated I/O thread packs
+// frames into large page-aligned chunks, writes them to a segment that was
+// preallocated with fallocate, and appends the sidecar index. Segments
+// rotate by age, size or a resolution change. When the queue is full the
+// disk is behind and frames are dropped, never waited for.
+class Y4MRecorder : public IFrameHubSink
+{
+public:
+    struct Config
+    {
+        std::string directory;
+        int segmentSeconds = 300;
+        size_t segmentBytes = size_t(1024) * 1024 * 1024;
+        size_t maxQueued = 8;  // frames waiting for the disk
+    };
+
+    struct Stats
+    {
+        uint64_t frames;         // offered by the hub
+        uint64_t framesWritten;
+        uint64_t drops;          // queue full, budget exhausted or write failed
+        uint64_t bytesWritten;
+        uint64_t segments;
+        size_t queueDepth;
+        size_t maxQueueDepth;
+        double maxWriteMs;       // slowest single write() call
+    };
+
+    Y4MRecorder(const std::string& streamName, const Config& config);
+    // Writes what is queued, closes the segment and joins the I/O thread
+    ~Y4MRecorder();
+
+    Y4MRecorder(const Y4MRecorder&) = delete;
+    Y4MRecorder& operator=(const Y4MRecorder&) = delete;
+
+    static FrameVariant variant()
+    {
+        FrameVariant v;
+        v.format = FRAME_FORMAT_I420;
+        return v;
+    }
+
+    // Creates the directory and starts the I/O thread
+    bool start();
+
+    // IFrameHubSink: copies and returns
+    void onHubFrame(const HubFrame& frame) override;
+
+    Stats stats() const;
+
+private:
+    struct PooledFrame
+    {
+        std::vector<uint8_t> data;  // packed Y, U, V
+        int width = 0;
+        int height = 0;
+        uint64_t frameNumber = 0;
+        int64_t timestampNs = 0;
+        bool inUse = false;
+    };
+
+    PooledFrame* acquire(int width, int height);
+    void release(PooledFrame* frame);
+
+    // I/O thread
+    void run();
+    void writeFrame(const PooledFrame& frame);
+    bool openSegment(const PooledFrame& first);
+    void closeSegment();
+    bool append(const uint8_t* data, size_t bytes);
+    bool writeChunk(size_t bytes);
+    void report();
+
+    std::string m_streamName;
+    Config m_config;
+    MemoryBudget::Account m_budgetAccount;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::vector<std::unique_ptr<PooledFrame>> m_pool;
+    std::deque<PooledFrame*> m_queue;
+    bool m_stopping;
+    size_t m_maxQueueDepth;
+    std::thread m_thread;
+
+    // Owned by the I/O thread
+    int m_fd;
+    FILE* m_index;
+    int m_segmentWidth;
+    int m_segmentHeight;
+    int64_t m_segmentStartNs;
+    uint64_t m_segmentSequence;
+    uint64_t m_fileBytes;     // logical size of the open segment
+    uint64_t m_chunkOffset;   // file offset of the staging chunk
+    uint8_t* m_staging;       // page-aligned chunk being filled
+    size_t m_stagingUsed;
+    int64_t m_lastReportNs;
+    uint64_t m_reportBytes;
+
+    std::atomic<uint64_t> m_frames;
+    std::atomic<uint64_t> m_framesWritten;
+    std::atomic<uint64_t> m_drops;
+    std::atomic<uint64_t> m_bytesWritten;
+    std::atomic<uint64_t> m_segments;
+    std::atomic<int64_t> m_maxWriteNs;
+};
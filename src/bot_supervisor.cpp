@@ -0,0 +1,700 @@
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "json.hpp"
+
+using Json = nlohmann::json;
+
+// Runs many bot processes on one host. The SDK is one session per process,
+// so density comes from processes: each instance gets its own config, a CPU
+// set and the NUMA node those CPUs belong to (memory bound there with
+// set_mempolicy), and is restarted with exponential backoff if it crashes.
+// Every --metrics-sec the supervisor reads each child's CPU time and RSS from
+// /proc and its control socket "stats", prints a line per instance, and on
+// exit prints a JSON summary. --fake runs simple_join --synthetic children
+// instead, so placement and density can be measured without a Zoom session.
+
+// From <linux/mempolicy.h>; set_mempolicy is called directly so the
+// supervisor does not need libnuma
+static const int kMpolBind = 2;
+
+struct Options
+{
+    int count = 1;
+    std::string botPath;        // default: headless_bot (or simple_join with --fake) next to this binary
+    std::string configPattern;  // "{n}" becomes the instance number; empty = the bot's default config
+    std::vector<std::string> botArgs;
+    int cpusPerInstance = 0;    // 0 = share the node's CPUs evenly
+    bool bindMemory = true;
+    std::string runDir = "/tmp/bot_supervisor";
+    int metricsSec = 10;
+    int durationSec = 0;        // 0 = until SIGINT/SIGTERM
+    int backoffMinMs = 1000;
+    int backoffMaxMs = 60000;
+    bool fake = false;
+    int fakeStreams = 4;
+    int fakeResolution = 360;
+    int fakeFps = 30;
+    std::string outputPath;
+};
+
+struct NumaNode
+{
+    int id;                 // -1 when the host exposes no NUMA topology
+    std::vector<int> cpus;  // allowed CPUs on this node
+};
+
+struct Instance
+{
+    int index = 0;
+    std::string name;
+    std::string configPath;
+    std::string socketPath;
+    std::string logPath;
+    std::string resultPath;  // --fake: simple_join's JSON summary
+    std::vector<int> cpus;
+    int node = -1;
+
+    pid_t pid = -1;
+    bool finished = false;   // exited with status 0; not restarted
+    int64_t startedNs = 0;
+    int64_t restartAtNs = 0; // 0 = no restart pending
+    int backoffMs = 0;
+    int restarts = 0;
+    std::string lastExit;
+
+    // Metrics
+    int64_t lastCpuTicks = -1;
+    int64_t lastSampleNs = 0;
+    double cpuPercent = 0.0;
+    double cpuPercentSum = 0.0;
+    int cpuSamples = 0;
+    size_t rssBytes = 0;
+    size_t peakRssBytes = 0;
+    Json stats;              // last control socket reply
+};
+
+static volatile sig_atomic_t g_stopRequested = 0;
+
+static void handleStopSignal(int)
+{
+    g_stopRequested = 1;
+}
+
+static int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static void printUsage(const char* argv0)
+{
+    std::cerr << "Usage: " << argv0 << " [options] [-- bot arguments]\n"
+              << "  --count N             instances to run (default 1)\n"
+              << "  --bot PATH            bot executable (default headless_bot next to this one)\n"
+              << "  --config PATTERN      per-instance config, {n} = instance number (e.g. bots/bot{n}.json)\n"
+              << "  --cpus-per-instance N CPUs pinned per instance (default: node CPUs / instances on it)\n"
+              << "  --no-mem-bind         do not bind instance memory to its NUMA node\n"
+              << "  --run-dir DIR         control sockets, logs and results (default /tmp/bot_supervisor)\n"
+              << "  --metrics-sec N       metrics interval (default 10)\n"
+              << "  --duration SEC        stop everything after this long (default: until a signal)\n"
+              << "  --backoff MIN,MAX     restart backoff in ms (default 1000,60000)\n"
+              << "  --fake                run simple_join --synthetic children, no Zoom session\n"
+              << "  --fake-streams N      synthetic streams per instance (default 4)\n"
+              << "  --resolution LINES    synthetic stream height (default 360)\n"
+              << "  --fps N               synthetic frame rate (default 30)\n"
+              << "  --output PATH         also write the JSON summary to a file\n";
+}
+
+static bool parseOptions(int argc, char* argv[], Options& opts)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (arg == "--") {
+            opts.botArgs.assign(argv + i + 1, argv + argc);
+            break;
+        } else if (arg == "--no-mem-bind") {
+            opts.bindMemory = false;
+        } else if (arg == "--fake") {
+            opts.fake = true;
+        } else if (!hasValue) {
+            std::cerr << "ERROR: missing value for " << arg << std::endl;
+            return false;
+        } else if (arg == "--count") {
+            opts.count = atoi(argv[++i]);
+        } else if (arg == "--bot") {
+            opts.botPath = argv[++i];
+        } else if (arg == "--config") {
+            opts.configPattern = argv[++i];
+        } else if (arg == "--cpus-per-instance") {
+            opts.cpusPerInstance = atoi(argv[++i]);
+        } else if (arg == "--run-dir") {
+            opts.runDir = argv[++i];
+        } else if (arg == "--metrics-sec") {
+            opts.metricsSec = atoi(argv[++i]);
+        } else if (arg == "--duration") {
+            opts.durationSec = atoi(argv[++i]);
+        } else if (arg == "--backoff") {
+            if (sscanf(argv[++i], "%d,%d", &opts.backoffMinMs, &opts.backoffMaxMs) != 2) {
+                std::cerr << "ERROR: --backoff wants MIN,MAX" << std::endl;
+                return false;
+            }
+        } else if (arg == "--fake-streams") {
+            opts.fakeStreams = atoi(argv[++i]);
+        } else if (arg == "--resolution") {
+            opts.fakeResolution = atoi(argv[++i]);
+        } else if (arg == "--fps") {
+            opts.fakeFps = atoi(argv[++i]);
+        } else if (arg == "--output") {
+            opts.outputPath = argv[++i];
+        } else {
+            std::cerr << "ERROR: unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (opts.count < 1 || opts.metricsSec < 1 || opts.backoffMinMs < 1 || opts.backoffMaxMs < opts.backoffMinMs) {
+        std::cerr << "ERROR: bad --count, --metrics-sec or --backoff" << std::endl;
+        return false;
+    }
+    // Synthetic children need to know when to stop and write their summary
+    if (opts.fake && opts.durationSec <= 0) opts.durationSec = 60;
+    return true;
+}
+
+static std::string selfDir()
+{
+    char path[PATH_MAX];
+    ssize_t n = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (n <= 0) return ".";
+    path[n] = '\0';
+    std::string dir(path);
+    size_t slash = dir.rfind('/');
+    return slash == std::string::npos ? "." : dir.substr(0, slash);
+}
+
+// "0-3,8-11" -> {0,1,2,3,8,9,10,11}
+static std::vector<int> parseCpuList(const std::string& text)
+{
+    std::vector<int> cpus;
+    std::stringstream list(text);
+    std::string range;
+    while (std::getline(list, range, ',')) {
+        int first, last;
+        int matched = sscanf(range.c_str(), "%d-%d", &first, &last);
+        if (matched == 1) last = first;
+        if (matched < 1) continue;
+        for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+// CPUs this process may use, grouped by NUMA node
+static std::vector<NumaNode> readTopology()
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+
+    std::vector<NumaNode> nodes;
+    DIR* dir = opendir("/sys/devices/system/node");
+    if (dir) {
+        while (dirent* entry = readdir(dir)) {
+            int id;
+            if (sscanf(entry->d_name, "node%d", &id) != 1) continue;
+            std::ifstream cpulist(std::string("/sys/devices/system/node/") + entry->d_name + "/cpulist");
+            std::string text;
+            std::getline(cpulist, text);
+            NumaNode node;
+            node.id = id;
+            for (int cpu : parseCpuList(text)) {
+                if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) node.cpus.push_back(cpu);
+            }
+            if (!node.cpus.empty()) nodes.push_back(node);
+        }
+        closedir(dir);
+    }
+    if (nodes.empty()) {
+        NumaNode node;
+        node.id = -1;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed)) node.cpus.push_back(cpu);
+        }
+        nodes.push_back(node);
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+    return nodes;
+}
+
+// Instances go round-robin over nodes so each node carries an equal share;
+// within a node each takes the next CPUs in order, wrapping when oversubscribed
+static void placeInstances(std::vector<Instance>& instances, const std::vector<NumaNode>& nodes, int cpusPerInstance)
+{
+    std::vector<int> perNode(nodes.size(), 0);
+    for (size_t i = 0; i < instances.size(); i++) perNode[i % nodes.size()]++;
+
+    std::vector<size_t> cursor(nodes.size(), 0);
+    for (size_t i = 0; i < instances.size(); i++) {
+        size_t n = i % nodes.size();
+        const NumaNode& node = nodes[n];
+        int want = cpusPerInstance > 0 ? cpusPerInstance : std::max<int>(1, int(node.cpus.size()) / perNode[n]);
+        want = std::min<int>(want, int(node.cpus.size()));
+        instances[i].node = node.id;
+        for (int k = 0; k < want; k++) {
+            instances[i].cpus.push_back(node.cpus[cursor[n] % node.cpus.size()]);
+            cursor[n]++;
+        }
+    }
+}
+
+static std::string cpuListText(const std::vector<int>& cpus)
+{
+    std::string text;
+    for (int cpu : cpus) text += (text.empty() ? "" : ",") + std::to_string(cpu);
+    return text;
+}
+
+static std::string replaceAll(std::string text, const std::string& from, const std::string& to)
+{
+    for (size_t pos = text.find(from); pos != std::string::npos; pos = text.find(from, pos + to.size())) {
+        text.replace(pos, from.size(), to);
+    }
+    return text;
+}
+
+static std::vector<std::string> childArguments(const Options& opts, const Instance& instance)
+{
+    std::vector<std::string> args = { opts.botPath };
+    if (opts.fake) {
+        args.insert(args.end(), { "--synthetic", std::to_string(opts.fakeStreams),
+                                  "--resolution", std::to_string(opts.fakeResolution),
+                                  "--fps", std::to_string(opts.fakeFps),
+                                  "--duration", std::to_string(opts.durationSec),
+                                  "--output", instance.resultPath });
+    } else {
+        args.insert(args.end(), { "--control-socket", instance.socketPath });
+        if (!instance.configPath.empty()) args.insert(args.end(), { "--config", instance.configPath });
+    }
+    args.insert(args.end(), opts.botArgs.begin(), opts.botArgs.end());
+    return args;
+}
+
+static bool startInstance(const Options& opts, Instance& instance)
+{
+    std::vector<std::string> args = childArguments(opts, instance);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "ERROR: fork failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (pid == 0) {
+        // Child: placement is set before exec so every SDK thread inherits it
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : instance.cpus) CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            fprintf(stderr, "%s: sched_setaffinity failed: %s\n", instance.name.c_str(), strerror(errno));
+        }
+        if (opts.bindMemory && instance.node >= 0) {
+            unsigned long mask[16] = {};
+            mask[instance.node / (8 * sizeof(unsigned long))] |= 1UL << (instance.node % (8 * sizeof(unsigned long)));
+            if (syscall(SYS_set_mempolicy, kMpolBind, mask, sizeof(mask) * 8) != 0) {
+                fprintf(stderr, "%s: set_mempolicy failed: %s\n", instance.name.c_str(), strerror(errno));
+            }
+        }
+
+        int log = open(instance.logPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (log >= 0) {
+            dup2(log, STDOUT_FILENO);
+            dup2(log, STDERR_FILENO);
+        }
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        setenv("BOT_INSTANCE", std::to_string(instance.index).c_str(), 1);
+
+        std::vector<char*> argv;
+        for (std::string& arg : args) argv.push_back(&arg[0]);
+        argv.push_back(nullptr);
+        execv(argv[0], argv.data());
+        fprintf(stderr, "%s: exec %s failed: %s\n", instance.name.c_str(), argv[0], strerror(errno));
+        _exit(127);
+    }
+
+    instance.pid = pid;
+    instance.startedNs = monotonicNs();
+    instance.restartAtNs = 0;
+    instance.lastCpuTicks = -1;
+    std::cerr << instance.name << ": started pid " << pid << " on CPUs " << cpuListText(instance.cpus)
+              << (instance.node >= 0 ? " node " + std::to_string(instance.node) : std::string()) << std::endl;
+    return true;
+}
+
+static std::string describeExit(int status)
+{
+    if (WIFEXITED(status)) return "exit " + std::to_string(WEXITSTATUS(status));
+    if (WIFSIGNALED(status)) return std::string("signal ") + strsignal(WTERMSIG(status));
+    return "status " + std::to_string(status);
+}
+
+// Reaps exited children; crashes are scheduled for restart with backoff
+static void reapChildren(const Options& opts, std::vector<Instance>& instances, bool stopping)
+{
+    int status;
+    pid_t pid;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        for (Instance& instance : instances) {
+            if (instance.pid != pid) continue;
+            int64_t now = monotonicNs();
+            double ranSec = (now - instance.startedNs) / 1e9;
+            instance.pid = -1;
+            instance.lastExit = describeExit(status);
+            if (stopping) break;
+            if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+                instance.finished = true;
+                std::cerr << instance.name << ": finished after " << ranSec << " s" << std::endl;
+                break;
+            }
+            // A run that outlasted the longest backoff counts as healthy again
+            if (instance.backoffMs == 0 || ranSec * 1000 > opts.backoffMaxMs) {
+                instance.backoffMs = opts.backoffMinMs;
+            } else {
+                instance.backoffMs = std::min(instance.backoffMs * 2, opts.backoffMaxMs);
+            }
+            instance.restartAtNs = now + int64_t(instance.backoffMs) * 1000000;
+            std::cerr << instance.name << ": " << instance.lastExit << " after " << ranSec << " s, restarting in "
+                      << instance.backoffMs << " ms" << std::endl;
+            break;
+        }
+    }
+}
+
+// One {"cmd":"stats"} round trip on every running instance's control socket,
+// all in flight at once over non-blocking sockets, so a wedged bot costs the
+// reap loop 500 ms per sample rather than 500 ms per instance. Instances that
+// did not answer in time get a null reply.
+static std::vector<Json> queryStats(const std::vector<Instance>& instances)
+{
+    struct Query
+    {
+        int fd = -1;
+        size_t sent = 0;
+        std::string line;
+    };
+    const char request[] = "{\"cmd\":\"stats\"}\n";
+    const size_t requestBytes = sizeof(request) - 1;
+
+    std::vector<Json> replies(instances.size());
+    std::vector<Query> queries(instances.size());
+    for (size_t i = 0; i < instances.size(); i++) {
+        if (instances[i].pid < 0) continue;
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (fd < 0) continue;
+        sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", instances[i].socketPath.c_str());
+        // Unix sockets connect at once or fail (EAGAIN: backlog full)
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            close(fd);
+            continue;
+        }
+        queries[i].fd = fd;
+    }
+
+    int64_t deadlineNs = monotonicNs() + 500000000;
+    for (;;) {
+        std::vector<pollfd> pfds;
+        std::vector<size_t> owners;
+        for (size_t i = 0; i < queries.size(); i++) {
+            if (queries[i].fd < 0) continue;
+            short events = queries[i].sent < requestBytes ? POLLOUT : POLLIN;
+            pfds.push_back(pollfd{ queries[i].fd, events, 0 });
+            owners.push_back(i);
+        }
+        int remainingMs = int((deadlineNs - monotonicNs()) / 1000000);
+        if (pfds.empty() || remainingMs <= 0) break;
+        int ready = poll(pfds.data(), pfds.size(), remainingMs);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready <= 0) break;
+
+        for (size_t k = 0; k < pfds.size(); k++) {
+            if (!pfds[k].revents) continue;
+            Query& query = queries[owners[k]];
+            bool failed = false;
+            if (query.sent < requestBytes) {
+                ssize_t n = send(query.fd, request + query.sent, requestBytes - query.sent, MSG_NOSIGNAL);
+                if (n > 0) {
+                    query.sent += size_t(n);
+                } else if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                    failed = true;
+                }
+            } else {
+                char buffer[4096];
+                ssize_t n = read(query.fd, buffer, sizeof(buffer));
+                if (n > 0) {
+                    query.line.append(buffer, size_t(n));
+                } else if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    failed = true;
+                }
+            }
+            size_t newline = query.line.find('\n');
+            if (!failed && newline == std::string::npos) continue;
+            if (!failed) {
+                Json reply = Json::parse(query.line.substr(0, newline), nullptr, false);
+                if (!reply.is_discarded()) replies[owners[k]] = reply;
+            }
+            close(query.fd);
+            query.fd = -1;
+        }
+    }
+
+    for (Query& query : queries) {
+        if (query.fd >= 0) close(query.fd);
+    }
+    return replies;
+}
+
+// utime + stime of a process, in clock ticks
+static int64_t processCpuTicks(pid_t pid)
+{
+    std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+    std::string text;
+    std::getline(stat, text);
+    // The command name may contain spaces; fields resume after its ')'
+    size_t close = text.rfind(')');
+    if (close == std::string::npos) return -1;
+    std::stringstream fields(text.substr(close + 2));
+    std::string field;
+    int64_t utime = 0, stime = 0;
+    for (int i = 3; fields >> field; i++) {
+        if (i == 14) utime = atoll(field.c_str());
+        if (i == 15) {
+            stime = atoll(field.c_str());
+            return utime + stime;
+        }
+    }
+    return -1;
+}
+
+static size_t processRssBytes(pid_t pid)
+{
+    std::ifstream statm("/proc/" + std::to_string(pid) + "/statm");
+    unsigned long size = 0, resident = 0;
+    statm >> size >> resident;
+    return size_t(resident) * size_t(sysconf(_SC_PAGESIZE));
+}
+
+static void sampleMetrics(const Options& opts, std::vector<Instance>& instances)
+{
+    static const long ticksPerSec = sysconf(_SC_CLK_TCK);
+    int64_t now = monotonicNs();
+    double totalCpu = 0.0;
+    size_t totalRss = 0;
+    int running = 0, inSession = 0;
+    std::vector<Json> replies;
+    if (!opts.fake) replies = queryStats(instances);
+
+    for (Instance& instance : instances) {
+        if (instance.pid < 0) continue;
+        running++;
+        int64_t ticks = processCpuTicks(instance.pid);
+        if (ticks >= 0 && instance.lastCpuTicks >= 0 && now > instance.lastSampleNs) {
+            double cpuSec = double(ticks - instance.lastCpuTicks) / ticksPerSec;
+            instance.cpuPercent = 100.0 * cpuSec / ((now - instance.lastSampleNs) / 1e9);
+            instance.cpuPercentSum += instance.cpuPercent;
+            instance.cpuSamples++;
+        }
+        instance.lastCpuTicks = ticks;
+        instance.lastSampleNs = now;
+        instance.rssBytes = processRssBytes(instance.pid);
+        instance.peakRssBytes = std::max(instance.peakRssBytes, instance.rssBytes);
+        totalCpu += instance.cpuPercent;
+        totalRss += instance.rssBytes;
+
+        std::string detail;
+        if (!opts.fake) {
+            const Json& reply = replies[size_t(instance.index)];
+            if (!reply.is_null()) {
+                instance.stats = reply;
+                bool session = reply.value("in_session", false);
+                inSession += session;
+                detail = std::string(session ? " in session" : " idle") + ", event bus dropped "
+                         + std::to_string(reply["event_bus"].value("dropped", 0ULL));
+            } else {
+                detail = " (no control socket reply)";
+            }
+        }
+        fprintf(stderr, "%s: pid %d cpu %.1f%% rss %zu MB restarts %d%s\n", instance.name.c_str(), instance.pid,
+                instance.cpuPercent, instance.rssBytes >> 20, instance.restarts, detail.c_str());
+    }
+    fprintf(stderr, "total: %d running%s, cpu %.1f%%, rss %zu MB\n", running,
+            opts.fake ? "" : (", " + std::to_string(inSession) + " in session").c_str(), totalCpu, totalRss >> 20);
+}
+
+static void stopInstances(std::vector<Instance>& instances)
+{
+    for (Instance& instance : instances) {
+        if (instance.pid > 0) kill(instance.pid, SIGTERM);
+    }
+    // Bots leave their sessions on SIGTERM; give them time before SIGKILL
+    int64_t deadlineNs = monotonicNs() + int64_t(10) * 1000000000;
+    for (;;) {
+        reapChildren(Options(), instances, true);
+        bool anyRunning = false;
+        for (const Instance& instance : instances) anyRunning |= instance.pid > 0;
+        if (!anyRunning) return;
+        if (monotonicNs() >= deadlineNs) break;
+        usleep(100000);
+    }
+    for (Instance& instance : instances) {
+        if (instance.pid > 0) {
+            std::cerr << instance.name << ": did not stop, killing" << std::endl;
+            kill(instance.pid, SIGKILL);
+        }
+    }
+    while (waitpid(-1, nullptr, 0) > 0) {
+    }
+}
+
+static Json summaryJson(const Options& opts, const std::vector<Instance>& instances)
+{
+    Json list = Json::array();
+    double totalCpu = 0.0;
+    size_t totalPeakRss = 0;
+    uint64_t framesDelivered = 0, lateTicks = 0;
+    int saturated = 0;
+    for (const Instance& instance : instances) {
+        double avgCpu = instance.cpuSamples ? instance.cpuPercentSum / instance.cpuSamples : 0.0;
+        Json entry = { { "name", instance.name }, { "cpus", instance.cpus }, { "node", instance.node },
+                       { "restarts", instance.restarts }, { "last_exit", instance.lastExit },
+                       { "avg_cpu_percent", avgCpu }, { "peak_rss_bytes", instance.peakRssBytes } };
+        totalCpu += avgCpu;
+        totalPeakRss += instance.peakRssBytes;
+        if (opts.fake) {
+            std::ifstream result(instance.resultPath);
+            Json child = Json::parse(result, nullptr, false);
+            if (!child.is_discarded() && child.contains("synthetic")) {
+                entry["synthetic"] = child["synthetic"];
+                framesDelivered += child["synthetic"].value("frames_delivered", 0ULL);
+                uint64_t late = child["synthetic"].value("late_ticks", 0ULL);
+                lateTicks += late;
+                saturated += late > 0;
+            }
+        } else if (!instance.stats.is_null()) {
+            entry["stats"] = instance.stats;
+        }
+        list.push_back(entry);
+    }
+
+    Json summary;
+    summary["mode"] = opts.fake ? "fake" : "bots";
+    summary["instances"] = list;
+    summary["totals"] = { { "instances", instances.size() }, { "avg_cpu_percent", totalCpu },
+                          { "peak_rss_bytes", totalPeakRss } };
+    if (opts.fake) {
+        summary["totals"]["frames_delivered"] = framesDelivered;
+        summary["totals"]["late_ticks"] = lateTicks;
+        // Instances that missed frame deadlines: the host is past its density
+        summary["totals"]["saturated_instances"] = saturated;
+    }
+    return summary;
+}
+
+int main(int argc, char* argv[])
+{
+    Options opts;
+    if (!parseOptions(argc, argv, opts)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (opts.botPath.empty()) {
+        opts.botPath = selfDir() + (opts.fake ? "/simple_join" : "/headless_bot");
+    }
+    if (mkdir(opts.runDir.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "ERROR: cannot create " << opts.runDir << ": " << strerror(errno) << std::endl;
+        return 1;
+    }
+
+    signal(SIGINT, handleStopSignal);
+    signal(SIGTERM, handleStopSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::vector<Instance> instances(size_t(opts.count));
+    for (int i = 0; i < opts.count; i++) {
+        Instance& instance = instances[size_t(i)];
+        instance.index = i;
+        instance.name = "bot" + std::to_string(i);
+        instance.configPath = replaceAll(opts.configPattern, "{n}", std::to_string(i));
+        instance.socketPath = opts.runDir + "/" + instance.name + ".sock";
+        instance.logPath = opts.runDir + "/" + instance.name + ".log";
+        instance.resultPath = opts.runDir + "/" + instance.name + ".json";
+    }
+    std::vector<NumaNode> nodes = readTopology();
+    placeInstances(instances, nodes, opts.cpusPerInstance);
+
+    std::cerr << "=== Bot supervisor: " << opts.count << " x " << opts.botPath << " on " << nodes.size()
+              << " node(s) ===" << std::endl;
+    for (Instance& instance : instances) {
+        if (!startInstance(opts, instance)) return 1;
+    }
+
+    int64_t startNs = monotonicNs();
+    int64_t nextMetricsNs = startNs + int64_t(opts.metricsSec) * 1000000000;
+    // Fake children stop themselves; the margin lets them write their results
+    int64_t endNs = opts.durationSec > 0 ? startNs + int64_t(opts.durationSec + (opts.fake ? 15 : 0)) * 1000000000 : 0;
+    while (!g_stopRequested) {
+        reapChildren(opts, instances, false);
+
+        int64_t now = monotonicNs();
+        bool allFinished = true;
+        for (Instance& instance : instances) {
+            if (instance.pid < 0 && !instance.finished && instance.restartAtNs && now >= instance.restartAtNs) {
+                instance.restarts++;
+                startInstance(opts, instance);
+            }
+            allFinished &= instance.finished;
+        }
+        if (allFinished || (endNs && now >= endNs)) break;
+
+        if (now >= nextMetricsNs) {
+            sampleMetrics(opts, instances);
+            nextMetricsNs += int64_t(opts.metricsSec) * 1000000000;
+        }
+        usleep(100000);
+    }
+
+    stopInstances(instances);
+
+    std::string text = summaryJson(opts, instances).dump(2);
+    std::cout << text << std::endl;
+    if (!opts.outputPath.empty()) {
+        std::ofstream out(opts.outputPath);
+        out << text << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <string>
+
+#include "ControlProtocol.h"
+
+// Control socket framing check (ctest). A request line with invalid UTF-8
+// must get an ok:false reply instead of an exception, and replies or events
+// carrying invalid UTF-8 from the SDK (a user name cut mid-character) must
+// still serialize to one parseable line.
+
+using Json = nlohmann::json;
+
+namespace {
+
+int g_failures = 0;
+
+void expect(bool ok, const char* what)
+{
+    if (ok) return;
+    fprintf(stderr, "control_protocol_test: %s\n", what);
+    g_failures++;
+}
+
+// Whether line is a single JSON object the client can parse
+bool parses(const std::string& line, Json& value)
+{
+    if (line.find('\n') != std::string::npos) return false;
+    try {
+        value = Json::parse(line);
+    } catch (Json::exception&) {
+        return false;
+    }
+    return value.is_object();
+}
+
+} // namespace
+
+int main()
+{
+    const char* badRequests[] = {
+        "{\"cmd\":\"\xff\"}",
+        "{\"cmd\":\"stats\",\"id\":\"\xc3\"}",
+        "\xfe\xff",
+        "{\"cmd\":\"subscribe\",\"user\":\"al\xe2\x82ice\"}",
+    };
+    for (const char* line : badRequests) {
+        Json request;
+        std::string errorLine;
+        bool ok = false;
+        try {
+            ok = parseControlRequest(line, request, errorLine);
+        } catch (...) {
+            expect(false, "parseControlRequest threw on invalid UTF-8");
+            continue;
+        }
+        Json reply;
+        expect(!ok, "invalid UTF-8 request was accepted");
+        expect(parses(errorLine, reply), "error reply is not one JSON line");
+        expect(reply.value("ok", true) == false && reply.contains("error"), "error reply is not ok:false");
+    }
+
+    // A reply built from SDK strings: a name cut inside a two-byte character
+    Json reply = { { "ok", true }, { "users", { std::string("Zo\xc3") } } };
+    Json parsed;
+    std::string line;
+    try {
+        line = controlLine(reply);
+    } catch (...) {
+        expect(false, "controlLine threw on invalid UTF-8");
+    }
+    expect(parses(line, parsed), "reply with invalid UTF-8 is not one JSON line");
+    expect(parsed["users"][0] == "Zo\xef\xbf\xbd", "invalid byte was not replaced with U+FFFD");
+
+    // Valid text passes through untouched
+    Json event = { { "event", "transcript" }, { "text", "caf\xc3\xa9 \xe2\x82\xac" } };
+    expect(parses(controlLine(event), parsed) && parsed["text"] == event["text"], "valid UTF-8 was altered");
+
+    if (!g_failures) printf("control_protocol_test: ok\n");
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cstdlib>
+#include <stdio.h>
+#include <vector>
+
+#include "FrameConvert.h"
+
+// RGB32 to I420 check (ctest): every matrix and range must round-trip
+// through the existing I420 to RGB32 path within 3 levels per channel, keep
+// grey neutral and put white at the top of the range. The odd size covers
+// the last chroma column and row.
+
+namespace {
+
+struct Planes
+{
+    std::vector<uint8_t> y, u, v;
+    I420Frame frame;
+
+    Planes(int width, int height)
+        : y(size_t(width) * height)
+        , u(size_t((width + 1) / 2) * ((height + 1) / 2))
+        , v(u.size())
+    {
+        frame.y = y.data();
+        frame.u = u.data();
+        frame.v = v.data();
+        frame.width = width;
+        frame.height = height;
+        frame.yStride = width;
+        frame.uStride = (width + 1) / 2;
+        frame.vStride = (width + 1) / 2;
+    }
+};
+
+int channelError(uint32_t a, uint32_t b)
+{
+    int worst = 0;
+    for (int shift = 0; shift < 24; shift += 8) {
+        worst = std::max(worst, std::abs(int((a >> shift) & 0xFF) - int((b >> shift) & 0xFF)));
+    }
+    return worst;
+}
+
+// Converts a 2x2 block of one colour; returns Y, U and V
+void convertSolid(uint32_t colour, ColorSpace space, int& y, int& u, int& v)
+{
+    uint32_t block[4] = { colour, colour, colour, colour };
+    Planes planes(2, 2);
+    convertRGB32ToI420(reinterpret_cast<const uint8_t*>(block), 8, planes.frame, space);
+    y = planes.y[0];
+    u = planes.u[0];
+    v = planes.v[0];
+}
+
+} // namespace
+
+int main()
+{
+    // Smooth gradients over every channel, as chroma subsampling assumes
+    const int width = 641;
+    const int height = 361;
+    std::vector<uint32_t> rgb(size_t(width) * height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint32_t r = (x / 2) & 0xFF, g = (y / 2) & 0xFF, b = ((x + y) / 4) & 0xFF;
+            rgb[size_t(y) * width + x] = 0xFF000000u | (r << 16) | (g << 8) | b;
+        }
+    }
+
+    int failures = 0;
+    const ColorMatrix matrices[] = { COLOR_MATRIX_BT601, COLOR_MATRIX_BT709 };
+    const ColorRange ranges[] = { COLOR_RANGE_LIMITED, COLOR_RANGE_FULL };
+    for (ColorMatrix matrix : matrices) {
+        for (ColorRange range : ranges) {
+            ColorSpace space;
+            space.matrix = matrix;
+            space.range = range;
+            const char* name = matrix == COLOR_MATRIX_BT601 ? (range == COLOR_RANGE_FULL ? "bt601 full" : "bt601 limited")
+                                                            : (range == COLOR_RANGE_FULL ? "bt709 full" : "bt709 limited");
+
+            Planes planes(width, height);
+            convertRGB32ToI420(reinterpret_cast<const uint8_t*>(rgb.data()), width * 4, planes.frame, space);
+            std::vector<uint32_t> back(rgb.size());
+            convertI420ToRGB32(planes.frame, reinterpret_cast<uint8_t*>(back.data()), width * 4, width, height, space);
+            int worst = 0;
+            for (size_t i = 0; i < rgb.size(); i++) worst = std::max(worst, channelError(rgb[i], back[i]));
+
+            int greyY, greyU, greyV, whiteY, whiteU, whiteV;
+            convertSolid(0xFF808080u, space, greyY, greyU, greyV);
+            convertSolid(0xFFFFFFFFu, space, whiteY, whiteU, whiteV);
+            int top = range == COLOR_RANGE_FULL ? 255 : 235;
+            printf("%s: round trip error %d, grey U %d V %d, white Y %d\n", name, worst, greyU, greyV, whiteY);
+
+            if (worst > 3) {
+                fprintf(stderr, "frame_convert_test: %s round trip is off by %d\n", name, worst);
+                failures++;
+            }
+            if (std::abs(greyU - 128) > 1 || std::abs(greyV - 128) > 1 || std::abs(whiteU - 128) > 1
+                || std::abs(whiteV - 128) > 1) {
+                fprintf(stderr, "frame_convert_test: %s grey is not neutral\n", name);
+                failures++;
+            }
+            if (std::abs(whiteY - top) > 1) {
+                fprintf(stderr, "frame_convert_test: %s white is at Y %d, not %d\n", name, whiteY, top);
+                failures++;
+            }
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,253 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "FrameExportRing.h"
+
+// Reference consumer for the bot's shared-memory frame export (config.json
+// "frame_export": true). Follows one stream's ring and prints per-second
+// frame rate, frames lost to a lapping writer, torn reads, frames
+// overwritten while in use and writer-to-reader latency. Frames are read in place, without copying. With
+// --throughput it instead runs a writer and a reader over a private ring in
+// this process and reports how fast frames move through it.
+
+struct Options
+{
+    std::string stream;   // "remote:alice" or a shm name such as "/zoombot.remote_alice"
+    int durationSec = 0;  // 0 = until the writer goes away or SIGINT
+    bool latest = false;
+    bool throughput = false;
+    int width = 1280;
+    int height = 720;
+    int slots = 4;
+};
+
+static volatile sig_atomic_t g_stopRequested = 0;
+
+static void handleStopSignal(int)
+{
+    g_stopRequested = 1;
+}
+
+static int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static void printUsage(const char* argv0)
+{
+    std::cerr << "Usage: " << argv0 << " [options] STREAM\n"
+              << "       " << argv0 << " --throughput [options]\n"
+              << "  STREAM                stream name (remote:alice) or shm name (/zoombot.remote_alice)\n"
+              << "  --duration SEC        stop after this long (default: until the writer exits)\n"
+              << "  --latest              skip to the newest frame each time instead of reading every one\n"
+              << "  --throughput          measure an in-process writer and reader over a private ring\n"
+              << "  --size WxH            throughput frame size (default 1280x720)\n"
+              << "  --slots N             throughput ring slots (default 4)\n";
+}
+
+static bool parseOptions(int argc, char* argv[], Options& opts)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (arg == "--latest") {
+            opts.latest = true;
+        } else if (arg == "--throughput") {
+            opts.throughput = true;
+        } else if (arg.compare(0, 2, "--") != 0) {
+            opts.stream = arg;
+        } else if (!hasValue) {
+            std::cerr << "ERROR: missing value for " << arg << std::endl;
+            return false;
+        } else if (arg == "--duration") {
+            opts.durationSec = atoi(argv[++i]);
+        } else if (arg == "--size") {
+            if (sscanf(argv[++i], "%dx%d", &opts.width, &opts.height) != 2) {
+                std::cerr << "ERROR: --size wants WxH" << std::endl;
+                return false;
+            }
+        } else if (arg == "--slots") {
+            opts.slots = atoi(argv[++i]);
+        } else {
+            std::cerr << "ERROR: unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    if (!opts.throughput && opts.stream.empty()) {
+        std::cerr << "ERROR: no stream given" << std::endl;
+        return false;
+    }
+    if (opts.width < 2 || opts.height < 2 || opts.slots < 2) {
+        std::cerr << "ERROR: bad --size or --slots" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Stands in for real processing: sums one byte per 64 of every Y row, so
+// each frame is actually read from the shared pages
+static uint64_t touchFrame(const I420Frame& frame)
+{
+    uint64_t sum = 0;
+    for (int row = 0; row < frame.height; row++) {
+        const uint8_t* line = frame.y + size_t(row) * frame.yStride;
+        for (int x = 0; x < frame.width; x += 64) sum += line[x];
+    }
+    return sum;
+}
+
+static int followStream(const Options& opts)
+{
+    std::string shmName = opts.stream[0] == '/' ? opts.stream : frameExportShmName(opts.stream);
+    FrameExportReader reader;
+    if (!reader.open(shmName)) {
+        std::cerr << "ERROR: cannot map " << shmName << " (is frame_export on and the stream subscribed?)" << std::endl;
+        return 1;
+    }
+    const FrameExportRingHeader* header = reader.header();
+    printf("%s: stream %s, %u slots of %u bytes\n", shmName.c_str(), header->streamName, header->slotCount,
+           header->slotBytes);
+
+    int64_t startNs = monotonicNs();
+    int64_t reportNs = startNs + 1000000000;
+    FrameExportReader::Stats last = reader.stats();
+    double latencySumMs = 0.0;
+    double latencyMaxMs = 0.0;
+    int latencyCount = 0;
+    uint64_t checksum = 0;
+    int width = 0;
+    int height = 0;
+
+    while (!g_stopRequested) {
+        FrameExportView view;
+        bool got = opts.latest ? reader.latest(view) : reader.next(view);
+        if (got) {
+            // Use the planes in place, then check they were not rewritten meanwhile
+            uint64_t sum = touchFrame(view.frame);
+            if (reader.validate(view)) {
+                checksum += sum;
+                width = view.frame.width;
+                height = view.frame.height;
+                double latencyMs = (monotonicNs() - view.timestampNs) / 1e6;
+                latencySumMs += latencyMs;
+                if (latencyMs > latencyMaxMs) latencyMaxMs = latencyMs;
+                latencyCount++;
+            }
+        } else {
+            if (!reader.writerAlive()) {
+                printf("writer closed the ring\n");
+                break;
+            }
+            usleep(1000);
+        }
+
+        int64_t now = monotonicNs();
+        if (now >= reportNs) {
+            FrameExportReader::Stats s = reader.stats();
+            printf("%dx%d  %llu fps  lost %llu  torn %llu  invalidated %llu  latency mean %.2f ms max %.2f ms  (checksum %llx)\n",
+                   width, height, (unsigned long long)(s.frames - last.frames),
+                   (unsigned long long)(s.lost - last.lost), (unsigned long long)(s.torn - last.torn),
+                   (unsigned long long)(s.invalidated - last.invalidated), latencyCount ? latencySumMs / latencyCount : 0.0, latencyMaxMs, (unsigned long long)checksum);
+            fflush(stdout);
+            last = s;
+            latencySumMs = latencyMaxMs = 0.0;
+            latencyCount = 0;
+            reportNs += 1000000000;
+            if (opts.durationSec > 0 && now - startNs >= int64_t(opts.durationSec) * 1000000000) break;
+        }
+    }
+
+    FrameExportReader::Stats s = reader.stats();
+    printf("total: %llu frames, %llu lost, %llu torn, %llu invalidated after use\n", (unsigned long long)s.frames,
+           (unsigned long long)s.lost, (unsigned long long)s.torn, (unsigned long long)s.invalidated);
+    return 0;
+}
+
+static int measureThroughput(const Options& opts)
+{
+    // A real shm object, so the numbers include the shared mapping
+    std::string shmName = "/zoombot.throughput." + std::to_string(getpid());
+    FrameExportWriter writer;
+    if (!writer.open(shmName, "throughput", uint32_t(opts.slots), opts.width, opts.height)) {
+        std::cerr << "ERROR: cannot create " << shmName << std::endl;
+        return 1;
+    }
+
+    int chromaWidth = (opts.width + 1) / 2;
+    int chromaHeight = (opts.height + 1) / 2;
+    std::vector<uint8_t> y(size_t(opts.width) * opts.height, 0x80);
+    std::vector<uint8_t> u(size_t(chromaWidth) * chromaHeight, 0x80);
+    std::vector<uint8_t> v(u.size(), 0x80);
+    I420Frame frame;
+    frame.y = y.data();
+    frame.u = u.data();
+    frame.v = v.data();
+    frame.width = opts.width;
+    frame.height = opts.height;
+    frame.yStride = opts.width;
+    frame.uStride = chromaWidth;
+    frame.vStride = chromaWidth;
+
+    std::atomic<bool> stop(false);
+    FrameExportReader reader;
+    if (!reader.open(shmName)) {
+        std::cerr << "ERROR: cannot map " << shmName << std::endl;
+        return 1;
+    }
+    uint64_t validFrames = 0;
+    std::thread consumer([&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            FrameExportView view;
+            if (reader.next(view)) {
+                touchFrame(view.frame);
+                if (reader.validate(view)) validFrames++;
+            }
+        }
+    });
+
+    int durationSec = opts.durationSec > 0 ? opts.durationSec : 5;
+    int64_t startNs = monotonicNs();
+    int64_t endNs = startNs + int64_t(durationSec) * 1000000000;
+    uint64_t written = 0;
+    while (!g_stopRequested && monotonicNs() < endNs) {
+        y[written % y.size()] = uint8_t(written);
+        writer.write(frame, monotonicNs());
+        written++;
+    }
+    double seconds = (monotonicNs() - startNs) / 1e9;
+    stop = true;
+    consumer.join();
+
+    FrameExportReader::Stats s = reader.stats();
+    double frameBytes = double(y.size() + u.size() + v.size());
+    printf("%dx%d, %d slots, %.1f s\n", opts.width, opts.height, opts.slots, seconds);
+    printf("writer: %.0f frames/s, %.2f GB/s\n", written / seconds, written * frameBytes / seconds / 1e9);
+    printf("reader: %.0f frames/s valid, %llu lost to laps, %llu torn, %llu invalidated after use\n",
+           validFrames / seconds, (unsigned long long)s.lost, (unsigned long long)s.torn,
+           (unsigned long long)s.invalidated);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    Options opts;
+    if (!parseOptions(argc, argv, opts)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    signal(SIGINT, handleStopSignal);
+    signal(SIGTERM, handleStopSignal);
+    return opts.throughput ? measureThroughput(opts) : followStream(opts);
+}
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <atomic>
+#include <stdio.h>
+#include <thread>
+#include <time.h>
+#include <vector>
+
+#include "FrameExportRing.h"
+
+// Frame export ring check (ctest). Every frame's Y plane is filled with its
+// frame number, so a reader can tell a torn frame from a good one.
+//  - paced: the writer keeps a slot of distance from the reader, so every
+//    frame must arrive in order with nothing lost, torn or invalidated
+//  - racing: the writer never waits; laps and torn reads are expected, but
+//    a frame that validates must never carry another frame's pixels, and
+//    every frame number is accounted for
+
+namespace {
+
+const int kWidth = 320;
+const int kHeight = 180;
+const uint32_t kSlots = 4;
+
+int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+struct Planes
+{
+    std::vector<uint8_t> y, u, v;
+    I420Frame frame;
+
+    Planes()
+        : y(size_t(kWidth) * kHeight)
+        , u(size_t(kWidth / 2) * (kHeight / 2), 0x80)
+        , v(u.size(), 0x80)
+    {
+        frame.y = y.data();
+        frame.u = u.data();
+        frame.v = v.data();
+        frame.width = kWidth;
+        frame.height = kHeight;
+        frame.yStride = kWidth;
+        frame.uStride = kWidth / 2;
+        frame.vStride = kWidth / 2;
+    }
+
+    void fill(uint64_t frameNumber) { std::fill(y.begin(), y.end(), uint8_t(frameNumber)); }
+};
+
+// Whether every Y byte carries the frame number the slot header claims
+bool matches(const FrameExportView& view)
+{
+    uint8_t expected = uint8_t(view.frameNumber);
+    for (int row = 0; row < view.frame.height; row++) {
+        const uint8_t* line = view.frame.y + size_t(row) * view.frame.yStride;
+        for (int x = 0; x < view.frame.width; x++) {
+            if (line[x] != expected) return false;
+        }
+    }
+    return true;
+}
+
+struct Result
+{
+    FrameExportReader::Stats stats;
+    uint64_t written;
+    uint64_t valid;
+    uint64_t mismatched;  // validated, but pixels from another frame
+    uint64_t outOfOrder;
+};
+
+// Paced runs write this many frames; racing ones write for racingMs
+Result run(uint64_t frames, bool paced, int racingMs = 300)
+{
+    FrameExportWriter writer;
+    FrameExportReader reader;
+    Result result = {};
+    if (!writer.open(std::string(), "test", kSlots, kWidth, kHeight) || !reader.attach(writer)) {
+        fprintf(stderr, "frame_export_ring_test: cannot create ring\n");
+        result.mismatched = 1;
+        return result;
+    }
+
+    std::atomic<uint64_t> consumed(0);  // frame numbers the reader is done with
+    std::atomic<bool> done(false);
+    std::thread consumer([&]() {
+        uint64_t expectNext = 0;
+        for (;;) {
+            bool finished = done.load(std::memory_order_acquire);
+            FrameExportView view;
+            if (!reader.next(view)) {
+                // Paced runs read up to the last frame; racing ones stop with the writer
+                FrameExportReader::Stats s = reader.stats();
+                if (finished && (!paced || s.frames + s.lost + s.torn >= frames)) break;
+                std::this_thread::yield();
+                continue;
+            }
+            bool same = matches(view);
+            if (reader.validate(view)) {
+                result.valid++;
+                if (!same) result.mismatched++;
+                if (view.frameNumber < expectNext) result.outOfOrder++;
+                expectNext = view.frameNumber + 1;
+            }
+            consumed.store(view.frameNumber + 1, std::memory_order_release);
+        }
+    });
+
+    Planes planes;
+    int64_t endNs = monotonicNs() + int64_t(racingMs) * 1000000;
+    for (uint64_t n = 0; paced ? n < frames : monotonicNs() < endNs; n++) {
+        // Slot n % kSlots last held frame n - kSlots; keep a spare slot so
+        // the one being read is never rewritten
+        while (paced && n >= consumed.load(std::memory_order_acquire) + kSlots - 1) {
+            std::this_thread::yield();
+        }
+        planes.fill(n);
+        writer.write(planes.frame, monotonicNs());
+        result.written++;
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+    result.stats = reader.stats();
+    return result;
+}
+
+void print(const char* name, const Result& r)
+{
+    printf("%s: written %llu, read %llu, valid %llu, lost %llu, torn %llu, invalidated %llu, mismatched %llu, "
+           "out of order %llu\n",
+           name, (unsigned long long)r.written, (unsigned long long)r.stats.frames, (unsigned long long)r.valid,
+           (unsigned long long)r.stats.lost, (unsigned long long)r.stats.torn,
+           (unsigned long long)r.stats.invalidated, (unsigned long long)r.mismatched,
+           (unsigned long long)r.outOfOrder);
+}
+
+} // namespace
+
+int main()
+{
+    const uint64_t kFrames = 20000;
+    int failures = 0;
+
+    Result paced = run(kFrames, true);
+    print("paced", paced);
+    if (paced.stats.frames != kFrames || paced.valid != kFrames || paced.stats.lost || paced.stats.torn
+        || paced.stats.invalidated || paced.mismatched || paced.outOfOrder) {
+        fprintf(stderr, "frame_export_ring_test: paced reader missed, tore or reordered frames\n");
+        failures++;
+    }
+
+    Result racing = run(0, false);
+    print("racing", racing);
+    if (racing.mismatched || racing.outOfOrder) {
+        fprintf(stderr, "frame_export_ring_test: a validated frame carried another frame's pixels\n");
+        failures++;
+    }
+    if (racing.valid + racing.stats.invalidated != racing.stats.frames
+        || racing.stats.frames + racing.stats.lost + racing.stats.torn > racing.written) {
+        fprintf(stderr, "frame_export_ring_test: reader statistics do not add up\n");
+        failures++;
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,200 @@
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QStringList>
+#include <QTimer>
+
+#include "BotSession.h"
+#include "Logger.h"
+#include "AllocationTracker.h"
+#include "MemoryBudget.h"
+#include "EventBus.h"
+#include "CommandChannel.h"
+#include "ControlServer.h"
+#include "SocketWatcher.h"
+#include "StartupProfiler.h"
+#include "StreamWatchdog.h"
+#include "VirtualShareSource.h"
+#include "WorkStealingExecutor.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <functional>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Headless front end: the same session core as the Qt GUI, driven by a
+// QCoreApplication event loop with no widgets, renderers or display.
+// With --standby it does not join on start; it keeps the SDK initialized and
+// takes join/leave/subscribe/mute commands on a control socket instead.
+
+// Self-pipe written from the signal handler and read on the event loop
+static int g_signalPipe[2] = { -1, -1 };
+
+static void handleTerminationSignal(int signo)
+{
+    char c = (char)signo;
+    ssize_t ignored = write(g_signalPipe[1], &c, 1);
+    (void)ignored;
+}
+
+static bool installSignalHandlers()
+{
+    if (pipe2(g_signalPipe, O_CLOEXEC | O_NONBLOCK) != 0) {
+        LOG_ERROR("Failed to create signal pipe: %s", strerror(errno));
+        return false;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handleTerminationSignal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    return true;
+}
+
+// Reports session events to the log; video is not rendered
+class HeadlessController : public IBotFrontend
+{
+public:
+    HeadlessController(QObject* context, ControlServer* control) : m_context(context), m_control(control) {}
+
+    void onStatusMessage(const std::string& message) override
+    {
+        LOG_INFO("[status] %s", message.c_str());
+    }
+
+    void onSessionStateChanged() override
+    {
+        LOG_INFO("[status] in_session=%s audio_muted=%s", g_in_session ? "true" : "false",
+                 g_audio_muted ? "true" : "false");
+    }
+
+    void onSessionEvent(const BotEvent& event) override
+    {
+        if (event.type == BOT_EVENT_SDK_READY && m_onSdkReady) m_onSdkReady(event.code != 0);
+        if (m_control) m_control->onSessionEvent(event);
+    }
+
+    // Called on the event loop once background SDK initialization finishes
+    void setSdkReadyHandler(std::function<void(bool)> handler) { m_onSdkReady = std::move(handler); }
+
+    void requestEventDispatch() override
+    {
+        QMetaObject::invokeMethod(m_context, [this]() { dispatchBotEvents(this); }, Qt::QueuedConnection);
+    }
+
+private:
+    QObject* m_context;  // events are dispatched on this object's thread
+    ControlServer* m_control;
+    std::function<void(bool)> m_onSdkReady;
+};
+
+int main(int argc, char* argv[])
+{
+    StartupProfiler::mark("main entered");
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("Zoom Video SDK Headless Bot");
+    app.setApplicationVersion("1.0");
+    StartupProfiler::mark("QCoreApplication created");
+
+    LOG_INFO("=== Starting headless Video SDK bot ===");
+
+    // The SDK initializes on a worker while arguments, config and the control
+    // socket are set up here; BOT_EVENT_SDK_READY reports when it is done
+    initializeVideoSDKAsync();
+
+    // --config <path> overrides config.json next to the executable
+    QString config_path = getSelfDirPath() + "/config.json";
+    QString control_path;
+    bool standby = false;
+    QStringList args = app.arguments();
+    for (int i = 1; i < args.size(); i++) {
+        if (args[i] == "--config" && i + 1 < args.size()) {
+            config_path = args[++i];
+        } else if (args[i] == "--control-socket" && i + 1 < args.size()) {
+            control_path = args[++i];
+        } else if (args[i] == "--standby") {
+            standby = true;
+        }
+    }
+    if (standby && control_path.isEmpty()) {
+        const char* runtime_dir = getenv("XDG_RUNTIME_DIR");
+        control_path = QString(runtime_dir ? runtime_dir : "/tmp") + "/zoom_bot.sock";
+    }
+
+    // In standby the config only supplies defaults for join commands
+    BotConfig config;
+    if (!loadBotConfig(config_path, config) && !standby) {
+        return 1;
+    }
+    if (config.user_name.isEmpty()) {
+        config.user_name = "Linux Headless Bot";
+    }
+    StartupProfiler::mark("config loaded");
+
+    if (!installSignalHandlers()) {
+        return 1;
+    }
+
+    ControlServer control;
+    control.setJoinDefaults(config);
+    if (!control_path.isEmpty() && !control.listen(control_path.toStdString())) {
+        return 1;
+    }
+
+    StartupProfiler::mark("control socket ready");
+
+    HeadlessController controller(&app, control_path.isEmpty() ? nullptr : &control);
+    controller.setSdkReadyHandler([&app, &config, &control_path, standby](bool ok) {
+        if (!ok) {
+            app.exit(1);
+            return;
+        }
+        StartupProfiler::markReady("SDK ready");
+        if (standby) {
+            LOG_INFO("Standby: SDK initialized, waiting for commands on %s", control_path.toStdString().c_str());
+        } else {
+            joinVideoSDKSession(config.session_name, config.session_psw, config.token, config.user_name);
+        }
+    });
+    attachBotFrontend(&controller);
+
+    // Leave the session and stop the event loop on SIGINT/SIGTERM
+    SocketWatcher signalWatcher(g_signalPipe[0], QSocketNotifier::Read, [&app]() {
+        char signo = 0;
+        while (read(g_signalPipe[0], &signo, 1) > 0) {
+        }
+        LOG_INFO("Received signal %d, leaving session", (int)signo);
+        leaveVideoSDKSession();
+        app.quit();
+    });
+
+    QTimer memoryReportTimer;
+    QObject::connect(&memoryReportTimer, &QTimer::timeout, []() {
+        MemoryBudget::instance().report();
+        AllocationTracker::report();
+        botEventBus().report();
+        if (CommandChannel* channel = botCommandChannelIfStarted()) channel->report();
+        streamWatchdog().report();
+        if (VirtualShareSource* share = virtualShareSourceIfStarted()) share->report();
+        if (WorkStealingExecutor* executor = frameExecutorIfStarted()) executor->report();
+    });
+    memoryReportTimer.start(10000);
+
+    // Lets debounced subscription changes (speaker, layout) take effect
+    QTimer subscriptionTimer;
+    QObject::connect(&subscriptionTimer, &QTimer::timeout, []() { applySubscriptionPolicy(); });
+    subscriptionTimer.start(250);
+
+    int result = app.exec();
+
+    control.close();
+    cleanupVideoSDK();
+    StartupProfiler::report();
+    LOG_INFO("Headless bot exited");
+    return result;
+}
@@ -3,12 +3,33 @@
 #include <string>
 #include <thread>
 #include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <atomic>
+#include <vector>
 #include <dlfcn.h>
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
 
 #include "json.hpp"
 
+#include "Logger.h"
+#include "QtRemoteVideoHandler.h"
+#include "ResourceSampler.h"
+#include "StreamStats.h"
+#include "SyntheticFrameSource.h"
+#include "VideoFrameSink.h"
+
 // Include Zoom SDK headers
 #include "helpers/zoom_video_sdk_user_helper_interface.h"
+#include "helpers/zoom_video_sdk_audio_helper_interface.h"
 #include "zoom_video_sdk_api.h"
 #include "zoom_video_sdk_def.h"
 #include "zoom_video_sdk_delegate_interface.h"
@@ -19,30 +40,273 @@
 using Json = nlohmann::json;
 USING_ZOOM_VIDEO_SDK_NAMESPACE
 
-// Simple delegate for session events
+// Headless soak and throughput tool: joins a session (or runs synthetic
+// streams), subscribes to every participant's video and to audio, and prints
+// a JSON summary of per-stream delivery stats and process CPU/RSS.
+
+struct Options
+{
+    int durationSec = 10;
+    int resolutionLines = 360;
+    bool video = true;
+    bool audio = true;
+    std::set<std::string> users;  // empty = every remote user
+    int synthetic = 0;            // >0: no SDK, this many generated streams
+    int syntheticFps = 30;
+    int sampleMs = 1000;
+    int pinCpu = -1;
+    std::string configPath = "config.json";
+    std::string outputPath;
+};
+
+static IZoomVideoSDK* g_sdk = nullptr;
+static volatile sig_atomic_t g_stopRequested = 0;
+
+static void handleStopSignal(int)
+{
+    g_stopRequested = 1;
+}
+
+static void printUsage(const char* argv0)
+{
+    std::cerr << "Usage: " << argv0 << " [options]\n"
+              << "  --duration SEC        measurement time after join (default 10)\n"
+              << "  --resolution 90|180|360|720|1080\n"
+              << "                        video subscription resolution (default 360)\n"
+              << "  --users a,b,...       only subscribe to these user names\n"
+              << "  --no-video            do not subscribe to video\n"
+              << "  --no-audio            do not subscribe to audio\n"
+              << "  --synthetic N         no SDK: measure N generated video streams\n"
+              << "  --fps N               frame rate of synthetic streams (default 30)\n"
+              << "  --sample-ms MS        CPU/RSS sampling interval (default 1000)\n"
+              << "  --pin-cpu N           run on a single CPU core\n"
+              << "  --config PATH         session config (default ./config.json)\n"
+              << "  --output PATH         also write the JSON summary to a file\n";
+}
+
+static bool parseOptions(int argc, char* argv[], Options& opts)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (arg == "--no-video") {
+            opts.video = false;
+        } else if (arg == "--no-audio") {
+            opts.audio = false;
+        } else if (!hasValue) {
+            std::cerr << "ERROR: missing value for " << arg << std::endl;
+            return false;
+        } else if (arg == "--duration") {
+            opts.durationSec = atoi(argv[++i]);
+        } else if (arg == "--resolution") {
+            opts.resolutionLines = atoi(argv[++i]);
+        } else if (arg == "--users") {
+            std::stringstream list(argv[++i]);
+            std::string name;
+            while (std::getline(list, name, ',')) {
+                if (!name.empty()) opts.users.insert(name);
+            }
+        } else if (arg == "--synthetic") {
+            opts.synthetic = atoi(argv[++i]);
+        } else if (arg == "--fps") {
+            opts.syntheticFps = atoi(argv[++i]);
+        } else if (arg == "--sample-ms") {
+            opts.sampleMs = atoi(argv[++i]);
+        } else if (arg == "--pin-cpu") {
+            opts.pinCpu = atoi(argv[++i]);
+        } else if (arg == "--config") {
+            opts.configPath = argv[++i];
+        } else if (arg == "--output") {
+            opts.outputPath = argv[++i];
+        } else {
+            std::cerr << "ERROR: unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+
+    switch (opts.resolutionLines) {
+    case 90: case 180: case 360: case 720: case 1080:
+        break;
+    default:
+        std::cerr << "ERROR: unsupported resolution " << opts.resolutionLines << std::endl;
+        return false;
+    }
+    if (opts.durationSec <= 0 || opts.sampleMs <= 0) {
+        std::cerr << "ERROR: duration and sample interval must be positive" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static ZoomVideoSDKResolution toSdkResolution(int lines)
+{
+    switch (lines) {
+    case 90:  return ZoomVideoSDKResolution_90P;
+    case 180: return ZoomVideoSDKResolution_180P;
+    case 360: return ZoomVideoSDKResolution_360P;
+    case 720: return ZoomVideoSDKResolution_720P;
+    default:  return ZoomVideoSDKResolution_1080P;
+    }
+}
+
+static Json toJson(const StreamStats::Summary& s, const char* kind)
+{
+    Json j;
+    j["name"] = s.name;
+    j["kind"] = kind;
+    j["frames"] = s.frames;
+    j["bytes"] = s.bytes;
+    j["fps"] = s.framesPerSec;
+    j["bytes_per_sec"] = s.bytesPerSec;
+    j["jitter_ms"] = s.jitterMs;
+    j["interval_ms"] = { { "mean", s.meanIntervalMs }, { "stddev", s.stddevIntervalMs },
+                         { "p50", s.p50IntervalMs }, { "p99", s.p99IntervalMs }, { "max", s.maxIntervalMs } };
+    return j;
+}
+
+// Counts every frame delivered to one video subscription
+class FrameProbe : public IVideoFrameSink
+{
+public:
+    explicit FrameProbe(const std::string& name) : m_stats(name), m_width(0), m_height(0) {}
+
+    void onVideoFrame(const I420Frame& frame) override
+    {
+        size_t bytes = size_t(frame.yStride) * frame.height
+                     + size_t(frame.uStride + frame.vStride) * (frame.height / 2);
+        m_stats.onDelivery(bytes);
+        m_width.store(frame.width, std::memory_order_relaxed);
+        m_height.store(frame.height, std::memory_order_relaxed);
+    }
+
+    Json summary() const
+    {
+        Json j = toJson(m_stats.summary(), "video");
+        j["width"] = m_width.load(std::memory_order_relaxed);
+        j["height"] = m_height.load(std::memory_order_relaxed);
+        return j;
+    }
+
+private:
+    StreamStats m_stats;
+    std::atomic<int> m_width;
+    std::atomic<int> m_height;
+};
+
+// Per-participant subscriptions; stats outlive the subscription so users
+// who leave early still show up in the summary
+struct UserProbe
+{
+    explicit UserProbe(const std::string& name) : video(name), audio(name) {}
+
+    FrameProbe video;
+    StreamStats audio;
+    std::unique_ptr<QtRemoteVideoHandler> handler;
+};
+
+// Session delegate that subscribes to remote users and counts deliveries
 class SimpleDelegate : public IZoomVideoSDKDelegate
 {
 public:
+    explicit SimpleDelegate(const Options& opts)
+        : m_opts(opts)
+        , m_mixedAudio("mixed")
+        , m_joined(false)
+        , m_failed(false)
+    {
+    }
+
+    bool joined() const { return m_joined.load(); }
+    bool failed() const { return m_failed.load(); }
+
     virtual void onSessionJoin() {
-        std::cout << "=== SUCCESS: Session joined successfully! ===" << std::endl;
+        std::cerr << "=== SUCCESS: Session joined successfully! ===" << std::endl;
+        m_joined = true;
+
+        if (m_opts.audio) {
+            IZoomVideoSDKAudioHelper* audioHelper = g_sdk->getAudioHelper();
+            if (audioHelper) {
+                ZoomVideoSDKErrors err = audioHelper->subscribe();
+                std::cerr << "Audio raw data subscription: " << (int)err << std::endl;
+            }
+        }
+
+        // Users already in the session do not trigger onUserJoin
+        IZoomVideoSDKSession* session = g_sdk->getSessionInfo();
+        IVideoSDKVector<IZoomVideoSDKUser*>* remoteUsers = session ? session->getRemoteUsers() : nullptr;
+        if (remoteUsers) {
+            subscribeUsers(remoteUsers);
+        }
     }
 
     virtual void onSessionLeave() {
-        std::cout << "Session left." << std::endl;
+        std::cerr << "Session left." << std::endl;
     }
 
     virtual void onSessionLeave(ZoomVideoSDKSessionLeaveReason eReason) {
-        std::cout << "Session left with reason: " << (int)eReason << std::endl;
+        std::cerr << "Session left with reason: " << (int)eReason << std::endl;
     }
 
     virtual void onError(ZoomVideoSDKErrors errorCode, int detailErrorCode) {
-        std::cout << "Session error - Code: " << errorCode << ", Detail: " << detailErrorCode << std::endl;
+        std::cerr << "Session error - Code: " << errorCode << ", Detail: " << detailErrorCode << std::endl;
+        if (!m_joined) m_failed = true;
+    }
+
+    virtual void onUserJoin(IZoomVideoSDKUserHelper* pUserHelper, IVideoSDKVector<IZoomVideoSDKUser*>* userList) {
+        subscribeUsers(userList);
+    }
+
+    virtual void onUserLeave(IZoomVideoSDKUserHelper* pUserHelper, IVideoSDKVector<IZoomVideoSDKUser*>* userList) {
+        if (!userList) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int i = 0; i < userList->GetCount(); i++) {
+            IZoomVideoSDKUser* user = userList->GetItem(i);
+            auto it = user ? m_users.find(userKey(user)) : m_users.end();
+            if (it != m_users.end()) {
+                it->second->handler.reset();
+            }
+        }
+    }
+
+    virtual void onUserVideoStatusChanged(IZoomVideoSDKVideoHelper* pVideoHelper, IVideoSDKVector<IZoomVideoSDKUser*>* userList) {
+        subscribeUsers(userList);
+    }
+
+    virtual void onMixedAudioRawDataReceived(AudioRawData* data_) {
+        if (data_) m_mixedAudio.onDelivery(data_->GetBufferLen());
+    }
+
+    virtual void onOneWayAudioRawDataReceived(AudioRawData* data_, IZoomVideoSDKUser* pUser) {
+        if (!data_ || !pUser || !wanted(pUser)) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        probeFor(pUser).audio.onDelivery(data_->GetBufferLen());
+    }
+
+    virtual void onSharedAudioRawDataReceived(AudioRawData* data_) {}
+
+    // Drop all video subscriptions, keeping the stats
+    void unsubscribeAll()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& entry : m_users) {
+            entry.second->handler.reset();
+        }
+    }
+
+    void appendStreams(Json& streams) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& entry : m_users) {
+            const UserProbe& probe = *entry.second;
+            streams.push_back(probe.video.summary());
+            streams.push_back(toJson(probe.audio.summary(), "audio"));
+        }
+        streams.push_back(toJson(m_mixedAudio.summary(), "audio"));
     }
 
     // Stub implementations for other required methods
-    virtual void onUserJoin(IZoomVideoSDKUserHelper* pUserHelper, IVideoSDKVector<IZoomVideoSDKUser*>* userList) {}
-    virtual void onUserLeave(IZoomVideoSDKUserHelper* pUserHelper, IVideoSDKVector<IZoomVideoSDKUser*>* userList) {}
-    virtual void onUserVideoStatusChanged(IZoomVideoSDKVideoHelper* pVideoHelper, IVideoSDKVector<IZoomVideoSDKUser*>* userList) {}
     virtual void onUserAudioStatusChanged(IZoomVideoSDKAudioHelper* pAudioHelper, IVideoSDKVector<IZoomVideoSDKUser*>* userList) {}
     virtual void onUserShareStatusChanged(IZoomVideoSDKShareHelper* pShareHelper, IZoomVideoSDKUser* pUser, IZoomVideoSDKShareAction* pShareAction) {}
     virtual void onShareContentChanged(IZoomVideoSDKShareHelper* pShareHelper, IZoomVideoSDKUser* pUser, IZoomVideoSDKShareAction* pShareAction) {}
@@ -111,22 +375,151 @@ public:
     virtual void onUserNameChanged(IZoomVideoSDKUser* pUser) {}
     virtual void onCameraControlRequestResult(IZoomVideoSDKUser* pUser, bool isApproved) {}
     virtual void onCameraControlRequestReceived(IZoomVideoSDKUser* pUser, ZoomVideoSDKCameraControlRequestType requestType, IZoomVideoSDKCameraControlRequestHandler* pCameraControlRequestHandler) {}
-    virtual void onMixedAudioRawDataReceived(AudioRawData* data_) {}
-    virtual void onOneWayAudioRawDataReceived(AudioRawData* data_, IZoomVideoSDKUser* pUser) {}
-    virtual void onSharedAudioRawDataReceived(AudioRawData* data_) {}
+
+private:
+    static std::string userKey(IZoomVideoSDKUser* user)
+    {
+        const zchar_t* id = user->getUserID();
+        return id ? id : "";
+    }
+
+    bool wanted(IZoomVideoSDKUser* user) const
+    {
+        if (m_opts.users.empty()) return true;
+        const zchar_t* name = user->getUserName();
+        return name && m_opts.users.count(name) > 0;
+    }
+
+    // Caller holds m_mutex
+    UserProbe& probeFor(IZoomVideoSDKUser* user)
+    {
+        std::unique_ptr<UserProbe>& probe = m_users[userKey(user)];
+        if (!probe) {
+            const zchar_t* name = user->getUserName();
+            probe.reset(new UserProbe(name ? name : "unknown"));
+        }
+        return *probe;
+    }
+
+    void subscribeUsers(IVideoSDKVector<IZoomVideoSDKUser*>* userList)
+    {
+        if (!m_opts.video || !userList || !g_sdk) return;
+
+        IZoomVideoSDKSession* session = g_sdk->getSessionInfo();
+        IZoomVideoSDKUser* myself = session ? session->getMyself() : nullptr;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int i = 0; i < userList->GetCount(); i++) {
+            IZoomVideoSDKUser* user = userList->GetItem(i);
+            if (!user || user == myself || !wanted(user) || !user->GetVideoPipe()) continue;
+
+            UserProbe& probe = probeFor(user);
+            if (probe.handler && probe.handler->IsSubscribed()) continue;
+
+            probe.handler.reset(new QtRemoteVideoHandler(&probe.video));
+            if (!probe.handler->SubscribeToUser(user, toSdkResolution(m_opts.resolutionLines))) {
+                std::cerr << "Failed to subscribe to video of " << user->getUserName() << std::endl;
+                probe.handler.reset();
+            }
+        }
+    }
+
+    const Options& m_opts;
+    mutable std::mutex m_mutex;
+    std::map<std::string, std::unique_ptr<UserProbe>> m_users;  // keyed by user id
+    StreamStats m_mixedAudio;
+    std::atomic<bool> m_joined;
+    std::atomic<bool> m_failed;
 };
 
-int main(int argc, char* argv[])
+// Pump SDK callbacks (dispatched from the default GLib main context) for up
+// to timeoutMs, returning early once done() is true or a stop was requested
+template <typename Done>
+static void runFor(int64_t timeoutMs, Done done)
+{
+    int64_t deadline = StreamStats::nowNs() + timeoutMs * 1000000;
+    while (!g_stopRequested && !done() && StreamStats::nowNs() < deadline) {
+        while (g_main_context_iteration(nullptr, FALSE)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+// Sample CPU/RSS every sampleMs for the measurement window
+static void measure(const Options& opts, ResourceSampler& sampler)
+{
+    sampler.start();
+    int64_t endNs = StreamStats::nowNs() + int64_t(opts.durationSec) * 1000000000;
+    while (!g_stopRequested) {
+        int64_t remainingMs = (endNs - StreamStats::nowNs()) / 1000000;
+        if (remainingMs <= 0) break;
+        runFor(remainingMs < opts.sampleMs ? remainingMs : opts.sampleMs, []() { return false; });
+        const ResourceSampler::Sample& s = sampler.sample();
+        std::cerr << "[" << s.elapsedSec << "s] cpu " << s.cpuPercent << "% rss "
+                  << s.rssBytes / 1024 << " KB" << std::endl;
+    }
+}
+
+static Json resourcesJson(const ResourceSampler& sampler)
+{
+    Json samples = Json::array();
+    for (const ResourceSampler::Sample& s : sampler.samples()) {
+        samples.push_back({ { "t", s.elapsedSec }, { "cpu_percent", s.cpuPercent }, { "rss_bytes", s.rssBytes } });
+    }
+    return { { "avg_cpu_percent", sampler.averageCpuPercent() },
+             { "peak_rss_bytes", sampler.peakRssBytes() },
+             { "samples", samples } };
+}
+
+static void addTotals(Json& summary)
+{
+    uint64_t videoFrames = 0, videoBytes = 0, audioFrames = 0, audioBytes = 0;
+    for (const Json& stream : summary["streams"]) {
+        bool video = stream["kind"] == "video";
+        (video ? videoFrames : audioFrames) += stream["frames"].get<uint64_t>();
+        (video ? videoBytes : audioBytes) += stream["bytes"].get<uint64_t>();
+    }
+    summary["totals"] = { { "video_frames", videoFrames }, { "video_bytes", videoBytes },
+                          { "audio_frames", audioFrames }, { "audio_bytes", audioBytes } };
+}
+
+static int runSynthetic(const Options& opts, Json& summary)
 {
-    std::cout << "=== Simple Zoom SDK Session Join Test ===" << std::endl;
+    int width = opts.resolutionLines * 16 / 9;
+    SyntheticFrameSource source(width, opts.resolutionLines, opts.syntheticFps);
+
+    std::vector<std::unique_ptr<FrameProbe>> probes;
+    for (int i = 0; i < opts.synthetic; i++) {
+        probes.emplace_back(new FrameProbe("synthetic-" + std::to_string(i)));
+        source.addStream(probes.back().get());
+    }
 
-    // Load config from config.json
+    ResourceSampler sampler;
+    source.start();
+    measure(opts, sampler);
+    source.stop();
+
+    Json streams = Json::array();
+    for (const auto& probe : probes) {
+        streams.push_back(probe->summary());
+    }
+    summary["streams"] = streams;
+    summary["synthetic"] = { { "streams", opts.synthetic }, { "fps", opts.syntheticFps },
+                             { "frames_delivered", source.framesDelivered() },
+                             { "late_ticks", source.lateTicks() } };
+    summary["resources"] = resourcesJson(sampler);
+    return 0;
+}
+
+static int runSession(const Options& opts, Json& summary)
+{
+    // Load config
     std::string session_name;
     std::string session_psw;
     std::string session_token;
 
     try {
-        std::ifstream config_file("config.json");
+        std::ifstream config_file(opts.configPath);
         if (config_file.is_open()) {
             Json config_json;
             config_file >> config_json;
@@ -138,11 +531,11 @@ int main(int argc, char* argv[])
             if (config_json.contains("token"))
                 session_token = config_json["token"];
 
-            std::cout << "Loaded config:" << std::endl;
-            std::cout << "  Session: " << session_name << std::endl;
-            std::cout << "  Token length: " << session_token.length() << std::endl;
+            std::cerr << "Loaded config:" << std::endl;
+            std::cerr << "  Session: " << session_name << std::endl;
+            std::cerr << "  Token length: " << session_token.length() << std::endl;
         } else {
-            std::cerr << "ERROR: Could not open config.json" << std::endl;
+            std::cerr << "ERROR: Could not open " << opts.configPath << std::endl;
             return 1;
         }
     } catch (const std::exception& e) {
@@ -156,15 +549,15 @@ int main(int argc, char* argv[])
     }
 
     // Create SDK instance
-    std::cout << "Creating Zoom Video SDK instance..." << std::endl;
-    IZoomVideoSDK* video_sdk_obj = CreateZoomVideoSDKObj();
-    if (!video_sdk_obj) {
+    std::cerr << "Creating Zoom Video SDK instance..." << std::endl;
+    g_sdk = CreateZoomVideoSDKObj();
+    if (!g_sdk) {
         std::cerr << "ERROR: Failed to create Video SDK object" << std::endl;
         return 1;
     }
 
     // Initialize SDK
-    std::cout << "Initializing Video SDK..." << std::endl;
+    std::cerr << "Initializing Video SDK..." << std::endl;
     ZoomVideoSDKInitParams init_params;
     init_params.domain = "https://zoom.us";
     init_params.enableLog = false;
@@ -174,19 +567,18 @@ int main(int argc, char* argv[])
     init_params.audioRawDataMemoryMode = ZoomVideoSDKRawDataMemoryModeHeap;
     init_params.enableIndirectRawdata = false;
 
-    ZoomVideoSDKErrors err = video_sdk_obj->initialize(init_params);
+    ZoomVideoSDKErrors err = g_sdk->initialize(init_params);
     if (err != ZoomVideoSDKErrors_Success) {
         std::cerr << "ERROR: Failed to initialize Video SDK, error: " << (int)err << std::endl;
         return 1;
     }
 
     // Set up delegate
-    std::cout << "Setting up delegate..." << std::endl;
-    SimpleDelegate* delegate = new SimpleDelegate();
-    video_sdk_obj->addListener(delegate);
+    std::cerr << "Setting up delegate..." << std::endl;
+    SimpleDelegate* delegate = new SimpleDelegate(opts);
+    g_sdk->addListener(delegate);
 
-    // Prepare session context
-    std::cout << "Preparing session context..." << std::endl;
+    // Prepare session context; the bot only receives
     ZoomVideoSDKSessionContext session_context;
     session_context.sessionName = session_name.c_str();
     session_context.userName = "Simple Linux Bot";
@@ -196,32 +588,98 @@ int main(int argc, char* argv[])
         session_context.sessionPassword = session_psw.c_str();
     }
 
-    // Enable audio and video
-    session_context.videoOption.localVideoOn = true;
-    session_context.audioOption.connect = true;
-    session_context.audioOption.mute = false;
+    session_context.videoOption.localVideoOn = false;
+    session_context.audioOption.connect = opts.audio;
+    session_context.audioOption.mute = true;
 
     // Join session
-    std::cout << "Joining session: " << session_name << std::endl;
-    IZoomVideoSDKSession* session = video_sdk_obj->joinSession(session_context);
+    std::cerr << "Joining session: " << session_name << std::endl;
+    int64_t joinStartNs = StreamStats::nowNs();
+    IZoomVideoSDKSession* session = g_sdk->joinSession(session_context);
 
+    int result = 0;
     if (!session) {
         std::cerr << "ERROR: Failed to join session" << std::endl;
-        video_sdk_obj->cleanup();
-        DestroyZoomVideoSDKObj();
-        return 1;
-    }
+        result = 1;
+    } else {
+        runFor(30000, [delegate]() { return delegate->joined() || delegate->failed(); });
+        if (!delegate->joined()) {
+            std::cerr << "ERROR: Session was not joined within 30 seconds" << std::endl;
+            result = 1;
+        } else {
+            summary["join_latency_ms"] = (StreamStats::nowNs() - joinStartNs) / 1e6;
 
-    // Wait for session to establish or fail
-    std::cout << "Waiting for session to establish..." << std::endl;
-    std::this_thread::sleep_for(std::chrono::seconds(10));
+            ResourceSampler sampler;
+            measure(opts, sampler);
+            summary["resources"] = resourcesJson(sampler);
+        }
+    }
 
     // Clean up
-    std::cout << "Cleaning up..." << std::endl;
-    video_sdk_obj->leaveSession(false);
-    video_sdk_obj->cleanup();
+    std::cerr << "Cleaning up..." << std::endl;
+    delegate->unsubscribeAll();
+    if (opts.audio && g_sdk->getAudioHelper()) {
+        g_sdk->getAudioHelper()->unSubscribe();
+    }
+
+    Json streams = Json::array();
+    delegate->appendStreams(streams);
+    summary["streams"] = streams;
+
+    g_sdk->leaveSession(false);
+    g_sdk->removeListener(delegate);
+    g_sdk->cleanup();
     DestroyZoomVideoSDKObj();
+    g_sdk = nullptr;
+    delete delegate;
+    return result;
+}
 
-    std::cout << "=== Test completed ===" << std::endl;
-    return 0;
+int main(int argc, char* argv[])
+{
+    Options opts;
+    if (!parseOptions(argc, argv, opts)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    // Keep stdout for the summary unless asked for more
+    if (!getenv("BOT_LOG_LEVEL")) {
+        Logger::setLevel(LOG_LEVEL_WARN);
+    }
+
+    signal(SIGINT, handleStopSignal);
+    signal(SIGTERM, handleStopSignal);
+
+    // Pin before the SDK starts its threads so they inherit the mask
+    if (opts.pinCpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(opts.pinCpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            std::cerr << "WARNING: could not pin to CPU " << opts.pinCpu << ": " << strerror(errno) << std::endl;
+        }
+    }
+
+    Json summary;
+    summary["mode"] = opts.synthetic > 0 ? "synthetic" : "session";
+    summary["duration_sec"] = opts.durationSec;
+    summary["resolution"] = opts.resolutionLines;
+    summary["pinned_cpu"] = opts.pinCpu;
+
+    std::cerr << "=== Simple Zoom SDK Session Join Test ===" << std::endl;
+    int result = opts.synthetic > 0 ? runSynthetic(opts, summary) : runSession(opts, summary);
+    addTotals(summary);
+
+    // Flush pending log lines so the summary is the last thing on stdout
+    Logger::shutdown();
+    std::string text = summary.dump(2);
+    std::cout << text << std::endl;
+    if (!opts.outputPath.empty()) {
+        std::ofstream out(opts.outputPath);
+        out << text << std::endl;
+    }
+
+    std::cerr << "=== Test completed ===" << std::endl;
+    return result;
 }
@@ -0,0 +1,117 @@
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <thread>
+
+#include "StreamWatchdog.h"
+
+// StreamWatchdog check (ctest; worth running under -fsanitize=thread).
+// Three streams with frames every 10 ms:
+//  - "stalling" goes silent for 1.5 s and must be detected, resubscribed
+//    with backoff, and counted as recovered once its frames return
+//  - "steady" never pauses and must never stall
+//  - "idle" is switched off (raw data off) and sends nothing; an inactive
+//    watch must never stall or be resubscribed
+
+namespace {
+
+std::mutex g_mutex;
+std::map<std::string, int> g_resubscribes;
+
+void sendFrames(StreamWatch& watch, int ms)
+{
+    for (int elapsed = 0; elapsed < ms; elapsed += 10) {
+        watch.onFrame();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+const StreamWatchdog::StreamReport* find(const std::vector<StreamWatchdog::StreamReport>& reports,
+                                         const std::string& name)
+{
+    for (const StreamWatchdog::StreamReport& report : reports) {
+        if (report.name == name) return &report;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+int main()
+{
+    StreamWatchdog::Config config;
+    config.tickMs = 10;
+    config.minStallMs = 200;
+    config.initialBackoffMs = 100;
+    config.maxBackoffMs = 400;
+    StreamWatchdog watchdog(config, [](const std::string& name) {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_resubscribes[name]++;
+    });
+
+    std::shared_ptr<StreamWatch> stalling = watchdog.add("stalling");
+    std::shared_ptr<StreamWatch> steady = watchdog.add("steady");
+    std::shared_ptr<StreamWatch> idle = watchdog.add("idle");
+    idle->setActive(false);
+
+    std::atomic<bool> running(true);
+    std::thread steadyThread([&]() {
+        while (running.load()) sendFrames(*steady, 10);
+    });
+    std::thread stallingThread([&]() {
+        sendFrames(*stalling, 500);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+        sendFrames(*stalling, 500);
+    });
+
+    // Reports are read while the streams run, as the control socket does
+    for (int elapsed = 0; elapsed < 2500; elapsed += 100) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        watchdog.streams();
+    }
+    stallingThread.join();
+    running = false;
+    steadyThread.join();
+
+    std::vector<StreamWatchdog::StreamReport> reports = watchdog.streams();
+    watchdog.report();
+    watchdog.remove(idle);
+    watchdog.stop();
+
+    int failures = 0;
+    const StreamWatchdog::StreamReport* s = find(reports, "stalling");
+    const StreamWatchdog::StreamReport* t = find(reports, "steady");
+    const StreamWatchdog::StreamReport* i = find(reports, "idle");
+    if (!s || !t || !i) {
+        fprintf(stderr, "stream_watchdog_test: a stream is missing from the report\n");
+        return 1;
+    }
+    printf("stalling: stalls %llu resubscribes %llu recoveries %llu recovery %.0f ms\n",
+           (unsigned long long)s->stalls, (unsigned long long)s->resubscribes, (unsigned long long)s->recoveries,
+           s->lastRecoveryMs);
+    printf("steady: stalls %llu, idle: stalls %llu resubscribes %llu\n", (unsigned long long)t->stalls,
+           (unsigned long long)i->stalls, (unsigned long long)i->resubscribes);
+
+    // Silent for 1.5 s against a 200 ms threshold: stall at ~0.2 s, then
+    // resubscribes at once and after 100, 200 and 400 ms of backoff
+    if (s->stalls != 1 || s->resubscribes < 3 || s->recoveries != 1 || s->stalled) {
+        fprintf(stderr, "stream_watchdog_test: stalled stream not detected, retried and recovered\n");
+        failures++;
+    }
+    if (int(s->resubscribes) != g_resubscribes["stalling"]) {
+        fprintf(stderr, "stream_watchdog_test: resubscribe callbacks and counts disagree\n");
+        failures++;
+    }
+    if (t->stalls || g_resubscribes.count("steady")) {
+        fprintf(stderr, "stream_watchdog_test: a steady stream was flagged\n");
+        failures++;
+    }
+    if (i->stalls || i->resubscribes || g_resubscribes.count("idle")) {
+        fprintf(stderr, "stream_watchdog_test: an inactive stream was flagged\n");
+        failures++;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,225 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "TranscriptLog.h"
+
+// Reference consumer for the bot's transcript logs (config.json
+// "transcript_dir"). Prints the committed records of one log, optionally
+// only those of one speaker or a time range, and with --follow keeps
+// printing records as the bot commits them. With --bench it instead appends
+// records from several threads to a private log in this process and reports
+// append latency, group commit sizes and index query time.
+
+struct Options
+{
+    std::string path;
+    bool follow = false;
+    std::string speaker;
+    int64_t fromMs = INT64_MIN;
+    int64_t toMs = INT64_MAX;
+    int bench = 0;  // records per thread
+    int threads = 4;
+};
+
+static volatile sig_atomic_t g_stopRequested = 0;
+
+static void handleStopSignal(int)
+{
+    g_stopRequested = 1;
+}
+
+static int64_t monotonicNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static const char* operationName(TranscriptOperation operation)
+{
+    switch (operation) {
+    case TRANSCRIPT_OP_ADD:      return "add";
+    case TRANSCRIPT_OP_UPDATE:   return "update";
+    case TRANSCRIPT_OP_DELETE:   return "delete";
+    case TRANSCRIPT_OP_COMPLETE: return "complete";
+    default:                     return "none";
+    }
+}
+
+static void printUsage(const char* argv0)
+{
+    std::cerr << "Usage: " << argv0 << " [options] FILE.tlog\n"
+              << "       " << argv0 << " --bench N [--threads T] [FILE.tlog]\n"
+              << "  --follow              keep printing records as they are committed\n"
+              << "  --speaker NAME        only this speaker's records\n"
+              << "  --from-ms MS          only records spoken at or after this Unix time\n"
+              << "  --to-ms MS            only records spoken at or before this Unix time\n"
+              << "  --bench N             append N records per thread to a private log and report\n"
+              << "  --threads T           bench appender threads (default 4)\n";
+}
+
+static bool parseOptions(int argc, char* argv[], Options& opts)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--follow") {
+            opts.follow = true;
+        } else if (arg == "--speaker" && hasValue) {
+            opts.speaker = argv[++i];
+        } else if (arg == "--from-ms" && hasValue) {
+            opts.fromMs = strtoll(argv[++i], nullptr, 10);
+        } else if (arg == "--to-ms" && hasValue) {
+            opts.toMs = strtoll(argv[++i], nullptr, 10);
+        } else if (arg == "--bench" && hasValue) {
+            opts.bench = atoi(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            opts.threads = atoi(argv[++i]);
+        } else if (arg == "-h" || arg == "--help") {
+            return false;
+        } else if (!arg.empty() && arg[0] != '-' && opts.path.empty()) {
+            opts.path = arg;
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << "\n";
+            return false;
+        }
+    }
+    return opts.bench > 0 || !opts.path.empty();
+}
+
+static void printEntry(const TranscriptEntry& entry)
+{
+    time_t seconds = time_t(entry.timestampMs / 1000);
+    tm local;
+    localtime_r(&seconds, &local);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+    printf("%s.%03d [%s] %s: %s", stamp, int(entry.timestampMs % 1000), operationName(entry.operation),
+           entry.speaker.c_str(), entry.text.c_str());
+    if (!entry.messageId.empty()) printf("  (%s)", entry.messageId.c_str());
+    printf("\n");
+}
+
+static int tail(const Options& opts)
+{
+    TranscriptLogReader reader;
+    if (!reader.open(opts.path)) return 1;
+    fprintf(stderr, "Session \"%s\", writer %s\n", reader.header()->sessionName,
+            reader.writerAlive() ? "running" : "closed");
+
+    uint64_t printed = 0;
+    TranscriptEntry entry;
+    while (!g_stopRequested) {
+        bool any = false;
+        while (reader.next(entry)) {
+            any = true;
+            if (!opts.speaker.empty() && entry.speaker != opts.speaker) continue;
+            if (entry.timestampMs < opts.fromMs || entry.timestampMs > opts.toMs) continue;
+            printEntry(entry);
+            printed++;
+        }
+        if (reader.corrupt()) {
+            fprintf(stderr, "Log is damaged after %llu records\n", (unsigned long long)printed);
+            return 1;
+        }
+        if (!opts.follow) break;
+        if (!any) {
+            fflush(stdout);
+            if (!reader.writerAlive()) break;
+            // Commits land every flush interval; polling faster gains nothing
+            usleep(50 * 1000);
+        }
+    }
+    fprintf(stderr, "%llu records\n", (unsigned long long)printed);
+    return 0;
+}
+
+static int bench(const Options& opts)
+{
+    std::string path = opts.path.empty() ? "/tmp/transcript_bench.tlog" : opts.path;
+    TranscriptLog::Config config;
+    TranscriptLog log(config);
+    if (!log.open(path, "bench")) return 1;
+
+    int threadCount = opts.threads > 0 ? opts.threads : 1;
+    std::vector<double> maxAppendUs(threadCount, 0.0);
+    std::vector<double> totalAppendUs(threadCount, 0.0);
+    int64_t baseMs = 1700000000000;
+    int64_t startNs = monotonicNs();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t] {
+            std::string speaker = "speaker" + std::to_string(t);
+            for (int i = 0; i < opts.bench; i++) {
+                // Every message is added, then updated once and completed
+                TranscriptEntry entry;
+                entry.timestampMs = baseMs + int64_t(i) * 100 + t;
+                entry.messageId = speaker + "-" + std::to_string(i / 3);
+                entry.operation = i % 3 == 0 ? TRANSCRIPT_OP_ADD : i % 3 == 1 ? TRANSCRIPT_OP_UPDATE : TRANSCRIPT_OP_COMPLETE;
+                entry.speaker = speaker;
+                entry.text = "the quick brown fox jumps over the lazy dog, revision " + std::to_string(i % 3);
+                int64_t appendNs = monotonicNs();
+                log.append(entry);
+                double us = (monotonicNs() - appendNs) / 1e3;
+                totalAppendUs[t] += us;
+                if (us > maxAppendUs[t]) maxAppendUs[t] = us;
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    double appendSec = (monotonicNs() - startNs) / 1e9;
+    log.flush();
+
+    double meanUs = 0.0;
+    double maxUs = 0.0;
+    for (int t = 0; t < threadCount; t++) {
+        meanUs += totalAppendUs[t];
+        if (maxAppendUs[t] > maxUs) maxUs = maxAppendUs[t];
+    }
+    uint64_t records = uint64_t(opts.bench) * threadCount;
+    meanUs /= records ? records : 1;
+
+    int64_t queryNs = monotonicNs();
+    std::vector<TranscriptSegment> window = log.query(baseMs + 1000, baseMs + 2000, "speaker0");
+    double queryUs = (monotonicNs() - queryNs) / 1e3;
+
+    TranscriptLog::Stats s = log.stats();
+    printf("%llu records in %.3f s (%.0f/s), append mean %.2f us max %.1f us\n", (unsigned long long)records,
+           appendSec, records / appendSec, meanUs, maxUs);
+    printf("%llu bytes committed in %llu flushes (%.1f records each, slowest %.2f ms), %llu drops\n",
+           (unsigned long long)s.committedBytes, (unsigned long long)s.flushes, s.meanRecordsPerFlush, s.maxFlushMs,
+           (unsigned long long)s.drops);
+    printf("%zu segments, %zu speakers; 1 s of speaker0 = %zu segments in %.1f us\n", s.segments, s.speakers,
+           window.size(), queryUs);
+    log.close();
+
+    // Read it back the way another process would
+    TranscriptLogReader reader;
+    uint64_t readBack = 0;
+    TranscriptEntry entry;
+    if (reader.open(path)) {
+        while (reader.next(entry)) readBack++;
+    }
+    printf("reader: %llu records%s\n", (unsigned long long)readBack, reader.corrupt() ? " (damaged)" : "");
+    return readBack == records && !reader.corrupt() ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+    Options opts;
+    if (!parseOptions(argc, argv, opts)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    signal(SIGINT, handleStopSignal);
+    signal(SIGTERM, handleStopSignal);
+    return opts.bench > 0 ? bench(opts) : tail(opts);
+}
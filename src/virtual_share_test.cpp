@@ -0,0 +1,173 @@
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "VirtualShareSource.h"
+
+// VirtualShareSource check (ctest; worth running under -fsanitize=thread)
+// against a fake SDK share sender: the first image is sent whole, a repeat
+// is skipped, a small change converts only its tiles, an idle share gets
+// keepalives, a PPM file is picked up and shared at its even size, and
+// images over the size cap are refused before anything is allocated.
+
+namespace {
+
+class FakeSender : public IZoomVideoSDKShareSender
+{
+public:
+    void sendShareFrame(char* frameBuffer, int width, int height, int frameLength, FrameDataFormat format) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        frames++;
+        lastWidth = width;
+        lastHeight = height;
+        lastFormat = format;
+        last.assign(frameBuffer, frameBuffer + frameLength);
+    }
+
+    bool lastSizeIs(int width, int height)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return lastWidth == width && lastHeight == height;
+    }
+
+    bool lastFormatIs(FrameDataFormat format)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return lastFormat == format;
+    }
+
+    int lumaAt(int x, int y)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return y < lastHeight && x < lastWidth ? last[size_t(y) * lastWidth + x] : -1;
+    }
+
+    std::mutex mutex;
+    int frames = 0;
+    int lastWidth = 0;
+    int lastHeight = 0;
+    FrameDataFormat lastFormat = FrameDataFormat_I420_LIMITED;
+    std::vector<uint8_t> last;
+};
+
+// Polls for up to two seconds
+bool waitFor(const std::function<bool()>& done)
+{
+    for (int i = 0; i < 200; i++) {
+        if (done()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return done();
+}
+
+bool writePPM(const std::string& path, int width, int height, uint8_t r, uint8_t g, uint8_t b)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    fprintf(file, "P6\n# test\n%d %d\n255\n", width, height);
+    for (int i = 0; i < width * height; i++) {
+        fputc(r, file);
+        fputc(g, file);
+        fputc(b, file);
+    }
+    return fclose(file) == 0;
+}
+
+int g_failures = 0;
+
+void expect(bool ok, const char* what)
+{
+    if (ok) return;
+    fprintf(stderr, "virtual_share_test: %s\n", what);
+    g_failures++;
+}
+
+} // namespace
+
+int main()
+{
+    VirtualShareSource::Config config;
+    config.maxFps = 50;
+    config.keepaliveMs = 200;
+    config.filePollMs = 20;
+    config.colorSpace = { COLOR_MATRIX_BT709, COLOR_RANGE_FULL };
+    VirtualShareSource source(config);
+    FakeSender sender;
+    source.onShareSendStarted(&sender);
+
+    const int width = 1280;
+    const int height = 720;
+    std::vector<uint32_t> image(size_t(width) * height, 0xFF808080u);
+    const uint8_t* pixels = reinterpret_cast<const uint8_t*>(image.data());
+
+    // First image: every tile converted and sent
+    source.submitRGB32(pixels, width * 4, width, height);
+    expect(waitFor([&]() { return source.stats().sent == 1; }), "first image was not sent");
+    expect(sender.lastSizeIs(width, height), "sent frame has the wrong size");
+    expect(sender.lastFormatIs(FrameDataFormat_I420_FULL), "full range not sent as I420_FULL");
+    expect(std::abs(sender.lumaAt(0, 0) - 128) <= 1, "grey converted to the wrong luma");
+
+    // Same pixels again: hashed, found unchanged, not converted or sent
+    source.submitRGB32(pixels, width * 4, width, height);
+    expect(waitFor([&]() { return source.stats().unchanged == 1; }), "repeated image was not skipped");
+
+    // A 100x60 white patch touches 3x2 of the 20x12 tiles
+    for (int y = 100; y < 160; y++) {
+        for (int x = 300; x < 400; x++) image[size_t(y) * width + x] = 0xFFFFFFFFu;
+    }
+    source.submitRGB32(pixels, width * 4, width, height);
+    expect(waitFor([&]() { return source.stats().sent == 2; }), "changed image was not sent");
+    VirtualShareSource::Stats stats = source.stats();
+    double patchFraction = 2 * stats.meanDirtyFraction - 1.0;  // the first image was all dirty
+    expect(patchFraction > 0.02 && patchFraction < 0.03, "patch did not convert exactly its six tiles");
+    expect(sender.lumaAt(350, 130) == 255 && std::abs(sender.lumaAt(0, 0) - 128) <= 1,
+           "patch or untouched area has the wrong luma");
+
+    // Nothing new: the retained frame is resent
+    expect(waitFor([&]() { return source.stats().keepalives >= 1; }), "idle share got no keepalive");
+
+    // A file with an odd size is shared at the even size below it
+    std::string path = "/tmp/virtual_share_test." + std::to_string(getpid()) + ".ppm";
+    expect(writePPM(path, 641, 361, 200, 10, 10), "cannot write the test PPM");
+    source.setFile(path);
+    expect(waitFor([&]() { return source.stats().fileLoads == 1 && source.stats().sent == 3; }),
+           "PPM file was not loaded and sent");
+    expect(sender.lastSizeIs(640, 360), "PPM frame has the wrong size");
+
+    // Over the cap: a header claiming 5000 pixels is rejected before any
+    // pixel is read, and so is an oversized submit
+    FILE* huge = fopen(path.c_str(), "wb");
+    expect(huge && fprintf(huge, "P6\n5000 8\n255\n") > 0 && fclose(huge) == 0, "cannot write the oversized PPM");
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    uint64_t submittedBefore = source.stats().submitted;
+    source.submitRGB32(pixels, 5000 * 4, 5000, 8);
+    expect(source.stats().fileLoads == 1 && source.stats().submitted == submittedBefore,
+           "oversized image was accepted");
+    source.setFile(std::string());
+    unlink(path.c_str());
+
+    source.onShareSendStopped();
+    int framesAtStop;
+    {
+        std::lock_guard<std::mutex> lock(sender.mutex);
+        framesAtStop = sender.frames;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    source.stop();
+    expect(sender.frames == framesAtStop, "frames sent after onShareSendStopped()");
+
+    stats = source.stats();
+    printf("submitted %llu, unchanged %llu, converted %llu, sent %llu, keepalives %llu, file loads %llu, "
+           "convert mean %.0f us\n",
+           (unsigned long long)stats.submitted, (unsigned long long)stats.unchanged,
+           (unsigned long long)stats.converted, (unsigned long long)stats.sent,
+           (unsigned long long)stats.keepalives, (unsigned long long)stats.fileLoads, stats.meanConvertUs);
+    return g_failures ? 1 : 0;
+}